@@ -0,0 +1,264 @@
+/*
+Copyright 2005 - 2017 by Paolo Brandoli/Binarno s.p.
+
+Imebra is available for free under the GNU General Public License.
+
+The full text of the license is available in the file license.rst
+ in the project root folder.
+
+If you do not want to be bound by the GPL terms (such as the requirement
+ that your application must also be GPL), you may purchase a commercial
+ license for Imebra from the Imebra’s website (http://imebra.com).
+*/
+
+#include "benchmarkRunner.h"
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <exception>
+#include <iostream>
+#include <locale>
+#include <mutex>
+#include <sstream>
+#include <thread>
+
+namespace imebra
+{
+
+namespace benchmarks
+{
+
+benchmarkOptions::benchmarkOptions():
+    minimumSeconds(0.5),
+    minimumIterations(2)
+{
+    sizes.push_back(256);
+    sizes.push_back(512);
+    sizes.push_back(1024);
+
+    threads.push_back(1);
+    threads.push_back(2);
+    threads.push_back(4);
+}
+
+
+benchmarkRunner::benchmarkRunner(const benchmarkOptions& options): m_options(options)
+{
+}
+
+
+std::string benchmarkRunner::getId(const std::string& name, const parameters_t& parameters)
+{
+    std::string id(name);
+    for(parameters_t::const_iterator scanParameters(parameters.begin()), endParameters(parameters.end()); scanParameters != endParameters; ++scanParameters)
+    {
+        id += "/" + scanParameters->first + "=" + scanParameters->second;
+    }
+    return id;
+}
+
+
+bool benchmarkRunner::isSelected(const std::string& name, const parameters_t& parameters) const
+{
+    return m_options.filter.empty() || getId(name, parameters).find(m_options.filter) != std::string::npos;
+}
+
+
+const benchmarkOptions& benchmarkRunner::getOptions() const
+{
+    return m_options;
+}
+
+
+void benchmarkRunner::run(const std::string& name, const parameters_t& parameters, const std::string& unit, workerFactory_t workerFactory)
+{
+    if(!isSelected(name, parameters))
+    {
+        return;
+    }
+
+    for(std::vector<size_t>::const_iterator scanThreads(m_options.threads.begin()), endThreads(m_options.threads.end()); scanThreads != endThreads; ++scanThreads)
+    {
+        std::cerr << getId(name, parameters) << "/threads=" << *scanThreads << std::flush;
+
+        benchmarkResult result(runThreads(name, parameters, unit, *scanThreads, workerFactory));
+        m_results.push_back(result);
+
+        std::cerr << ": " << (double)result.units / result.seconds << " " << unit << "/s" << std::endl;
+    }
+}
+
+
+benchmarkResult benchmarkRunner::runThreads(const std::string& name, const parameters_t& parameters, const std::string& unit, size_t threadsNumber, workerFactory_t workerFactory) const
+{
+    std::mutex startMutex;
+    std::condition_variable startCondition;
+    size_t readyThreads(0);
+    bool bStart(false);
+
+    std::mutex errorMutex;
+    std::exception_ptr pError;
+
+    std::atomic<std::uint64_t> totalIterations(0);
+    std::atomic<std::uint64_t> totalUnits(0);
+
+    const std::chrono::duration<double> minimumDuration(m_options.minimumSeconds);
+    const std::uint64_t minimumIterations(m_options.minimumIterations);
+
+    std::vector<std::thread> threads;
+    for(size_t threadNumber(0); threadNumber != threadsNumber; ++threadNumber)
+    {
+        threads.push_back(std::thread([&]()
+        {
+            // Prepare the data and warm up the caches
+            ///////////////////////////////////////////////////////////
+            iteration_t iteration;
+            try
+            {
+                iteration = workerFactory();
+                iteration();
+            }
+            catch(...)
+            {
+                std::lock_guard<std::mutex> lock(errorMutex);
+                pError = std::current_exception();
+            }
+
+            {
+                std::unique_lock<std::mutex> lock(startMutex);
+                ++readyThreads;
+                startCondition.notify_all();
+                startCondition.wait(lock, [&]() { return bStart; });
+            }
+
+            {
+                std::lock_guard<std::mutex> lock(errorMutex);
+                if(pError)
+                {
+                    return;
+                }
+            }
+
+            const std::chrono::steady_clock::time_point startTime(std::chrono::steady_clock::now());
+            std::uint64_t iterations(0);
+            std::uint64_t units(0);
+            do
+            {
+                units += iteration();
+                ++iterations;
+            } while(iterations < minimumIterations || std::chrono::steady_clock::now() - startTime < minimumDuration);
+
+            totalIterations += iterations;
+            totalUnits += units;
+        }));
+    }
+
+    // Start all the threads at the same time
+    ///////////////////////////////////////////////////////////
+    std::chrono::steady_clock::time_point startTime;
+    {
+        std::unique_lock<std::mutex> lock(startMutex);
+        startCondition.wait(lock, [&]() { return readyThreads == threadsNumber; });
+        Statistics::resetStatistics();
+        startTime = std::chrono::steady_clock::now();
+        bStart = true;
+        startCondition.notify_all();
+    }
+
+    for(std::vector<std::thread>::iterator scanThreads(threads.begin()), endThreads(threads.end()); scanThreads != endThreads; ++scanThreads)
+    {
+        scanThreads->join();
+    }
+
+    if(pError)
+    {
+        std::rethrow_exception(pError);
+    }
+
+    benchmarkResult result;
+    result.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - startTime).count();
+    result.statistics = Statistics::getStatistics();
+    result.name = name;
+    result.parameters = parameters;
+    result.threads = threadsNumber;
+    result.unit = unit;
+    result.iterations = totalIterations;
+    result.units = totalUnits;
+
+    return result;
+}
+
+
+static std::string jsonString(const std::string& value)
+{
+    std::string escaped("\"");
+    for(std::string::const_iterator scanChars(value.begin()), endChars(value.end()); scanChars != endChars; ++scanChars)
+    {
+        if(*scanChars == '"' || *scanChars == '\\')
+        {
+            escaped += '\\';
+        }
+        escaped += *scanChars;
+    }
+    escaped += "\"";
+    return escaped;
+}
+
+
+void benchmarkRunner::writeJson(std::ostream& stream) const
+{
+    std::ostringstream json;
+    json.imbue(std::locale::classic());
+    json.precision(9);
+
+    json << "{\n";
+    json << "  \"statisticsEnabled\": " << (Statistics::isEnabled() ? "true" : "false") << ",\n";
+    json << "  \"hardwareThreads\": " << std::thread::hardware_concurrency() << ",\n";
+    json << "  \"minimumSeconds\": " << m_options.minimumSeconds << ",\n";
+    json << "  \"benchmarks\": [";
+
+    for(size_t scanResults(0); scanResults != m_results.size(); ++scanResults)
+    {
+        const benchmarkResult& result(m_results[scanResults]);
+
+        json << (scanResults == 0 ? "\n" : ",\n");
+        json << "    {\n";
+        json << "      \"id\": " << jsonString(getId(result.name, result.parameters) + "/threads=" + std::to_string(result.threads)) << ",\n";
+        json << "      \"name\": " << jsonString(result.name) << ",\n";
+        json << "      \"parameters\": {";
+        for(size_t scanParameters(0); scanParameters != result.parameters.size(); ++scanParameters)
+        {
+            json << (scanParameters == 0 ? "" : ", ") << jsonString(result.parameters[scanParameters].first) << ": " << jsonString(result.parameters[scanParameters].second);
+        }
+        json << "},\n";
+        json << "      \"threads\": " << result.threads << ",\n";
+        json << "      \"iterations\": " << result.iterations << ",\n";
+        json << "      \"seconds\": " << result.seconds << ",\n";
+        json << "      \"secondsPerIteration\": " << result.seconds * (double)result.threads / (double)result.iterations << ",\n";
+        json << "      \"unit\": " << jsonString(result.unit) << ",\n";
+        json << "      \"units\": " << result.units << ",\n";
+        json << "      \"unitsPerSecond\": " << (double)result.units / result.seconds << ",\n";
+        json << "      \"counters\": {";
+        json << "\"fileBytesRead\": " << result.statistics.fileBytesRead;
+        json << ", \"parsedElements\": " << result.statistics.parsedElements;
+        json << ", \"parsingTime\": " << result.statistics.parsingTime;
+        json << ", \"dicomDecodedPixels\": " << result.statistics.dicomDecodedPixels;
+        json << ", \"dicomDecodingTime\": " << result.statistics.dicomDecodingTime;
+        json << ", \"jpegDecodedPixels\": " << result.statistics.jpegDecodedPixels;
+        json << ", \"jpegDecodingTime\": " << result.statistics.jpegDecodingTime;
+        json << ", \"transformedPixels\": " << result.statistics.transformedPixels;
+        json << ", \"transformTime\": " << result.statistics.transformTime;
+        json << ", \"memoryPoolHits\": " << result.statistics.memoryPoolHits;
+        json << ", \"memoryPoolMisses\": " << result.statistics.memoryPoolMisses;
+        json << "}\n";
+        json << "    }";
+    }
+
+    json << "\n  ]\n}\n";
+
+    stream << json.str();
+}
+
+} // namespace benchmarks
+
+} // namespace imebra
@@ -0,0 +1,132 @@
+/*
+Copyright 2005 - 2017 by Paolo Brandoli/Binarno s.p.
+
+Imebra is available for free under the GNU General Public License.
+
+The full text of the license is available in the file license.rst
+ in the project root folder.
+
+If you do not want to be bound by the GPL terms (such as the requirement
+ that your application must also be GPL), you may purchase a commercial
+ license for Imebra from the Imebra’s website (http://imebra.com).
+*/
+
+#if !defined(imebraBenchmarkRunner_5C7E2A19_0D84_4B6F_9E31_A8F4D6B20C57__INCLUDED_)
+#define imebraBenchmarkRunner_5C7E2A19_0D84_4B6F_9E31_A8F4D6B20C57__INCLUDED_
+
+#include <imebra/imebra.h>
+#include <functional>
+#include <ostream>
+#include <string>
+#include <vector>
+#include <utility>
+#include <cstdint>
+
+namespace imebra
+{
+
+namespace benchmarks
+{
+
+///
+/// \brief Options that control how long each benchmark runs and which
+///        benchmarks are executed.
+///
+///////////////////////////////////////////////////////////////////////////////
+struct benchmarkOptions
+{
+    benchmarkOptions();
+
+    std::string filter;                 ///< Run only the benchmarks whose id contains this text
+    double minimumSeconds;              ///< Minimum duration of each benchmark
+    std::uint64_t minimumIterations;    ///< Minimum iterations executed by each thread
+    std::vector<std::uint32_t> sizes;   ///< Width and height of the synthetic images
+    std::vector<size_t> threads;        ///< Numbers of concurrent threads
+};
+
+/// \brief The benchmark's parameters, as (name, value) pairs.
+///
+///////////////////////////////////////////////////////////////////////////////
+typedef std::vector<std::pair<std::string, std::string> > parameters_t;
+
+/// \brief Executes one iteration of a benchmark and returns the processed
+///        units (pixels, bytes, elements...).
+///
+///////////////////////////////////////////////////////////////////////////////
+typedef std::function<std::uint64_t()> iteration_t;
+
+/// \brief Called once by each benchmark thread before the measurement
+///        starts: prepares the thread's private data and returns the
+///        function that executes one iteration.
+///
+///////////////////////////////////////////////////////////////////////////////
+typedef std::function<iteration_t()> workerFactory_t;
+
+///
+/// \brief The result of a benchmark.
+///
+///////////////////////////////////////////////////////////////////////////////
+struct benchmarkResult
+{
+    std::string name;
+    parameters_t parameters;
+    size_t threads;
+    std::string unit;
+    std::uint64_t iterations;
+    std::uint64_t units;
+    double seconds;
+    LibraryStatistics statistics;
+};
+
+///
+/// \brief Runs the benchmarks and collects their results.
+///
+/// Each benchmark is executed concurrently by the requested number of
+/// threads; each thread works on its own data, prepared before the
+/// measurement starts.
+///
+///////////////////////////////////////////////////////////////////////////////
+class benchmarkRunner
+{
+public:
+    benchmarkRunner(const benchmarkOptions& options);
+
+    /// \brief Returns the benchmark's id, used by the filter.
+    ///
+    ///////////////////////////////////////////////////////////////////////////////
+    static std::string getId(const std::string& name, const parameters_t& parameters);
+
+    /// \brief Returns true if the filter selects the benchmark.
+    ///
+    ///////////////////////////////////////////////////////////////////////////////
+    bool isSelected(const std::string& name, const parameters_t& parameters) const;
+
+    /// \brief Run a benchmark with all the configured thread counts.
+    ///
+    /// \param name          the benchmark's name
+    /// \param parameters    the benchmark's parameters
+    /// \param unit          the name of the units returned by the iterations
+    /// \param workerFactory creates the iteration function for each thread
+    ///
+    ///////////////////////////////////////////////////////////////////////////////
+    void run(const std::string& name, const parameters_t& parameters, const std::string& unit, workerFactory_t workerFactory);
+
+    /// \brief Write the results in JSON format.
+    ///
+    ///////////////////////////////////////////////////////////////////////////////
+    void writeJson(std::ostream& stream) const;
+
+    const benchmarkOptions& getOptions() const;
+
+private:
+    benchmarkResult runThreads(const std::string& name, const parameters_t& parameters, const std::string& unit, size_t threadsNumber, workerFactory_t workerFactory) const;
+
+    const benchmarkOptions m_options;
+    std::vector<benchmarkResult> m_results;
+};
+
+} // namespace benchmarks
+
+} // namespace imebra
+
+#endif // !defined(imebraBenchmarkRunner_5C7E2A19_0D84_4B6F_9E31_A8F4D6B20C57__INCLUDED_)
@@ -0,0 +1,500 @@
+/*
+Copyright 2005 - 2017 by Paolo Brandoli/Binarno s.p.
+
+Imebra is available for free under the GNU General Public License.
+
+The full text of the license is available in the file license.rst
+ in the project root folder.
+
+If you do not want to be bound by the GPL terms (such as the requirement
+ that your application must also be GPL), you may purchase a commercial
+ license for Imebra from the Imebra’s website (http://imebra.com).
+*/
+
+#include <imebra/imebra.h>
+#include <fstream>
+#include <iostream>
+#include <memory>
+#include <sstream>
+#include <cstdlib>
+
+#include "benchmarkRunner.h"
+#include "syntheticData.h"
+
+using namespace imebra;
+using namespace imebra::benchmarks;
+
+///////////////////////////////////////////////////////////
+//
+// The images used to benchmark each transfer syntax
+//
+///////////////////////////////////////////////////////////
+struct transferSyntaxImage
+{
+    const char* transferSyntax;
+    const char* description;
+    bitDepth_t depth;
+    std::uint32_t highBit;
+    const char* colorSpace;
+};
+
+static const transferSyntaxImage transferSyntaxImages[] =
+{
+    {"1.2.840.10008.1.2", "implicitLittleEndian", bitDepth_t::depthU16, 15, "MONOCHROME2"},
+    {"1.2.840.10008.1.2.1", "explicitLittleEndian", bitDepth_t::depthU16, 15, "MONOCHROME2"},
+    {"1.2.840.10008.1.2.1", "explicitLittleEndian", bitDepth_t::depthU8, 7, "RGB"},
+    {"1.2.840.10008.1.2.2", "explicitBigEndian", bitDepth_t::depthU16, 15, "MONOCHROME2"},
+    {"1.2.840.10008.1.2.5", "rle", bitDepth_t::depthU16, 15, "MONOCHROME2"},
+    {"1.2.840.10008.1.2.5", "rle", bitDepth_t::depthU8, 7, "RGB"},
+    {"1.2.840.10008.1.2.4.50", "jpegBaseline", bitDepth_t::depthU8, 7, "YBR_FULL"},
+    {"1.2.840.10008.1.2.4.51", "jpegExtended", bitDepth_t::depthU16, 11, "MONOCHROME2"},
+    {"1.2.840.10008.1.2.4.57", "jpegLossless", bitDepth_t::depthU16, 15, "MONOCHROME2"},
+    {"1.2.840.10008.1.2.4.70", "jpegLosslessFirstOrder", bitDepth_t::depthU16, 15, "MONOCHROME2"}
+};
+
+
+static parameters_t imageParameters(std::uint32_t size, const transferSyntaxImage& image)
+{
+    parameters_t parameters;
+    parameters.push_back(std::make_pair(std::string("transferSyntax"), std::string(image.description)));
+    parameters.push_back(std::make_pair(std::string("colorSpace"), std::string(image.colorSpace)));
+    parameters.push_back(std::make_pair(std::string("bits"), std::to_string(image.highBit + 1)));
+    parameters.push_back(std::make_pair(std::string("size"), std::to_string(size)));
+    return parameters;
+}
+
+
+///////////////////////////////////////////////////////////
+//
+// Header parsing: load a dataset with many small tags
+//
+///////////////////////////////////////////////////////////
+static void benchmarkParse(benchmarkRunner& runner)
+{
+    const size_t tagsNumbers[] = {100, 2000};
+
+    for(size_t scanTags(0); scanTags != sizeof(tagsNumbers) / sizeof(tagsNumbers[0]); ++scanTags)
+    {
+        const size_t tagsNumber(tagsNumbers[scanTags]);
+
+        parameters_t parameters;
+        parameters.push_back(std::make_pair(std::string("tags"), std::to_string(tagsNumber)));
+
+        runner.run("parse", parameters, "bytes", [tagsNumber]()
+        {
+            std::unique_ptr<DataSet> dataSet(buildSyntheticHeader("1.2.840.10008.1.2.1", tagsNumber));
+            std::shared_ptr<ReadWriteMemory> encoded(saveToMemory(*dataSet));
+
+            return iteration_t([encoded]()
+            {
+                std::unique_ptr<DataSet> loaded(loadFromMemory(*encoded));
+                return (std::uint64_t)encoded->size();
+            });
+        });
+    }
+}
+
+
+///////////////////////////////////////////////////////////
+//
+// Concurrent reads of one dataset shared by all the
+//  threads, with and without freezing it
+//
+///////////////////////////////////////////////////////////
+static void benchmarkSharedRead(benchmarkRunner& runner)
+{
+    const size_t tagsNumber(100);
+
+    for(int frozen(0); frozen != 2; ++frozen)
+    {
+        parameters_t parameters;
+        parameters.push_back(std::make_pair(std::string("tags"), std::to_string(tagsNumber)));
+        parameters.push_back(std::make_pair(std::string("frozen"), std::to_string(frozen)));
+
+        if(!runner.isSelected("sharedRead", parameters))
+        {
+            continue;
+        }
+
+        std::shared_ptr<DataSet> sharedDataSet;
+        {
+            std::unique_ptr<DataSet> dataSet(buildSyntheticHeader("1.2.840.10008.1.2.1", tagsNumber));
+            std::unique_ptr<ReadWriteMemory> encoded(saveToMemory(*dataSet));
+            sharedDataSet.reset(loadFromMemory(*encoded));
+        }
+        if(frozen != 0)
+        {
+            sharedDataSet->freeze();
+        }
+
+        runner.run("sharedRead", parameters, "tags", [sharedDataSet, tagsNumber]()
+        {
+            return iteration_t([sharedDataSet, tagsNumber]()
+            {
+                sharedDataSet->getString(TagId(tagId_t::PatientName_0010_0010), 0);
+                for(size_t tagNumber(0); tagNumber != tagsNumber; ++tagNumber)
+                {
+                    sharedDataSet->getString(TagId((std::uint16_t)0x0011, (std::uint16_t)(0x1000u + tagNumber)), 0);
+                }
+                return (std::uint64_t)(tagsNumber + 1);
+            });
+        });
+    }
+}
+
+
+///////////////////////////////////////////////////////////
+//
+// Decoding and encoding for each transfer syntax
+//
+///////////////////////////////////////////////////////////
+static void benchmarkCodecs(benchmarkRunner& runner)
+{
+    const std::vector<std::uint32_t>& sizes(runner.getOptions().sizes);
+
+    for(size_t scanImages(0); scanImages != sizeof(transferSyntaxImages) / sizeof(transferSyntaxImages[0]); ++scanImages)
+    {
+        const transferSyntaxImage& imageInfo(transferSyntaxImages[scanImages]);
+
+        for(std::vector<std::uint32_t>::const_iterator scanSizes(sizes.begin()), endSizes(sizes.end()); scanSizes != endSizes; ++scanSizes)
+        {
+            const std::uint32_t size(*scanSizes);
+            const parameters_t parameters(imageParameters(size, imageInfo));
+
+            runner.run("decode", parameters, "pixels", [size, &imageInfo]()
+            {
+                std::unique_ptr<Image> image(buildSyntheticImage(size, size, imageInfo.depth, imageInfo.highBit, imageInfo.colorSpace));
+                DataSet dataSet(imageInfo.transferSyntax);
+                dataSet.setImage(0, *image, imageQuality_t::veryHigh);
+                std::shared_ptr<ReadWriteMemory> encoded(saveToMemory(dataSet));
+
+                return iteration_t([encoded, size]()
+                {
+                    std::unique_ptr<DataSet> loaded(loadFromMemory(*encoded));
+                    std::unique_ptr<Image> decoded(loaded->getImage(0));
+                    return (std::uint64_t)size * size;
+                });
+            });
+
+            runner.run("encode", parameters, "pixels", [size, &imageInfo]()
+            {
+                std::shared_ptr<Image> image(buildSyntheticImage(size, size, imageInfo.depth, imageInfo.highBit, imageInfo.colorSpace));
+                const std::string transferSyntax(imageInfo.transferSyntax);
+
+                return iteration_t([image, transferSyntax, size]()
+                {
+                    DataSet dataSet(transferSyntax);
+                    dataSet.setImage(0, *image, imageQuality_t::veryHigh);
+                    return (std::uint64_t)size * size;
+                });
+            });
+
+            // Jpeg encoding with the restart intervals encoded
+            //  concurrently
+            ///////////////////////////////////////////////////////////
+            if(std::string(imageInfo.description).compare(0, 4, "jpeg") == 0)
+            {
+                parameters_t restartParameters(parameters);
+                restartParameters.push_back(std::make_pair(std::string("restartRows"), std::string("4")));
+
+                CodecFactory::setJpegRestartInterval(4);
+                try
+                {
+                    runner.run("encode", restartParameters, "pixels", [size, &imageInfo]()
+                    {
+                        std::shared_ptr<Image> image(buildSyntheticImage(size, size, imageInfo.depth, imageInfo.highBit, imageInfo.colorSpace));
+                        const std::string transferSyntax(imageInfo.transferSyntax);
+
+                        return iteration_t([image, transferSyntax, size]()
+                        {
+                            DataSet dataSet(transferSyntax);
+                            dataSet.setImage(0, *image, imageQuality_t::veryHigh);
+                            return (std::uint64_t)size * size;
+                        });
+                    });
+                }
+                catch(...)
+                {
+                    CodecFactory::setJpegRestartInterval(0);
+                    throw;
+                }
+                CodecFactory::setJpegRestartInterval(0);
+            }
+        }
+    }
+}
+
+
+///////////////////////////////////////////////////////////
+//
+// Saving datasets that already contain encoded images
+//
+///////////////////////////////////////////////////////////
+static void benchmarkSave(benchmarkRunner& runner)
+{
+    const std::vector<std::uint32_t>& sizes(runner.getOptions().sizes);
+
+    for(size_t scanImages(0); scanImages != sizeof(transferSyntaxImages) / sizeof(transferSyntaxImages[0]); ++scanImages)
+    {
+        const transferSyntaxImage& imageInfo(transferSyntaxImages[scanImages]);
+
+        for(std::vector<std::uint32_t>::const_iterator scanSizes(sizes.begin()), endSizes(sizes.end()); scanSizes != endSizes; ++scanSizes)
+        {
+            const std::uint32_t size(*scanSizes);
+
+            runner.run("save", imageParameters(size, imageInfo), "bytes", [size, &imageInfo]()
+            {
+                std::unique_ptr<Image> image(buildSyntheticImage(size, size, imageInfo.depth, imageInfo.highBit, imageInfo.colorSpace));
+                std::shared_ptr<DataSet> dataSet(buildSyntheticHeader(imageInfo.transferSyntax, 100));
+                dataSet->setImage(0, *image, imageQuality_t::veryHigh);
+
+                return iteration_t([dataSet]()
+                {
+                    std::unique_ptr<ReadWriteMemory> encoded(saveToMemory(*dataSet));
+                    return (std::uint64_t)encoded->size();
+                });
+            });
+        }
+    }
+}
+
+
+///////////////////////////////////////////////////////////
+//
+// Color and VOI transforms
+//
+///////////////////////////////////////////////////////////
+static void benchmarkTransforms(benchmarkRunner& runner)
+{
+    const std::vector<std::uint32_t>& sizes(runner.getOptions().sizes);
+
+    for(std::vector<std::uint32_t>::const_iterator scanSizes(sizes.begin()), endSizes(sizes.end()); scanSizes != endSizes; ++scanSizes)
+    {
+        const std::uint32_t size(*scanSizes);
+
+        parameters_t colorParameters;
+        colorParameters.push_back(std::make_pair(std::string("transform"), std::string("RGBToYBR_FULL")));
+        colorParameters.push_back(std::make_pair(std::string("size"), std::to_string(size)));
+
+        runner.run("transform", colorParameters, "pixels", [size]()
+        {
+            std::shared_ptr<Image> input(buildSyntheticImage(size, size, bitDepth_t::depthU8, 7, "RGB"));
+            std::shared_ptr<Transform> transform(ColorTransformsFactory::getTransform("RGB", "YBR_FULL"));
+            std::shared_ptr<Image> output(transform->allocateOutputImage(*input, size, size));
+
+            return iteration_t([input, transform, output, size]()
+            {
+                transform->runTransform(*input, 0, 0, size, size, *output, 0, 0);
+                return (std::uint64_t)size * size;
+            });
+        });
+
+        parameters_t voiParameters;
+        voiParameters.push_back(std::make_pair(std::string("transform"), std::string("VOILUT")));
+        voiParameters.push_back(std::make_pair(std::string("size"), std::to_string(size)));
+
+        runner.run("transform", voiParameters, "pixels", [size]()
+        {
+            std::shared_ptr<Image> input(buildSyntheticImage(size, size, bitDepth_t::depthU16, 15, "MONOCHROME2"));
+            std::shared_ptr<VOILUT> transform(new VOILUT());
+            transform->setCenterWidth(32768.0, 40000.0);
+            std::shared_ptr<Image> output(transform->allocateOutputImage(*input, size, size));
+
+            return iteration_t([input, transform, output, size]()
+            {
+                transform->runTransform(*input, 0, 0, size, size, *output, 0, 0);
+                return (std::uint64_t)size * size;
+            });
+        });
+    }
+}
+
+
+///////////////////////////////////////////////////////////
+//
+// Rendering
+//
+///////////////////////////////////////////////////////////
+static void benchmarkDrawBitmap(benchmarkRunner& runner)
+{
+    const std::vector<std::uint32_t>& sizes(runner.getOptions().sizes);
+
+    for(std::vector<std::uint32_t>::const_iterator scanSizes(sizes.begin()), endSizes(sizes.end()); scanSizes != endSizes; ++scanSizes)
+    {
+        const std::uint32_t size(*scanSizes);
+
+        parameters_t colorParameters;
+        colorParameters.push_back(std::make_pair(std::string("colorSpace"), std::string("YBR_FULL")));
+        colorParameters.push_back(std::make_pair(std::string("bits"), std::string("8")));
+        colorParameters.push_back(std::make_pair(std::string("size"), std::to_string(size)));
+
+        runner.run("drawBitmap", colorParameters, "pixels", [size]()
+        {
+            std::shared_ptr<Image> image(buildSyntheticImage(size, size, bitDepth_t::depthU8, 7, "YBR_FULL"));
+            std::shared_ptr<DrawBitmap> drawBitmap(new DrawBitmap());
+            std::shared_ptr<std::vector<char> > bitmap(new std::vector<char>(drawBitmap->getBitmap(*image, drawBitmapType_t::drawBitmapRGBA, 4, 0, 0)));
+
+            return iteration_t([image, drawBitmap, bitmap, size]()
+            {
+                drawBitmap->getBitmap(*image, drawBitmapType_t::drawBitmapRGBA, 4, bitmap->data(), bitmap->size());
+                return (std::uint64_t)size * size;
+            });
+        });
+
+        parameters_t monochromeParameters;
+        monochromeParameters.push_back(std::make_pair(std::string("colorSpace"), std::string("MONOCHROME2")));
+        monochromeParameters.push_back(std::make_pair(std::string("bits"), std::string("16")));
+        monochromeParameters.push_back(std::make_pair(std::string("size"), std::to_string(size)));
+
+        runner.run("drawBitmap", monochromeParameters, "pixels", [size]()
+        {
+            std::shared_ptr<Image> image(buildSyntheticImage(size, size, bitDepth_t::depthU16, 15, "MONOCHROME2"));
+            VOILUT voilut;
+            voilut.setCenterWidth(32768.0, 40000.0);
+            std::shared_ptr<DrawBitmap> drawBitmap(new DrawBitmap(voilut));
+            std::shared_ptr<std::vector<char> > bitmap(new std::vector<char>(drawBitmap->getBitmap(*image, drawBitmapType_t::drawBitmapRGB, 4, 0, 0)));
+
+            return iteration_t([image, drawBitmap, bitmap, size]()
+            {
+                drawBitmap->getBitmap(*image, drawBitmapType_t::drawBitmapRGB, 4, bitmap->data(), bitmap->size());
+                return (std::uint64_t)size * size;
+            });
+        });
+    }
+}
+
+
+///////////////////////////////////////////////////////////
+//
+// Memory pool: allocate and release frame-sized buffers
+//
+///////////////////////////////////////////////////////////
+static void benchmarkMemoryPool(benchmarkRunner& runner)
+{
+    const std::vector<std::uint32_t>& sizes(runner.getOptions().sizes);
+
+    for(std::vector<std::uint32_t>::const_iterator scanSizes(sizes.begin()), endSizes(sizes.end()); scanSizes != endSizes; ++scanSizes)
+    {
+        const size_t bytes((size_t)*scanSizes * (size_t)*scanSizes * 2u);
+
+        parameters_t parameters;
+        parameters.push_back(std::make_pair(std::string("bytes"), std::to_string(bytes)));
+
+        runner.run("memoryPool", parameters, "bytes", [bytes]()
+        {
+            return iteration_t([bytes]()
+            {
+                ReadWriteMemory memory(bytes);
+                size_t dataSize;
+                memory.data(&dataSize)[0] = 1;
+                return (std::uint64_t)dataSize;
+            });
+        });
+    }
+}
+
+
+///////////////////////////////////////////////////////////
+//
+// Command line parsing
+//
+///////////////////////////////////////////////////////////
+template<typename value_t>
+static std::vector<value_t> parseList(const std::string& list)
+{
+    std::vector<value_t> values;
+    std::istringstream stream(list);
+    std::string value;
+    while(std::getline(stream, value, ','))
+    {
+        values.push_back((value_t)std::strtoul(value.c_str(), 0, 10));
+    }
+    return values;
+}
+
+static void printUsage()
+{
+    std::cerr << "Usage: imebra_benchmarks [options]" << std::endl;
+    std::cerr << "  --output <file>      write the JSON results to a file instead of stdout" << std::endl;
+    std::cerr << "  --filter <text>      run only the benchmarks whose id contains the text" << std::endl;
+    std::cerr << "  --min-time <sec>     minimum duration of each benchmark (default 0.5)" << std::endl;
+    std::cerr << "  --sizes <list>       comma separated image sizes (default 256,512,1024)" << std::endl;
+    std::cerr << "  --threads <list>     comma separated thread counts (default 1,2,4)" << std::endl;
+    std::cerr << "  --quick              small images, one thread, short runs" << std::endl;
+}
+
+
+int main(int argc, char* argv[])
+{
+    benchmarkOptions options;
+    std::string outputFile;
+
+    for(int scanArguments(1); scanArguments < argc; ++scanArguments)
+    {
+        const std::string argument(argv[scanArguments]);
+        const bool bHasValue(scanArguments + 1 < argc);
+
+        if(argument == "--output" && bHasValue)
+        {
+            outputFile = argv[++scanArguments];
+        }
+        else if(argument == "--filter" && bHasValue)
+        {
+            options.filter = argv[++scanArguments];
+        }
+        else if(argument == "--min-time" && bHasValue)
+        {
+            options.minimumSeconds = std::strtod(argv[++scanArguments], 0);
+        }
+        else if(argument == "--sizes" && bHasValue)
+        {
+            options.sizes = parseList<std::uint32_t>(argv[++scanArguments]);
+        }
+        else if(argument == "--threads" && bHasValue)
+        {
+            options.threads = parseList<size_t>(argv[++scanArguments]);
+        }
+        else if(argument == "--quick")
+        {
+            options.sizes = std::vector<std::uint32_t>(1, 128);
+            options.threads = std::vector<size_t>(1, 1);
+            options.minimumSeconds = 0.05;
+        }
+        else
+        {
+            printUsage();
+            return 1;
+        }
+    }
+
+    try
+    {
+        benchmarkRunner runner(options);
+
+        benchmarkParse(runner);
+        benchmarkSharedRead(runner);
+        benchmarkCodecs(runner);
+        benchmarkSave(runner);
+        benchmarkTransforms(runner);
+        benchmarkDrawBitmap(runner);
+        benchmarkMemoryPool(runner);
+
+        if(outputFile.empty())
+        {
+            runner.writeJson(std::cout);
+        }
+        else
+        {
+            std::ofstream output(outputFile.c_str());
+            runner.writeJson(output);
+        }
+    }
+    catch(const std::exception& e)
+    {
+        std::cerr << ExceptionsManager::getExceptionTrace() << std::endl;
+        std::cerr << e.what() << std::endl;
+        return 1;
+    }
+
+    return 0;
+}
@@ -0,0 +1,199 @@
+/*
+Copyright 2005 - 2017 by Paolo Brandoli/Binarno s.p.
+
+Imebra is available for free under the GNU General Public License.
+
+The full text of the license is available in the file license.rst
+ in the project root folder.
+
+If you do not want to be bound by the GPL terms (such as the requirement
+ that your application must also be GPL), you may purchase a commercial
+ license for Imebra from the Imebra’s website (http://imebra.com).
+*/
+
+#include "syntheticData.h"
+#include <memory>
+
+namespace imebra
+{
+
+namespace benchmarks
+{
+
+///////////////////////////////////////////////////////////
+//
+// Deterministic pseudo-random generator (xorshift32)
+//
+///////////////////////////////////////////////////////////
+class noiseGenerator
+{
+public:
+    noiseGenerator(): m_state(0x2545f491u)
+    {
+    }
+
+    std::uint32_t next()
+    {
+        m_state ^= m_state << 13;
+        m_state ^= m_state >> 17;
+        m_state ^= m_state << 5;
+        return m_state;
+    }
+
+private:
+    std::uint32_t m_state;
+};
+
+
+template<typename dataType_t>
+static void fillImage(dataType_t* pData, std::uint32_t width, std::uint32_t height, std::uint32_t channels, std::uint32_t highBit, bool bSigned)
+{
+    const std::int64_t maxValue(((std::int64_t)1 << (highBit + 1)) - 1);
+    const std::int64_t offset(bSigned ? ((std::int64_t)1 << highBit) : 0);
+    const std::int64_t noiseMask(maxValue >> 5);
+
+    noiseGenerator noise;
+
+    for(std::uint32_t y(0); y != height; ++y)
+    {
+        for(std::uint32_t x(0); x != width; ++x)
+        {
+            for(std::uint32_t channel(0); channel != channels; ++channel)
+            {
+                // A different gradient on each channel
+                ///////////////////////////////////////////////////////////
+                std::int64_t value;
+                switch(channel)
+                {
+                case 0:
+                    value = ((std::int64_t)x * maxValue / width + (std::int64_t)y * maxValue / height) / 2;
+                    break;
+                case 1:
+                    value = (std::int64_t)x * maxValue / width;
+                    break;
+                default:
+                    value = (std::int64_t)y * maxValue / height;
+                    break;
+                }
+                value += (std::int64_t)(noise.next() & 0xffffu) & noiseMask;
+                if(value > maxValue)
+                {
+                    value = maxValue;
+                }
+                *(pData++) = (dataType_t)(value - offset);
+            }
+        }
+    }
+}
+
+
+Image* buildSyntheticImage(std::uint32_t width, std::uint32_t height, bitDepth_t depth, std::uint32_t highBit, const std::string& colorSpace)
+{
+    std::unique_ptr<Image> image(new Image(width, height, depth, colorSpace, highBit));
+
+    {
+        std::unique_ptr<WritingDataHandlerNumeric> handler(image->getWritingDataHandler());
+        size_t dataSize;
+        char* pData(handler->data(&dataSize));
+        const std::uint32_t channels(image->getChannelsNumber());
+
+        switch(depth)
+        {
+        case bitDepth_t::depthU8:
+            fillImage((std::uint8_t*)pData, width, height, channels, highBit, false);
+            break;
+        case bitDepth_t::depthS8:
+            fillImage((std::int8_t*)pData, width, height, channels, highBit, true);
+            break;
+        case bitDepth_t::depthU16:
+            fillImage((std::uint16_t*)pData, width, height, channels, highBit, false);
+            break;
+        case bitDepth_t::depthS16:
+            fillImage((std::int16_t*)pData, width, height, channels, highBit, true);
+            break;
+        case bitDepth_t::depthU32:
+            fillImage((std::uint32_t*)pData, width, height, channels, highBit, false);
+            break;
+        case bitDepth_t::depthS32:
+            fillImage((std::int32_t*)pData, width, height, channels, highBit, true);
+            break;
+        }
+    }
+
+    return image.release();
+}
+
+
+DataSet* buildSyntheticHeader(const std::string& transferSyntax, size_t tagsNumber)
+{
+    std::unique_ptr<DataSet> dataSet(new DataSet(transferSyntax));
+
+    dataSet->setString(TagId(tagId_t::PatientName_0010_0010), "Synthetic^Patient");
+    dataSet->setString(TagId(tagId_t::PatientID_0010_0020), "BENCHMARK");
+    dataSet->setString(TagId(tagId_t::StudyDate_0008_0020), "20170101");
+    dataSet->setString(TagId(tagId_t::Modality_0008_0060), "OT");
+
+    const std::uint16_t privateGroup(0x0011);
+    for(size_t tagNumber(0); tagNumber != tagsNumber; ++tagNumber)
+    {
+        const TagId tagId(privateGroup, (std::uint16_t)(0x1000u + tagNumber));
+        switch(tagNumber % 6)
+        {
+        case 0:
+            dataSet->setString(tagId, "Value " + std::to_string(tagNumber), tagVR_t::LO);
+            break;
+        case 1:
+            dataSet->setDouble(tagId, (double)tagNumber * 0.25, tagVR_t::DS);
+            break;
+        case 2:
+            dataSet->setSignedLong(tagId, (std::int32_t)tagNumber, tagVR_t::IS);
+            break;
+        case 3:
+            dataSet->setUnsignedLong(tagId, (std::uint32_t)tagNumber, tagVR_t::US);
+            break;
+        case 4:
+            dataSet->setUnsignedLong(tagId, (std::uint32_t)tagNumber * 1000u, tagVR_t::UL);
+            break;
+        default:
+            dataSet->setString(tagId, "20170101", tagVR_t::DA);
+            break;
+        }
+
+        // Add a sequence every 50 tags
+        ///////////////////////////////////////////////////////////
+        if(tagNumber % 50 == 0)
+        {
+            DataSet item;
+            item.setString(TagId(tagId_t::CodeValue_0008_0100), "CODE" + std::to_string(tagNumber));
+            item.setString(TagId(tagId_t::CodingSchemeDesignator_0008_0102), "DCM");
+            item.setString(TagId(tagId_t::CodeMeaning_0008_0104), "Synthetic code");
+            dataSet->setSequenceItem(TagId(privateGroup, (std::uint16_t)(0x3000u + tagNumber / 50u)), 0, item);
+        }
+    }
+
+    return dataSet.release();
+}
+
+
+ReadWriteMemory* saveToMemory(const DataSet& dataSet)
+{
+    std::unique_ptr<ReadWriteMemory> memory(new ReadWriteMemory());
+    {
+        MemoryStreamOutput stream(*memory);
+        StreamWriter writer(stream);
+        CodecFactory::save(dataSet, writer, codecType_t::dicom);
+    }
+    return memory.release();
+}
+
+
+DataSet* loadFromMemory(const ReadWriteMemory& memory)
+{
+    MemoryStreamInput stream(memory);
+    StreamReader reader(stream);
+    return CodecFactory::load(reader);
+}
+
+} // namespace benchmarks
+
+} // namespace imebra
@@ -0,0 +1,59 @@
+/*
+Copyright 2005 - 2017 by Paolo Brandoli/Binarno s.p.
+
+Imebra is available for free under the GNU General Public License.
+
+The full text of the license is available in the file license.rst
+ in the project root folder.
+
+If you do not want to be bound by the GPL terms (such as the requirement
+ that your application must also be GPL), you may purchase a commercial
+ license for Imebra from the Imebra’s website (http://imebra.com).
+*/
+
+#if !defined(imebraSyntheticData_2F8A6D34_91B7_4C0E_B5D2_7E13C94A0F68__INCLUDED_)
+#define imebraSyntheticData_2F8A6D34_91B7_4C0E_B5D2_7E13C94A0F68__INCLUDED_
+
+#include <imebra/imebra.h>
+#include <string>
+#include <cstdint>
+
+namespace imebra
+{
+
+namespace benchmarks
+{
+
+///
+/// \brief Build an image containing smooth gradients and a little noise.
+///
+/// The content depends only on the parameters, so all the runs of the
+/// benchmarks process the same data.
+///
+///////////////////////////////////////////////////////////////////////////////
+Image* buildSyntheticImage(std::uint32_t width, std::uint32_t height, bitDepth_t depth, std::uint32_t highBit, const std::string& colorSpace);
+
+///
+/// \brief Build a dataset with a header made of tagsNumber tags of various
+///        types, including sequences.
+///
+///////////////////////////////////////////////////////////////////////////////
+DataSet* buildSyntheticHeader(const std::string& transferSyntax, size_t tagsNumber);
+
+///
+/// \brief Save a dataset into a memory region.
+///
+///////////////////////////////////////////////////////////////////////////////
+ReadWriteMemory* saveToMemory(const DataSet& dataSet);
+
+///
+/// \brief Load a dataset from a memory region.
+///
+///////////////////////////////////////////////////////////////////////////////
+DataSet* loadFromMemory(const ReadWriteMemory& memory);
+
+} // namespace benchmarks
+
+} // namespace imebra
+
+#endif // !defined(imebraSyntheticData_2F8A6D34_91B7_4C0E_B5D2_7E13C94A0F68__INCLUDED_)
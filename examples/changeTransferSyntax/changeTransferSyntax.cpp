@@ -189,20 +189,18 @@ int main(int argc, char* argv[])
 		// Now we create a new dataset and copy the tags and images from the loaded dataset
         DataSet newDataSet(transferSyntax);
 
-		// Copy the images first
+		// Copy the images first. The frames are decoded and encoded
+		//  concurrently
 		try
 		{
-            for(size_t scanImages(0);; ++scanImages)
-			{
-                std::unique_ptr<Image> copyImage(loadedDataSet->getImage(scanImages));
-                if(copyImage->getHighBit() > maxHighBit)
-                {
-                    std::cout << "WARNING: image has highBit=" << copyImage->getHighBit() <<
-                                 " but the selected transfer syntax support highBit<=" <<
-                                 maxHighBit << std::endl;
-                }
-                newDataSet.setImage(scanImages, *copyImage, imageQuality_t::high);
-			}
+            std::unique_ptr<Image> firstImage(loadedDataSet->getImage(0));
+            if(firstImage->getHighBit() > maxHighBit)
+            {
+                std::cout << "WARNING: image has highBit=" << firstImage->getHighBit() <<
+                             " but the selected transfer syntax support highBit<=" <<
+                             maxHighBit << std::endl;
+            }
+            newDataSet.transcodeImages(*loadedDataSet, imageQuality_t::high);
 		}
         catch(const DataSetImageDoesntExistError&)
 		{
@@ -0,0 +1,392 @@
+/*
+Copyright 2005 - 2017 by Paolo Brandoli/Binarno s.p.
+
+Imebra is available for free under the GNU General Public License.
+
+The full text of the license is available in the file license.rst
+ in the project root folder.
+
+If you do not want to be bound by the GPL terms (such as the requirement
+ that your application must also be GPL), you may purchase a commercial
+ license for Imebra from the Imebra’s website (http://imebra.com).
+*/
+
+/*! \file batchLoaderImpl.cpp
+    \brief Implementation of the class batchLoader.
+
+*/
+
+#include "batchLoaderImpl.h"
+#include "exceptionImpl.h"
+#include "codecFactoryImpl.h"
+#include "streamReaderImpl.h"
+#include "fileStreamImpl.h"
+#include "memoryStreamImpl.h"
+#include "memoryImpl.h"
+#include "dataSetImpl.h"
+#include "../include/imebra/exceptions.h"
+#include <chrono>
+#include <limits>
+
+namespace imebra
+{
+
+namespace implementation
+{
+
+///////////////////////////////////////////////////////////
+//
+// Job constructor
+//
+///////////////////////////////////////////////////////////
+batchLoader::job::job():
+    m_completedFuture(m_completed.get_future().share()),
+    m_readTime(0),
+    m_parseTime(0)
+{
+}
+
+
+///////////////////////////////////////////////////////////
+//
+// Constructor
+//
+///////////////////////////////////////////////////////////
+batchLoader::batchLoader(size_t threadsNumber, size_t prefetchFiles, size_t maxSizeBufferLoad):
+    m_maxSizeBufferLoad(maxSizeBufferLoad),
+    m_nextJobId(0),
+    m_prefetchFiles(0),
+    m_maxPrefetchFiles(prefetchFiles),
+    m_parsePool(threadsNumber),
+    m_ioPool(1)
+{
+    if(m_maxPrefetchFiles == 0)
+    {
+        m_maxPrefetchFiles = m_parsePool.getThreadsNumber() * 2;
+    }
+}
+
+
+///////////////////////////////////////////////////////////
+//
+// Destructor
+//
+///////////////////////////////////////////////////////////
+batchLoader::~batchLoader()
+{
+}
+
+
+///////////////////////////////////////////////////////////
+//
+// Queue the loading of a file
+//
+///////////////////////////////////////////////////////////
+size_t batchLoader::load(const std::wstring& fileName)
+{
+    IMEBRA_FUNCTION_START();
+
+    size_t jobId;
+    std::shared_ptr<job> pJob(createJob(&jobId));
+
+    m_ioPool.execute([this, pJob, fileName](){ readFile(pJob, fileName); });
+
+    return jobId;
+
+    IMEBRA_FUNCTION_END();
+}
+
+
+///////////////////////////////////////////////////////////
+//
+// Queue the loading of a file (the name is converted as
+//  in fileStreamInput)
+//
+///////////////////////////////////////////////////////////
+size_t batchLoader::load(const std::string& fileName)
+{
+    IMEBRA_FUNCTION_START();
+
+    std::wstring wFileName;
+    size_t fileNameSize(fileName.size());
+    wFileName.resize(fileNameSize);
+    for(size_t copyChars = 0; copyChars != fileNameSize; ++copyChars)
+    {
+        wFileName[copyChars] = (wchar_t)fileName[copyChars];
+    }
+
+    return load(wFileName);
+
+    IMEBRA_FUNCTION_END();
+}
+
+
+///////////////////////////////////////////////////////////
+//
+// Queue the loading of a stream
+//
+///////////////////////////////////////////////////////////
+size_t batchLoader::load(std::shared_ptr<baseStreamInput> pStream)
+{
+    IMEBRA_FUNCTION_START();
+
+    size_t jobId;
+    std::shared_ptr<job> pJob(createJob(&jobId));
+
+    m_parsePool.execute([this, pJob, pStream](){ parseStream(pJob, pStream, false); });
+
+    return jobId;
+
+    IMEBRA_FUNCTION_END();
+}
+
+
+///////////////////////////////////////////////////////////
+//
+// Check if a job has been completed
+//
+///////////////////////////////////////////////////////////
+bool batchLoader::isReady(size_t jobId)
+{
+    IMEBRA_FUNCTION_START();
+
+    std::shared_ptr<job> pJob;
+    {
+        std::lock_guard<std::mutex> lock(m_jobsMutex);
+        std::map<size_t, std::shared_ptr<job> >::const_iterator findJob(m_jobs.find(jobId));
+        if(findJob == m_jobs.end())
+        {
+            IMEBRA_THROW(BatchLoaderUnknownJobError, "The job " << jobId << " does not exist");
+        }
+        pJob = findJob->second;
+    }
+
+    return pJob->m_completedFuture.wait_for(std::chrono::seconds(0)) == std::future_status::ready;
+
+    IMEBRA_FUNCTION_END();
+}
+
+
+///////////////////////////////////////////////////////////
+//
+// Return the loaded dataSet
+//
+///////////////////////////////////////////////////////////
+std::shared_ptr<dataSet> batchLoader::getDataSet(size_t jobId)
+{
+    IMEBRA_FUNCTION_START();
+
+    std::shared_ptr<job> pJob(getCompletedJob(jobId));
+
+    // Remove the job, so the loader doesn't grow while it
+    //  loads new files. Only the first caller finds the job
+    ///////////////////////////////////////////////////////////
+    {
+        std::lock_guard<std::mutex> lock(m_jobsMutex);
+        if(m_jobs.erase(jobId) == 0)
+        {
+            IMEBRA_THROW(BatchLoaderUnknownJobError, "The dataset for the job " << jobId << " has already been retrieved");
+        }
+    }
+
+    // Rethrow the job's exception, if any
+    ///////////////////////////////////////////////////////////
+    pJob->m_completedFuture.get();
+
+    return pJob->m_pDataSet;
+
+    IMEBRA_FUNCTION_END();
+}
+
+
+///////////////////////////////////////////////////////////
+//
+// Return the time spent reading the file
+//
+///////////////////////////////////////////////////////////
+std::uint64_t batchLoader::getReadTime(size_t jobId)
+{
+    IMEBRA_FUNCTION_START();
+
+    return getCompletedJob(jobId)->m_readTime;
+
+    IMEBRA_FUNCTION_END();
+}
+
+
+///////////////////////////////////////////////////////////
+//
+// Return the time spent parsing the stream
+//
+///////////////////////////////////////////////////////////
+std::uint64_t batchLoader::getParseTime(size_t jobId)
+{
+    IMEBRA_FUNCTION_START();
+
+    return getCompletedJob(jobId)->m_parseTime;
+
+    IMEBRA_FUNCTION_END();
+}
+
+
+///////////////////////////////////////////////////////////
+//
+// Allocate a new job
+//
+///////////////////////////////////////////////////////////
+std::shared_ptr<batchLoader::job> batchLoader::createJob(size_t* pJobId)
+{
+    IMEBRA_FUNCTION_START();
+
+    std::shared_ptr<job> pJob(std::make_shared<job>());
+
+    std::lock_guard<std::mutex> lock(m_jobsMutex);
+    *pJobId = m_nextJobId++;
+    m_jobs[*pJobId] = pJob;
+
+    return pJob;
+
+    IMEBRA_FUNCTION_END();
+}
+
+
+///////////////////////////////////////////////////////////
+//
+// Wait for a job to complete and return it
+//
+///////////////////////////////////////////////////////////
+std::shared_ptr<batchLoader::job> batchLoader::getCompletedJob(size_t jobId)
+{
+    IMEBRA_FUNCTION_START();
+
+    std::shared_ptr<job> pJob;
+    {
+        std::lock_guard<std::mutex> lock(m_jobsMutex);
+        std::map<size_t, std::shared_ptr<job> >::const_iterator findJob(m_jobs.find(jobId));
+        if(findJob == m_jobs.end())
+        {
+            IMEBRA_THROW(BatchLoaderUnknownJobError, "The job " << jobId << " does not exist");
+        }
+        pJob = findJob->second;
+    }
+
+    pJob->m_completedFuture.wait();
+
+    return pJob;
+
+    IMEBRA_FUNCTION_END();
+}
+
+
+///////////////////////////////////////////////////////////
+//
+// Read a file into memory, then queue it for parsing.
+// Executed by the I/O thread.
+//
+///////////////////////////////////////////////////////////
+void batchLoader::readFile(std::shared_ptr<job> pJob, const std::wstring& fileName)
+{
+    // Wait until the parsing threads consume the prefetched
+    //  files
+    ///////////////////////////////////////////////////////////
+    {
+        std::unique_lock<std::mutex> lock(m_prefetchMutex);
+        m_prefetchSlotFree.wait(lock, [this](){ return m_prefetchFiles < m_maxPrefetchFiles; });
+        ++m_prefetchFiles;
+    }
+
+    try
+    {
+        std::chrono::steady_clock::time_point startTime(std::chrono::steady_clock::now());
+
+        std::shared_ptr<memory> pMemory(std::make_shared<memory>());
+
+        {
+            fileStreamInput file(fileName);
+
+            // Size the buffer once, then fill it
+            ///////////////////////////////////////////////////////////
+            const size_t fileSize(file.getSize());
+            pMemory->resize(fileSize);
+            size_t readSize(0);
+            while(readSize != fileSize)
+            {
+                const size_t readBytes(file.read(readSize, pMemory->data() + readSize, fileSize - readSize));
+                if(readBytes == 0)
+                {
+                    break;
+                }
+                readSize += readBytes;
+            }
+            pMemory->resize(readSize);
+        }
+
+        pJob->m_readTime = (std::uint64_t)std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - startTime).count();
+
+        std::shared_ptr<baseStreamInput> pStream(std::make_shared<memoryStreamInput>(pMemory));
+        m_parsePool.execute([this, pJob, pStream](){ parseStream(pJob, pStream, true); });
+    }
+    catch(...)
+    {
+        {
+            std::lock_guard<std::mutex> lock(m_prefetchMutex);
+            --m_prefetchFiles;
+        }
+        m_prefetchSlotFree.notify_one();
+
+        pJob->m_completed.set_exception(std::current_exception());
+    }
+}
+
+
+///////////////////////////////////////////////////////////
+//
+// Parse a stream. Executed by the parsing threads.
+//
+///////////////////////////////////////////////////////////
+void batchLoader::parseStream(std::shared_ptr<job> pJob, std::shared_ptr<baseStreamInput> pStream, bool bPrefetched)
+{
+    std::exception_ptr pException;
+
+    try
+    {
+        std::chrono::steady_clock::time_point startTime(std::chrono::steady_clock::now());
+
+        std::shared_ptr<streamReader> pReader(std::make_shared<streamReader>(pStream));
+        // The tags' lengths fit in 32 bits: larger limits load
+        //  all the tags
+        ///////////////////////////////////////////////////////////
+        const std::uint32_t maxSizeBufferLoad(m_maxSizeBufferLoad > std::numeric_limits<std::uint32_t>::max() ?
+                                                  std::numeric_limits<std::uint32_t>::max() :
+                                                  (std::uint32_t)m_maxSizeBufferLoad);
+        pJob->m_pDataSet = codecs::codecFactory::getCodecFactory()->load(pReader, maxSizeBufferLoad);
+
+        pJob->m_parseTime = (std::uint64_t)std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - startTime).count();
+    }
+    catch(...)
+    {
+        pException = std::current_exception();
+    }
+
+    if(bPrefetched)
+    {
+        {
+            std::lock_guard<std::mutex> lock(m_prefetchMutex);
+            --m_prefetchFiles;
+        }
+        m_prefetchSlotFree.notify_one();
+    }
+
+    if(pException)
+    {
+        pJob->m_completed.set_exception(pException);
+    }
+    else
+    {
+        pJob->m_completed.set_value();
+    }
+}
+
+} // namespace implementation
+
+} // namespace imebra
@@ -0,0 +1,175 @@
+/*
+Copyright 2005 - 2017 by Paolo Brandoli/Binarno s.p.
+
+Imebra is available for free under the GNU General Public License.
+
+The full text of the license is available in the file license.rst
+ in the project root folder.
+
+If you do not want to be bound by the GPL terms (such as the requirement
+ that your application must also be GPL), you may purchase a commercial
+ license for Imebra from the Imebra’s website (http://imebra.com).
+*/
+
+/*! \file batchLoaderImpl.h
+    \brief Declaration of the class batchLoader.
+
+*/
+
+#if !defined(imebraBatchLoader_9D4E2B71_3C6A_4E8F_A15B_7F02C4D8E936__INCLUDED_)
+#define imebraBatchLoader_9D4E2B71_3C6A_4E8F_A15B_7F02C4D8E936__INCLUDED_
+
+#include <memory>
+#include <map>
+#include <string>
+#include <future>
+#include <mutex>
+#include <condition_variable>
+#include <cstdint>
+#include "threadPoolImpl.h"
+
+namespace imebra
+{
+
+namespace implementation
+{
+
+class dataSet;
+class baseStreamInput;
+class memory;
+
+///////////////////////////////////////////////////////////
+///////////////////////////////////////////////////////////
+/// \brief Loads several DICOM streams concurrently.
+///
+/// The files are read into memory by a dedicated I/O
+///  thread which stays at most prefetchFiles files ahead
+///  of the parsing threads; the parsing is executed by a
+///  pool of worker threads.
+///
+/// Streams supplied by the client are not prefetched:
+///  they are parsed directly by the worker threads.
+///
+///////////////////////////////////////////////////////////
+///////////////////////////////////////////////////////////
+class batchLoader
+{
+public:
+    /// \brief Constructor.
+    ///
+    /// @param threadsNumber     the number of parsing
+    ///                           threads. 0 means one thread
+    ///                           per hardware thread
+    /// @param prefetchFiles     the maximum number of files
+    ///                           read in memory and waiting
+    ///                           to be parsed. 0 means twice
+    ///                           the number of threads
+    /// @param maxSizeBufferLoad tags larger than this value
+    ///                           are loaded on demand
+    ///
+    ///////////////////////////////////////////////////////////
+    batchLoader(size_t threadsNumber, size_t prefetchFiles, size_t maxSizeBufferLoad);
+
+    /// \brief Destructor. Waits for all the pending jobs.
+    ///
+    ///////////////////////////////////////////////////////////
+    ~batchLoader();
+
+    /// \brief Queue the loading of a file.
+    ///
+    /// @param fileName the name of the file to load
+    /// @return the job's id
+    ///
+    ///////////////////////////////////////////////////////////
+    size_t load(const std::wstring& fileName);
+
+    /// \brief Queue the loading of a file.
+    ///
+    /// @param fileName the name of the file to load
+    /// @return the job's id
+    ///
+    ///////////////////////////////////////////////////////////
+    size_t load(const std::string& fileName);
+
+    /// \brief Queue the loading of a stream.
+    ///
+    /// @param pStream the stream to load
+    /// @return the job's id
+    ///
+    ///////////////////////////////////////////////////////////
+    size_t load(std::shared_ptr<baseStreamInput> pStream);
+
+    /// \brief Returns true if the job has been completed.
+    ///
+    ///////////////////////////////////////////////////////////
+    bool isReady(size_t jobId);
+
+    /// \brief Wait for the job completion and return the
+    ///         loaded dataSet.
+    ///
+    /// The job is removed from the loader: the dataSet of
+    ///  each job can be retrieved only once, and the other
+    ///  functions don't recognize the job anymore.
+    /// If the job failed then its exception is rethrown.
+    ///
+    ///////////////////////////////////////////////////////////
+    std::shared_ptr<dataSet> getDataSet(size_t jobId);
+
+    /// \brief Wait for the job completion and return the
+    ///         time spent reading the file, in microseconds.
+    ///
+    /// Returns 0 for the jobs that load a client's stream.
+    ///
+    ///////////////////////////////////////////////////////////
+    std::uint64_t getReadTime(size_t jobId);
+
+    /// \brief Wait for the job completion and return the
+    ///         time spent parsing the stream, in
+    ///         microseconds.
+    ///
+    ///////////////////////////////////////////////////////////
+    std::uint64_t getParseTime(size_t jobId);
+
+private:
+    struct job
+    {
+        job();
+
+        std::promise<void> m_completed;
+        std::shared_future<void> m_completedFuture;
+        std::shared_ptr<dataSet> m_pDataSet;
+        std::uint64_t m_readTime;
+        std::uint64_t m_parseTime;
+    };
+
+    std::shared_ptr<job> createJob(size_t* pJobId);
+
+    std::shared_ptr<job> getCompletedJob(size_t jobId);
+
+    void readFile(std::shared_ptr<job> pJob, const std::wstring& fileName);
+
+    void parseStream(std::shared_ptr<job> pJob, std::shared_ptr<baseStreamInput> pStream, bool bPrefetched);
+
+    const size_t m_maxSizeBufferLoad;
+
+    std::mutex m_jobsMutex;
+    std::map<size_t, std::shared_ptr<job> > m_jobs;
+    size_t m_nextJobId;
+
+    std::mutex m_prefetchMutex;
+    std::condition_variable m_prefetchSlotFree;
+    size_t m_prefetchFiles;
+    size_t m_maxPrefetchFiles;
+
+    // The I/O pool must be destroyed before the parsing
+    //  pool, because its tasks queue new parsing tasks
+    ///////////////////////////////////////////////////////////
+    threadPool m_parsePool;
+    threadPool m_ioPool;
+};
+
+} // namespace implementation
+
+} // namespace imebra
+
+#endif // !defined(imebraBatchLoader_9D4E2B71_3C6A_4E8F_A15B_7F02C4D8E936__INCLUDED_)
@@ -44,6 +44,7 @@ If you do not want to be bound by the GPL terms (such as the requirement
 #include "../include/imebra/exceptions.h"
 
 #include <vector>
+#include <algorithm>
 #include <string.h>
 
 
@@ -77,6 +78,9 @@ namespace implementation
 ///////////////////////////////////////////////////////////
 ///////////////////////////////////////////////////////////
 buffer::buffer():
+    m_bFrozen(false),
+    m_readingHandlerVR(tagVR_t::OB),
+    m_version(0),
     m_originalBufferPosition(0),
     m_originalBufferLength(0),
     m_originalWordLength(1),
@@ -100,6 +104,9 @@ buffer::buffer(
         size_t bufferLength,
         size_t wordLength,
 		streamController::tByteOrdering endianType):
+        m_bFrozen(false),
+        m_readingHandlerVR(tagVR_t::OB),
+        m_version(0),
 		m_originalStream(originalStream),
 		m_originalBufferPosition(bufferPosition),
 		m_originalBufferLength(bufferLength),
@@ -122,14 +129,7 @@ std::shared_ptr<const memory> buffer::getLocalMemory() const
         if(m_originalBufferLength != 0)
         {
             std::shared_ptr<streamReader> reader(std::make_shared<streamReader>(m_originalStream, m_originalBufferPosition, m_originalBufferLength));
-            std::vector<std::uint8_t> localBuffer;
-            localBuffer.resize(m_originalBufferLength);
-            reader->read(&localBuffer[0], m_originalBufferLength);
-            if(m_originalWordLength != 0)
-            {
-                reader->adjustEndian(&localBuffer[0], m_originalWordLength, m_originalEndianType, m_originalBufferLength/m_originalWordLength);
-            }
-            localMemory->assign(&localBuffer[0], m_originalBufferLength);
+            reader->read(localMemory->data(), m_originalBufferLength, m_originalWordLength, m_originalEndianType);
         }
         return localMemory;
     }
@@ -204,26 +204,63 @@ std::shared_ptr<handlers::readingDataHandler> buffer::getReadingDataHandler(tagV
 {
     IMEBRA_FUNCTION_START();
 
-    std::lock_guard<std::mutex> lock(m_mutex);
+    std::unique_lock<std::mutex> lock(lockUnlessFrozen(m_mutex, m_bFrozen));
+
+    // Reuse the handler built by the previous call: reading
+    //  handlers don't change after they have been created
+    ///////////////////////////////////////////////////////////
+    if(m_pReadingHandler != 0 && m_readingHandlerVR == tagVR)
+    {
+        return m_pReadingHandler;
+    }
+
+    std::shared_ptr<handlers::readingDataHandler> handler(createReadingDataHandler(tagVR, getLocalMemory()));
+
+    // Frozen buffers are read without locking, so only freeze()
+    //  sets their handler. Buffers that are loaded lazily are
+    //  not kept in memory.
+    ///////////////////////////////////////////////////////////
+    if(lock.owns_lock() && m_originalStream == 0)
+    {
+        m_pReadingHandler = handler;
+        m_readingHandlerVR = tagVR;
+    }
+
+    return handler;
+
+    IMEBRA_FUNCTION_END();
+}
+
 
-    std::shared_ptr<const memory> localMemory(getLocalMemory());
+///////////////////////////////////////////////////////////
+///////////////////////////////////////////////////////////
+//
+//
+// Build a new reading handler for the specified memory
+//
+//
+///////////////////////////////////////////////////////////
+///////////////////////////////////////////////////////////
+std::shared_ptr<handlers::readingDataHandler> buffer::createReadingDataHandler(tagVR_t tagVR, const std::shared_ptr<const memory>& localMemory) const
+{
+    IMEBRA_FUNCTION_START();
 
     switch(tagVR)
     {
     case tagVR_t::AE:
-        return std::make_shared<handlers::readingDataHandlerStringAE>(*localMemory);
+        return std::make_shared<handlers::readingDataHandlerStringAE>(localMemory);
 
     case tagVR_t::AS:
-        return std::make_shared<handlers::readingDataHandlerStringAS>(*localMemory);
+        return std::make_shared<handlers::readingDataHandlerStringAS>(localMemory);
 
     case tagVR_t::CS:
-        return std::make_shared<handlers::readingDataHandlerStringCS>(*localMemory);
+        return std::make_shared<handlers::readingDataHandlerStringCS>(localMemory);
 
     case tagVR_t::DS:
-        return std::make_shared<handlers::readingDataHandlerStringDS>(*localMemory);
+        return std::make_shared<handlers::readingDataHandlerStringDS>(localMemory);
 
     case tagVR_t::IS:
-        return std::make_shared<handlers::readingDataHandlerStringIS>(*localMemory);
+        return std::make_shared<handlers::readingDataHandlerStringIS>(localMemory);
 
     case tagVR_t::LO:
         return std::make_shared<handlers::readingDataHandlerStringLO>(*localMemory, m_charsetsList);
@@ -244,10 +281,10 @@ std::shared_ptr<handlers::readingDataHandler> buffer::getReadingDataHandler(tagV
         return std::make_shared<handlers::readingDataHandlerStringUC>(*localMemory, m_charsetsList);
 
     case tagVR_t::UI:
-        return std::make_shared<handlers::readingDataHandlerStringUI>(*localMemory);
+        return std::make_shared<handlers::readingDataHandlerStringUI>(localMemory);
 
     case tagVR_t::UR:
-        return std::make_shared<handlers::readingDataHandlerStringUR>(*localMemory);
+        return std::make_shared<handlers::readingDataHandlerStringUR>(localMemory);
 
     case tagVR_t::UT:
         return std::make_shared< handlers::readingDataHandlerStringUT>(*localMemory, m_charsetsList);
@@ -258,6 +295,9 @@ std::shared_ptr<handlers::readingDataHandler> buffer::getReadingDataHandler(tagV
     case tagVR_t::OL:
         return std::make_shared<handlers::readingDataHandlerNumeric<std::int32_t> >(localMemory, tagVR);
 
+    case tagVR_t::OV:
+        return std::make_shared<handlers::readingDataHandlerNumeric<std::uint64_t> >(localMemory, tagVR);
+
     case tagVR_t::SB:
         return std::make_shared<handlers::readingDataHandlerNumeric<std::int8_t> >(localMemory, tagVR);
 
@@ -295,13 +335,13 @@ std::shared_ptr<handlers::readingDataHandler> buffer::getReadingDataHandler(tagV
         return std::make_shared<handlers::readingDataHandlerNumeric<std::uint16_t> >(localMemory, tagVR);
 
     case tagVR_t::DA:
-        return std::make_shared<handlers::readingDataHandlerDate>(*localMemory);
+        return std::make_shared<handlers::readingDataHandlerDate>(localMemory);
 
     case tagVR_t::DT:
-        return std::make_shared<handlers::readingDataHandlerDateTime>(*localMemory);
+        return std::make_shared<handlers::readingDataHandlerDateTime>(localMemory);
 
     case tagVR_t::TM:
-        return std::make_shared<handlers::readingDataHandlerTime>(*localMemory);
+        return std::make_shared<handlers::readingDataHandlerTime>(localMemory);
 
     case tagVR_t::SQ:
         IMEBRA_THROW(std::logic_error, "Cannot retrieve a SQ data handler");
@@ -319,6 +359,11 @@ std::shared_ptr<handlers::writingDataHandler> buffer::getWritingDataHandler(tagV
 
     std::lock_guard<std::mutex> lock(m_mutex);
 
+    if(m_bFrozen)
+    {
+        IMEBRA_THROW(DataSetFrozenError, "The buffer belongs to a frozen dataset and cannot be modified");
+    }
+
     // Reset the pointer to the data handler
     ///////////////////////////////////////////////////////////
     std::shared_ptr<handlers::writingDataHandler> handler;
@@ -373,6 +418,9 @@ std::shared_ptr<handlers::writingDataHandler> buffer::getWritingDataHandler(tagV
     case tagVR_t::OL:
         return std::make_shared<handlers::writingDataHandlerNumeric<std::int32_t> >(shared_from_this(), size, tagVR);
 
+    case tagVR_t::OV:
+        return std::make_shared<handlers::writingDataHandlerNumeric<std::uint64_t> >(shared_from_this(), size, tagVR);
+
     case tagVR_t::SB:
         return std::make_shared<handlers::writingDataHandlerNumeric<std::int8_t> >(shared_from_this(), size, tagVR);
 
@@ -442,7 +490,7 @@ std::shared_ptr<streamReader> buffer::getStreamReader()
 {
     IMEBRA_FUNCTION_START();
 
-    std::lock_guard<std::mutex> lock(m_mutex);
+    std::unique_lock<std::mutex> lock(lockUnlessFrozen(m_mutex, m_bFrozen));
 
 	// If the object must be loaded from the original stream,
 	//  then return the original stream
@@ -499,7 +547,7 @@ std::shared_ptr<handlers::readingDataHandlerRaw> buffer::getReadingDataHandlerRa
 {
     IMEBRA_FUNCTION_START();
 
-    std::lock_guard<std::mutex> lock(m_mutex);
+    std::unique_lock<std::mutex> lock(lockUnlessFrozen(m_mutex, m_bFrozen));
 
     return std::make_shared<handlers::readingDataHandlerRaw>(getLocalMemory(), tagVR);
 
@@ -513,6 +561,11 @@ std::shared_ptr<handlers::writingDataHandlerRaw> buffer::getWritingDataHandlerRa
 
     std::lock_guard<std::mutex> lock(m_mutex);
 
+    if(m_bFrozen)
+    {
+        IMEBRA_THROW(DataSetFrozenError, "The buffer belongs to a frozen dataset and cannot be modified");
+    }
+
     return std::make_shared<handlers::writingDataHandlerRaw>(shared_from_this(), size, tagVR);
 
     IMEBRA_FUNCTION_END();
@@ -566,7 +619,23 @@ void buffer::appendMemory(std::shared_ptr<const memory> pMemory)
 
     std::lock_guard<std::mutex> lock(m_mutex);
 
+    if(m_bFrozen)
+    {
+        IMEBRA_THROW(DataSetFrozenError, "The buffer belongs to a frozen dataset and cannot be modified");
+    }
+
+    // Load the original content before appending to it
+    ///////////////////////////////////////////////////////////
+    if(m_originalStream != 0)
+    {
+        std::shared_ptr<const memory> originalMemory(getLocalMemory());
+        m_memory.clear();
+        m_memory.push_back(originalMemory);
+        m_originalStream.reset();
+    }
+
     m_memory.push_back(pMemory);
+    invalidateReadingHandler();
 
     IMEBRA_FUNCTION_END();
 }
@@ -583,7 +652,7 @@ size_t buffer::getBufferSizeBytes() const
 {
     IMEBRA_FUNCTION_START();
 
-    std::lock_guard<std::mutex> lock(m_mutex);
+    std::unique_lock<std::mutex> lock(lockUnlessFrozen(m_mutex, m_bFrozen));
 
     // The buffer has not been loaded yet
 	///////////////////////////////////////////////////////////
@@ -622,10 +691,19 @@ void buffer::commit(std::shared_ptr<memory> newMemory, const charsetsList::tChar
 
     std::lock_guard<std::mutex> lock(m_mutex);
 
+    // Writing handlers created before the buffer was frozen
+    //  cannot change it anymore
+    ///////////////////////////////////////////////////////////
+    if(m_bFrozen)
+    {
+        return;
+    }
+
     m_memory.clear();
     m_memory.push_back(newMemory);
     m_originalStream.reset();
     m_charsetsList = newCharsetsList;
+    invalidateReadingHandler();
 
 	IMEBRA_FUNCTION_END();
 }
@@ -644,14 +722,140 @@ void buffer::commit(std::shared_ptr<memory> newMemory)
 
     std::lock_guard<std::mutex> lock(m_mutex);
 
+    // Writing handlers created before the buffer was frozen
+    //  cannot change it anymore
+    ///////////////////////////////////////////////////////////
+    if(m_bFrozen)
+    {
+        return;
+    }
+
     m_memory.clear();
     m_memory.push_back(newMemory);
     m_originalStream.reset();
+    invalidateReadingHandler();
 
     IMEBRA_FUNCTION_END();
 }
 
 
+///////////////////////////////////////////////////////////
+///////////////////////////////////////////////////////////
+//
+//
+// Freeze the buffer
+//
+//
+///////////////////////////////////////////////////////////
+///////////////////////////////////////////////////////////
+void buffer::freeze(tagVR_t tagVR)
+{
+    IMEBRA_FUNCTION_START();
+
+    std::lock_guard<std::mutex> lock(m_mutex);
+
+    // Join the memory blocks now, so the lock-free reads
+    //  don't have to modify the memory list, and build the
+    //  handler that the lock-free reads will share
+    ///////////////////////////////////////////////////////////
+    if(m_originalStream == 0)
+    {
+        std::shared_ptr<const memory> localMemory(joinMemory());
+
+        if(tagVR != tagVR_t::SQ && (m_pReadingHandler == 0 || m_readingHandlerVR != tagVR))
+        {
+            try
+            {
+                m_pReadingHandler = createReadingDataHandler(tagVR, localMemory);
+                m_readingHandlerVR = tagVR;
+            }
+            catch(const std::exception&)
+            {
+                // The readers will build the handler and report
+                //  the error
+                ///////////////////////////////////////////////////////////
+            }
+        }
+    }
+
+    m_bFrozen.store(true, std::memory_order_release);
+
+    IMEBRA_FUNCTION_END();
+}
+
+
+bool buffer::isFrozen() const
+{
+    return m_bFrozen.load(std::memory_order_acquire);
+}
+
+
+std::uint64_t buffer::getVersion() const
+{
+    return m_version.load(std::memory_order_acquire);
+}
+
+
+void buffer::setOwnerVersion(const std::shared_ptr<std::atomic<std::uint64_t> >& pOwnerVersion)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+
+    m_pOwnerVersion = pOwnerVersion;
+}
+
+
+size_t buffer::copyFirstBytes(std::uint8_t* pDestination, size_t size) const
+{
+    IMEBRA_FUNCTION_START();
+
+    std::lock_guard<std::mutex> lock(m_mutex);
+
+    // Read only the requested bytes from the original stream
+    ///////////////////////////////////////////////////////////
+    if(m_originalStream != 0)
+    {
+        size_t copySize(std::min(size, m_originalBufferLength));
+        if(m_originalWordLength > 1)
+        {
+            copySize -= copySize % m_originalWordLength;
+        }
+        if(copySize != 0)
+        {
+            std::shared_ptr<streamReader> reader(std::make_shared<streamReader>(m_originalStream, m_originalBufferPosition, copySize));
+            reader->read(pDestination, copySize, m_originalWordLength, m_originalEndianType);
+        }
+        return copySize;
+    }
+
+    size_t copiedSize(0);
+    for(std::list<std::shared_ptr<const memory> >::const_iterator scanMemory(m_memory.begin()), endMemory(m_memory.end());
+        scanMemory != endMemory && copiedSize != size;
+        ++scanMemory)
+    {
+        const size_t copySize(std::min(size - copiedSize, (*scanMemory)->size()));
+        if(copySize != 0)
+        {
+            ::memcpy(pDestination + copiedSize, (*scanMemory)->data(), copySize);
+            copiedSize += copySize;
+        }
+    }
+    return copiedSize;
+
+    IMEBRA_FUNCTION_END();
+}
+
+
+void buffer::invalidateReadingHandler()
+{
+    m_pReadingHandler.reset();
+    m_version.fetch_add(1, std::memory_order_acq_rel);
+    if(m_pOwnerVersion != 0)
+    {
+        m_pOwnerVersion->fetch_add(1, std::memory_order_acq_rel);
+    }
+}
+
+
 ///////////////////////////////////////////////////////////
 ///////////////////////////////////////////////////////////
 //
@@ -666,7 +870,14 @@ void buffer::setCharsetsList(const charsetsList::tCharsetsList& charsets)
     IMEBRA_FUNCTION_START();
 
     std::lock_guard<std::mutex> lock(m_mutex);
+
+    if(m_bFrozen)
+    {
+        IMEBRA_THROW(DataSetFrozenError, "The buffer belongs to a frozen dataset and cannot be modified");
+    }
+
     m_charsetsList = charsets;
+    invalidateReadingHandler();
 
 	IMEBRA_FUNCTION_END();
 }
@@ -685,7 +896,7 @@ void buffer::getCharsetsList(charsetsList::tCharsetsList* pCharsetsList) const
 {
     IMEBRA_FUNCTION_START();
 
-    std::lock_guard<std::mutex> lock(m_mutex);
+    std::unique_lock<std::mutex> lock(lockUnlessFrozen(m_mutex, m_bFrozen));
     pCharsetsList->insert(pCharsetsList->end(), m_charsetsList.begin(), m_charsetsList.end());
 
 	IMEBRA_FUNCTION_END();
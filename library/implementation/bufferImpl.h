@@ -25,6 +25,8 @@ If you do not want to be bound by the GPL terms (such as the requirement
 #include "../include/imebra/definitions.h"
 
 #include "charsetsListImpl.h"
+#include "frozenLockImpl.h"
+#include <atomic>
 #include <mutex>
 
 namespace imebra
@@ -300,6 +302,60 @@ public:
 
 	//@}
 
+    /// \brief Make the buffer read-only.
+    ///
+    /// After the buffer has been frozen the functions that
+    ///  modify it throw DataSetFrozenError and the reading
+    ///  functions don't lock the buffer's mutex.
+    ///
+    /// The changes committed by writing handlers created
+    ///  before the buffer was frozen are discarded.
+    ///
+    /// @param tagVR the data type of the tag that owns the
+    ///               buffer: the reading handler for this
+    ///               type is built before the buffer is frozen
+    ///               and then shared by all the readers
+    ///
+    ///////////////////////////////////////////////////////////
+    void freeze(tagVR_t tagVR);
+
+    /// \brief Returns true if the buffer has been frozen.
+    ///
+    ///////////////////////////////////////////////////////////
+    bool isFrozen() const;
+
+    /// \brief Returns a number that changes every time the
+    ///        buffer's content or charsets are modified.
+    ///
+    /// Used to validate the values cached from the buffer.
+    ///
+    ///////////////////////////////////////////////////////////
+    std::uint64_t getVersion() const;
+
+    /// \brief Set the counter incremented together with the
+    ///        buffer's version.
+    ///
+    /// The tag that owns the buffer uses the counter to
+    ///  detect the changes in any of its buffers.
+    ///
+    /// @param pOwnerVersion the owner's counter
+    ///
+    ///////////////////////////////////////////////////////////
+    void setOwnerVersion(const std::shared_ptr<std::atomic<std::uint64_t> >& pOwnerVersion);
+
+    /// \brief Copy the first bytes of the buffer.
+    ///
+    /// When the buffer is loaded lazily only the requested
+    ///  bytes are read from the original stream.
+    ///
+    /// @param pDestination the destination of the bytes
+    /// @param size         the number of bytes to copy
+    /// @return the number of copied bytes, smaller than size
+    ///          when the buffer is shorter
+    ///
+    ///////////////////////////////////////////////////////////
+    size_t copyFirstBytes(std::uint8_t* pDestination, size_t size) const;
+
 protected:
 
     /// \brief Returns a memory block containing the buffer
@@ -323,6 +379,25 @@ protected:
     ///////////////////////////////////////////////////////////
     std::shared_ptr<const memory> joinMemory() const;
 
+    /// \brief Build a new reading handler for the specified
+    ///        memory.
+    ///
+    /// @param tagVR       the handler's data type
+    /// @param localMemory the memory read by the handler
+    /// @return a new reading handler
+    ///
+    ///////////////////////////////////////////////////////////
+    std::shared_ptr<handlers::readingDataHandler> createReadingDataHandler(tagVR_t tagVR, const std::shared_ptr<const memory>& localMemory) const;
+
+    /// \brief Discard the cached reading handler and update
+    ///        the buffer's version.
+    ///
+    /// Must be called with the mutex locked every time the
+    ///  buffer's content changes.
+    ///
+    ///////////////////////////////////////////////////////////
+    void invalidateReadingHandler();
+
 	//
 	// Attributes
 	//
@@ -334,6 +409,20 @@ private:
 
     mutable std::mutex m_mutex;
 
+    std::atomic<bool> m_bFrozen;
+
+    // Reading handler returned by getReadingDataHandler(),
+    //  reused until the buffer changes
+    ///////////////////////////////////////////////////////////
+    mutable std::shared_ptr<handlers::readingDataHandler> m_pReadingHandler;
+    mutable tagVR_t m_readingHandlerVR;
+
+    std::atomic<std::uint64_t> m_version;
+
+    // Owner's counter, incremented together with m_version
+    ///////////////////////////////////////////////////////////
+    std::shared_ptr<std::atomic<std::uint64_t> > m_pOwnerVersion;
+
 protected:
 	// The following variables are used to reread the buffer
 	//  from the stream.
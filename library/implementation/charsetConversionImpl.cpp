@@ -13,6 +13,7 @@ If you do not want to be bound by the GPL terms (such as the requirement
 
 #include "charsetConversionImpl.h"
 #include "exceptionImpl.h"
+#include "threadRegistryImpl.h"
 #include "../include/imebra/exceptions.h"
 
 namespace imebra
@@ -21,6 +22,78 @@ namespace imebra
 namespace implementation
 {
 
+///////////////////////////////////////////////////////////
+//
+// Return the cache of the calling thread
+//
+///////////////////////////////////////////////////////////
+charsetConversionCache& charsetConversionCache::getThreadCache()
+{
+    IMEBRA_FUNCTION_START();
+
+    return getThreadObject<charsetConversionCache>();
+
+    IMEBRA_FUNCTION_END();
+}
+
+
+///////////////////////////////////////////////////////////
+//
+// Return a conversion object
+//
+///////////////////////////////////////////////////////////
+const charsetConversionCache::cachedConversion& charsetConversionCache::getConversion(const std::string& dicomName)
+{
+    IMEBRA_FUNCTION_START();
+
+    conversions_t::const_iterator findConversion(m_conversions.find(dicomName));
+    if(findConversion == m_conversions.end())
+    {
+        std::unique_ptr<cachedConversion> pConversion(new cachedConversion);
+        pConversion->m_bAsciiCompatible = false;
+        pConversion->m_bUtf8 = (charsetConversionBase::normalizeIsoCharset(dicomName) == "ISOIR192");
+
+        // Unsupported charsets are remembered too
+        ///////////////////////////////////////////////////////////
+        try
+        {
+            pConversion->m_pConversion.reset(new defaultCharsetConversion(dicomName));
+        }
+        catch(const CharsetConversionNoSupportedTableError&)
+        {
+        }
+
+        // Check if the ASCII chars can be converted without
+        //  calling the conversion object
+        ///////////////////////////////////////////////////////////
+        if(pConversion->m_pConversion.get() != 0)
+        {
+            std::string asciiChars;
+            std::wstring unicodeChars;
+            for(int asciiChar(0x1); asciiChar != 0x80; ++asciiChar)
+            {
+                asciiChars.push_back((char)asciiChar);
+                unicodeChars.push_back((wchar_t)asciiChar);
+            }
+            pConversion->m_bAsciiCompatible =
+                    pConversion->m_pConversion->toUnicode(asciiChars) == unicodeChars &&
+                    pConversion->m_pConversion->fromUnicode(unicodeChars) == asciiChars;
+        }
+
+        findConversion = m_conversions.insert(std::make_pair(dicomName, std::move(pConversion))).first;
+    }
+
+    if(findConversion->second->m_pConversion.get() == 0)
+    {
+        IMEBRA_THROW(CharsetConversionNoSupportedTableError, "Table " << dicomName << " not supported by the system");
+    }
+
+    return *(findConversion->second);
+
+    IMEBRA_FUNCTION_END();
+}
+
+
 std::string dicomConversion::convertFromUnicode(const std::wstring& unicodeString, charsetsList::tCharsetsList* pCharsets)
 {
     IMEBRA_FUNCTION_START();
@@ -34,7 +107,22 @@ std::string dicomConversion::convertFromUnicode(const std::wstring& unicodeStrin
 
     // Setup the conversion objects
     ///////////////////////////////////////////////////////////
-    std::unique_ptr<defaultCharsetConversion> localCharsetConversion(new defaultCharsetConversion(pCharsets->front()));
+    charsetConversionCache& conversionCache(charsetConversionCache::getThreadCache());
+    const charsetConversionCache::cachedConversion& defaultConversion(conversionCache.getConversion(pCharsets->front()));
+
+    // Fast paths that don't need the conversion object
+    ///////////////////////////////////////////////////////////
+    std::string fastString;
+    if(defaultConversion.m_bAsciiCompatible && asciiFromUnicode(unicodeString, &fastString))
+    {
+        return fastString;
+    }
+    if(defaultConversion.m_bUtf8 && utf8FromUnicode(unicodeString, &fastString))
+    {
+        return fastString;
+    }
+
+    const defaultCharsetConversion* localCharsetConversion(defaultConversion.m_pConversion.get());
 
     // Get the escape sequences from the unicode conversion
     //  engine
@@ -94,14 +182,14 @@ std::string dicomConversion::convertFromUnicode(const std::wstring& unicodeStrin
         {
             try
             {
-                std::unique_ptr<defaultCharsetConversion> testEscapeSequence(new defaultCharsetConversion(scanEscapes->second));
+                const defaultCharsetConversion* testEscapeSequence(conversionCache.getConversion(scanEscapes->second).m_pConversion.get());
                 std::string convertedChar(testEscapeSequence->fromUnicode(code));
                 if(!convertedChar.empty())
                 {
                     rawString += scanEscapes->first;
                     rawString += convertedChar;
 
-                    localCharsetConversion.reset(testEscapeSequence.release());
+                    localCharsetConversion = testEscapeSequence;
 
                     // Add the dicom charset to the charsets
                     ///////////////////////////////////////////////////////////
@@ -138,23 +226,31 @@ std::wstring dicomConversion::convertToUnicode(const std::string& value, const c
 {
     IMEBRA_FUNCTION_START();
 
-    // Should we take care of the escape sequences...?
+    // Initialize the conversion engine with the default
+    //  charset
+    ///////////////////////////////////////////////////////////
+    charsetConversionCache& conversionCache(charsetConversionCache::getThreadCache());
+    const charsetConversionCache::cachedConversion& defaultConversion(conversionCache.getConversion(charsets.empty() ? std::string("ISO_IR 6") : charsets.front()));
+
+    // Fast paths that don't need the conversion object.
+    // ASCII strings don't contain escape sequences
     ///////////////////////////////////////////////////////////
-    if(charsets.empty())
+    std::wstring fastString;
+    if(defaultConversion.m_bAsciiCompatible && asciiToUnicode(value, &fastString))
     {
-        std::unique_ptr<defaultCharsetConversion> localCharsetConversion(new defaultCharsetConversion("ISO_IR 6"));
-        return localCharsetConversion->toUnicode(value);
+        return fastString;
+    }
+    if(defaultConversion.m_bUtf8 && charsets.size() <= 1 && utf8ToUnicode(value, &fastString))
+    {
+        return fastString;
     }
 
-    // Initialize the conversion engine with the default
-    //  charset
-    ///////////////////////////////////////////////////////////
-    std::unique_ptr<defaultCharsetConversion> localCharsetConversion(new defaultCharsetConversion(charsets.front()));
+    const defaultCharsetConversion* localCharsetConversion(defaultConversion.m_pConversion.get());
 
     // Only one charset is present: we don't need to check
     //  the escape sequences
     ///////////////////////////////////////////////////////////
-    if(charsets.size() == 1)
+    if(charsets.size() <= 1)
     {
         return localCharsetConversion->toUnicode(value);
     }
@@ -225,7 +321,7 @@ std::wstring dicomConversion::convertToUnicode(const std::string& value, const c
 
         // An iso table is coupled to the found escape sequence.
         ///////////////////////////////////////////////////////////
-        localCharsetConversion.reset(new defaultCharsetConversion(isoTable));
+        localCharsetConversion = conversionCache.getConversion(isoTable).m_pConversion.get();
     }
 
     return returnString;
@@ -234,8 +330,193 @@ std::wstring dicomConversion::convertToUnicode(const std::string& value, const c
 
 }
 
+
+///////////////////////////////////////////////////////////
+//
+// Convert an ASCII string to unicode
+//
+///////////////////////////////////////////////////////////
+bool dicomConversion::asciiToUnicode(const std::string& value, std::wstring* pUnicodeString)
+{
+    for(std::string::const_iterator scanChars(value.begin()), endChars(value.end()); scanChars != endChars; ++scanChars)
+    {
+        const std::uint8_t asciiChar((std::uint8_t)*scanChars);
+        if(asciiChar == 0 || asciiChar >= 0x80 || asciiChar == 0x1b)
+        {
+            return false;
+        }
+    }
+    pUnicodeString->assign(value.begin(), value.end());
+    return true;
+}
+
+
+///////////////////////////////////////////////////////////
+//
+// Convert a unicode string containing only ASCII chars
+//
+///////////////////////////////////////////////////////////
+bool dicomConversion::asciiFromUnicode(const std::wstring& unicodeString, std::string* pValue)
+{
+    pValue->resize(unicodeString.size());
+    std::string::iterator pDestination(pValue->begin());
+    for(std::wstring::const_iterator scanChars(unicodeString.begin()), endChars(unicodeString.end()); scanChars != endChars; ++scanChars)
+    {
+        const std::uint32_t unicodeChar((std::uint32_t)*scanChars);
+        if(unicodeChar == 0 || unicodeChar >= 0x80 || unicodeChar == 0x1b)
+        {
+            return false;
+        }
+        *(pDestination++) = (char)unicodeChar;
+    }
+    return true;
+}
+
+
+///////////////////////////////////////////////////////////
+//
+// Decode an UTF-8 string
+//
+///////////////////////////////////////////////////////////
+bool dicomConversion::utf8ToUnicode(const std::string& value, std::wstring* pUnicodeString)
+{
+    pUnicodeString->clear();
+    pUnicodeString->reserve(value.size());
+
+    const std::uint8_t* pChars((const std::uint8_t*)value.data());
+    const std::uint8_t* pEndChars(pChars + value.size());
+    while(pChars != pEndChars)
+    {
+        std::uint32_t codePoint(*(pChars++));
+        if(codePoint < 0x80)
+        {
+            pUnicodeString->push_back((wchar_t)codePoint);
+            continue;
+        }
+
+        // Find the number of continuation bytes and the minimum
+        //  value allowed for the sequence's length
+        ///////////////////////////////////////////////////////////
+        size_t continuationBytes;
+        std::uint32_t minimumCodePoint;
+        if((codePoint & 0xe0) == 0xc0)
+        {
+            continuationBytes = 1;
+            minimumCodePoint = 0x80;
+            codePoint &= 0x1f;
+        }
+        else if((codePoint & 0xf0) == 0xe0)
+        {
+            continuationBytes = 2;
+            minimumCodePoint = 0x800;
+            codePoint &= 0x0f;
+        }
+        else if((codePoint & 0xf8) == 0xf0)
+        {
+            continuationBytes = 3;
+            minimumCodePoint = 0x10000;
+            codePoint &= 0x07;
+        }
+        else
+        {
+            return false;
+        }
+
+        if((size_t)(pEndChars - pChars) < continuationBytes)
+        {
+            return false;
+        }
+        for(; continuationBytes != 0; --continuationBytes)
+        {
+            if((*pChars & 0xc0) != 0x80)
+            {
+                return false;
+            }
+            codePoint = (codePoint << 6) | (*(pChars++) & 0x3f);
+        }
+
+        if(codePoint < minimumCodePoint || codePoint > 0x10ffff || (codePoint >= 0xd800 && codePoint <= 0xdfff))
+        {
+            return false;
+        }
+
+        if(sizeof(wchar_t) == 2 && codePoint >= 0x10000)
+        {
+            codePoint -= 0x10000;
+            pUnicodeString->push_back((wchar_t)(0xd800 + (codePoint >> 10)));
+            pUnicodeString->push_back((wchar_t)(0xdc00 + (codePoint & 0x3ff)));
+            continue;
+        }
+        pUnicodeString->push_back((wchar_t)codePoint);
+    }
+
+    return true;
 }
 
+
+///////////////////////////////////////////////////////////
+//
+// Encode a string into UTF-8
+//
+///////////////////////////////////////////////////////////
+bool dicomConversion::utf8FromUnicode(const std::wstring& unicodeString, std::string* pValue)
+{
+    pValue->clear();
+    pValue->reserve(unicodeString.size());
+
+    for(size_t scanChars(0); scanChars != unicodeString.size(); ++scanChars)
+    {
+        std::uint32_t codePoint((std::uint32_t)unicodeString[scanChars]);
+
+        // Join the UTF-16 surrogate pairs (Windows only)
+        ///////////////////////////////////////////////////////////
+        if(sizeof(wchar_t) == 2 && codePoint >= 0xd800 && codePoint <= 0xdbff && scanChars + 1 != unicodeString.size())
+        {
+            const std::uint32_t lowSurrogate((std::uint32_t)unicodeString[scanChars + 1]);
+            if(lowSurrogate >= 0xdc00 && lowSurrogate <= 0xdfff)
+            {
+                codePoint = 0x10000 + ((codePoint - 0xd800) << 10) + (lowSurrogate - 0xdc00);
+                ++scanChars;
+            }
+        }
+
+        if(codePoint < 0x80)
+        {
+            pValue->push_back((char)codePoint);
+        }
+        else if(codePoint < 0x800)
+        {
+            pValue->push_back((char)(0xc0 | (codePoint >> 6)));
+            pValue->push_back((char)(0x80 | (codePoint & 0x3f)));
+        }
+        else if(codePoint < 0x10000)
+        {
+            if(codePoint >= 0xd800 && codePoint <= 0xdfff)
+            {
+                return false;
+            }
+            pValue->push_back((char)(0xe0 | (codePoint >> 12)));
+            pValue->push_back((char)(0x80 | ((codePoint >> 6) & 0x3f)));
+            pValue->push_back((char)(0x80 | (codePoint & 0x3f)));
+        }
+        else if(codePoint <= 0x10ffff)
+        {
+            pValue->push_back((char)(0xf0 | (codePoint >> 18)));
+            pValue->push_back((char)(0x80 | ((codePoint >> 12) & 0x3f)));
+            pValue->push_back((char)(0x80 | ((codePoint >> 6) & 0x3f)));
+            pValue->push_back((char)(0x80 | (codePoint & 0x3f)));
+        }
+        else
+        {
+            return false;
+        }
+    }
+
+    return true;
 }
 
+} // namespace implementation
+
+} // namespace imebra
+
 
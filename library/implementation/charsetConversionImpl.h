@@ -22,6 +22,8 @@ If you do not want to be bound by the GPL terms (such as the requirement
 #include "charsetsListImpl.h"
 
 #include <string>
+#include <map>
+#include <memory>
 
 namespace imebra
 {
@@ -29,11 +31,74 @@ namespace imebra
 namespace implementation
 {
 
+///////////////////////////////////////////////////////////
+///////////////////////////////////////////////////////////
+/// \brief Keeps the charset conversion objects used by a
+///         thread, so they are created only once per
+///         charset.
+///
+/// The conversion objects are not thread safe (e.g. the
+///  iconv contexts), therefore each thread has its own
+///  cache.
+///
+///////////////////////////////////////////////////////////
+///////////////////////////////////////////////////////////
+class charsetConversionCache
+{
+public:
+    /// \brief A conversion object and the properties of its
+    ///         charset.
+    ///
+    ///////////////////////////////////////////////////////////
+    struct cachedConversion
+    {
+        std::unique_ptr<defaultCharsetConversion> m_pConversion; ///< null if the charset is not supported
+        bool m_bAsciiCompatible; ///< true if the chars 0x01...0x7f are mapped to the same unicode chars
+        bool m_bUtf8;            ///< true for ISO_IR 192
+    };
+
+    /// \brief Return the cache of the calling thread.
+    ///
+    ///////////////////////////////////////////////////////////
+    static charsetConversionCache& getThreadCache();
+
+    /// \brief Return the conversion for the specified DICOM
+    ///         charset, creating it if necessary.
+    ///
+    /// Throws CharsetConversionNoSupportedTableError if the
+    ///  charset is not supported by the system.
+    ///
+    ///////////////////////////////////////////////////////////
+    const cachedConversion& getConversion(const std::string& dicomName);
+
+private:
+    typedef std::map<std::string, std::unique_ptr<cachedConversion> > conversions_t;
+    conversions_t m_conversions;
+};
+
 class dicomConversion
 {
 public:
     static std::string convertFromUnicode(const std::wstring& unicodeString, charsetsList::tCharsetsList* pCharsets);
     static std::wstring convertToUnicode(const std::string& value, const charsetsList::tCharsetsList& charsets);
+
+private:
+    /// \brief Convert a string that contains only the chars
+    ///         0x01...0x7f, excluding the escape char.
+    ///
+    /// @return false if the string contains other chars
+    ///
+    ///////////////////////////////////////////////////////////
+    static bool asciiToUnicode(const std::string& value, std::wstring* pUnicodeString);
+    static bool asciiFromUnicode(const std::wstring& unicodeString, std::string* pValue);
+
+    /// \brief Convert between UTF-8 and unicode.
+    ///
+    /// @return false if the input is not valid
+    ///
+    ///////////////////////////////////////////////////////////
+    static bool utf8ToUnicode(const std::string& value, std::wstring* pUnicodeString);
+    static bool utf8FromUnicode(const std::wstring& unicodeString, std::string* pValue);
 };
 
 }
@@ -19,6 +19,7 @@ If you do not want to be bound by the GPL terms (such as the requirement
 #include "codecFactoryImpl.h"
 #include "configurationImpl.h"
 #include "exceptionImpl.h"
+#include "tracingImpl.h"
 #include "streamReaderImpl.h"
 #include "streamCodecImpl.h"
 #include "imageCodecImpl.h"
@@ -65,7 +66,7 @@ static codecFactory::forceCodecFactoryCreation forceCreation;
 //
 ///////////////////////////////////////////////////////////
 ///////////////////////////////////////////////////////////
-codecFactory::codecFactory(): m_maximumImageWidth(MAXIMUM_IMAGE_WIDTH), m_maximumImageHeight(MAXIMUM_IMAGE_HEIGHT)
+codecFactory::codecFactory(): m_maximumImageWidth(MAXIMUM_IMAGE_WIDTH), m_maximumImageHeight(MAXIMUM_IMAGE_HEIGHT), m_jpegRestartInterval(0)
 {
     IMEBRA_FUNCTION_START();
 
@@ -194,13 +195,26 @@ std::shared_ptr<dataSet> codecFactory::load(std::shared_ptr<streamReader> pStrea
 {
     IMEBRA_FUNCTION_START();
 
-	// Copy the list of codecs in a local list so we don't have
-	//  to lock the object for a long time
-	///////////////////////////////////////////////////////////
+    IMEBRA_TRACE_SPAN("codecFactory::load");
+
+    // Peek the stream's signature, so the codecs that don't
+    //  recognize it can be skipped without throwing
+    ///////////////////////////////////////////////////////////
+    std::uint8_t prefix[IMEBRA_STREAM_PROBE_LENGTH];
+    const size_t prefixLength(pStream->peek(prefix, sizeof(prefix)));
+
     std::shared_ptr<dataSet> pDataSet;
 	{
         for(std::map<codecType_t, std::shared_ptr<const streamCodec> >::const_iterator scanCodecs(m_streamCodecs.begin()); scanCodecs != m_streamCodecs.end(); ++scanCodecs)
 		{
+            if(!scanCodecs->second->canRead(prefix, prefixLength))
+            {
+                continue;
+            }
+
+            // The signature may match but the stream may still
+            //  be invalid
+            ///////////////////////////////////////////////////////////
             try
             {
                 return scanCodecs->second->read(pStream, maxSizeBufferLoad);
@@ -245,6 +259,16 @@ std::uint32_t codecFactory::getMaximumImageHeight()
     return m_maximumImageHeight;
 }
 
+void codecFactory::setJpegRestartInterval(const std::uint32_t mcuRows)
+{
+    m_jpegRestartInterval = mcuRows;
+}
+
+std::uint32_t codecFactory::getJpegRestartInterval() const
+{
+    return m_jpegRestartInterval;
+}
+
 } // namespace codecs
 
 } // namespace implementation
@@ -23,6 +23,7 @@ If you do not want to be bound by the GPL terms (such as the requirement
 #include <memory>
 #include <map>
 #include <list>
+#include <atomic>
 #include <functional>
 #include "../include/imebra/codecFactory.h"
 #include "dataSetImpl.h"
@@ -132,7 +133,9 @@ public:
 	///         stream of data.
 	///
 	/// The function selects automatically the codec that can
-	///  read the specified stream.
+	///  read the specified stream: the first bytes of the
+	///  stream are passed to streamCodec::canRead() and only
+	///  the codecs that recognize them are used.
 	///
 	/// @param pStream the stream that contain the data to be
 	///                 parsed
@@ -180,6 +183,26 @@ public:
     ///////////////////////////////////////////////////////////
     std::uint32_t getMaximumImageHeight();
 
+    /// \brief Set the restart interval used by the jpeg
+    ///         encoder.
+    ///
+    /// @param mcuRows the number of MCU rows in each restart
+    ///                 interval, or 0 to disable the restart
+    ///                 intervals
+    ///
+    ///////////////////////////////////////////////////////////
+    void setJpegRestartInterval(const std::uint32_t mcuRows);
+
+    /// \brief Get the restart interval used by the jpeg
+    ///         encoder.
+    ///
+    /// @return the number of MCU rows in each restart
+    ///          interval, or 0 if the restart intervals are
+    ///          disabled
+    ///
+    ///////////////////////////////////////////////////////////
+    std::uint32_t getJpegRestartInterval() const;
+
 protected:
 	// The list of the registered codecs
 	///////////////////////////////////////////////////////////
@@ -192,6 +215,10 @@ protected:
     std::uint32_t m_maximumImageWidth;
     std::uint32_t m_maximumImageHeight;
 
+    // Restart interval used by the jpeg encoder, in MCU rows
+    ///////////////////////////////////////////////////////////
+    std::atomic<std::uint32_t> m_jpegRestartInterval;
+
 
 public:
 	// Force the creation of the codec factory before main()
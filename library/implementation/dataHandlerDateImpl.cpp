@@ -46,7 +46,7 @@ namespace handlers
 ///////////////////////////////////////////////////////////
 ///////////////////////////////////////////////////////////
 
-readingDataHandlerDate::readingDataHandlerDate(const memory& parseMemory): readingDataHandlerDateTimeBase(parseMemory, tagVR_t::DA)
+readingDataHandlerDate::readingDataHandlerDate(std::shared_ptr<const memory> pParseMemory): readingDataHandlerDateTimeBase(pParseMemory, tagVR_t::DA)
 {
 
 }
@@ -83,8 +83,9 @@ void readingDataHandlerDate::getDate(const size_t index,
 	*pOffsetHours = 0;
 	*pOffsetMinutes = 0;
 
-    std::string dateString = getString(index);
-	parseDate(dateString, pYear, pMonth, pDay);
+    size_t dateLength;
+    const char* pDateChars(getStringView(index, &dateLength));
+	parseDate(pDateChars, dateLength, pYear, pMonth, pDay);
 
 	IMEBRA_FUNCTION_END();
 }
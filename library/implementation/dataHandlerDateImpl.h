@@ -43,7 +43,7 @@ namespace handlers
 class readingDataHandlerDate : public readingDataHandlerDateTimeBase
 {
 public:
-    readingDataHandlerDate(const memory& parseMemory);
+    readingDataHandlerDate(std::shared_ptr<const memory> pParseMemory);
 
 	virtual void getDate(const size_t index,
         std::uint32_t* pYear,
@@ -19,11 +19,11 @@ If you do not want to be bound by the GPL terms (such as the requirement
 #include "exceptionImpl.h"
 #include "dataHandlerDateTimeBaseImpl.h"
 #include "dicomDictImpl.h"
+#include "numericStringImpl.h"
 #include "../include/imebra/exceptions.h"
 #include <time.h>
 #include <stdlib.h>
-#include <sstream>
-#include <iomanip>
+#include <string.h>
 
 namespace imebra
 {
@@ -48,8 +48,8 @@ namespace handlers
 ///////////////////////////////////////////////////////////
 ///////////////////////////////////////////////////////////
 
-readingDataHandlerDateTimeBase::readingDataHandlerDateTimeBase(const memory& parseMemory, tagVR_t dataType):
-    readingDataHandlerString(parseMemory, dataType, '-', 0x20)
+readingDataHandlerDateTimeBase::readingDataHandlerDateTimeBase(std::shared_ptr<const memory> pParseMemory, tagVR_t dataType):
+    readingDataHandlerString(pParseMemory, dataType, '-', 0x20)
 {
 
 }
@@ -183,30 +183,22 @@ void writingDataHandlerDateTimeBase::setDouble(const size_t /* index */, const d
 ///////////////////////////////////////////////////////////
 ///////////////////////////////////////////////////////////
 void readingDataHandlerDateTimeBase::parseDate(
-        const std::string& dateString,
+        const char* pDateChars,
+        size_t dateLength,
         std::uint32_t* pYear,
         std::uint32_t* pMonth,
         std::uint32_t* pDay) const
 {
     IMEBRA_FUNCTION_START();
 
-    if(dateString.size() != 8)
+    if(dateLength != 8)
     {
         IMEBRA_THROW(DataHandlerCorruptedBufferError, "The date/time string has the wrong size");
     }
 
-    std::string dateYear=dateString.substr(0, 4);
-    std::string dateMonth=dateString.substr(4, 2);
-    std::string dateDay=dateString.substr(6, 2);
-
-    std::istringstream yearStream(dateYear);
-	yearStream >> (*pYear);
-
-    std::istringstream monthStream(dateMonth);
-	monthStream >> (*pMonth);
-
-    std::istringstream dayStream(dateDay);
-	dayStream >> (*pDay);
+    *pYear = (std::uint32_t)parseField(pDateChars, 4);
+    *pMonth = (std::uint32_t)parseField(pDateChars + 4, 2);
+    *pDay = (std::uint32_t)parseField(pDateChars + 6, 2);
 
 	IMEBRA_FUNCTION_END();
 }
@@ -233,13 +225,13 @@ std::string writingDataHandlerDateTimeBase::buildDate(
 		year = month = day = 0;
 	}
 
-    std::ostringstream dateStream;
-    dateStream << std::setfill('0');
-	dateStream << std::setw(4) << year;
-	dateStream << std::setw(2) << month;
-	dateStream << std::setw(2) << day;
+    std::string dateString;
+    dateString.reserve(8);
+    appendZeroPadded(&dateString, year, 4);
+    appendZeroPadded(&dateString, month, 2);
+    appendZeroPadded(&dateString, day, 2);
 
-	return dateStream.str();
+	return dateString;
 
 	IMEBRA_FUNCTION_END();
 }
@@ -255,7 +247,8 @@ std::string writingDataHandlerDateTimeBase::buildDate(
 ///////////////////////////////////////////////////////////
 ///////////////////////////////////////////////////////////
 void readingDataHandlerDateTimeBase::parseTime(
-        const std::string& timeString,
+        const char* pTimeChars,
+        size_t timeLength,
         std::uint32_t* pHour,
         std::uint32_t* pMinutes,
         std::uint32_t* pSeconds,
@@ -265,53 +258,18 @@ void readingDataHandlerDateTimeBase::parseTime(
 {
     IMEBRA_FUNCTION_START();
 
-    std::string fullTimeString(timeString);
-
-    if(fullTimeString.size() < 6)
-	{
-        fullTimeString.resize(6, '0');
-	}
-    if(fullTimeString.size() < 7)
-	{
-        fullTimeString += '.';
-	}
-    if(fullTimeString.size() < 13)
-	{
-        fullTimeString.resize(13, '0');
-	}
-    if(fullTimeString.size() < 14)
-	{
-        fullTimeString += '+';
-	}
-    if(fullTimeString.size() < 18)
-	{
-        fullTimeString.resize(18, '0');
-	}
-	
-    std::string timeHour = fullTimeString.substr(0, 2);
-    std::string timeMinutes = fullTimeString.substr(2, 2);
-    std::string timeSeconds = fullTimeString.substr(4, 2);
-    std::string timeNanoseconds = fullTimeString.substr(7, 6);
-    std::string timeOffsetHours = fullTimeString.substr(13, 3);
-    std::string timeOffsetMinutes = fullTimeString.substr(16, 2);
-
-    std::istringstream hourStream(timeHour);
-	hourStream >> (*pHour);
+    // Complete the missing parts of the time with the
+    //  default values (HHMMSS.FFFFFF+HHMM)
+    ///////////////////////////////////////////////////////////
+    char fullTime[] = "000000.000000+0000";
+    ::memcpy(fullTime, pTimeChars, timeLength < 18 ? timeLength : 18);
 
-    std::istringstream minutesStream(timeMinutes);
-	minutesStream >> (*pMinutes);
-
-    std::istringstream secondsStream(timeSeconds);
-	secondsStream >> (*pSeconds);
-
-    std::istringstream nanosecondsStream(timeNanoseconds);
-	nanosecondsStream >> (*pNanoseconds);
-
-    std::istringstream offsetHoursStream(timeOffsetHours);
-	offsetHoursStream >> (*pOffsetHours);
-
-    std::istringstream offsetMinutesStream(timeOffsetMinutes);
-	offsetMinutesStream >> (*pOffsetMinutes);
+    *pHour = (std::uint32_t)parseField(fullTime, 2);
+    *pMinutes = (std::uint32_t)parseField(fullTime + 2, 2);
+    *pSeconds = (std::uint32_t)parseField(fullTime + 4, 2);
+    *pNanoseconds = (std::uint32_t)parseField(fullTime + 7, 6);
+    *pOffsetHours = parseField(fullTime + 13, 3);
+    *pOffsetMinutes = parseField(fullTime + 16, 2);
 
 	if(*pOffsetHours < 0)
 	{
@@ -357,18 +315,18 @@ std::string writingDataHandlerDateTimeBase::buildTime(
 
 	bool bMinus=offsetHours < 0;
 
-    std::ostringstream timeStream;
-    timeStream << std::setfill('0');
-	timeStream << std::setw(2) << hour;
-	timeStream << std::setw(2) << minutes;
-	timeStream << std::setw(2) << seconds;
-    timeStream << std::setw(1) << ".";
-	timeStream << std::setw(6) << nanoseconds;
-    timeStream << std::setw(1) << (bMinus ? "-" : "+");
-	timeStream << std::setw(2) << labs(offsetHours);
-	timeStream << std::setw(2) << labs(offsetMinutes);
-	
-	return timeStream.str();
+    std::string timeString;
+    timeString.reserve(18);
+    appendZeroPadded(&timeString, hour, 2);
+    appendZeroPadded(&timeString, minutes, 2);
+    appendZeroPadded(&timeString, seconds, 2);
+    timeString += '.';
+    appendZeroPadded(&timeString, nanoseconds, 6);
+    timeString += (bMinus ? '-' : '+');
+    appendZeroPadded(&timeString, (std::uint32_t)labs(offsetHours), 2);
+    appendZeroPadded(&timeString, (std::uint32_t)labs(offsetMinutes), 2);
+
+	return timeString;
 
 	IMEBRA_FUNCTION_END();
 }
@@ -401,18 +359,18 @@ std::string writingDataHandlerDateTimeBase::buildTimeSimple(
         throw;
     }
 
-    std::ostringstream timeStream;
-    timeStream << std::setfill('0');
-    timeStream << std::setw(2) << hour;
-    timeStream << std::setw(2) << minutes;
-    timeStream << std::setw(2) << seconds;
+    std::string timeString;
+    timeString.reserve(13);
+    appendZeroPadded(&timeString, hour, 2);
+    appendZeroPadded(&timeString, minutes, 2);
+    appendZeroPadded(&timeString, seconds, 2);
     if(nanoseconds != 0)
     {
-        timeStream << std::setw(1) << ".";
-        timeStream << std::setw(6) << nanoseconds;
+        timeString += '.';
+        appendZeroPadded(&timeString, nanoseconds, 6);
     }
 
-    return timeStream.str();
+    return timeString;
 
     IMEBRA_FUNCTION_END();
 }
@@ -47,7 +47,7 @@ class readingDataHandlerDateTimeBase : public readingDataHandlerString
 {
 
 public:
-    readingDataHandlerDateTimeBase(const memory& parseMemory, tagVR_t dataType);
+    readingDataHandlerDateTimeBase(std::shared_ptr<const memory> pParseMemory, tagVR_t dataType);
 
     virtual std::int32_t getSignedLong(const size_t index) const;
     virtual std::uint32_t getUnsignedLong(const size_t index) const;
@@ -55,13 +55,15 @@ public:
 
 protected:
 	void parseDate(
-        const std::string& dateString,
+        const char* pDateChars,
+        size_t dateLength,
         std::uint32_t* pYear,
         std::uint32_t* pMonth,
         std::uint32_t* pDay) const;
 
 	void parseTime(
-        const std::string& timeString,
+        const char* pTimeChars,
+        size_t timeLength,
         std::uint32_t* pHour,
         std::uint32_t* pMinutes,
         std::uint32_t* pSeconds,
@@ -46,7 +46,7 @@ namespace handlers
 ///////////////////////////////////////////////////////////
 ///////////////////////////////////////////////////////////
 
-readingDataHandlerDateTime::readingDataHandlerDateTime(const memory& parseMemory): readingDataHandlerDateTimeBase(parseMemory, tagVR_t::DT)
+readingDataHandlerDateTime::readingDataHandlerDateTime(std::shared_ptr<const memory> pParseMemory): readingDataHandlerDateTimeBase(pParseMemory, tagVR_t::DT)
 {
 
 }
@@ -75,17 +75,18 @@ void readingDataHandlerDateTime::getDate(const size_t index,
 {
     IMEBRA_FUNCTION_START();
 
-    std::string dateTimeString = getString(index);
+    size_t dateTimeLength;
+    const char* pDateTimeChars(getStringView(index, &dateTimeLength));
 
-    parseDate(dateTimeString.substr(0, 8), pYear, pMonth, pDay);
+    parseDate(pDateTimeChars, dateTimeLength < 8 ? dateTimeLength : 8, pYear, pMonth, pDay);
 
-    if(dateTimeString.size() <= 8)
+    if(dateTimeLength <= 8)
     {
-        parseTime("", pHour, pMinutes, pSeconds, pNanoseconds, pOffsetHours, pOffsetMinutes);
+        parseTime(pDateTimeChars, 0, pHour, pMinutes, pSeconds, pNanoseconds, pOffsetHours, pOffsetMinutes);
     }
     else
     {
-        parseTime(dateTimeString.substr(8), pHour, pMinutes, pSeconds, pNanoseconds, pOffsetHours, pOffsetMinutes);
+        parseTime(pDateTimeChars + 8, dateTimeLength - 8, pHour, pMinutes, pSeconds, pNanoseconds, pOffsetHours, pOffsetMinutes);
     }
 
 	IMEBRA_FUNCTION_END();
@@ -35,7 +35,7 @@ class readingDataHandlerDateTime : public readingDataHandlerDateTimeBase
 {
 
 public:
-    readingDataHandlerDateTime(const memory& parseMemory);
+    readingDataHandlerDateTime(std::shared_ptr<const memory> pParseMemory);
 
 	virtual void getDate(const size_t index,
         std::uint32_t* pYear,
@@ -88,6 +88,52 @@ std::uint32_t readingDataHandler::getAge(const size_t /* index */, ageUnit_t * /
 }
 
 
+///////////////////////////////////////////////////////////
+///////////////////////////////////////////////////////////
+//
+//
+// Retrieve a view on a string
+//
+//
+///////////////////////////////////////////////////////////
+///////////////////////////////////////////////////////////
+const char* readingDataHandler::getStringView(const size_t /* index */, size_t* /* pLength */) const
+{
+    IMEBRA_FUNCTION_START();
+
+    IMEBRA_THROW(DataHandlerConversionError, "Cannot access VR "<< dicomDictionary::getDicomDictionary()->enumDataTypeToString(getDataType()) << " as an ASCII string");
+
+    IMEBRA_FUNCTION_END();
+}
+
+
+///////////////////////////////////////////////////////////
+///////////////////////////////////////////////////////////
+//
+//
+// Retrieve several values as doubles
+//
+//
+///////////////////////////////////////////////////////////
+///////////////////////////////////////////////////////////
+void readingDataHandler::getDoubles(const size_t firstIndex, double* pDestination, const size_t count) const
+{
+    IMEBRA_FUNCTION_START();
+
+    if(firstIndex + count > getSize())
+    {
+        IMEBRA_THROW(MissingItemError, "Missing item " << getSize());
+    }
+
+    for(size_t scanValues(0); scanValues != count; ++scanValues)
+    {
+        pDestination[scanValues] = getDouble(firstIndex + scanValues);
+    }
+
+    IMEBRA_FUNCTION_END();
+}
+
+
 writingDataHandler::writingDataHandler(const std::shared_ptr<buffer> &pBuffer, tagVR_t dataType, const uint8_t paddingByte):
     m_dataType(dataType), m_buffer(pBuffer), m_paddingByte(paddingByte)
 {
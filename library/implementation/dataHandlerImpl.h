@@ -191,6 +191,35 @@ public:
     ///////////////////////////////////////////////////////////
     virtual std::uint32_t getAge(const size_t index, ageUnit_t* pUnit) const;
 
+    /// \brief Return a pointer to the characters of a string
+    ///         value, without copying them.
+    ///
+    /// Available only for the tags that store ASCII strings.
+    ///
+    /// @param index   the zero based index of the value
+    /// @param pLength a pointer to a variable that will be
+    ///                 filled with the number of characters
+    ///                 in the value
+    /// @return a pointer to the first character of the
+    ///          value. The characters are not terminated by
+    ///          a zero and remain valid as long as the
+    ///          handler exists
+    ///
+    ///////////////////////////////////////////////////////////
+    virtual const char* getStringView(const size_t index, size_t* pLength) const;
+
+    /// \brief Retrieve several consecutive values as
+    ///         doubles.
+    ///
+    /// @param firstIndex   the zero based index of the first
+    ///                      value to retrieve
+    /// @param pDestination the array that will be filled
+    ///                      with the values
+    /// @param count        the number of values to retrieve
+    ///
+    ///////////////////////////////////////////////////////////
+    virtual void getDoubles(const size_t firstIndex, double* pDestination, const size_t count) const;
+
 private:
     const tagVR_t m_dataType;
 };
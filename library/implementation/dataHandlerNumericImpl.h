@@ -28,6 +28,7 @@ If you do not want to be bound by the GPL terms (such as the requirement
 #include "dataHandlerImpl.h"
 #include "memoryImpl.h"
 #include "charsetConversionImpl.h"
+#include "numericStringImpl.h"
 
 
 namespace imebra
@@ -246,6 +247,25 @@ public:
         IMEBRA_FUNCTION_END();
     }
 
+    // Retrieve several data elements as doubles
+    ///////////////////////////////////////////////////////////
+    virtual void getDoubles(const size_t firstIndex, double* pDestination, const size_t count) const
+    {
+        IMEBRA_FUNCTION_START();
+
+        if(firstIndex + count > getSize())
+        {
+            IMEBRA_THROW(MissingItemError, "Missing item " << getSize());
+        }
+        const dataHandlerType* pSource(((const dataHandlerType*)m_pMemory->data()) + firstIndex);
+        for(size_t scanValues(0); scanValues != count; ++scanValues)
+        {
+            pDestination[scanValues] = (double)pSource[scanValues];
+        }
+
+        IMEBRA_FUNCTION_END();
+    }
+
 	// Retrieve the data element as a string
 	///////////////////////////////////////////////////////////
     virtual std::string getString(const size_t index) const
@@ -257,19 +277,16 @@ public:
             IMEBRA_THROW(MissingItemError, "Missing item " << index);
         }
 
-        std::ostringstream convStream;
-
-        if(std::is_same<dataHandlerType, std::uint8_t>::value ||
-                std::is_same<dataHandlerType, std::int8_t>::value )
+        const dataHandlerType value(((const dataHandlerType*)m_pMemory->data())[index]);
+        if(!std::numeric_limits<dataHandlerType>::is_integer)
         {
-            int tempValue = (int) (((const dataHandlerType*)m_pMemory->data())[index]);
-            convStream << tempValue;
+            return doubleToString((double)value);
         }
-        else
+        if(std::numeric_limits<dataHandlerType>::is_signed)
         {
-            convStream << (((const dataHandlerType*)m_pMemory->data())[index]);
+            return signedLongToString((std::int64_t)value);
         }
-		return convStream.str();
+        return unsignedLongToString((std::uint64_t)value);
 
 		IMEBRA_FUNCTION_END();
 	}
@@ -50,7 +50,7 @@ namespace handlers
 //
 ///////////////////////////////////////////////////////////
 ///////////////////////////////////////////////////////////
-readingDataHandlerStringAE::readingDataHandlerStringAE(const memory &parseMemory): readingDataHandlerString(parseMemory, tagVR_t::AE, '\\', 0x20)
+readingDataHandlerStringAE::readingDataHandlerStringAE(std::shared_ptr<const memory> pParseMemory): readingDataHandlerString(pParseMemory, tagVR_t::AE, '\\', 0x20)
 {
 }
 
@@ -44,7 +44,7 @@ namespace handlers
 class readingDataHandlerStringAE : public readingDataHandlerString
 {
 public:
-    readingDataHandlerStringAE(const memory& parseMemory);
+    readingDataHandlerStringAE(std::shared_ptr<const memory> pParseMemory);
 };
 
 class writingDataHandlerStringAE: public writingDataHandlerString
@@ -57,7 +57,7 @@ namespace handlers
 //
 ///////////////////////////////////////////////////////////
 ///////////////////////////////////////////////////////////
-readingDataHandlerStringAS::readingDataHandlerStringAS(const memory& parseMemory): readingDataHandlerString(parseMemory, tagVR_t::AS, '\\', 0x20)
+readingDataHandlerStringAS::readingDataHandlerStringAS(std::shared_ptr<const memory> pParseMemory): readingDataHandlerString(pParseMemory, tagVR_t::AS, '\\', 0x20)
 {
 }
 
@@ -253,8 +253,8 @@ void writingDataHandlerStringAS::validate() const
 {
     IMEBRA_FUNCTION_START();
 
-    memory parseMemory(m_strings[0].size());
-    ::memcpy(parseMemory.data(), m_strings[0].data(), parseMemory.size());
+    std::shared_ptr<memory> parseMemory(std::make_shared<memory>(m_strings[0].size()));
+    ::memcpy(parseMemory->data(), m_strings[0].data(), parseMemory->size());
     try
     {
         readingDataHandlerStringAS readingHandler(parseMemory);
@@ -53,7 +53,7 @@ namespace handlers
 class readingDataHandlerStringAS : public readingDataHandlerString
 {
 public:
-    readingDataHandlerStringAS(const memory& parseMemory);
+    readingDataHandlerStringAS(std::shared_ptr<const memory> pParseMemory);
 
 	/// \brief Retrieve the age value and its unit from the
 	///         buffer handled by this handler.
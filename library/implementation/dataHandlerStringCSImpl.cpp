@@ -41,8 +41,8 @@ namespace handlers
 ///////////////////////////////////////////////////////////
 ///////////////////////////////////////////////////////////
 
-readingDataHandlerStringCS::readingDataHandlerStringCS(const memory &parseMemory):
-    readingDataHandlerString(parseMemory, tagVR_t::CS, '\\', 0x20)
+readingDataHandlerStringCS::readingDataHandlerStringCS(std::shared_ptr<const memory> pParseMemory):
+    readingDataHandlerString(pParseMemory, tagVR_t::CS, '\\', 0x20)
 {
 }
 
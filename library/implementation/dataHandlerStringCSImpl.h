@@ -41,7 +41,7 @@ namespace handlers
 class readingDataHandlerStringCS : public readingDataHandlerString
 {
 public:
-    readingDataHandlerStringCS(const memory& parseMemory);
+    readingDataHandlerStringCS(std::shared_ptr<const memory> pParseMemory);
 
 };
 
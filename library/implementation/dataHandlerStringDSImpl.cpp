@@ -45,7 +45,7 @@ namespace handlers
 ///////////////////////////////////////////////////////////
 ///////////////////////////////////////////////////////////
 
-readingDataHandlerStringDS::readingDataHandlerStringDS(const memory& parseMemory): readingDataHandlerString(parseMemory, tagVR_t::DS, '\\', 0x20)
+readingDataHandlerStringDS::readingDataHandlerStringDS(std::shared_ptr<const memory> pParseMemory): readingDataHandlerString(pParseMemory, tagVR_t::DS, '\\', 0x20)
 {
 }
 
@@ -40,7 +40,7 @@ namespace handlers
 class readingDataHandlerStringDS : public readingDataHandlerString
 {
 public:
-    readingDataHandlerStringDS(const memory& memory);
+    readingDataHandlerStringDS(std::shared_ptr<const memory> pParseMemory);
 
 	// Overwritten to use getDouble()
 	///////////////////////////////////////////////////////////
@@ -42,7 +42,7 @@ namespace handlers
 ///////////////////////////////////////////////////////////
 ///////////////////////////////////////////////////////////
 
-readingDataHandlerStringIS::readingDataHandlerStringIS(const memory& parseMemory): readingDataHandlerString(parseMemory, tagVR_t::IS, '\\', 0x20)
+readingDataHandlerStringIS::readingDataHandlerStringIS(std::shared_ptr<const memory> pParseMemory): readingDataHandlerString(pParseMemory, tagVR_t::IS, '\\', 0x20)
 {
 }
 
@@ -40,7 +40,7 @@ namespace handlers
 class readingDataHandlerStringIS : public readingDataHandlerString
 {
 public:
-    readingDataHandlerStringIS(const memory& parseMemory);
+    readingDataHandlerStringIS(std::shared_ptr<const memory> pParseMemory);
 
 	// Overwritten to use getSignedLong()
 	///////////////////////////////////////////////////////////
@@ -18,11 +18,13 @@ If you do not want to be bound by the GPL terms (such as the requirement
 
 #include <sstream>
 #include <iomanip>
+#include <string.h>
 
 #include "exceptionImpl.h"
 #include "dataHandlerStringImpl.h"
 #include "memoryImpl.h"
 #include "bufferImpl.h"
+#include "numericStringImpl.h"
 
 namespace imebra
 {
@@ -56,33 +58,26 @@ namespace handlers
 //
 ///////////////////////////////////////////////////////////
 ///////////////////////////////////////////////////////////
-readingDataHandlerString::readingDataHandlerString(const memory &parseMemory, tagVR_t dataType, const char separator, const uint8_t paddingByte):
-    readingDataHandler(dataType)
+readingDataHandlerString::readingDataHandlerString(std::shared_ptr<const memory> pParseMemory, tagVR_t dataType, const char separator, const uint8_t paddingByte):
+    readingDataHandler(dataType), m_pMemory(pParseMemory), m_pChars((const char*)pParseMemory->data()), m_length(pParseMemory->size())
 {
     IMEBRA_FUNCTION_START();
 
-    std::string parseString((const char*)parseMemory.data(), parseMemory.size());
-    while(!parseString.empty() && (parseString.back() == (char)paddingByte || parseString.back() == 0))
+    while(m_length != 0 && (m_pChars[m_length - 1] == (char)paddingByte || m_pChars[m_length - 1] == 0))
     {
-        parseString.pop_back();
+        --m_length;
     }
 
-    if(separator == 0)
+    if(separator == 0 || m_length == 0)
     {
-        m_strings.push_back(parseString);
         return;
     }
 
-    for(size_t firstPosition(0); ;)
+    for(const char* pSeparator((const char*)::memchr(m_pChars, separator, m_length));
+        pSeparator != 0;
+        pSeparator = (const char*)::memchr(pSeparator + 1, separator, m_length - (size_t)(pSeparator + 1 - m_pChars)))
     {
-        size_t nextPosition = parseString.find(separator, firstPosition);
-        if(nextPosition == std::string::npos)
-        {
-            m_strings.push_back(parseString.substr(firstPosition));
-            return;
-        }
-        m_strings.push_back(parseString.substr(firstPosition, nextPosition - firstPosition));
-        firstPosition = ++nextPosition;
+        m_separators.push_back((size_t)(pSeparator - m_pChars));
     }
 
     IMEBRA_FUNCTION_END();
@@ -108,11 +103,12 @@ std::int32_t readingDataHandlerString::getSignedLong(const size_t index) const
 {
     IMEBRA_FUNCTION_START();
 
-    std::istringstream conversion(getString(index));
+    size_t length;
+    const char* pValue(getStringView(index, &length));
     std::int32_t value;
-    if(!(conversion >> value))
+    if(!parseSignedLong(pValue, length, &value))
     {
-        IMEBRA_THROW(DataHandlerConversionError, "Cannot convert " << m_strings.at(index) << " to a number");
+        IMEBRA_THROW(DataHandlerConversionError, "Cannot convert " << getString(index) << " to a number");
     }
     return value;
 
@@ -125,11 +121,12 @@ std::uint32_t readingDataHandlerString::getUnsignedLong(const size_t index) cons
 {
     IMEBRA_FUNCTION_START();
 
-    std::istringstream conversion(getString(index));
+    size_t length;
+    const char* pValue(getStringView(index, &length));
     std::uint32_t value;
-    if(!(conversion >> value))
+    if(!parseUnsignedLong(pValue, length, &value))
     {
-        IMEBRA_THROW(DataHandlerConversionError, "Cannot convert " << m_strings.at(index) << " to a number");
+        IMEBRA_THROW(DataHandlerConversionError, "Cannot convert " << getString(index) << " to a number");
     }
     return value;
 
@@ -142,11 +139,12 @@ double readingDataHandlerString::getDouble(const size_t index) const
 {
     IMEBRA_FUNCTION_START();
 
-    std::istringstream conversion(getString(index));
+    size_t length;
+    const char* pValue(getStringView(index, &length));
     double value;
-    if(!(conversion >> value))
+    if(!parseDouble(pValue, length, &value))
     {
-        IMEBRA_THROW(DataHandlerConversionError, "Cannot convert " << m_strings.at(index) << " to a number");
+        IMEBRA_THROW(DataHandlerConversionError, "Cannot convert " << getString(index) << " to a number");
     }
     return value;
 
@@ -159,12 +157,28 @@ std::string readingDataHandlerString::getString(const size_t index) const
 {
     IMEBRA_FUNCTION_START();
 
+    size_t length;
+    const char* pValue(getStringView(index, &length));
+    return std::string(pValue, length);
+
+    IMEBRA_FUNCTION_END();
+}
+
+// Get a view on the data element
+///////////////////////////////////////////////////////////
+const char* readingDataHandlerString::getStringView(const size_t index, size_t* pLength) const
+{
+    IMEBRA_FUNCTION_START();
+
     if(index >= getSize())
     {
         IMEBRA_THROW(MissingItemError, "Missing item " << index);
     }
 
-    return m_strings.at(index);
+    const size_t firstPosition(index == 0 ? 0 : m_separators[index - 1] + 1);
+    const size_t endPosition(index == m_separators.size() ? m_length : m_separators[index]);
+    *pLength = endPosition - firstPosition;
+    return m_pChars + firstPosition;
 
     IMEBRA_FUNCTION_END();
 }
@@ -188,7 +202,7 @@ size_t readingDataHandlerString::getSize() const
 {
     IMEBRA_FUNCTION_START();
 
-    return m_strings.size();
+    return m_separators.size() + 1;
 
     IMEBRA_FUNCTION_END();
 }
@@ -231,9 +245,7 @@ void writingDataHandlerString::setSignedLong(const size_t index, const std::int3
 {
     IMEBRA_FUNCTION_START();
 
-    std::ostringstream conversion;
-    conversion << value;
-    setString(index, conversion.str());
+    setString(index, signedLongToString(value));
 
     IMEBRA_FUNCTION_END();
 }
@@ -244,9 +256,7 @@ void writingDataHandlerString::setUnsignedLong(const size_t index, const std::ui
 {
     IMEBRA_FUNCTION_START();
 
-    std::ostringstream conversion;
-    conversion << value;
-    setString(index, conversion.str());
+    setString(index, unsignedLongToString(value));
 
     IMEBRA_FUNCTION_END();
 }
@@ -257,9 +267,7 @@ void writingDataHandlerString::setDouble(const size_t index, const double value)
 {
     IMEBRA_FUNCTION_START();
 
-    std::ostringstream conversion;
-    conversion << value;
-    setString(index, conversion.str());
+    setString(index, doubleToString(value));
 
     IMEBRA_FUNCTION_END();
 }
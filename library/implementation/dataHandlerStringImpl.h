@@ -43,7 +43,21 @@ namespace handlers
 class readingDataHandlerString : public readingDataHandler
 {
 public:
-    readingDataHandlerString(const memory& parseMemory, tagVR_t dataType, const char separator, const std::uint8_t paddingByte);
+    /// \brief Constructor.
+    ///
+    /// The handler keeps a reference to the memory and
+    ///  only records the position of the separators: the
+    ///  values are copied only when requested as strings.
+    ///
+    /// @param pParseMemory the memory containing the values
+    /// @param dataType     the tag's data type
+    /// @param separator    the char that separates the
+    ///                      values, or 0 for single value
+    ///                      tags
+    /// @param paddingByte  the char used to pad the values
+    ///
+    ///////////////////////////////////////////////////////////
+    readingDataHandlerString(std::shared_ptr<const memory> pParseMemory, tagVR_t dataType, const char separator, const std::uint8_t paddingByte);
 
     // Get the data element as a signed long
     ///////////////////////////////////////////////////////////
@@ -65,13 +79,27 @@ public:
     ///////////////////////////////////////////////////////////
     virtual std::wstring getUnicodeString(const size_t index) const;
 
+    // Get a view on the data element
+    ///////////////////////////////////////////////////////////
+    virtual const char* getStringView(const size_t index, size_t* pLength) const;
+
     // Retrieve the data element as a string
     ///////////////////////////////////////////////////////////
     virtual size_t getSize() const;
 
 protected:
 
-    std::vector<std::string> m_strings;    
+    std::shared_ptr<const memory> m_pMemory;
+
+    // Memory content, without the trailing padding
+    ///////////////////////////////////////////////////////////
+    const char* m_pChars;
+    size_t m_length;
+
+    // Position of the separators. Empty for single value
+    //  tags, so they don't allocate anything
+    ///////////////////////////////////////////////////////////
+    std::vector<size_t> m_separators;
 };
 
 
@@ -41,8 +41,8 @@ namespace handlers
 ///////////////////////////////////////////////////////////
 ///////////////////////////////////////////////////////////
 
-readingDataHandlerStringUI::readingDataHandlerStringUI(const memory& parseMemory):
-    readingDataHandlerString(parseMemory, tagVR_t::UI, 0x0, 0x0)
+readingDataHandlerStringUI::readingDataHandlerStringUI(std::shared_ptr<const memory> pParseMemory):
+    readingDataHandlerString(pParseMemory, tagVR_t::UI, 0x0, 0x0)
 {
 }
 
@@ -43,7 +43,7 @@ namespace handlers
 class readingDataHandlerStringUI : public readingDataHandlerString
 {
 public:
-    readingDataHandlerStringUI(const memory& parseMemory);
+    readingDataHandlerStringUI(std::shared_ptr<const memory> pParseMemory);
 };
 
 class writingDataHandlerStringUI: public writingDataHandlerString
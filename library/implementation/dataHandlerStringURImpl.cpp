@@ -50,7 +50,7 @@ namespace handlers
 //
 ///////////////////////////////////////////////////////////
 ///////////////////////////////////////////////////////////
-readingDataHandlerStringUR::readingDataHandlerStringUR(const memory &parseMemory): readingDataHandlerString(parseMemory, tagVR_t::UR, 0, 0x20)
+readingDataHandlerStringUR::readingDataHandlerStringUR(std::shared_ptr<const memory> pParseMemory): readingDataHandlerString(pParseMemory, tagVR_t::UR, 0, 0x20)
 {
 }
 
@@ -44,7 +44,7 @@ namespace handlers
 class readingDataHandlerStringUR : public readingDataHandlerString
 {
 public:
-    readingDataHandlerStringUR(const memory& parseMemory);
+    readingDataHandlerStringUR(std::shared_ptr<const memory> pParseMemory);
 };
 
 class writingDataHandlerStringUR: public writingDataHandlerString
@@ -46,7 +46,7 @@ namespace handlers
 ///////////////////////////////////////////////////////////
 ///////////////////////////////////////////////////////////
 
-readingDataHandlerTime::readingDataHandlerTime(const memory& parseMemory): readingDataHandlerDateTimeBase(parseMemory, tagVR_t::TM)
+readingDataHandlerTime::readingDataHandlerTime(std::shared_ptr<const memory> pParseMemory): readingDataHandlerDateTimeBase(pParseMemory, tagVR_t::TM)
 {
 }
 
@@ -82,7 +82,9 @@ void readingDataHandlerTime::getDate(const size_t index,
     *pOffsetHours = 0;
     *pOffsetMinutes = 0;
 
-    parseTime(getString(index), pHour, pMinutes, pSeconds, pNanoseconds, pOffsetHours, pOffsetMinutes);
+    size_t timeLength;
+    const char* pTimeChars(getStringView(index, &timeLength));
+    parseTime(pTimeChars, timeLength, pHour, pMinutes, pSeconds, pNanoseconds, pOffsetHours, pOffsetMinutes);
 
     IMEBRA_FUNCTION_END();
 
@@ -43,7 +43,7 @@ class readingDataHandlerTime : public readingDataHandlerDateTimeBase
 {
 
 public:
-    readingDataHandlerTime(const memory& parseMemory);
+    readingDataHandlerTime(std::shared_ptr<const memory> pParseMemory);
 
 	virtual void getDate(
         const size_t index,
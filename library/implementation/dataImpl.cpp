@@ -59,7 +59,7 @@ namespace implementation
 ///////////////////////////////////////////////////////////
 ///////////////////////////////////////////////////////////
 data::data(tagVR_t tagVR, const charsetsList::tCharsetsList &defaultCharsets):
-    m_charsetsList(defaultCharsets), m_tagVR(tagVR)
+    m_charsetsList(defaultCharsets), m_tagVR(tagVR), m_pBuffersVersion(std::make_shared<std::atomic<std::uint64_t> >(0)), m_bFrozen(false)
 {
 }
 
@@ -79,9 +79,19 @@ void data::setBuffer(size_t bufferId, const std::shared_ptr<buffer>& newBuffer)
 
     std::lock_guard<std::mutex> lock(m_mutex);
 
+    if(m_bFrozen)
+    {
+        IMEBRA_THROW(DataSetFrozenError, "The tag belongs to a frozen dataset and cannot be modified");
+    }
+
     // Assign the new buffer
     ///////////////////////////////////////////////////////////
     m_buffers[bufferId] = newBuffer;
+    if(newBuffer != 0)
+    {
+        newBuffer->setOwnerVersion(m_pBuffersVersion);
+    }
+    m_pBuffersVersion->fetch_add(1, std::memory_order_acq_rel);
 
     IMEBRA_FUNCTION_END();
 }
@@ -120,7 +130,7 @@ size_t data::getBuffersCount() const
 {
     IMEBRA_FUNCTION_START();
 
-    std::lock_guard<std::mutex> lock(m_mutex);
+    std::unique_lock<std::mutex> lock(lockUnlessFrozen(m_mutex, m_bFrozen));
 
 	// Returns the number of buffers
 	///////////////////////////////////////////////////////////
@@ -143,7 +153,7 @@ bool data::bufferExists(size_t bufferId) const
 {
     IMEBRA_FUNCTION_START();
 
-    std::lock_guard<std::mutex> lock(m_mutex);
+    std::unique_lock<std::mutex> lock(lockUnlessFrozen(m_mutex, m_bFrozen));
 
 	// Retrieve the buffer
 	///////////////////////////////////////////////////////////
@@ -173,11 +183,17 @@ size_t data::getBufferSize(size_t bufferId) const
 }
 
 
+std::uint64_t data::getBuffersVersion() const
+{
+    return m_pBuffersVersion->load(std::memory_order_acquire);
+}
+
+
 std::shared_ptr<buffer> data::getBuffer(size_t bufferId) const
 {
     IMEBRA_FUNCTION_START();
 
-    std::lock_guard<std::mutex> lock(m_mutex);
+    std::unique_lock<std::mutex> lock(lockUnlessFrozen(m_mutex, m_bFrozen));
 
     // Retrieve the buffer
     ///////////////////////////////////////////////////////////
@@ -199,6 +215,11 @@ std::shared_ptr<buffer> data::getBufferCreate(size_t bufferId)
 
     std::lock_guard<std::mutex> lock(m_mutex);
 
+    if(m_bFrozen)
+    {
+        IMEBRA_THROW(DataSetFrozenError, "The tag belongs to a frozen dataset and cannot be modified");
+    }
+
     // Retrieve the buffer
     ///////////////////////////////////////////////////////////
     tBuffersMap::const_iterator findBuffer = m_buffers.find(bufferId);
@@ -209,7 +230,9 @@ std::shared_ptr<buffer> data::getBufferCreate(size_t bufferId)
 
     std::shared_ptr<buffer> pNewBuffer(std::make_shared<buffer>());
     pNewBuffer->setCharsetsList(m_charsetsList);
+    pNewBuffer->setOwnerVersion(m_pBuffersVersion);
     m_buffers[bufferId] = pNewBuffer;
+    m_pBuffersVersion->fetch_add(1, std::memory_order_acq_rel);
     return pNewBuffer;
 
     IMEBRA_FUNCTION_END();
@@ -346,7 +369,7 @@ std::shared_ptr<dataSet> data::getSequenceItem(size_t dataSetId) const
 {
     IMEBRA_FUNCTION_START();
 
-    std::lock_guard<std::mutex> lock(m_mutex);
+    std::unique_lock<std::mutex> lock(lockUnlessFrozen(m_mutex, m_bFrozen));
 
     if(m_embeddedDataSets.size() <= dataSetId)
 	{
@@ -362,7 +385,7 @@ bool data::dataSetExists(size_t dataSetId) const
 {
     IMEBRA_FUNCTION_START();
 
-    std::lock_guard<std::mutex> lock(m_mutex);
+    std::unique_lock<std::mutex> lock(lockUnlessFrozen(m_mutex, m_bFrozen));
 
     return m_embeddedDataSets.size() > dataSetId;
 
@@ -385,6 +408,11 @@ void data::setSequenceItem(size_t dataSetId, std::shared_ptr<dataSet> pDataSet)
 
     std::lock_guard<std::mutex> lock(m_mutex);
 
+    if(m_bFrozen)
+    {
+        IMEBRA_THROW(DataSetFrozenError, "The tag belongs to a frozen dataset and cannot be modified");
+    }
+
 	if(dataSetId >= m_embeddedDataSets.size())
 	{
 		m_embeddedDataSets.resize(dataSetId + 1);
@@ -410,6 +438,11 @@ void data::appendDataSet(std::shared_ptr<dataSet> pDataSet)
 
     std::lock_guard<std::mutex> lock(m_mutex);
 
+    if(m_bFrozen)
+    {
+        IMEBRA_THROW(DataSetFrozenError, "The tag belongs to a frozen dataset and cannot be modified");
+    }
+
     pDataSet->setCharsetsList(m_charsetsList);
     m_embeddedDataSets.push_back(pDataSet);
 
@@ -433,6 +466,11 @@ void data::setCharsetsList(const charsetsList::tCharsetsList& charsetsList)
 
     std::lock_guard<std::mutex> lock(m_mutex);
 
+    if(m_bFrozen)
+    {
+        IMEBRA_THROW(DataSetFrozenError, "The tag belongs to a frozen dataset and cannot be modified");
+    }
+
     m_charsetsList = charsetsList;
 
 	for(tEmbeddedDatasetsMap::iterator scanEmbeddedDataSets = m_embeddedDataSets.begin(); scanEmbeddedDataSets != m_embeddedDataSets.end(); ++scanEmbeddedDataSets)
@@ -463,7 +501,7 @@ void data::getCharsetsList(charsetsList::tCharsetsList* pCharsetsList) const
 {
     IMEBRA_FUNCTION_START();
 
-    std::lock_guard<std::mutex> lock(m_mutex);
+    std::unique_lock<std::mutex> lock(lockUnlessFrozen(m_mutex, m_bFrozen));
 
     for(tEmbeddedDatasetsMap::const_iterator scanEmbeddedDataSets = m_embeddedDataSets.begin(); scanEmbeddedDataSets != m_embeddedDataSets.end(); ++scanEmbeddedDataSets)
 	{
@@ -483,6 +521,46 @@ void data::getCharsetsList(charsetsList::tCharsetsList* pCharsetsList) const
 }
 
 
+///////////////////////////////////////////////////////////
+///////////////////////////////////////////////////////////
+//
+//
+// Freeze the tag, its buffers and its sequence items
+//
+//
+///////////////////////////////////////////////////////////
+///////////////////////////////////////////////////////////
+void data::freeze()
+{
+    IMEBRA_FUNCTION_START();
+
+    std::lock_guard<std::mutex> lock(m_mutex);
+
+    for(tEmbeddedDatasetsMap::iterator scanEmbeddedDataSets = m_embeddedDataSets.begin(); scanEmbeddedDataSets != m_embeddedDataSets.end(); ++scanEmbeddedDataSets)
+    {
+        if(*scanEmbeddedDataSets != 0)
+        {
+            (*scanEmbeddedDataSets)->freeze();
+        }
+    }
+
+    for(tBuffersMap::iterator scanBuffers = m_buffers.begin(); scanBuffers != m_buffers.end(); ++scanBuffers)
+    {
+        scanBuffers->second->freeze(m_tagVR);
+    }
+
+    m_bFrozen.store(true, std::memory_order_release);
+
+    IMEBRA_FUNCTION_END();
+}
+
+
+bool data::isFrozen() const
+{
+    return m_bFrozen.load(std::memory_order_acquire);
+}
+
+
 } // namespace implementation
 
 } // namespace imebra
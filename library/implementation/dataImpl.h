@@ -23,8 +23,10 @@ If you do not want to be bound by the GPL terms (such as the requirement
 
 #include "charsetsListImpl.h"
 #include "dataHandlerNumericImpl.h"
+#include "frozenLockImpl.h"
 #include "../include/imebra/definitions.h"
 
+#include <atomic>
 #include <map>
 #include <vector>
 #include <mutex>
@@ -112,6 +114,15 @@ public:
 	///////////////////////////////////////////////////////////
     size_t getBufferSize(size_t bufferId) const;
 
+    /// \brief Returns a number that changes every time a
+    ///        buffer is added, replaced or modified.
+    ///
+    /// Used to validate the values cached from the tag's
+    ///  buffers.
+    ///
+    ///////////////////////////////////////////////////////////
+    std::uint64_t getBuffersVersion() const;
+
     std::shared_ptr<buffer> getBuffer(size_t bufferId) const;
 
     std::shared_ptr<buffer> getBufferCreate(size_t bufferId);
@@ -316,6 +327,21 @@ public:
     virtual void setCharsetsList(const charsetsList::tCharsetsList& charsetsList);
     virtual void getCharsetsList(charsetsList::tCharsetsList* pCharsetsList) const;
 
+    /// \brief Make the tag, its buffers and its sequence items
+    ///         read-only.
+    ///
+    /// After the tag has been frozen the functions that
+    ///  modify it throw DataSetFrozenError and the reading
+    ///  functions don't lock the tag's mutex.
+    ///
+    ///////////////////////////////////////////////////////////
+    void freeze();
+
+    /// \brief Returns true if the tag has been frozen.
+    ///
+    ///////////////////////////////////////////////////////////
+    bool isFrozen() const;
+
     // Set a buffer
     ///////////////////////////////////////////////////////////
     void setBuffer(size_t bufferId, const std::shared_ptr<buffer>& newBuffer);
@@ -331,6 +357,11 @@ protected:
     typedef std::map<size_t, std::shared_ptr<buffer> > tBuffersMap;
 	tBuffersMap m_buffers;
 
+    // Incremented by the buffers when they change and by
+    //  setBuffer()/getBufferCreate()
+    ///////////////////////////////////////////////////////////
+    const std::shared_ptr<std::atomic<std::uint64_t> > m_pBuffersVersion;
+
 	// Pointers to the embedded datasets
 	///////////////////////////////////////////////////////////
 	typedef std::shared_ptr<dataSet> ptrDataSet;
@@ -338,6 +369,8 @@ protected:
 	tEmbeddedDatasetsMap m_embeddedDataSets;
 
     mutable std::mutex m_mutex;
+
+    std::atomic<bool> m_bFrozen;
 };
 
 /// @}
@@ -33,8 +33,12 @@ If you do not want to be bound by the GPL terms (such as the requirement
 #include "transformHighBitImpl.h"
 #include "modalityVOILUTImpl.h"
 #include "bufferImpl.h"
+#include "threadPoolImpl.h"
+#include "framesCacheImpl.h"
 #include <iostream>
 #include <string.h>
+#include <algorithm>
+#include <list>
 
 
 namespace imebra
@@ -57,11 +61,11 @@ namespace implementation
 ///////////////////////////////////////////////////////////
 ///////////////////////////////////////////////////////////
 
-dataSet::dataSet(): m_itemOffset(0)
+dataSet::dataSet(): m_framesIndexVersion(0), m_framesIndexOffsetsVersion(0), m_bFramesIndexFrozen(false), m_itemOffset(0), m_bFrozen(false)
 {
 }
 
-dataSet::dataSet(const std::string& transferSyntax): m_itemOffset(0)
+dataSet::dataSet(const std::string& transferSyntax): m_framesIndexVersion(0), m_framesIndexOffsetsVersion(0), m_bFramesIndexFrozen(false), m_itemOffset(0), m_bFrozen(false)
 {
     setString(0x0002, 0x0, 0x0010, 0, transferSyntax);
 }
@@ -79,7 +83,7 @@ std::shared_ptr<data> dataSet::getTag(std::uint16_t groupId, std::uint32_t order
 {
     IMEBRA_FUNCTION_START();
 
-    std::lock_guard<std::recursive_mutex> lock(m_mutex);
+    std::unique_lock<std::recursive_mutex> lock(lockUnlessFrozen(m_mutex, m_bFrozen));
 
     tGroups::const_iterator findGroup(m_groups.find(groupId));
     if(findGroup == m_groups.end())
@@ -110,6 +114,32 @@ std::shared_ptr<data> dataSet::getTagCreate(std::uint16_t groupId, std::uint32_t
 
     std::lock_guard<std::recursive_mutex> lock(m_mutex);
 
+    if(m_bFrozen)
+    {
+        IMEBRA_THROW(DataSetFrozenError, "The dataset is frozen and cannot be modified");
+    }
+
+    // The pixel data or the offset tables may be modified:
+    //  the frames index must be rebuilt
+    ///////////////////////////////////////////////////////////
+    if(groupId == 0x7fe0)
+    {
+        m_framesIndex.clear();
+        m_pFramesIndexTag.reset();
+    }
+
+    // The decoded frames depend on the pixel data and on the
+    //  image attributes
+    ///////////////////////////////////////////////////////////
+    if((groupId == 0x7fe0 || groupId == 0x0028) && m_pFramesCache != 0)
+    {
+        m_pFramesCache->clear();
+    }
+
+    // The tag's buffers may be replaced
+    ///////////////////////////////////////////////////////////
+    clearHotValues();
+
     if(m_groups[groupId].size() <= order)
     {
         m_groups[groupId].resize(order + 1);
@@ -164,7 +194,45 @@ std::shared_ptr<image> dataSet::getImage(std::uint32_t frameNumber) const
 {
     IMEBRA_FUNCTION_START();
 
-    std::lock_guard<std::recursive_mutex> lock(m_mutex);
+    std::shared_ptr<framesCache> pFramesCache;
+    std::uint32_t numberOfFrames(0);
+    {
+        std::unique_lock<std::recursive_mutex> lock(lockUnlessFrozen(m_mutex, m_bFrozen));
+        pFramesCache = m_pFramesCache;
+        numberOfFrames = getUnsignedLong(0x0028, 0, 0x0008, 0, 0, 1);
+    }
+
+    if(pFramesCache == 0)
+    {
+        return decodeImage(frameNumber);
+    }
+
+    if(frameNumber >= numberOfFrames)
+    {
+        IMEBRA_THROW(DataSetImageDoesntExistError, "The requested image doesn't exist");
+    }
+
+    std::shared_ptr<const dataSet> pDataSet(std::static_pointer_cast<const dataSet>(shared_from_this()));
+    return pFramesCache->getImage(frameNumber, numberOfFrames, [pDataSet](std::uint32_t decodeFrame){ return pDataSet->decodeImage(decodeFrame); });
+
+    IMEBRA_FUNCTION_END();
+}
+
+
+///////////////////////////////////////////////////////////
+///////////////////////////////////////////////////////////
+//
+//
+// Decode an image without using the frames cache
+//
+//
+///////////////////////////////////////////////////////////
+///////////////////////////////////////////////////////////
+std::shared_ptr<image> dataSet::decodeImage(std::uint32_t frameNumber) const
+{
+    IMEBRA_FUNCTION_START();
+
+    std::unique_lock<std::recursive_mutex> lock(lockUnlessFrozen(m_mutex, m_bFrozen));
 
 	// Retrieve the transfer syntax
 	///////////////////////////////////////////////////////////
@@ -201,18 +269,9 @@ std::shared_ptr<image> dataSet::getImage(std::uint32_t frameNumber) const
         {
             if(imageTag->bufferExists(1))
             {
-                std::uint32_t firstBufferId(0), endBufferId(0);
-                size_t totalLength(0);
-                if(imageTag->getBufferSize(0) == 0 && numberOfFrames + 1 == imageTag->getBuffersCount())
-                {
-                    firstBufferId = frameNumber + 1;
-                    endBufferId = firstBufferId + 1;
-                    totalLength = imageTag->getBufferSize(firstBufferId);
-                }
-                else
-                {
-                    totalLength = getFrameBufferIds(frameNumber, &firstBufferId, &endBufferId);
-                }
+                const frameFragments& fragments(getFramesIndex(imageTag, numberOfFrames)[frameNumber]);
+                const std::uint32_t firstBufferId(fragments.m_firstBuffer), endBufferId(fragments.m_endBuffer);
+                const size_t totalLength(fragments.m_length);
                 if(firstBufferId == endBufferId - 1)
                 {
                     imageStream = imageTag->getStreamReader(firstBufferId);
@@ -253,43 +312,61 @@ std::shared_ptr<image> dataSet::getImage(std::uint32_t frameNumber) const
             }
         }
 
-        // We are dealing with an old dicom format that doesn't
-        //  include the image offsets and stores all the images
-        //  in one buffer
+        // All the images are stored in one buffer.
+        // If the frames have a fixed size then seek directly to
+        //  the requested one, otherwise decode all the frames
+        //  that precede it
         ///////////////////////////////////////////////////////////
         if(imageStream == 0)
         {
             imageStream = imageTag->getStreamReader(0x0);
 
-            // Reset an internal array that keeps track of the
-            //  images position
-            ///////////////////////////////////////////////////////////
-            if(m_imagesPositions.size() != numberOfFrames)
+            const size_t frameSize(pCodec->getFrameSize(*this, imageStreamDataType));
+            if(frameSize != 0)
             {
-                m_imagesPositions.resize(numberOfFrames);
-
-                for(std::uint32_t resetImagesPositions = 0; resetImagesPositions != numberOfFrames; ++resetImagesPositions)
+                imageStream->seek(frameSize * frameNumber);
+                bDontNeedImagesPositions = true;
+            }
+            else
+            {
+                // The images positions are updated also when the
+                //  dataset is frozen
+                ///////////////////////////////////////////////////////////
+                if(!lock.owns_lock())
                 {
-                    m_imagesPositions[resetImagesPositions] = 0;
+                    lock.lock();
                 }
 
-            }
-
-            // Read all the images before the desidered one so we set
-            //  reading position in the stream
-            ///////////////////////////////////////////////////////////
-            for(std::uint32_t readImages = 0; readImages < frameNumber; readImages++)
-            {
-                size_t offsetPosition = m_imagesPositions[readImages];
-                if(offsetPosition == 0)
+                // Reset an internal array that keeps track of the
+                //  images position
+                ///////////////////////////////////////////////////////////
+                if(m_imagesPositions.size() != numberOfFrames)
                 {
-                    pCodec->getImage(*this, imageStream, imageStreamDataType);
-                    m_imagesPositions[readImages] = imageStream->position();
-                    continue;
+                    m_imagesPositions.resize(numberOfFrames);
+
+                    for(std::uint32_t resetImagesPositions = 0; resetImagesPositions != numberOfFrames; ++resetImagesPositions)
+                    {
+                        m_imagesPositions[resetImagesPositions] = 0;
+                    }
+
                 }
-                if((m_imagesPositions[readImages + 1] == 0) || (readImages == (frameNumber - 1)))
+
+                // Read all the images before the desidered one so we set
+                //  reading position in the stream
+                ///////////////////////////////////////////////////////////
+                for(std::uint32_t readImages = 0; readImages < frameNumber; readImages++)
                 {
-                    imageStream->seek(offsetPosition);
+                    size_t offsetPosition = m_imagesPositions[readImages];
+                    if(offsetPosition == 0)
+                    {
+                        pCodec->getImage(*this, imageStream, imageStreamDataType);
+                        m_imagesPositions[readImages] = imageStream->position();
+                        continue;
+                    }
+                    if((m_imagesPositions[readImages + 1] == 0) || (readImages == (frameNumber - 1)))
+                    {
+                        imageStream->seek(offsetPosition);
+                    }
                 }
             }
         }
@@ -297,6 +374,14 @@ std::shared_ptr<image> dataSet::getImage(std::uint32_t frameNumber) const
         double pixelDistanceX = getDouble(0x0028, 0x0, 0x0030, 0, 0, 1);
         double pixelDistanceY = getDouble(0x0028, 0x0, 0x0030, 0, 1, 1);
 
+        // The decoding doesn't need the dataset's lock unless
+        //  the frames positions must be updated
+        ///////////////////////////////////////////////////////////
+        if(bDontNeedImagesPositions && lock.owns_lock())
+        {
+            lock.unlock();
+        }
+
         std::shared_ptr<image> pImage;
         pImage = pCodec->getImage(*this, imageStream, imageStreamDataType);
 
@@ -335,6 +420,115 @@ std::shared_ptr<image> dataSet::getImage(std::uint32_t frameNumber) const
 }
 
 
+///////////////////////////////////////////////////////////
+///////////////////////////////////////////////////////////
+//
+//
+// Decode several frames concurrently
+//
+//
+///////////////////////////////////////////////////////////
+///////////////////////////////////////////////////////////
+std::vector<std::shared_ptr<image> > dataSet::getImages(std::uint32_t firstFrame, std::uint32_t framesCount) const
+{
+    IMEBRA_FUNCTION_START();
+
+    std::uint32_t numberOfFrames = getUnsignedLong(0x0028, 0, 0x0008, 0, 0, 1);
+    if(firstFrame >= numberOfFrames || framesCount > numberOfFrames - firstFrame)
+    {
+        IMEBRA_THROW(DataSetImageDoesntExistError, "The requested images don't exist");
+    }
+
+    // The calling thread decodes frames too, so this can be
+    //  called also by the tasks executed by the shared pool
+    ///////////////////////////////////////////////////////////
+    std::vector<std::shared_ptr<image> > images(framesCount);
+    threadPool::getSharedThreadPool().executeParallel(framesCount, [&](size_t frame)
+    {
+        images[frame] = getImage(firstFrame + (std::uint32_t)frame);
+    });
+
+    return images;
+
+    IMEBRA_FUNCTION_END();
+}
+
+
+///////////////////////////////////////////////////////////
+///////////////////////////////////////////////////////////
+//
+//
+// Decoded frames cache
+//
+//
+///////////////////////////////////////////////////////////
+///////////////////////////////////////////////////////////
+void dataSet::enableFramesCache(size_t memoryBudget, std::uint32_t readAheadFrames)
+{
+    IMEBRA_FUNCTION_START();
+
+    std::lock_guard<std::recursive_mutex> lock(m_mutex);
+
+    if(m_bFrozen)
+    {
+        IMEBRA_THROW(DataSetFrozenError, "The dataset is frozen and cannot be modified");
+    }
+
+    m_pFramesCache = std::make_shared<framesCache>(memoryBudget, readAheadFrames);
+
+    IMEBRA_FUNCTION_END();
+}
+
+void dataSet::disableFramesCache()
+{
+    IMEBRA_FUNCTION_START();
+
+    std::lock_guard<std::recursive_mutex> lock(m_mutex);
+
+    if(m_bFrozen)
+    {
+        IMEBRA_THROW(DataSetFrozenError, "The dataset is frozen and cannot be modified");
+    }
+
+    m_pFramesCache.reset();
+
+    IMEBRA_FUNCTION_END();
+}
+
+FramesCacheStatistics dataSet::getFramesCacheStatistics() const
+{
+    IMEBRA_FUNCTION_START();
+
+    std::unique_lock<std::recursive_mutex> lock(lockUnlessFrozen(m_mutex, m_bFrozen));
+
+    if(m_pFramesCache == 0)
+    {
+        FramesCacheStatistics statistics;
+        statistics.hits = statistics.misses = statistics.decodedFrames = statistics.decodingTime = statistics.maxDecodingTime = 0;
+        statistics.cachedFrames = statistics.usedMemory = 0;
+        return statistics;
+    }
+
+    return m_pFramesCache->getStatistics();
+
+    IMEBRA_FUNCTION_END();
+}
+
+void dataSet::resetFramesCacheStatistics()
+{
+    IMEBRA_FUNCTION_START();
+
+    std::unique_lock<std::recursive_mutex> lock(lockUnlessFrozen(m_mutex, m_bFrozen));
+
+    if(m_pFramesCache != 0)
+    {
+        m_pFramesCache->resetStatistics();
+    }
+
+    IMEBRA_FUNCTION_END();
+}
+
+
 ///////////////////////////////////////////////////////////
 ///////////////////////////////////////////////////////////
 //
@@ -349,10 +543,13 @@ std::shared_ptr<image> dataSet::getModalityImage(std::uint32_t frameNumber) cons
 {
     IMEBRA_FUNCTION_START();
 
-    std::lock_guard<std::recursive_mutex> lock(m_mutex);
-
+    // Don't hold the lock while getImage() waits for a frame
+    //  decoded in the background by the frames cache
+    ///////////////////////////////////////////////////////////
     std::shared_ptr<image> originalImage = getImage(frameNumber);
 
+    std::unique_lock<std::recursive_mutex> lock(lockUnlessFrozen(m_mutex, m_bFrozen));
+
     std::shared_ptr<transforms::colorTransforms::colorTransformsFactory> colorFactory(transforms::colorTransforms::colorTransformsFactory::getColorTransformsFactory());
     if(originalImage == 0 || !colorFactory->isMonochrome(originalImage->getColorSpace()))
     {
@@ -413,6 +610,11 @@ void dataSet::setImage(std::uint32_t frameNumber, std::shared_ptr<image> pImage,
 
     std::lock_guard<std::recursive_mutex> lock(m_mutex);
 
+    if(m_bFrozen)
+    {
+        IMEBRA_THROW(DataSetFrozenError, "The dataset is frozen and cannot be modified");
+    }
+
 	// bDontChangeAttributes is true if some images already
 	//  exist in the dataset and we must save the new image
 	//  using the attributes already stored
@@ -602,72 +804,389 @@ void dataSet::setImage(std::uint32_t frameNumber, std::shared_ptr<image> pImage,
 		return;
 	}
 
-	std::uint32_t calculatePosition(0);
-    std::shared_ptr<data> tag(getTag(groupId, 0, tagId));
-    for(std::uint32_t scanBuffers = 1; scanBuffers < firstBufferId; ++scanBuffers)
-	{
-        calculatePosition += (std::uint32_t)tag->getBufferSize(scanBuffers);
-		calculatePosition += 8;
-	}
-    std::shared_ptr<handlers::writingDataHandlerRaw> offsetHandler(getWritingDataHandlerRaw(groupId, 0, tagId, 0, dataHandlerType));
-    offsetHandler->setSize(4 * (frameNumber + 1));
-    std::shared_ptr<handlers::readingDataHandlerRaw> originalOffsetHandler(getReadingDataHandlerRaw(groupId, 0, tagId, 0));
-    originalOffsetHandler->copyTo(offsetHandler->getMemoryBuffer(), offsetHandler->getSize());
-	std::uint8_t* pOffsetFrame(offsetHandler->getMemoryBuffer() + (frameNumber * 4));
-	*( (std::uint32_t*)pOffsetFrame  ) = calculatePosition;
-	streamController::adjustEndian(pOffsetFrame, 4, streamController::lowByteEndian, 1);
+    updateOffsetTables(frameNumber, firstBufferId, dataHandlerType);
+
+	IMEBRA_FUNCTION_END();
+}
+
+
+///////////////////////////////////////////////////////////
+///////////////////////////////////////////////////////////
+//
+//
+// Insert several images, encoding them concurrently
+//
+//
+///////////////////////////////////////////////////////////
+///////////////////////////////////////////////////////////
+void dataSet::setImages(std::uint32_t firstFrame, const std::vector<std::shared_ptr<image> >& images, imageQuality_t quality)
+{
+    IMEBRA_FUNCTION_START();
+
+    // Fail before encoding the frames. appendEncodedFrame()
+    //  checks the frame number again while the dataset is
+    //  locked
+    ///////////////////////////////////////////////////////////
+    if(firstFrame != getUnsignedLong(0x0028, 0, 0x0008, 0, 0, 0))
+    {
+        IMEBRA_THROW(DataSetWrongFrameError, "The frames must be inserted in sequence");
+    }
+
+    // The calling thread encodes frames too, so this can be
+    //  called also by the tasks executed by the shared pool
+    ///////////////////////////////////////////////////////////
+    std::vector<std::shared_ptr<dataSet> > encodedFrames(images.size());
+    threadPool::getSharedThreadPool().executeParallel(images.size(), [&](size_t frame)
+    {
+        encodedFrames[frame] = encodeFrame(images[frame], quality);
+    });
+
+    // Insert the frames in order
+    ///////////////////////////////////////////////////////////
+    for(size_t scanFrames(0); scanFrames != encodedFrames.size(); ++scanFrames)
+    {
+        appendEncodedFrame(firstFrame + (std::uint32_t)scanFrames, *(encodedFrames[scanFrames]));
+    }
+
+    IMEBRA_FUNCTION_END();
+}
+
+
+///////////////////////////////////////////////////////////
+///////////////////////////////////////////////////////////
+//
+//
+// Decode the frames of another dataset and encode them
+//  into this one
+//
+//
+///////////////////////////////////////////////////////////
+///////////////////////////////////////////////////////////
+void dataSet::transcodeImages(std::shared_ptr<const dataSet> pSource, imageQuality_t quality)
+{
+    IMEBRA_FUNCTION_START();
+
+    const std::uint32_t numberOfFrames(pSource->getUnsignedLong(0x0028, 0, 0x0008, 0, 0, 1));
+    std::uint32_t appendFrame(getUnsignedLong(0x0028, 0, 0x0008, 0, 0, 0));
+
+    // Each call decodes and encodes one frame: process only a
+    //  few frames at once so the memory doesn't grow with
+    //  the number of frames. The calling thread transcodes
+    //  frames too
+    ///////////////////////////////////////////////////////////
+    threadPool& pool(threadPool::getSharedThreadPool());
+    const std::uint32_t maxFramesInFlight((std::uint32_t)pool.getThreadsNumber() * 2 + 1);
+    std::vector<std::shared_ptr<dataSet> > encodedFrames;
+
+    for(std::uint32_t firstFrame(0); firstFrame != numberOfFrames; )
+    {
+        const std::uint32_t framesCount(std::min(maxFramesInFlight, numberOfFrames - firstFrame));
+        encodedFrames.assign(framesCount, std::shared_ptr<dataSet>());
+        pool.executeParallel(framesCount, [&](size_t frame)
+        {
+            encodedFrames[frame] = encodeFrame(pSource->getImage(firstFrame + (std::uint32_t)frame), quality);
+        });
+
+        for(std::uint32_t scanFrames(0); scanFrames != framesCount; ++scanFrames)
+        {
+            appendEncodedFrame(appendFrame++, *(encodedFrames[scanFrames]));
+        }
+        firstFrame += framesCount;
+    }
+
+    IMEBRA_FUNCTION_END();
+}
+
+
+///////////////////////////////////////////////////////////
+//
+// Image attributes (group 0x0028) written by setImage()
+//  that must be identical in all the frames
+//
+///////////////////////////////////////////////////////////
+static const std::uint16_t imageAttributes[] =
+{
+    0x0002, // Samples per pixel
+    0x0006, // Planar configuration
+    0x0010, // Rows
+    0x0011, // Columns
+    0x0100, // Bits allocated
+    0x0101, // Bits stored
+    0x0102, // High bit
+    0x0103  // Pixel representation
+};
+
+
+///////////////////////////////////////////////////////////
+///////////////////////////////////////////////////////////
+//
+//
+// Copy the image attributes
+//
+//
+///////////////////////////////////////////////////////////
+///////////////////////////////////////////////////////////
+void dataSet::copyImageAttributes(const dataSet& source)
+{
+    IMEBRA_FUNCTION_START();
+
+    setString(0x0028, 0, 0x0004, 0, source.getString(0x0028, 0, 0x0004, 0, 0));
+    for(size_t scanAttributes(0); scanAttributes != sizeof(imageAttributes) / sizeof(imageAttributes[0]); ++scanAttributes)
+    {
+        if(source.bufferExists(0x0028, 0, imageAttributes[scanAttributes], 0))
+        {
+            setUnsignedLong(0x0028, 0, imageAttributes[scanAttributes], 0, source.getUnsignedLong(0x0028, 0, imageAttributes[scanAttributes], 0, 0));
+        }
+    }
+
+    IMEBRA_FUNCTION_END();
+}
+
+
+///////////////////////////////////////////////////////////
+///////////////////////////////////////////////////////////
+//
+//
+// Compare the image attributes
+//
+//
+///////////////////////////////////////////////////////////
+///////////////////////////////////////////////////////////
+bool dataSet::sameImageAttributes(const dataSet& other) const
+{
+    IMEBRA_FUNCTION_START();
+
+    if(other.getString(0x0028, 0, 0x0004, 0, 0) != getString(0x0028, 0, 0x0004, 0, 0))
+    {
+        return false;
+    }
+    for(size_t scanAttributes(0); scanAttributes != sizeof(imageAttributes) / sizeof(imageAttributes[0]); ++scanAttributes)
+    {
+        if(other.getUnsignedLong(0x0028, 0, imageAttributes[scanAttributes], 0, 0, 0) !=
+                getUnsignedLong(0x0028, 0, imageAttributes[scanAttributes], 0, 0, 0))
+        {
+            return false;
+        }
+    }
+    return true;
+
+    IMEBRA_FUNCTION_END();
+}
+
+
+///////////////////////////////////////////////////////////
+///////////////////////////////////////////////////////////
+//
+//
+// Encode an image into a temporary dataset
+//
+//
+///////////////////////////////////////////////////////////
+///////////////////////////////////////////////////////////
+std::shared_ptr<dataSet> dataSet::encodeFrame(std::shared_ptr<image> pImage, imageQuality_t quality) const
+{
+    IMEBRA_FUNCTION_START();
+
+    std::shared_ptr<dataSet> pFrameDataSet(std::make_shared<dataSet>(getString(0x0002, 0x0, 0x0010, 0, 0, "1.2.840.10008.1.2")));
+    if(bufferExists(0x0028, 0, 0x0006, 0))
+    {
+        pFrameDataSet->setUnsignedLong(0x0028, 0, 0x0006, 0, getUnsignedLong(0x0028, 0, 0x0006, 0, 0));
+    }
+    pFrameDataSet->setImage(0, pImage, quality);
+
+    return pFrameDataSet;
+
+    IMEBRA_FUNCTION_END();
+}
+
+
+///////////////////////////////////////////////////////////
+///////////////////////////////////////////////////////////
+//
+//
+// Append a frame encoded by encodeFrame()
+//
+//
+///////////////////////////////////////////////////////////
+///////////////////////////////////////////////////////////
+void dataSet::appendEncodedFrame(std::uint32_t frameNumber, const dataSet& frameDataSet)
+{
+    IMEBRA_FUNCTION_START();
+
+    std::lock_guard<std::recursive_mutex> lock(m_mutex);
+
+    if(m_bFrozen)
+    {
+        IMEBRA_THROW(DataSetFrozenError, "The dataset is frozen and cannot be modified");
+    }
+
+    // Another thread may have inserted a frame since the
+    //  caller checked the frame number
+    ///////////////////////////////////////////////////////////
+    if(frameNumber != getUnsignedLong(0x0028, 0, 0x0008, 0, 0, 0))
+    {
+        IMEBRA_THROW(DataSetWrongFrameError, "The frames must be inserted in sequence");
+    }
+
+    if(frameNumber == 0)
+    {
+        copyImageAttributes(frameDataSet);
+    }
+    else if(!sameImageAttributes(frameDataSet))
+    {
+        IMEBRA_THROW(DataSetDifferentFormatError, "An image already exists in the dataset and has different attributes");
+    }
+
+    std::shared_ptr<data> pFramePixelData(frameDataSet.getTag(0x7fe0, 0, 0x0010));
+    const tagVR_t dataType(pFramePixelData->getDataType());
+    std::shared_ptr<data> pPixelData(getTagCreate(0x7fe0, 0, 0x0010, dataType));
+
+    // Native frame: append the frame to the first buffer.
+    // The reading handler pads the frame to an even length,
+    //  while setImage() appends the frame written by the
+    //  codec without padding: cut the frame to the codec's
+    //  frame size so the following frames are not shifted
+    ///////////////////////////////////////////////////////////
+    if(!pFramePixelData->bufferExists(1))
+    {
+        std::shared_ptr<handlers::readingDataHandlerRaw> frameHandler(pFramePixelData->getReadingDataHandlerRaw(0));
+        size_t frameSize(codecs::codecFactory::getCodecFactory()->getImageCodec(getString(0x0002, 0x0, 0x0010, 0, 0, "1.2.840.10008.1.2"))->getFrameSize(frameDataSet, dataType));
+        if(frameSize == 0 || frameSize > frameHandler->getSize())
+        {
+            frameSize = frameHandler->getSize();
+        }
+        std::shared_ptr<memory> frameMemory(std::make_shared<memory>(frameSize));
+        ::memcpy(frameMemory->data(), frameHandler->getMemoryBuffer(), frameSize);
+        pPixelData->getBufferCreate(0)->appendMemory(frameMemory);
+
+        m_imagesPositions.clear();
+        setUnsignedLong(0x0028, 0, 0x0008, 0, frameNumber + 1);
+        return;
+    }
+
+    // Encapsulated frame: append the fragments after the
+    //  existing ones and update the offset tables
+    ///////////////////////////////////////////////////////////
+    if(!pPixelData->bufferExists(0))
+    {
+        getWritingDataHandlerRaw(0x7fe0, 0, 0x0010, 0, dataType)->setSize(0);
+    }
+    else if(frameNumber != 0 && !pPixelData->bufferExists(1))
+    {
+        IMEBRA_THROW(DataSetDifferentFormatError, "The existing frames are not encapsulated");
+    }
+
+    const std::uint32_t firstBufferId(getFirstAvailFrameBufferId());
+    for(size_t scanBuffers(1); pFramePixelData->bufferExists(scanBuffers); ++scanBuffers)
+    {
+        std::shared_ptr<handlers::readingDataHandlerRaw> fragmentHandler(pFramePixelData->getReadingDataHandlerRaw(scanBuffers));
+        std::shared_ptr<handlers::writingDataHandlerRaw> destinationHandler(getWritingDataHandlerRaw(0x7fe0, 0, 0x0010, firstBufferId + scanBuffers - 1, dataType));
+        destinationHandler->setSize(fragmentHandler->getSize());
+        ::memcpy(destinationHandler->getMemoryBuffer(), fragmentHandler->getMemoryBuffer(), fragmentHandler->getSize());
+    }
 
-	IMEBRA_FUNCTION_END();
+    m_imagesPositions.clear();
+    setUnsignedLong(0x0028, 0, 0x0008, 0, frameNumber + 1);
+
+    updateOffsetTables(frameNumber, firstBufferId, dataType);
+
+    IMEBRA_FUNCTION_END();
 }
 
 
 ///////////////////////////////////////////////////////////
 ///////////////////////////////////////////////////////////
 //
-// Get the offset, in bytes, of the specified frame
+//
+// Append the offset of the last frame to the offset
+//  tables
+//
 //
 ///////////////////////////////////////////////////////////
 ///////////////////////////////////////////////////////////
-std::uint32_t dataSet::getFrameOffset(std::uint32_t frameNumber) const
+void dataSet::updateOffsetTables(std::uint32_t frameNumber, std::uint32_t firstBufferId, tagVR_t dataType)
 {
     IMEBRA_FUNCTION_START();
 
-    try
+    std::shared_ptr<data> tag(getTag(0x7fe0, 0, 0x0010));
+
+    std::uint64_t calculatePosition(0);
+    for(std::uint32_t scanBuffers = 1; scanBuffers < firstBufferId; ++scanBuffers)
     {
-        // Retrieve the buffer containing the offsets
-        ///////////////////////////////////////////////////////////
-        std::shared_ptr<handlers::readingDataHandlerRaw> framesPointer = getReadingDataHandlerRaw(0x7fe0, 0x0, 0x0010, 0);
+        calculatePosition += tag->getBufferSize(scanBuffers);
+        calculatePosition += 8;
+    }
 
-        // Get the offset table's size, in number of offsets
-        ///////////////////////////////////////////////////////////
-        std::uint32_t offsetsCount = (std::uint32_t)(framesPointer->getSize() / sizeof(std::uint32_t));
+    // Use the basic offset table while the offsets fit in
+    //  32 bits. The new offset is appended to the table
+    //  when the table contains the previous frames
+    ///////////////////////////////////////////////////////////
+    if(calculatePosition <= std::numeric_limits<std::uint32_t>::max() && !bufferExists(0x7fe0, 0, 0x0001, 0))
+    {
+        std::shared_ptr<memory> offsetMemory(std::make_shared<memory>(4));
+        *( (std::uint32_t*)offsetMemory->data()  ) = (std::uint32_t)calculatePosition;
+        streamController::adjustEndian(offsetMemory->data(), 4, streamController::lowByteEndian, 1);
 
-        // If the requested frame doesn't exist then return
-        //  0xffffffff (the maximum value)
-        ///////////////////////////////////////////////////////////
-        if(frameNumber >= offsetsCount && frameNumber != 0)
+        std::shared_ptr<buffer> offsetBuffer(tag->getBufferCreate(0));
+        if(offsetBuffer->getBufferSizeBytes() == 4 * (size_t)frameNumber)
         {
-            return std::numeric_limits<std::uint32_t>::max();
+            offsetBuffer->appendMemory(offsetMemory);
+            return;
         }
 
-        // Return the requested offset. If the requested frame is
-        //  the first and is offset is not specified, then return
-        //  0 (the first position)
-        ///////////////////////////////////////////////////////////
-        if(frameNumber < offsetsCount)
-        {
-            std::uint32_t* pOffsets = (std::uint32_t*)(framesPointer->getMemoryBuffer());
-            std::uint32_t returnOffset(pOffsets[frameNumber]);
-            streamController::adjustEndian((std::uint8_t*)&returnOffset, 4, streamController::lowByteEndian);
-            return returnOffset;
-        }
-        return 0;
+        std::shared_ptr<handlers::writingDataHandlerRaw> offsetHandler(getWritingDataHandlerRaw(0x7fe0, 0, 0x0010, 0, dataType));
+        offsetHandler->setSize(4 * (frameNumber + 1));
+        std::shared_ptr<handlers::readingDataHandlerRaw> originalOffsetHandler(getReadingDataHandlerRaw(0x7fe0, 0, 0x0010, 0));
+        originalOffsetHandler->copyTo(offsetHandler->getMemoryBuffer(), offsetHandler->getSize());
+        ::memcpy(offsetHandler->getMemoryBuffer() + (frameNumber * 4), offsetMemory->data(), 4);
+        return;
     }
-    catch(const MissingDataElementError&)
+
+    // The extended offset table can be used only when each
+    //  frame is stored in one fragment
+    ///////////////////////////////////////////////////////////
+    if(tag->getBuffersCount() != (size_t)frameNumber + 2)
+    {
+        IMEBRA_THROW(DataSetCorruptedOffsetTableError, "The frames offsets don't fit in the basic offset table and the frames are fragmented");
+    }
+
+    // Append the new frame to the extended offset table when
+    //  the table contains the previous frames: the table is
+    //  built only once, when the basic offset table overflows
+    ///////////////////////////////////////////////////////////
+    if(bufferExists(0x7fe0, 0, 0x0001, 0) && bufferExists(0x7fe0, 0, 0x0002, 0) &&
+            getTag(0x7fe0, 0, 0x0001)->getBufferSize(0) == 8 * (size_t)frameNumber &&
+            getTag(0x7fe0, 0, 0x0002)->getBufferSize(0) == 8 * (size_t)frameNumber)
     {
-        return 0xffffffff;
+        const std::uint64_t frameLength(tag->getBufferSize(frameNumber + 1));
+        std::shared_ptr<memory> offsetMemory(std::make_shared<memory>(8));
+        std::shared_ptr<memory> lengthMemory(std::make_shared<memory>(8));
+        ::memcpy(offsetMemory->data(), &calculatePosition, 8);
+        ::memcpy(lengthMemory->data(), &frameLength, 8);
+        getTagCreate(0x7fe0, 0, 0x0001, tagVR_t::OV)->getBufferCreate(0)->appendMemory(offsetMemory);
+        getTagCreate(0x7fe0, 0, 0x0002, tagVR_t::OV)->getBufferCreate(0)->appendMemory(lengthMemory);
+        return;
     }
 
+    std::shared_ptr<handlers::writingDataHandlerRaw> offsetsHandler(getWritingDataHandlerRaw(0x7fe0, 0, 0x0001, 0, tagVR_t::OV));
+    std::shared_ptr<handlers::writingDataHandlerRaw> lengthsHandler(getWritingDataHandlerRaw(0x7fe0, 0, 0x0002, 0, tagVR_t::OV));
+    offsetsHandler->setSize(8 * ((size_t)frameNumber + 1));
+    lengthsHandler->setSize(8 * ((size_t)frameNumber + 1));
+
+    std::uint64_t framePosition(0);
+    for(std::uint32_t scanFrames(0); scanFrames <= frameNumber; ++scanFrames)
+    {
+        const std::uint64_t frameLength(tag->getBufferSize(scanFrames + 1));
+        ::memcpy(offsetsHandler->getMemoryBuffer() + scanFrames * 8, &framePosition, 8);
+        ::memcpy(lengthsHandler->getMemoryBuffer() + scanFrames * 8, &frameLength, 8);
+        framePosition += frameLength + 8;
+    }
+
+    // The basic offset table must be empty when the extended
+    //  offset table is present
+    ///////////////////////////////////////////////////////////
+    getWritingDataHandlerRaw(0x7fe0, 0, 0x0010, 0, dataType)->setSize(0);
+
     IMEBRA_FUNCTION_END();
 }
 
@@ -675,49 +1194,171 @@ std::uint32_t dataSet::getFrameOffset(std::uint32_t frameNumber) const
 ///////////////////////////////////////////////////////////
 ///////////////////////////////////////////////////////////
 //
-// Return the buffer that starts at the specified offset
+//
+// Return the index that maps the frames to the fragments
+//
 //
 ///////////////////////////////////////////////////////////
 ///////////////////////////////////////////////////////////
-std::uint32_t dataSet::getFrameBufferId(std::uint32_t offset) const
+const std::vector<dataSet::frameFragments>& dataSet::getFramesIndex(std::shared_ptr<data> pImageTag, std::uint32_t numberOfFrames) const
 {
     IMEBRA_FUNCTION_START();
 
-    std::shared_ptr<data> imageTag = getTag(0x7fe0, 0, 0x0010);
+    // The index built by freeze() doesn't change anymore
+    ///////////////////////////////////////////////////////////
+    if(m_bFramesIndexFrozen)
+    {
+        return m_framesIndex;
+    }
+
+    // The callers don't hold the lock when the dataset is
+    //  frozen
+    ///////////////////////////////////////////////////////////
+    std::lock_guard<std::recursive_mutex> lock(m_mutex);
+
+    // The index is still valid if neither the fragments nor
+    //  the extended offset table changed
+    ///////////////////////////////////////////////////////////
+    std::shared_ptr<data> pOffsetsTag;
+    tGroups::const_iterator findGroup(m_groups.find(0x7fe0));
+    if(findGroup != m_groups.end() && !findGroup->second.empty())
+    {
+        tTags::const_iterator findTag(findGroup->second.front().find(0x0001));
+        if(findTag != findGroup->second.front().end())
+        {
+            pOffsetsTag = findTag->second;
+        }
+    }
+    const std::uint64_t buffersVersion(pImageTag->getBuffersVersion());
+    const std::uint64_t offsetsVersion(pOffsetsTag == 0 ? 0 : pOffsetsTag->getBuffersVersion());
+
+    if(m_pFramesIndexTag == pImageTag && m_framesIndexVersion == buffersVersion &&
+            m_pFramesIndexOffsetsTag == pOffsetsTag && m_framesIndexOffsetsVersion == offsetsVersion &&
+            m_framesIndex.size() == numberOfFrames)
+    {
+        return m_framesIndex;
+    }
+
+    m_framesIndex.clear();
+    m_pFramesIndexTag.reset();
+    m_pFramesIndexOffsetsTag.reset();
 
-    // Start from the buffer n. 1 (the buffer 0 contains
-    //  the offset table
+    const size_t buffersCount(pImageTag->getBuffersCount());
+
+    if(buffersCount < 2 || numberOfFrames == 0)
+    {
+        IMEBRA_THROW(DataSetCorruptedOffsetTableError, "The pixel data doesn't contain any fragment");
+    }
+
+    // Position of each fragment from the beginning of the
+    //  first one, including the items' headers. The last
+    //  element is the position past the last fragment
     ///////////////////////////////////////////////////////////
-    std::uint32_t scanBuffers(1);
+    std::vector<std::uint64_t> fragmentsPositions;
+    fragmentsPositions.reserve(buffersCount);
+    std::uint64_t position(0);
+    for(size_t scanBuffers(1); scanBuffers != buffersCount; ++scanBuffers)
+    {
+        fragmentsPositions.push_back(position);
+        position += pImageTag->getBufferSize(scanBuffers) + 8;
+    }
+    fragmentsPositions.push_back(position);
 
-    if(offset == std::numeric_limits<std::uint32_t>::max())
+    // Get the frames offsets from the extended offset table
+    //  or from the basic offset table
+    ///////////////////////////////////////////////////////////
+    std::vector<std::uint64_t> offsets;
+    if(bufferExists(0x7fe0, 0, 0x0001, 0) && getDataType(0x7fe0, 0, 0x0001) == tagVR_t::OV)
+    {
+        std::shared_ptr<handlers::readingDataHandlerRaw> offsetsHandler(getReadingDataHandlerRaw(0x7fe0, 0, 0x0001, 0));
+        if(offsetsHandler->getSize() >= (size_t)numberOfFrames * 8)
+        {
+            offsets.resize(numberOfFrames);
+            ::memcpy(offsets.data(), offsetsHandler->getMemoryBuffer(), (size_t)numberOfFrames * 8);
+        }
+    }
+    if(offsets.empty())
     {
-        while(imageTag->bufferExists(scanBuffers))
+        std::shared_ptr<handlers::readingDataHandlerRaw> offsetsHandler(pImageTag->getReadingDataHandlerRaw(0));
+        if(offsetsHandler->getSize() != 0 && offsetsHandler->getSize() >= (size_t)numberOfFrames * 4)
         {
-            ++scanBuffers;
+            offsets.reserve(numberOfFrames);
+            for(std::uint32_t scanOffsets(0); scanOffsets != numberOfFrames; ++scanOffsets)
+            {
+                std::uint32_t offset;
+                ::memcpy(&offset, offsetsHandler->getMemoryBuffer() + scanOffsets * 4, 4);
+                streamController::adjustEndian((std::uint8_t*)&offset, 4, streamController::lowByteEndian);
+                offsets.push_back(offset);
+            }
         }
-        return scanBuffers;
     }
 
-    while(offset != 0)
+    // Find the first fragment of each frame
+    ///////////////////////////////////////////////////////////
+    std::vector<std::uint32_t> firstBuffers;
+    firstBuffers.reserve(numberOfFrames);
+    if(!offsets.empty())
+    {
+        for(std::vector<std::uint64_t>::const_iterator scanOffsets(offsets.begin()), endOffsets(offsets.end()); scanOffsets != endOffsets; ++scanOffsets)
+        {
+            std::vector<std::uint64_t>::const_iterator findFragment(std::lower_bound(fragmentsPositions.begin(), fragmentsPositions.end() - 1, *scanOffsets));
+            const std::uint32_t bufferId((std::uint32_t)(findFragment - fragmentsPositions.begin()) + 1);
+            if(findFragment == fragmentsPositions.end() - 1 || *findFragment != *scanOffsets || (!firstBuffers.empty() && firstBuffers.back() >= bufferId))
+            {
+                IMEBRA_THROW(DataSetCorruptedOffsetTableError, "The offset table is corrupted");
+            }
+            firstBuffers.push_back(bufferId);
+        }
+    }
+    else if(buffersCount - 1 == numberOfFrames)
+    {
+        for(std::uint32_t scanFrames(0); scanFrames != numberOfFrames; ++scanFrames)
+        {
+            firstBuffers.push_back(scanFrames + 1);
+        }
+    }
+    else
     {
-        // Calculate the total size of the buffer, including
-        //  its descriptor (tag group and id and length)
+        // The offset tables are empty: a new frame starts with
+        //  each fragment that begins with a JPEG SOI or a
+        //  JPEG2000 SOC marker. Only the markers are read
         ///////////////////////////////////////////////////////////
-        std::uint32_t bufferSize = (std::uint32_t)imageTag->getBufferSize(scanBuffers);;
-        bufferSize += 4; // one WORD for the group id, one WORD for the tag id
-        bufferSize += 4; // one DWORD for the tag length
-        if(bufferSize > offset)
+        firstBuffers.push_back(1);
+        for(std::uint32_t scanBuffers(2); numberOfFrames != 1 && scanBuffers != (std::uint32_t)buffersCount; ++scanBuffers)
+        {
+            std::uint8_t pFragment[2];
+            if(pImageTag->getBuffer(scanBuffers)->copyFirstBytes(pFragment, 2) == 2 && pFragment[0] == 0xff && (pFragment[1] == 0xd8 || pFragment[1] == 0x4f))
+            {
+                firstBuffers.push_back(scanBuffers);
+            }
+        }
+        if(firstBuffers.size() != numberOfFrames)
         {
-            IMEBRA_THROW(DataSetImageDoesntExistError, "Image not in the offset table");
+            IMEBRA_THROW(DataSetCorruptedOffsetTableError, "The offset table is empty and the frames cannot be located");
         }
-        offset -= bufferSize;
-        ++scanBuffers;
     }
 
-    return scanBuffers;
+    // Build the index
+    ///////////////////////////////////////////////////////////
+    std::vector<frameFragments> framesIndex(numberOfFrames);
+    for(std::uint32_t scanFrames(0); scanFrames != numberOfFrames; ++scanFrames)
+    {
+        frameFragments& fragments(framesIndex[scanFrames]);
+        fragments.m_firstBuffer = firstBuffers[scanFrames];
+        fragments.m_endBuffer = (scanFrames + 1 == numberOfFrames) ? (std::uint32_t)buffersCount : firstBuffers[scanFrames + 1];
+        fragments.m_length = (size_t)(fragmentsPositions[fragments.m_endBuffer - 1] - fragmentsPositions[fragments.m_firstBuffer - 1] -
+                                      8 * (std::uint64_t)(fragments.m_endBuffer - fragments.m_firstBuffer));
+    }
+
+    m_framesIndex.swap(framesIndex);
+    m_pFramesIndexTag = pImageTag;
+    m_framesIndexVersion = buffersVersion;
+    m_pFramesIndexOffsetsTag = pOffsetsTag;
+    m_framesIndexOffsetsVersion = offsetsVersion;
 
-	IMEBRA_FUNCTION_END();
+    return m_framesIndex;
+
+    IMEBRA_FUNCTION_END();
 }
 
 
@@ -735,37 +1376,22 @@ size_t dataSet::getFrameBufferIds(std::uint32_t frameNumber, std::uint32_t* pFir
 {
     IMEBRA_FUNCTION_START();
 
-    std::lock_guard<std::recursive_mutex> lock(m_mutex);
+    std::unique_lock<std::recursive_mutex> lock(lockUnlessFrozen(m_mutex, m_bFrozen));
 
     try
     {
-        std::uint32_t startOffset = getFrameOffset(frameNumber);
-        std::uint32_t endOffset = getFrameOffset(frameNumber + 1);
+        std::shared_ptr<data> imageTag(getTag(0x7fe0, 0, 0x0010));
 
-        if(startOffset == std::numeric_limits<std::int32_t>::max())
+        std::uint32_t numberOfFrames = getUnsignedLong(0x0028, 0, 0x0008, 0, 0, 1);
+        if(frameNumber >= numberOfFrames)
         {
             IMEBRA_THROW(DataSetImageDoesntExistError, "Image not in the table offset");
         }
 
-        *pFirstBuffer = getFrameBufferId(startOffset);
-        *pEndBuffer = getFrameBufferId(endOffset);
-
-        std::shared_ptr<data> imageTag;
-        try
-        {
-            imageTag = getTag(0x7fe0, 0, 0x0010);
-        }
-        catch(MissingDataElementError& e)
-        {
-            return 0;
-        }
-
-        size_t totalSize(0);
-        for(std::uint32_t scanBuffers(*pFirstBuffer); scanBuffers != *pEndBuffer; ++scanBuffers)
-        {
-            totalSize += imageTag->getBufferSize(scanBuffers);
-        }
-        return totalSize;
+        const frameFragments& fragments(getFramesIndex(imageTag, numberOfFrames)[frameNumber]);
+        *pFirstBuffer = fragments.m_firstBuffer;
+        *pEndBuffer = fragments.m_endBuffer;
+        return fragments.m_length;
     }
     catch(const MissingDataElementError&)
     {
@@ -853,7 +1479,7 @@ std::shared_ptr<lut> dataSet::getLut(std::uint16_t groupId, std::uint16_t tagId,
 {
     IMEBRA_FUNCTION_START();
 
-    std::lock_guard<std::recursive_mutex> lock(m_mutex);
+    std::unique_lock<std::recursive_mutex> lock(lockUnlessFrozen(m_mutex, m_bFrozen));
 
     std::shared_ptr<dataSet> embeddedLUT = getSequenceItem(groupId, 0, tagId, lutId);
     std::shared_ptr<handlers::readingDataHandlerNumericBase> descriptorHandle = embeddedLUT->getReadingDataHandlerNumeric(0x0028, 0x0, 0x3002, 0x0);
@@ -907,6 +1533,95 @@ vois_t dataSet::getVOIs()
 }
 
 
+///////////////////////////////////////////////////////////
+///////////////////////////////////////////////////////////
+//
+//
+// Return a value from the hot values cache
+//
+//
+///////////////////////////////////////////////////////////
+///////////////////////////////////////////////////////////
+template <typename value_t>
+value_t dataSet::getHotValue(std::uint16_t groupId, std::uint32_t order, std::uint16_t tagId, size_t bufferId, size_t elementNumber, hotValueType_t type, value_t hotValueData::* pValue) const
+{
+    IMEBRA_FUNCTION_START();
+
+    const size_t entry(((size_t)groupId * 31u + (size_t)tagId * 7u + (size_t)order * 131u + bufferId * 17u + elementNumber * 3u + (size_t)type) % m_hotValuesCacheSize);
+
+    std::shared_ptr<data> pTag;
+    std::uint64_t buffersVersion(0);
+    std::shared_ptr<handlers::readingDataHandler> pHandler;
+    {
+        std::lock_guard<std::recursive_mutex> lock(m_mutex);
+
+        if(m_pHotValues == 0)
+        {
+            m_pHotValues.reset(new tHotValues);
+        }
+
+        const hotValue& cachedValue((*m_pHotValues)[entry]);
+        const std::shared_ptr<data> pCachedTag(cachedValue.m_pTag.lock());
+        if(pCachedTag != 0 &&
+                cachedValue.m_groupId == groupId &&
+                cachedValue.m_order == order &&
+                cachedValue.m_tagId == tagId &&
+                cachedValue.m_bufferId == bufferId &&
+                cachedValue.m_elementNumber == elementNumber &&
+                cachedValue.m_type == type &&
+                cachedValue.m_buffersVersion == pCachedTag->getBuffersVersion())
+        {
+            return cachedValue.m_value.*pValue;
+        }
+
+        // Read the version before the content: if the buffers
+        //  change meanwhile then the entry is just discarded
+        //  on the next call
+        ///////////////////////////////////////////////////////////
+        pTag = getTag(groupId, order, tagId);
+        buffersVersion = pTag->getBuffersVersion();
+        pHandler = pTag->getReadingDataHandler(bufferId);
+    }
+
+    // Convert the value without holding the lock
+    ///////////////////////////////////////////////////////////
+    hotValue value;
+    switch(type)
+    {
+    case hotValueType_t::signedLong:
+        value.m_value.m_signedLong = pHandler->getSignedLong(elementNumber);
+        break;
+    case hotValueType_t::unsignedLong:
+        value.m_value.m_unsignedLong = pHandler->getUnsignedLong(elementNumber);
+        break;
+    case hotValueType_t::doubleValue:
+        value.m_value.m_double = pHandler->getDouble(elementNumber);
+        break;
+    case hotValueType_t::stringValue:
+        value.m_value.m_string = pHandler->getString(elementNumber);
+        break;
+    }
+
+    value.m_groupId = groupId;
+    value.m_order = order;
+    value.m_tagId = tagId;
+    value.m_bufferId = bufferId;
+    value.m_elementNumber = elementNumber;
+    value.m_type = type;
+    value.m_pTag = pTag;
+    value.m_buffersVersion = buffersVersion;
+
+    {
+        std::lock_guard<std::recursive_mutex> lock(m_mutex);
+        (*m_pHotValues)[entry] = value;
+    }
+
+    return std::move(value.m_value.*pValue);
+
+    IMEBRA_FUNCTION_END();
+}
+
+
 ///////////////////////////////////////////////////////////
 ///////////////////////////////////////////////////////////
 //
@@ -920,7 +1635,12 @@ std::int32_t dataSet::getSignedLong(std::uint16_t groupId, std::uint32_t order,
 {
     IMEBRA_FUNCTION_START();
 
-    return getReadingDataHandler(groupId, order, tagId, bufferId)->getSignedLong(elementNumber);
+    if(isFrozen())
+    {
+        return getReadingDataHandler(groupId, order, tagId, bufferId)->getSignedLong(elementNumber);
+    }
+
+    return getHotValue(groupId, order, tagId, bufferId, elementNumber, hotValueType_t::signedLong, &hotValueData::m_signedLong);
 
 	IMEBRA_FUNCTION_END();
 }
@@ -957,6 +1677,11 @@ void dataSet::setSignedLong(std::uint16_t groupId, std::uint32_t order, std::uin
 
     std::lock_guard<std::recursive_mutex> lock(m_mutex);
 
+    if(m_bFrozen)
+    {
+        IMEBRA_THROW(DataSetFrozenError, "The dataset is frozen and cannot be modified");
+    }
+
     std::shared_ptr<handlers::writingDataHandler> dataHandler = getWritingDataHandler(groupId, order, tagId, bufferId, tagVR);
     dataHandler->setSize(1);
     dataHandler->setSignedLong(0, newValue);
@@ -988,7 +1713,12 @@ std::uint32_t dataSet::getUnsignedLong(std::uint16_t groupId, std::uint32_t orde
 {
     IMEBRA_FUNCTION_START();
 
-    return getReadingDataHandler(groupId, order, tagId, bufferId)->getUnsignedLong(elementNumber);
+    if(isFrozen())
+    {
+        return getReadingDataHandler(groupId, order, tagId, bufferId)->getUnsignedLong(elementNumber);
+    }
+
+    return getHotValue(groupId, order, tagId, bufferId, elementNumber, hotValueType_t::unsignedLong, &hotValueData::m_unsignedLong);
 
 	IMEBRA_FUNCTION_END();
 }
@@ -1025,6 +1755,11 @@ void dataSet::setUnsignedLong(std::uint16_t groupId, std::uint32_t order, std::u
 
     std::lock_guard<std::recursive_mutex> lock(m_mutex);
 
+    if(m_bFrozen)
+    {
+        IMEBRA_THROW(DataSetFrozenError, "The dataset is frozen and cannot be modified");
+    }
+
     std::shared_ptr<handlers::writingDataHandler> dataHandler = getWritingDataHandler(groupId, order, tagId, bufferId, tagVR);
     dataHandler->setSize(1);
     dataHandler->setUnsignedLong(0, newValue);
@@ -1056,7 +1791,12 @@ double dataSet::getDouble(std::uint16_t groupId, std::uint32_t order, std::uint1
 {
     IMEBRA_FUNCTION_START();
 
-    return getReadingDataHandler(groupId, order, tagId, bufferId)->getDouble(elementNumber);
+    if(isFrozen())
+    {
+        return getReadingDataHandler(groupId, order, tagId, bufferId)->getDouble(elementNumber);
+    }
+
+    return getHotValue(groupId, order, tagId, bufferId, elementNumber, hotValueType_t::doubleValue, &hotValueData::m_double);
 
 	IMEBRA_FUNCTION_END();
 }
@@ -1092,6 +1832,11 @@ void dataSet::setDouble(std::uint16_t groupId, std::uint32_t order, std::uint16_
 
     std::lock_guard<std::recursive_mutex> lock(m_mutex);
 
+    if(m_bFrozen)
+    {
+        IMEBRA_THROW(DataSetFrozenError, "The dataset is frozen and cannot be modified");
+    }
+
     std::shared_ptr<handlers::writingDataHandler> dataHandler = getWritingDataHandler(groupId, order, tagId, bufferId, tagVR);
     dataHandler->setSize(1);
     dataHandler->setDouble(0, newValue);
@@ -1122,7 +1867,12 @@ std::string dataSet::getString(std::uint16_t groupId, std::uint32_t order, std::
 {
     IMEBRA_FUNCTION_START();
 
-    return getReadingDataHandler(groupId, order, tagId, bufferId)->getString(elementNumber);
+    if(isFrozen())
+    {
+        return getReadingDataHandler(groupId, order, tagId, bufferId)->getString(elementNumber);
+    }
+
+    return getHotValue(groupId, order, tagId, bufferId, elementNumber, hotValueType_t::stringValue, &hotValueData::m_string);
 
 	IMEBRA_FUNCTION_END();
 }
@@ -1194,6 +1944,11 @@ void dataSet::setString(std::uint16_t groupId, std::uint32_t order, std::uint16_
 
     std::lock_guard<std::recursive_mutex> lock(m_mutex);
 
+    if(m_bFrozen)
+    {
+        IMEBRA_THROW(DataSetFrozenError, "The dataset is frozen and cannot be modified");
+    }
+
     std::shared_ptr<handlers::writingDataHandler> dataHandler = getWritingDataHandler(groupId, order, tagId, bufferId, tagVR);
     dataHandler->setSize(1);
     dataHandler->setString(0, newString);
@@ -1227,6 +1982,11 @@ void dataSet::setUnicodeString(std::uint16_t groupId, std::uint32_t order, std::
 
     std::lock_guard<std::recursive_mutex> lock(m_mutex);
 
+    if(m_bFrozen)
+    {
+        IMEBRA_THROW(DataSetFrozenError, "The dataset is frozen and cannot be modified");
+    }
+
     std::shared_ptr<handlers::writingDataHandler> dataHandler = getWritingDataHandler(groupId, order, tagId, bufferId, tagVR);
     dataHandler->setSize(1);
     dataHandler->setUnicodeString(0, newString);
@@ -1251,6 +2011,11 @@ void dataSet::setAge(std::uint16_t groupId, std::uint32_t order, std::uint16_t t
 
     std::lock_guard<std::recursive_mutex> lock(m_mutex);
 
+    if(m_bFrozen)
+    {
+        IMEBRA_THROW(DataSetFrozenError, "The dataset is frozen and cannot be modified");
+    }
+
     std::shared_ptr<handlers::writingDataHandler> dataHandler = getWritingDataHandler(groupId, order, tagId, bufferId, tagVR_t::AS);
     dataHandler->setSize(1);
     dataHandler->setAge(0, age, units);
@@ -1294,6 +2059,11 @@ void dataSet::setDate(std::uint16_t groupId, std::uint32_t order, std::uint16_t
 
     std::lock_guard<std::recursive_mutex> lock(m_mutex);
 
+    if(m_bFrozen)
+    {
+        IMEBRA_THROW(DataSetFrozenError, "The dataset is frozen and cannot be modified");
+    }
+
     std::shared_ptr<handlers::writingDataHandler> dataHandler = getWritingDataHandler(groupId, order, tagId, bufferId, tagVR);
     dataHandler->setSize(1);
     dataHandler->setDate(0, year, month, day, hour, minutes, seconds, nanoseconds, offsetHours, offsetMinutes);
@@ -1363,6 +2133,27 @@ void dataSet::getDate(std::uint16_t groupId, std::uint32_t order, std::uint16_t
 }
 
 
+///////////////////////////////////////////////////////////
+///////////////////////////////////////////////////////////
+//
+//
+// Empty the hot values cache
+//
+//
+///////////////////////////////////////////////////////////
+///////////////////////////////////////////////////////////
+void dataSet::clearHotValues()
+{
+    if(m_pHotValues != 0)
+    {
+        for(hotValue& value: *m_pHotValues)
+        {
+            value.m_pTag.reset();
+        }
+    }
+}
+
+
 ///////////////////////////////////////////////////////////
 ///////////////////////////////////////////////////////////
 //
@@ -1545,6 +2336,14 @@ void dataSet::updateCharsetTag()
 
     std::lock_guard<std::recursive_mutex> lock(m_mutex);
 
+    // The charsets of a frozen dataset cannot change: it is
+    //  saved as it is
+    ///////////////////////////////////////////////////////////
+    if(m_bFrozen)
+    {
+        return;
+    }
+
     charsetsList::tCharsetsList charsets;
 	getCharsetsList(&charsets);
     std::shared_ptr<handlers::writingDataHandler> charsetHandler(getWritingDataHandler(0x0008, 0, 0x0005, 0));
@@ -1574,6 +2373,11 @@ void dataSet::updateTagsCharset()
 
     std::lock_guard<std::recursive_mutex> lock(m_mutex);
 
+    if(m_bFrozen)
+    {
+        IMEBRA_THROW(DataSetFrozenError, "The dataset is frozen and cannot be modified");
+    }
+
     charsetsList::tCharsetsList charsets;
     try
     {
@@ -1598,15 +2402,82 @@ void dataSet::updateTagsCharset()
 ///////////////////////////////////////////////////////////
 //
 //
-// Set the item's position in the stream
+// Freeze the dataset
 //
 //
 ///////////////////////////////////////////////////////////
 ///////////////////////////////////////////////////////////
-void dataSet::setItemOffset(std::uint32_t offset)
+void dataSet::freeze()
 {
+    IMEBRA_FUNCTION_START();
+
     std::lock_guard<std::recursive_mutex> lock(m_mutex);
 
+    if(m_bFrozen)
+    {
+        return;
+    }
+
+    for(tGroups::iterator scanGroups(m_groups.begin()), endGroups(m_groups.end()); scanGroups != endGroups; ++scanGroups)
+    {
+        for(tGroupsList::iterator scanGroupsList(scanGroups->second.begin()), endGroupsList(scanGroups->second.end()); scanGroupsList != endGroupsList; ++scanGroupsList)
+        {
+            for(tTags::iterator scanTags((*scanGroupsList).begin()), endTags((*scanGroupsList).end()); scanTags != endTags; ++scanTags)
+            {
+                scanTags->second->freeze();
+            }
+        }
+    }
+
+    // Build the frames index now, so the frames of the frozen
+    //  dataset can be located without locking
+    ///////////////////////////////////////////////////////////
+    try
+    {
+        std::shared_ptr<data> imageTag(getTag(0x7fe0, 0, 0x0010));
+        if(imageTag->bufferExists(1))
+        {
+            getFramesIndex(imageTag, getUnsignedLong(0x0028, 0, 0x0008, 0, 0, 1));
+            m_bFramesIndexFrozen = true;
+        }
+    }
+    catch(const MissingDataElementError&)
+    {
+        // Nothing to do
+    }
+    catch(const DataSetCorruptedOffsetTableError&)
+    {
+        // The index will be rebuilt (and the error reported)
+        //  when a frame is requested
+    }
+
+    m_bFrozen.store(true, std::memory_order_release);
+
+    IMEBRA_FUNCTION_END();
+}
+
+
+bool dataSet::isFrozen() const
+{
+    return m_bFrozen.load(std::memory_order_acquire);
+}
+
+
+///////////////////////////////////////////////////////////
+///////////////////////////////////////////////////////////
+//
+//
+// Set the item's position in the stream
+//
+//
+///////////////////////////////////////////////////////////
+///////////////////////////////////////////////////////////
+void dataSet::setItemOffset(std::uint32_t offset)
+{
+    // The offset is updated also when a frozen dataset is
+    //  written, so it is atomic instead of being protected
+    //  by the mutex
+    ///////////////////////////////////////////////////////////
 	m_itemOffset = offset;
 }
 
@@ -1622,8 +2493,6 @@ void dataSet::setItemOffset(std::uint32_t offset)
 ///////////////////////////////////////////////////////////
 std::uint32_t dataSet::getItemOffset() const
 {
-    std::lock_guard<std::recursive_mutex> lock(m_mutex);
-
 	return m_itemOffset;
 }
 
@@ -1631,7 +2500,7 @@ void dataSet::getCharsetsList(charsetsList::tCharsetsList* pCharsetsList) const
 {
     IMEBRA_FUNCTION_START();
 
-    std::lock_guard<std::recursive_mutex> lock(m_mutex);
+    std::unique_lock<std::recursive_mutex> lock(lockUnlessFrozen(m_mutex, m_bFrozen));
 
     for(tGroups::const_iterator scanGroups(m_groups.begin()), endGroups(m_groups.end()); scanGroups != endGroups; ++scanGroups)
     {
@@ -1654,7 +2523,7 @@ dataSet::tGroupsIds dataSet::getGroups() const
 {
     IMEBRA_FUNCTION_START();
 
-    std::lock_guard<std::recursive_mutex> lock(m_mutex);
+    std::unique_lock<std::recursive_mutex> lock(lockUnlessFrozen(m_mutex, m_bFrozen));
 
     dataSet::tGroupsIds groups;
 
@@ -1672,7 +2541,7 @@ std::uint32_t dataSet::getGroupsNumber(uint16_t groupId) const
 {
     IMEBRA_FUNCTION_START();
 
-    std::lock_guard<std::recursive_mutex> lock(m_mutex);
+    std::unique_lock<std::recursive_mutex> lock(lockUnlessFrozen(m_mutex, m_bFrozen));
 
     dataSet::tGroups::const_iterator findGroup(m_groups.find(groupId));
 
@@ -1692,7 +2561,7 @@ const dataSet::tTags& dataSet::getGroupTags(std::uint16_t groupId, size_t groupO
 
     static const dataSet::tTags emptyTags;
 
-    std::lock_guard<std::recursive_mutex> lock(m_mutex);
+    std::unique_lock<std::recursive_mutex> lock(lockUnlessFrozen(m_mutex, m_bFrozen));
 
     tGroups::const_iterator findGroup(m_groups.find(groupId));
     if(findGroup == m_groups.end() || findGroup->second.size() <= groupOrder)
@@ -1711,7 +2580,13 @@ void dataSet::setCharsetsList(const charsetsList::tCharsetsList& charsetsList)
 
     std::lock_guard<std::recursive_mutex> lock(m_mutex);
 
+    if(m_bFrozen)
+    {
+        IMEBRA_THROW(DataSetFrozenError, "The dataset is frozen and cannot be modified");
+    }
+
     m_charsetsList = charsetsList;
+    clearHotValues();
     for(tGroups::iterator scanGroups(m_groups.begin()), endGroups(m_groups.end()); scanGroups != endGroups; ++scanGroups)
     {
         for(tGroupsList::iterator scanGroupsList(scanGroups->second.begin()), endGroupsList(scanGroups->second.end()); scanGroupsList != endGroupsList; ++scanGroupsList)
@@ -22,10 +22,12 @@ If you do not want to be bound by the GPL terms (such as the requirement
 #include "exceptionImpl.h"
 #include "streamCodecImpl.h"
 #include "dataImpl.h"
+#include <array>
 #include <vector>
 #include <memory>
 #include <set>
 #include <map>
+#include <atomic>
 #include <mutex>
 
 
@@ -42,6 +44,7 @@ namespace implementation
 class image;
 class lut;
 class waveform;
+class framesCache;
 
 /// \addtogroup group_dataset Dicom data
 /// \brief The Dicom dataset is represented by the
@@ -199,6 +202,55 @@ public:
     ///
     ///////////////////////////////////////////////////////////
     std::shared_ptr<image> getModalityImage(std::uint32_t frameNumber) const;
+
+    /// \brief Retrieve several consecutive frames, decoding
+    ///         them concurrently in the library's shared
+    ///         thread pool.
+    ///
+    /// @param firstFrame  the first frame to retrieve
+    /// @param framesCount the number of frames to retrieve
+    /// @return the decoded frames, in order
+    ///
+    ///////////////////////////////////////////////////////////
+    std::vector<std::shared_ptr<image> > getImages(std::uint32_t firstFrame, std::uint32_t framesCount) const;
+
+    /// \brief Enable the decoded frames cache.
+    ///
+    /// Once enabled, getImage() returns the frames kept in
+    ///  the cache and decodes in advance the next frames in
+    ///  the playback direction. The returned images are
+    ///  shared by the cache and must not be modified.
+    ///
+    /// The cache is emptied when the pixel data or the
+    ///  image attributes (group 0x0028) are modified.
+    ///
+    /// @param memoryBudget    the maximum memory, in bytes,
+    ///                         used by the decoded frames
+    /// @param readAheadFrames the number of frames decoded
+    ///                         in advance
+    ///
+    ///////////////////////////////////////////////////////////
+    void enableFramesCache(size_t memoryBudget, std::uint32_t readAheadFrames);
+
+    /// \brief Disable the decoded frames cache and release
+    ///         the cached frames.
+    ///
+    ///////////////////////////////////////////////////////////
+    void disableFramesCache();
+
+    /// \brief Return the statistics of the decoded frames
+    ///         cache.
+    ///
+    /// All the values are zero if the cache is not enabled.
+    ///
+    ///////////////////////////////////////////////////////////
+    FramesCacheStatistics getFramesCacheStatistics() const;
+
+    /// \brief Reset the hits, misses and decoding times
+    ///         collected by the decoded frames cache.
+    ///
+    ///////////////////////////////////////////////////////////
+    void resetFramesCacheStatistics();
 	
 	/// \brief Insert an image into the data set.
 	///
@@ -216,6 +268,59 @@ public:
 	///////////////////////////////////////////////////////////
     void setImage(std::uint32_t frameNumber, std::shared_ptr<image> pImage, imageQuality_t quality);
 
+    /// \brief Insert several images into the data set,
+    ///         encoding them concurrently in the library's
+    ///         shared thread pool.
+    ///
+    /// The frames are inserted in order, after the existing
+    ///  ones. All the images must have the attributes of the
+    ///  frames already stored in the dataset.
+    ///
+    /// @param firstFrame the frame number of the first image.
+    ///                   Must be equal to the number of frames
+    ///                   already in the dataset
+    /// @param images     the images to insert
+    /// @param quality    the compression quality
+    ///
+    ///////////////////////////////////////////////////////////
+    void setImages(std::uint32_t firstFrame, const std::vector<std::shared_ptr<image> >& images, imageQuality_t quality);
+
+    /// \brief Decode all the frames of another dataset and
+    ///         insert them after the existing frames, encoded
+    ///         with this dataset's transfer syntax.
+    ///
+    /// The frames are transcoded in small batches: the
+    ///  frames of a batch are decoded and encoded
+    ///  concurrently by the library's shared thread pool and
+    ///  by the calling thread, then inserted in order.
+    ///
+    /// @param pSource the dataset containing the frames
+    /// @param quality the compression quality
+    ///
+    ///////////////////////////////////////////////////////////
+    void transcodeImages(std::shared_ptr<const dataSet> pSource, imageQuality_t quality);
+
+    /// \brief Copy the image attributes written by
+    ///         setImage() that must be identical in all the
+    ///         frames (color space, samples per pixel, planar
+    ///         configuration, size and bit depth).
+    ///
+    /// @param source the dataset from which the attributes
+    ///                are copied
+    ///
+    ///////////////////////////////////////////////////////////
+    void copyImageAttributes(const dataSet& source);
+
+    /// \brief Compare the image attributes copied by
+    ///         copyImageAttributes().
+    ///
+    /// @param other the dataset to compare
+    /// @return true if all the image attributes are
+    ///          identical
+    ///
+    ///////////////////////////////////////////////////////////
+    bool sameImageAttributes(const dataSet& other) const;
+
     /// \brief Retrieve the first and the last buffers used
     ///         to store the image.
     ///
@@ -878,6 +983,9 @@ public:
 	///  stream is saved, therefore the application doesn't
 	///  need to call the function before saving the stream.
 	///
+	/// The function doesn't do anything when the dataSet
+	///  has been frozen.
+	///
 	///////////////////////////////////////////////////////////
 	void updateCharsetTag();
 
@@ -923,6 +1031,38 @@ public:
 
 	//@}
 
+
+	///////////////////////////////////////////////////////////
+	/// \name Read-only datasets
+	///
+	///////////////////////////////////////////////////////////
+	//@{
+
+	/// \brief Make the dataSet, its tags and its sequence
+	///         items read-only.
+	///
+	/// After the dataSet has been frozen the functions that
+	///  modify it throw DataSetFrozenError, while the
+	///  functions that read it (tags, handlers, images) don't
+	///  lock the mutexes of the dataSet, of its tags and of
+	///  their buffers, so many threads can read it
+	///  concurrently without contention.
+	///
+	/// The decoded frames cache must be enabled before the
+	///  dataSet is frozen.
+	///
+	/// A frozen dataSet cannot be unfrozen.
+	///
+	///////////////////////////////////////////////////////////
+	void freeze();
+
+	/// \brief Returns true if the dataSet has been frozen.
+	///
+	///////////////////////////////////////////////////////////
+	bool isFrozen() const;
+
+	//@}
+
     typedef std::map<std::uint16_t, std::shared_ptr<data> > tTags;
     typedef std::vector<tTags> tGroupsList;
     typedef std::map<std::uint16_t, tGroupsList> tGroups;
@@ -939,15 +1079,6 @@ public:
     void setCharsetsList(const charsetsList::tCharsetsList& charsetsList);
 
 private:
-    /// \brief Get a frame's offset from the offset table.
-    ///
-    /// @param frameNumber the number of the frame for which
-    ///                     the offset is requested
-    /// @return the offset for the specified frame
-    ///
-    ///////////////////////////////////////////////////////////
-    std::uint32_t getFrameOffset(std::uint32_t frameNumber) const;
-
     /// \brief Return the first buffer's id available where
     ///         a new frame can be saved.
     ///
@@ -957,23 +1088,201 @@ private:
     ///////////////////////////////////////////////////////////
     std::uint32_t getFirstAvailFrameBufferId() const;
 
-    mutable std::vector<size_t> m_imagesPositions;
+    /// \brief Describes the fragments (buffers) of the
+    ///         encapsulated pixel data that store a frame.
+    ///
+    ///////////////////////////////////////////////////////////
+    struct frameFragments
+    {
+        std::uint32_t m_firstBuffer; ///< first buffer
+        std::uint32_t m_endBuffer;   ///< buffer after the last
+        size_t m_length;             ///< total length in bytes
+    };
+
+    /// \brief Return the index that maps each frame to its
+    ///         fragments.
+    ///
+    /// The index is built the first time it is needed and
+    ///  rebuilt only when the pixel data or the number of
+    ///  frames change. It is built from the Extended Offset
+    ///  Table, the Basic Offset Table or, when both are
+    ///  empty, by looking for the first marker of the
+    ///  JPEG/JPEG2000 codestreams in each fragment.
+    ///
+    /// The caller must hold m_mutex.
+    ///
+    /// @param pImageTag      the encapsulated pixel data
+    /// @param numberOfFrames the number of frames
+    /// @return the frames index
+    ///
+    ///////////////////////////////////////////////////////////
+    const std::vector<frameFragments>& getFramesIndex(std::shared_ptr<data> pImageTag, std::uint32_t numberOfFrames) const;
 
-	// Position of the sequence item in the stream. Used to
-	//  parse DICOMDIR items
-	///////////////////////////////////////////////////////////
-	std::uint32_t m_itemOffset;
+    /// \brief Store the offset of the last frame into the
+    ///         Basic Offset Table, or into the Extended Offset
+    ///         Table when the offset doesn't fit in 32 bits.
+    ///
+    /// The offset is appended to the table when the table
+    ///  already contains the previous frames, so the tables
+    ///  are not rewritten for each new frame.
+    ///
+    /// @param frameNumber   the frame just added
+    /// @param firstBufferId the buffer containing the frame
+    /// @param dataType      the data type of the pixel data
+    ///
+    ///////////////////////////////////////////////////////////
+    void updateOffsetTables(std::uint32_t frameNumber, std::uint32_t firstBufferId, tagVR_t dataType);
+
+    /// \brief Decode a frame without using the decoded
+    ///         frames cache.
+    ///
+    /// @param frameNumber the frame to decode
+    /// @return the decoded frame
+    ///
+    ///////////////////////////////////////////////////////////
+    std::shared_ptr<image> decodeImage(std::uint32_t frameNumber) const;
+
+    /// \brief Encode an image into a new dataset that has the
+    ///         same transfer syntax and planar configuration
+    ///         of this dataset.
+    ///
+    /// Used to encode several frames concurrently before
+    ///  appending them with appendEncodedFrame().
+    ///
+    /// @param pImage  the image to encode
+    /// @param quality the compression quality
+    /// @return a dataset containing only the encoded frame
+    ///
+    ///////////////////////////////////////////////////////////
+    std::shared_ptr<dataSet> encodeFrame(std::shared_ptr<image> pImage, imageQuality_t quality) const;
+
+    /// \brief Append the frame encoded by encodeFrame().
+    ///
+    /// If the dataset doesn't contain any frame then the
+    ///  image attributes are copied from the encoded frame,
+    ///  otherwise they must be identical.
+    ///
+    /// Throws DataSetWrongFrameError if frameNumber is not
+    ///  the number of frames in the dataset.
+    ///
+    /// @param frameNumber  the number of the appended frame
+    /// @param frameDataSet the dataset returned by
+    ///                      encodeFrame()
+    ///
+    ///////////////////////////////////////////////////////////
+    void appendEncodedFrame(std::uint32_t frameNumber, const dataSet& frameDataSet);
 
-    /// \brief Get the id of the buffer that starts at the
-    ///         specified offset.
+    /// \brief Type of the values stored in the hot values
+    ///         cache.
+    ///
+    ///////////////////////////////////////////////////////////
+    enum class hotValueType_t
+    {
+        signedLong,
+        unsignedLong,
+        doubleValue,
+        stringValue
+    };
+
+    /// \brief A value returned by one of the scalar getters.
+    ///
+    ///////////////////////////////////////////////////////////
+    struct hotValueData
+    {
+        std::int32_t m_signedLong;
+        std::uint32_t m_unsignedLong;
+        double m_double;
+        std::string m_string;
+    };
+
+    /// \brief A value returned by one of the scalar getters,
+    ///         with the tag it was read from.
     ///
-    /// @param offset   one offset retrieved from the frames
-    ///                  offset table: see getFrameOffset()
-    /// @return         the id of the buffer that starts at
-    ///                  the specified offset
+    /// The value is valid while the version of the tag's
+    ///  buffers doesn't change: the version changes also when
+    ///  a buffer is replaced. The entry doesn't keep the tag
+    ///  alive: it becomes empty when the tag is released.
     ///
     ///////////////////////////////////////////////////////////
-    std::uint32_t getFrameBufferId(std::uint32_t offset) const;
+    struct hotValue
+    {
+        std::uint16_t m_groupId;
+        std::uint32_t m_order;
+        std::uint16_t m_tagId;
+        size_t m_bufferId;
+        size_t m_elementNumber;
+        hotValueType_t m_type;
+
+        std::weak_ptr<data> m_pTag; ///< expired if the entry is empty
+        std::uint64_t m_buffersVersion;
+
+        hotValueData m_value;
+    };
+
+    /// \brief Return the cached value of an element, reading
+    ///         it from the tag when it isn't cached or when
+    ///         the tag has been modified.
+    ///
+    /// The cache is a small direct mapped table: each element
+    ///  can be stored only in one entry, chosen from its id.
+    ///
+    /// The cache is accessed while holding m_mutex, but the
+    ///  value is converted without holding it. Frozen datasets
+    ///  don't use the cache because they are read without
+    ///  locking.
+    ///
+    /// @param groupId       the element's group
+    /// @param order         the group's order
+    /// @param tagId         the element's tag
+    /// @param bufferId      the element's buffer
+    /// @param elementNumber the element's number
+    /// @param type          the type of the value to return
+    /// @param pValue        the member of hotValueData that
+    ///                       stores the value
+    /// @return the value
+    ///
+    ///////////////////////////////////////////////////////////
+    template <typename value_t>
+    value_t getHotValue(std::uint16_t groupId, std::uint32_t order, std::uint16_t tagId, size_t bufferId, size_t elementNumber, hotValueType_t type, value_t hotValueData::* pValue) const;
+
+    /// \brief Empty the hot values cache.
+    ///
+    /// Called when a tag may get a new buffer or when the
+    ///  charsets change: in both cases the buffers' versions
+    ///  don't reveal that the cached values are stale.
+    ///
+    /// The caller must hold m_mutex.
+    ///
+    ///////////////////////////////////////////////////////////
+    void clearHotValues();
+
+    static const size_t m_hotValuesCacheSize = 16;
+    typedef std::array<hotValue, m_hotValuesCacheSize> tHotValues;
+    mutable std::unique_ptr<tHotValues> m_pHotValues;
+
+    mutable std::vector<size_t> m_imagesPositions;
+
+    // The frames index is valid while the pixel data tag and
+    //  the extended offset table keep the same buffers'
+    //  versions
+    ///////////////////////////////////////////////////////////
+    mutable std::vector<frameFragments> m_framesIndex;
+    mutable std::shared_ptr<data> m_pFramesIndexTag;
+    mutable std::uint64_t m_framesIndexVersion;
+    mutable std::shared_ptr<data> m_pFramesIndexOffsetsTag;
+    mutable std::uint64_t m_framesIndexOffsetsVersion;
+
+    // Set by freeze() when the frames index has been built:
+    //  after that the index doesn't change anymore
+    ///////////////////////////////////////////////////////////
+    bool m_bFramesIndexFrozen;
+
+    std::shared_ptr<framesCache> m_pFramesCache;
+
+	// Position of the sequence item in the stream. Used to
+	//  parse DICOMDIR items
+	///////////////////////////////////////////////////////////
+	std::atomic<std::uint32_t> m_itemOffset;
 
     tGroups m_groups;
 
@@ -982,6 +1291,8 @@ private:
     charsetsList::tCharsetsList m_charsetsList;
 
     mutable std::recursive_mutex m_mutex;
+
+    std::atomic<bool> m_bFrozen;
 };
 
 
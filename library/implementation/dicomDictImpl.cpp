@@ -72,6 +72,7 @@ dicomDictionary::dicomDictionary()
     registerVR(tagVR_t::OD, true,  8, 0);
     registerVR(tagVR_t::OF, true,  4, 0);
     registerVR(tagVR_t::OL, true,  4, 0);
+    registerVR(tagVR_t::OV, true,  8, 0);
     registerVR(tagVR_t::OW, true,  2, 0);
     registerVR(tagVR_t::PN, false, 0, 64);
     registerVR(tagVR_t::SH, false, 0, 16);
@@ -20,6 +20,8 @@ If you do not want to be bound by the GPL terms (such as the requirement
 #include <vector>
 #include <string.h>
 #include "exceptionImpl.h"
+#include "statisticsImpl.h"
+#include "tracingImpl.h"
 #include "streamReaderImpl.h"
 #include "streamWriterImpl.h"
 #include "memoryImpl.h"
@@ -30,6 +32,7 @@ If you do not want to be bound by the GPL terms (such as the requirement
 #include "colorTransformsFactoryImpl.h"
 #include "codecFactoryImpl.h"
 #include "bufferImpl.h"
+#include "threadPoolImpl.h"
 #include "../include/imebra/exceptions.h"
 
 namespace imebra
@@ -41,6 +44,180 @@ namespace implementation
 namespace codecs
 {
 
+// RLE segments of frames smaller than this amount of bytes
+//  are decoded by the calling thread
+///////////////////////////////////////////////////////////
+static const size_t minimumParallelRLESize(256 * 1024);
+
+///////////////////////////////////////////////////////////
+//
+// Clear the bits outside the mask of the samples decoded
+//  from a RLE stream and extend their sign
+//
+///////////////////////////////////////////////////////////
+template<typename sample_t>
+static void adjustRLESamples(sample_t* pSamples, size_t samplesNumber, std::uint32_t mask, bool b2Complement, std::uint8_t highBit)
+{
+    const std::uint32_t checkSign((std::uint32_t)1 << highBit);
+    const std::uint32_t orMask(b2Complement ? (std::uint32_t)-1 << highBit : 0);
+    for(; samplesNumber != 0; --samplesNumber, ++pSamples)
+    {
+        std::uint32_t value((std::uint32_t)*pSamples & mask);
+        if((value & checkSign) != 0)
+        {
+            value |= orMask;
+        }
+        *pSamples = (sample_t)value;
+    }
+}
+
+///////////////////////////////////////////////////////////
+//
+// Extract one byte of each sample of a channel, for the
+//  RLE segment that stores it
+//
+///////////////////////////////////////////////////////////
+template<typename sample_t>
+static void extractRLEPlane(const sample_t* pSamples, size_t samplesNumber, std::uint32_t channelsNumber, std::uint32_t channel, std::uint32_t mask, std::uint32_t rightShift, std::uint8_t* pPlane)
+{
+    pSamples += channel;
+    for(size_t pixelsNumber(samplesNumber / channelsNumber); pixelsNumber != 0; --pixelsNumber, pSamples += channelsNumber)
+    {
+        *(pPlane++) = (std::uint8_t)(((std::uint32_t)*pSamples & mask) >> rightShift);
+    }
+}
+
+// Packed pixels are unpacked and packed in bulk when
+//  reading or writing at least this amount of values
+///////////////////////////////////////////////////////////
+static const std::uint32_t minimumBulkPackedPixels(16);
+
+///////////////////////////////////////////////////////////
+//
+// Unpack values stored in a little endian bit stream
+//  (the first value starts at bit 0 of the first byte)
+//
+///////////////////////////////////////////////////////////
+static void unpackPixels(const std::uint8_t* pSource, std::int32_t* pDest, size_t numPixels, std::uint8_t allocatedBits, std::uint32_t mask)
+{
+    if(allocatedBits == 1)
+    {
+        for(; numPixels >= 8; numPixels -= 8, ++pSource)
+        {
+            const std::uint32_t sourceByte(*pSource);
+            for(std::uint32_t bit(0); bit != 8; ++bit)
+            {
+                *(pDest++) = (std::int32_t)((sourceByte >> bit) & 1 & mask);
+            }
+        }
+        for(std::uint32_t bit(0); numPixels != 0; --numPixels, ++bit)
+        {
+            *(pDest++) = (std::int32_t)((*pSource >> bit) & 1 & mask);
+        }
+        return;
+    }
+
+    if(allocatedBits == 12)
+    {
+        for(; numPixels >= 2; numPixels -= 2, pSource += 3)
+        {
+            *(pDest++) = (std::int32_t)(((std::uint32_t)pSource[0] | ((std::uint32_t)(pSource[1] & 0x0f) << 8)) & mask);
+            *(pDest++) = (std::int32_t)(((std::uint32_t)(pSource[1] >> 4) | ((std::uint32_t)pSource[2] << 4)) & mask);
+        }
+        if(numPixels != 0)
+        {
+            *pDest = (std::int32_t)(((std::uint32_t)pSource[0] | ((std::uint32_t)(pSource[1] & 0x0f) << 8)) & mask);
+        }
+        return;
+    }
+
+    // Generic size: keep the bits read in advance in a 64 bit
+    //  accumulator
+    ///////////////////////////////////////////////////////////
+    const std::uint64_t valueMask(((std::uint64_t)1 << allocatedBits) - 1);
+    std::uint64_t accumulator(0);
+    std::uint32_t accumulatorBits(0);
+    for(; numPixels != 0; --numPixels)
+    {
+        while(accumulatorBits < allocatedBits)
+        {
+            accumulator |= (std::uint64_t)*(pSource++) << accumulatorBits;
+            accumulatorBits += 8;
+        }
+        *(pDest++) = (std::int32_t)((std::uint32_t)(accumulator & valueMask) & mask);
+        accumulator >>= allocatedBits;
+        accumulatorBits -= allocatedBits;
+    }
+}
+
+///////////////////////////////////////////////////////////
+//
+// Pack values into a little endian bit stream. The last
+//  byte is completed with zero bits
+//
+///////////////////////////////////////////////////////////
+static void packPixels(const std::int32_t* pSource, std::uint8_t* pDest, size_t numPixels, std::uint8_t allocatedBits, std::uint32_t mask)
+{
+    if(allocatedBits == 1)
+    {
+        for(; numPixels >= 8; numPixels -= 8)
+        {
+            std::uint32_t destByte(0);
+            for(std::uint32_t bit(0); bit != 8; ++bit)
+            {
+                destByte |= ((std::uint32_t)*(pSource++) & mask & 1) << bit;
+            }
+            *(pDest++) = (std::uint8_t)destByte;
+        }
+        if(numPixels != 0)
+        {
+            std::uint32_t destByte(0);
+            for(std::uint32_t bit(0); numPixels != 0; --numPixels, ++bit)
+            {
+                destByte |= ((std::uint32_t)*(pSource++) & mask & 1) << bit;
+            }
+            *pDest = (std::uint8_t)destByte;
+        }
+        return;
+    }
+
+    if(allocatedBits == 12)
+    {
+        for(; numPixels >= 2; numPixels -= 2, pSource += 2)
+        {
+            const std::uint32_t value0((std::uint32_t)pSource[0] & mask & 0x0fff);
+            const std::uint32_t value1((std::uint32_t)pSource[1] & mask & 0x0fff);
+            *(pDest++) = (std::uint8_t)value0;
+            *(pDest++) = (std::uint8_t)((value0 >> 8) | (value1 << 4));
+            *(pDest++) = (std::uint8_t)(value1 >> 4);
+        }
+        if(numPixels != 0)
+        {
+            const std::uint32_t value0((std::uint32_t)pSource[0] & mask & 0x0fff);
+            *(pDest++) = (std::uint8_t)value0;
+            *pDest = (std::uint8_t)(value0 >> 8);
+        }
+        return;
+    }
+
+    const std::uint64_t valueMask(((std::uint64_t)1 << allocatedBits) - 1);
+    std::uint64_t accumulator(0);
+    std::uint32_t accumulatorBits(0);
+    for(; numPixels != 0; --numPixels)
+    {
+        accumulator |= ((std::uint64_t)((std::uint32_t)*(pSource++) & mask) & valueMask) << accumulatorBits;
+        accumulatorBits += allocatedBits;
+        for(; accumulatorBits >= 8; accumulatorBits -= 8, accumulator >>= 8)
+        {
+            *(pDest++) = (std::uint8_t)accumulator;
+        }
+    }
+    if(accumulatorBits != 0)
+    {
+        *pDest = (std::uint8_t)accumulator;
+    }
+}
+
 ///////////////////////////////////////////////////////////
 ///////////////////////////////////////////////////////////
 ///////////////////////////////////////////////////////////
@@ -68,6 +245,10 @@ std::shared_ptr<image> dicomImageCodec::getImage(const dataSet& dataset, std::sh
 {
     IMEBRA_FUNCTION_START();
 
+    IMEBRA_TRACE_SPAN("dicomImageCodec::getImage");
+
+    IMEBRA_STATISTICS_TIMER(decodingTimer, dicomDecodingTime);
+
     streamReader* pSourceStream = pStream.get();
 
     // Check for RLE compression
@@ -180,10 +361,14 @@ std::shared_ptr<image> dicomImageCodec::getImage(const dataSet& dataset, std::sh
         IMEBRA_THROW(CodecCorruptedFileError, "Cannot allocate the image's buffer");
     }
 
-    // Allocate the dicom channels
+    // Allocate the dicom channels. RLE images are decoded
+    //  directly into the image's memory
     ///////////////////////////////////////////////////////////
     dicomInformation information;
-    allocChannels(information, channelsNumber, imageWidth, imageHeight, bSubSampledX, bSubSampledY);
+    if(!bRleCompressed)
+    {
+        allocChannels(information, channelsNumber, imageWidth, imageHeight, bSubSampledX, bSubSampledY);
+    }
 
     std::uint32_t mask = (std::uint32_t)( ((std::uint64_t)1 << (highBit + 1)) - 1);
     mask -= (std::uint32_t)(((std::uint64_t)1 << (highBit + 1 - storedBits)) - 1);
@@ -233,7 +418,52 @@ std::shared_ptr<image> dicomImageCodec::getImage(const dataSet& dataset, std::sh
             IMEBRA_THROW(CodecCorruptedFileError, "Cannot read subsampled RLE images");
         }
 
-        readRLECompressed(information, imageWidth, imageHeight, channelsNumber, pSourceStream, allocatedBits, mask);
+        // The segments are decoded directly into the image's
+        //  memory
+        ///////////////////////////////////////////////////////////
+        std::uint32_t sampleBytes(1);
+        if(depth == bitDepth_t::depthU16 || depth == bitDepth_t::depthS16)
+        {
+            sampleBytes = 2;
+        }
+        else if(depth == bitDepth_t::depthU32 || depth == bitDepth_t::depthS32)
+        {
+            sampleBytes = 4;
+        }
+        std::uint8_t* pImageMemory(handler->getMemoryBuffer());
+        readRLECompressed(pImageMemory, sampleBytes, imageWidth, imageHeight, channelsNumber, pSourceStream, allocatedBits);
+
+        const size_t samplesNumber((size_t)imageWidth * (size_t)imageHeight * channelsNumber);
+        const std::uint32_t fullMask((std::uint32_t)(((std::uint64_t)1 << (sampleBytes * 8)) - 1));
+        if(mask != fullMask || sampleBytes * 8 < allocatedBits || (b2Complement && highBit != sampleBytes * 8 - 1))
+        {
+            switch(depth)
+            {
+            case bitDepth_t::depthU8:
+                adjustRLESamples((std::uint8_t*)pImageMemory, samplesNumber, mask, false, highBit);
+                break;
+            case bitDepth_t::depthS8:
+                adjustRLESamples((std::int8_t*)pImageMemory, samplesNumber, mask, true, highBit);
+                break;
+            case bitDepth_t::depthU16:
+                adjustRLESamples((std::uint16_t*)pImageMemory, samplesNumber, mask, false, highBit);
+                break;
+            case bitDepth_t::depthS16:
+                adjustRLESamples((std::int16_t*)pImageMemory, samplesNumber, mask, true, highBit);
+                break;
+            case bitDepth_t::depthU32:
+                adjustRLESamples((std::uint32_t*)pImageMemory, samplesNumber, mask, false, highBit);
+                break;
+            default:
+                adjustRLESamples((std::int32_t*)pImageMemory, samplesNumber, mask, true, highBit);
+                break;
+            }
+        }
+
+        IMEBRA_STATISTICS_ADD(dicomDecodedFrames, 1);
+        IMEBRA_STATISTICS_ADD(dicomDecodedPixels, (size_t)imageWidth * (size_t)imageHeight);
+
+        return pImage;
 
     } // ...End of RLE decoding
 
@@ -281,6 +511,9 @@ std::shared_ptr<image> dicomImageCodec::getImage(const dataSet& dataset, std::sh
                     channelsNumber);
     }
 
+    IMEBRA_STATISTICS_ADD(dicomDecodedFrames, 1);
+    IMEBRA_STATISTICS_ADD(dicomDecodedPixels, (size_t)imageWidth * (size_t)imageHeight);
+
     // Return OK
     ///////////////////////////////////////////////////////////
     return pImage;
@@ -290,6 +523,72 @@ std::shared_ptr<image> dicomImageCodec::getImage(const dataSet& dataset, std::sh
 }
 
 
+///////////////////////////////////////////////////////////
+///////////////////////////////////////////////////////////
+//
+//
+// Return the size of each uncompressed frame, as read by
+//  getImage()
+//
+//
+///////////////////////////////////////////////////////////
+///////////////////////////////////////////////////////////
+size_t dicomImageCodec::getFrameSize(const dataSet& dataset, tagVR_t dataType) const
+{
+    IMEBRA_FUNCTION_START();
+
+    // RLE frames have a variable size
+    ///////////////////////////////////////////////////////////
+    if(dataset.getString(0x0002, 0x0, 0x0010, 0, 0, "1.2.840.10008.1.2") == "1.2.840.10008.1.2.5")
+    {
+        return 0;
+    }
+
+    std::string colorSpace = dataset.getString(0x0028, 0x0, 0x0004, 0, 0, "");
+    std::uint32_t channelsNumber = dataset.getUnsignedLong(0x0028, 0x0, 0x0002, 0, 0, 0);
+    if(channelsNumber == 0)
+    {
+        channelsNumber = 1;
+    }
+
+    size_t imageWidth = dataset.getUnsignedLong(0x0028, 0x0, 0x0011, 0, 0, 0);
+    size_t imageHeight = dataset.getUnsignedLong(0x0028, 0x0, 0x0010, 0, 0, 0);
+    const size_t allocatedBits = dataset.getUnsignedLong(0x0028, 0x0, 0x0100, 0, 0, 0);
+    if(imageWidth == 0 || imageHeight == 0 || allocatedBits == 0)
+    {
+        return 0;
+    }
+
+    // Calculate the number of values, as in allocChannels()
+    ///////////////////////////////////////////////////////////
+    const bool bSubSampledY = channelsNumber > 0x1 && transforms::colorTransforms::colorTransformsFactory::isSubsampledY(colorSpace);
+    const bool bSubSampledX = channelsNumber > 0x1 && transforms::colorTransforms::colorTransformsFactory::isSubsampledX(colorSpace);
+    if(bSubSampledX && (imageWidth & 0x1) != 0)
+    {
+        ++imageWidth;
+    }
+    if(bSubSampledY && (imageHeight & 0x1) != 0)
+    {
+        ++imageHeight;
+    }
+    const size_t chrominanceValues((bSubSampledX ? imageWidth >> 1 : imageWidth) * (bSubSampledY ? imageHeight >> 1 : imageHeight));
+    const size_t valuesNumber(imageWidth * imageHeight + chrominanceValues * (channelsNumber - 1));
+
+    if(allocatedBits == 8 || allocatedBits == 16 || allocatedBits == 32)
+    {
+        return valuesNumber * (allocatedBits >> 3);
+    }
+
+    // Packed values: readPixel() discards the unused bits
+    //  of the last word
+    ///////////////////////////////////////////////////////////
+    const size_t wordSizeBits = (dataType == tagVR_t::OW) ? 16 : 8;
+    return ((valuesNumber * allocatedBits + wordSizeBits - 1) / wordSizeBits) * (wordSizeBits >> 3);
+
+    IMEBRA_FUNCTION_END();
+}
+
+
 ///////////////////////////////////////////////////////////
 ///////////////////////////////////////////////////////////
 //
@@ -389,12 +688,21 @@ void dicomImageCodec::readUncompressedInterleaved(
     ///////////////////////////////////////////////////////////
     if(!bSubSampledX && !bSubSampledY)
     {
-        std::uint8_t readBuffer[4];
-        for(std::uint32_t totalSize = information.m_channels[0]->m_bufferSize; totalSize != 0; --totalSize)
+        // Read a row at a time, then separate the channels
+        ///////////////////////////////////////////////////////////
+        const std::uint32_t rowValues(information.m_channels[0]->m_width * channelsNumber);
+        std::vector<std::int32_t> rowBuffer(rowValues);
+        std::vector<std::uint8_t> readBuffer((size_t)rowValues * 4);
+        for(std::uint32_t scanRows = information.m_channels[0]->m_height; scanRows != 0; --scanRows)
         {
-            for(std::uint32_t scanChannels = 0; scanChannels != channelsNumber; ++scanChannels)
+            readPixel(information, pSourceStream, rowBuffer.data(), rowValues, &bitPointer, readBuffer.data(), wordSizeBytes, allocatedBits, mask);
+            const std::int32_t* pRowValues(rowBuffer.data());
+            for(std::uint32_t scanPixels = information.m_channels[0]->m_width; scanPixels != 0; --scanPixels)
             {
-                readPixel(information, pSourceStream, channelsMemory[scanChannels]++, 1, &bitPointer, readBuffer, wordSizeBytes, allocatedBits, mask);
+                for(std::uint32_t scanChannels = 0; scanChannels != channelsNumber; ++scanChannels)
+                {
+                    *(channelsMemory[scanChannels]++) = *(pRowValues++);
+                }
             }
         }
         return;
@@ -496,12 +804,21 @@ void dicomImageCodec::writeUncompressedInterleaved(
     ///////////////////////////////////////////////////////////
     if(!bSubSampledX && !bSubSampledY)
     {
-        for(std::uint32_t totalSize = information.m_channels[0]->m_bufferSize; totalSize != 0; --totalSize)
+        // Interleave the channels of a row, then write it
+        ///////////////////////////////////////////////////////////
+        const std::uint32_t rowValues(information.m_channels[0]->m_width * channelsNumber);
+        std::vector<std::int32_t> rowBuffer(rowValues);
+        for(std::uint32_t scanRows = information.m_channels[0]->m_height; scanRows != 0; --scanRows)
         {
-            for(std::uint32_t scanChannels = 0; scanChannels < channelsNumber; ++scanChannels)
+            std::int32_t* pRowValues(rowBuffer.data());
+            for(std::uint32_t scanPixels = information.m_channels[0]->m_width; scanPixels != 0; --scanPixels)
             {
-                writePixel(information, pDestStream, *(channelsMemory[scanChannels]++), &bitPointer, wordSizeBytes, allocatedBits, mask);
+                for(std::uint32_t scanChannels = 0; scanChannels < channelsNumber; ++scanChannels)
+                {
+                    *(pRowValues++) = *(channelsMemory[scanChannels]++);
+                }
             }
+            writePixels(information, pDestStream, rowBuffer.data(), rowValues, &bitPointer, wordSizeBytes, allocatedBits, mask);
         }
         flushUnwrittenPixels(information, pDestStream, &bitPointer, wordSizeBytes);
         return;
@@ -623,11 +940,7 @@ void dicomImageCodec::writeUncompressedNotInterleaved(
     ///////////////////////////////////////////////////////////
     for(std::uint32_t channel = 0; channel < channelsNumber; ++channel)
     {
-        std::int32_t* pMemoryDest = information.m_channels[channel]->m_pBuffer;
-        for(std::uint32_t scanPixels = information.m_channels[channel]->m_bufferSize; scanPixels != 0; --scanPixels)
-        {
-            writePixel(information, pDestStream, *pMemoryDest++, &bitPointer, wordSizeBytes, allocatedBits, mask);
-        }
+        writePixels(information, pDestStream, information.m_channels[channel]->m_pBuffer, information.m_channels[channel]->m_bufferSize, &bitPointer, wordSizeBytes, allocatedBits, mask);
     }
     flushUnwrittenPixels(information, pDestStream, &bitPointer, wordSizeBytes);
 
@@ -645,7 +958,7 @@ void dicomImageCodec::writeUncompressedNotInterleaved(
 ///////////////////////////////////////////////////////////
 ///////////////////////////////////////////////////////////
 void dicomImageCodec::writeRLECompressed(
-        dicomInformation& information,
+        std::shared_ptr<handlers::readingDataHandlerNumericBase> pImageHandler,
         std::uint32_t imageWidth,
         std::uint32_t imageHeight,
         std::uint32_t channelsNumber,
@@ -656,113 +969,112 @@ void dicomImageCodec::writeRLECompressed(
 {
     IMEBRA_FUNCTION_START();
 
-    std::uint32_t segmentsOffset[16];
-    ::memset(segmentsOffset, 0, sizeof(segmentsOffset));
+    const std::uint32_t sampleBytes((allocatedBits + 7) / 8);
+    const std::uint32_t segmentsNumber(sampleBytes * channelsNumber);
+    if(segmentsNumber > 15)
+    {
+        IMEBRA_THROW(CodecWrongFormatError, "Too many RLE segments");
+    }
 
-    // The first phase fills the segmentsOffset pointers, the
-    //  second phase writes to the stream.
+    // Each segment is encoded into its own buffer. The first
+    //  segment of each channel contains the most significant
+    //  byte
     ///////////////////////////////////////////////////////////
-    for(int phase = 0; phase < 2; ++phase)
+    const size_t pixelsNumber((size_t)imageWidth * (size_t)imageHeight);
+    std::vector<std::vector<std::uint8_t> > segments(segmentsNumber);
+    std::function<void(size_t)> encodeSegment([&](size_t segment)
     {
-        if(phase == 1)
+        const std::uint32_t channel((std::uint32_t)segment / sampleBytes);
+        const std::uint32_t rightShift((sampleBytes - 1 - (std::uint32_t)segment % sampleBytes) * 8);
+
+        std::vector<std::uint8_t> plane(pixelsNumber);
+        HANDLER_CALL_TEMPLATE_FUNCTION_WITH_PARAMS(extractRLEPlane, pImageHandler, channelsNumber, channel, mask, rightShift, plane.data());
+
+        std::vector<std::uint8_t>& segmentData(segments[segment]);
+        segmentData.reserve(pixelsNumber + (pixelsNumber + 127) / 128 + 1);
+        const std::uint8_t* pRow(plane.data());
+        for(std::uint32_t scanY(imageHeight); scanY != 0; --scanY, pRow += imageWidth)
         {
-            pDestStream->adjustEndian((std::uint8_t*)segmentsOffset, 4, streamController::lowByteEndian, sizeof(segmentsOffset) / sizeof(segmentsOffset[0]));
-            pDestStream->write((std::uint8_t*)segmentsOffset, sizeof(segmentsOffset));
+            writeRLERow(pRow, imageWidth, &segmentData);
         }
 
-        std::uint32_t segmentNumber = 0;
-        std::uint32_t offset = 64;
+        // Segments must have an even length
+        ///////////////////////////////////////////////////////////
+        if((segmentData.size() & 1) != 0)
+        {
+            segmentData.push_back(0x80);
+        }
+    });
 
-        for(std::uint32_t scanChannels = 0; scanChannels < channelsNumber; ++scanChannels)
+    if(pixelsNumber * segmentsNumber >= minimumParallelRLESize)
+    {
+        threadPool::getSharedThreadPool().executeParallel(segmentsNumber, encodeSegment);
+    }
+    else
+    {
+        for(size_t segment(0); segment != segmentsNumber; ++segment)
         {
-            std::vector<std::uint8_t> rowBytes(imageWidth);
+            encodeSegment(segment);
+        }
+    }
 
-            std::vector<std::uint8_t> differentBytes;
-            differentBytes.reserve(imageWidth);
+    // Write the header with the segments offsets, then the
+    //  segments
+    ///////////////////////////////////////////////////////////
+    std::uint32_t segmentsOffset[16];
+    ::memset(segmentsOffset, 0, sizeof(segmentsOffset));
+    segmentsOffset[0] = segmentsNumber;
+    std::uint32_t offset((std::uint32_t)sizeof(segmentsOffset));
+    for(std::uint32_t segment(0); segment != segmentsNumber; ++segment)
+    {
+        segmentsOffset[segment + 1] = offset;
+        offset += (std::uint32_t)segments[segment].size();
+    }
+    pDestStream->adjustEndian((std::uint8_t*)segmentsOffset, 4, streamController::lowByteEndian, sizeof(segmentsOffset) / sizeof(segmentsOffset[0]));
+    pDestStream->write((std::uint8_t*)segmentsOffset, sizeof(segmentsOffset));
 
-            for(std::int32_t rightShift = (std::int32_t)(((allocatedBits + 7) & 0xfffffff8) - 8); rightShift >= 0; rightShift -= 8)
-            {
-                std::int32_t* pPixel = information.m_channels[scanChannels]->m_pBuffer;
+    for(std::uint32_t segment(0); segment != segmentsNumber; ++segment)
+    {
+        pDestStream->write(segments[segment].data(), segments[segment].size());
+    }
 
-                if(phase == 0)
-                {
-                    segmentsOffset[++segmentNumber] = offset;
-                    segmentsOffset[0] = segmentNumber;
-                }
-                else
-                {
-                    offset = segmentsOffset[++segmentNumber];
-                }
+    IMEBRA_FUNCTION_END();
+}
 
-                for(std::uint32_t scanY = imageHeight; scanY != 0; --scanY)
-                {
-                    std::uint8_t* rowBytesPointer = &(rowBytes[0]);
-
-                    for(std::uint32_t scanX = imageWidth; scanX != 0; --scanX)
-                    {
-                        *(rowBytesPointer++) = (std::uint8_t)((*pPixel & mask) >> rightShift);
-                        ++pPixel;
-                    }
-
-                    for(size_t scanBytes = 0; scanBytes < imageWidth; /* left empty */)
-                    {
-                        std::uint8_t currentByte = rowBytes[scanBytes];
-
-                        // Calculate the run-length
-                        ///////////////////////////
-                        size_t runLength(1);
-                        for(; ((scanBytes + runLength) != imageWidth) && rowBytes[scanBytes + runLength] == currentByte; ++runLength)
-                        {
-                        }
-
-                        // Write the runlength
-                        //////////////////////
-                        if(runLength > 3)
-                        {
-                            if(!differentBytes.empty())
-                            {
-                                offset += (std::uint32_t)writeRLEDifferentBytes(&differentBytes, pDestStream, phase == 1);
-                            }
-                            if(runLength > 128)
-                            {
-                                runLength = 128;
-                            }
-                            offset += 2;
-                            scanBytes += runLength;
-                            if(phase == 1)
-                            {
-                                std::uint8_t lengthByte = (std::uint8_t)(1 - runLength);
-                                pDestStream->write(&lengthByte, 1);
-                                pDestStream->write(&currentByte, 1);
-                            }
-                            continue;
-                        }
-
-                        // Remmember sequence of different bytes
-                        ////////////////////////////////////////
-                        differentBytes.push_back(currentByte);
-                        ++scanBytes;
-                    } // for(std::uint32_t scanBytes = 0; scanBytes < imageWidth; )
-
-                    offset += (std::uint32_t)writeRLEDifferentBytes(&differentBytes, pDestStream, phase == 1);
-
-                } // for(std::uint32_t scanY = imageHeight; scanY != 0; --scanY)
-
-                if((offset & 1) != 0)
-                {
-                    ++offset;
-                    if(phase == 1)
-                    {
-                        const std::uint8_t command = 0x80;
-                        pDestStream->write(&command, 1);
-                    }
-                }
 
-            } // for(std::int32_t rightShift = ((allocatedBits + 7) & 0xfffffff8) -8; rightShift >= 0; rightShift -= 8)
+///////////////////////////////////////////////////////////
+///////////////////////////////////////////////////////////
+//
+//
+// Append a RLE compressed row to a segment
+//
+//
+///////////////////////////////////////////////////////////
+///////////////////////////////////////////////////////////
+void dicomImageCodec::writeRLERow(const std::uint8_t* pRow, size_t rowLength, std::vector<std::uint8_t>* pSegment)
+{
+    IMEBRA_FUNCTION_START();
 
-        } // for(int scanChannels = 0; scanChannels < channelsNumber; ++scanChannels)
+    size_t literalStart(0);
+    for(size_t scanBytes(0); scanBytes != rowLength; /* left empty */)
+    {
+        const size_t runLength(getRLERunLength(pRow + scanBytes, rowLength - scanBytes));
 
-    } // for(int phase = 0; phase < 2; ++phase)
+        // Runs longer than 3 bytes are stored as replicated
+        //  bytes, shorter runs are added to the literal bytes
+        ///////////////////////////////////////////////////////////
+        if(runLength > 3)
+        {
+            writeRLELiteral(pRow + literalStart, scanBytes - literalStart, pSegment);
+            pSegment->push_back((std::uint8_t)(1 - runLength));
+            pSegment->push_back(pRow[scanBytes]);
+            scanBytes += runLength;
+            literalStart = scanBytes;
+            continue;
+        }
+        scanBytes += runLength;
+    }
+    writeRLELiteral(pRow + literalStart, rowLength - literalStart, pSegment);
 
     IMEBRA_FUNCTION_END();
 }
@@ -772,39 +1084,61 @@ void dicomImageCodec::writeRLECompressed(
 ///////////////////////////////////////////////////////////
 //
 //
-// Write RLE sequence of different bytes
+// Append RLE literal bytes to a segment
 //
 //
 ///////////////////////////////////////////////////////////
 ///////////////////////////////////////////////////////////
-size_t dicomImageCodec::writeRLEDifferentBytes(std::vector<std::uint8_t>* pDifferentBytes, streamWriter* pDestStream, bool bWrite)
+void dicomImageCodec::writeRLELiteral(const std::uint8_t* pBytes, size_t length, std::vector<std::uint8_t>* pSegment)
 {
-    IMEBRA_FUNCTION_START();
+    while(length != 0)
+    {
+        const size_t writeSize(length > 128 ? 128 : length);
+        pSegment->push_back((std::uint8_t)(writeSize - 1));
+        pSegment->insert(pSegment->end(), pBytes, pBytes + writeSize);
+        pBytes += writeSize;
+        length -= writeSize;
+    }
+}
 
-    size_t writtenLength = 0;
-    for(size_t offset(0); offset != pDifferentBytes->size();)
+
+///////////////////////////////////////////////////////////
+///////////////////////////////////////////////////////////
+//
+//
+// Return the number of identical bytes at the beginning
+//  of a buffer, up to 128
+//
+//
+///////////////////////////////////////////////////////////
+///////////////////////////////////////////////////////////
+size_t dicomImageCodec::getRLERunLength(const std::uint8_t* pBytes, size_t length)
+{
+    if(length > 128)
     {
-        size_t writeSize = pDifferentBytes->size() - offset;
-        if(writeSize > 128)
-        {
-            writeSize = 128;
-        }
-        writtenLength += writeSize + 1;
-        if(bWrite)
+        length = 128;
+    }
+
+    // Compare 8 bytes at once against the first byte
+    //  replicated in a 64 bit word
+    ///////////////////////////////////////////////////////////
+    const std::uint64_t replicatedByte((std::uint64_t)pBytes[0] * (std::uint64_t)0x0101010101010101ull);
+    size_t runLength(1);
+    while(runLength + 8 <= length)
+    {
+        std::uint64_t word;
+        ::memcpy(&word, pBytes + runLength, sizeof(word));
+        if(word != replicatedByte)
         {
-            const std::uint8_t writeLength((std::uint8_t)(writeSize - 1));
-            pDestStream->write(&writeLength, 1);
-            pDestStream->write(&(pDifferentBytes->at(offset)), writeSize);
+            break;
         }
-        offset += writeSize;
+        runLength += 8;
     }
-    pDifferentBytes->clear();
-
-    // return number of written bytes
-    /////////////////////////////////
-    return writtenLength;
-
-    IMEBRA_FUNCTION_END();
+    while(runLength != length && pBytes[runLength] == pBytes[0])
+    {
+        ++runLength;
+    }
+    return runLength;
 }
 
 
@@ -818,13 +1152,13 @@ size_t dicomImageCodec::writeRLEDifferentBytes(std::vector<std::uint8_t>* pDiffe
 ///////////////////////////////////////////////////////////
 ///////////////////////////////////////////////////////////
 void dicomImageCodec::readRLECompressed(
-        dicomInformation& information,
+        std::uint8_t* pDestination,
+        std::uint32_t destinationSampleBytes,
         std::uint32_t imageWidth,
         std::uint32_t imageHeight,
         std::uint32_t channelsNumber,
         streamReader* pSourceStream,
-        std::uint8_t allocatedBits,
-        std::uint32_t mask)
+        std::uint8_t allocatedBits)
 {
     IMEBRA_FUNCTION_START();
 
@@ -836,101 +1170,213 @@ void dicomImageCodec::readRLECompressed(
     pSourceStream->read((std::uint8_t*)segmentsOffset, 64);
     pSourceStream->adjustEndian((std::uint8_t*)segmentsOffset, 4, streamController::lowByteEndian, sizeof(segmentsOffset) / sizeof(segmentsOffset[0]));
 
-    //
-    // Scan all the RLE segments
-    //
+    const std::uint32_t sampleBytes((allocatedBits + 7) / 8);
+    const std::uint32_t segmentsNumber(sampleBytes * channelsNumber);
+    if(segmentsNumber == 0 || segmentsNumber > 15 || segmentsOffset[0] < segmentsNumber || segmentsOffset[0] > 15)
+    {
+        IMEBRA_THROW(CodecCorruptedFileError, "Wrong number of RLE segments");
+    }
+    for(std::uint32_t checkOffsets(1); checkOffsets <= segmentsOffset[0]; ++checkOffsets)
+    {
+        if(segmentsOffset[checkOffsets] < (checkOffsets == 1 ? sizeof(segmentsOffset) : segmentsOffset[checkOffsets - 1]))
+        {
+            IMEBRA_THROW(CodecCorruptedFileError, "Wrong RLE segment offset");
+        }
+    }
+
+    // Load all the needed segments into memory. The length
+    //  of the last segment is not known: read until the end
+    //  of the stream but not more than the size of a segment
+    //  in which each byte is stored in a separate literal
     ///////////////////////////////////////////////////////////
-    std::uint32_t loopsNumber = channelsNumber;
-    std::uint32_t loopSize = imageWidth * imageHeight;
+    const size_t pixelsNumber((size_t)imageWidth * (size_t)imageHeight);
+    pSourceStream->seekForward(segmentsOffset[1] - (std::uint32_t)sizeof(segmentsOffset));
 
-    std::uint32_t currentSegmentOffset = sizeof(segmentsOffset);
-    std::uint8_t segmentNumber = 0;
-    for(std::uint32_t channel = 0; channel<loopsNumber; ++channel)
+    std::vector<std::uint8_t> segmentsData;
+    if(segmentsOffset[0] > segmentsNumber)
+    {
+        segmentsData.resize(segmentsOffset[segmentsNumber + 1] - segmentsOffset[1]);
+        pSourceStream->read(segmentsData.data(), segmentsData.size());
+    }
+    else
     {
-        for(std::int32_t leftShift = (std::int32_t)(((allocatedBits + 7) & 0xfffffff8) - 8); leftShift >= 0; leftShift -= 8)
+        const size_t knownSize(segmentsOffset[segmentsNumber] - segmentsOffset[1]);
+        const size_t maxSize(knownSize + pixelsNumber * 2 + 1);
+        segmentsData.resize(knownSize);
+        pSourceStream->read(segmentsData.data(), knownSize);
+        while(segmentsData.size() != maxSize && !pSourceStream->endReached())
         {
-            // Prepare to scan all the RLE segment
-            ///////////////////////////////////////////////////////////
-            std::uint32_t segmentOffset = segmentsOffset[++segmentNumber]; // Get the offset
-            pSourceStream->seekForward(segmentOffset - currentSegmentOffset);
-            currentSegmentOffset = segmentOffset;
+            size_t readSize(maxSize - segmentsData.size());
+            if(readSize > 65536)
+            {
+                readSize = 65536;
+            }
+            const size_t previousSize(segmentsData.size());
+            segmentsData.resize(previousSize + readSize);
+            segmentsData.resize(previousSize + pSourceStream->readSome(&(segmentsData[previousSize]), readSize));
+        }
+    }
 
-            std::uint8_t  rleByte = 0;         // RLE code
-            std::uint8_t  copyBytes = 0;       // Number of bytes to copy
-            std::uint8_t  runByte = 0;         // Byte to use in run-lengths
-            std::uint8_t  runLength = 0;       // Number of bytes with the same information (runByte)
-            std::uint8_t  copyBytesBuffer[0x81];
+    // A single 8 bit channel is decoded directly into the
+    //  image. Otherwise each segment is decoded into its own
+    //  plane, then the planes are copied into the samples.
+    //  Planes that contain only bits higher than the image's
+    //  depth are skipped
+    ///////////////////////////////////////////////////////////
+    const bool bDirect(segmentsNumber == 1 && destinationSampleBytes == 1);
+    std::vector<std::vector<std::uint8_t> > planes(segmentsNumber);
+    std::vector<std::uint32_t> decodeSegments;
+    for(std::uint32_t segment(0); segment != segmentsNumber; ++segment)
+    {
+        if(sampleBytes - 1 - segment % sampleBytes < destinationSampleBytes)
+        {
+            decodeSegments.push_back(segment);
+            if(!bDirect)
+            {
+                planes[segment].resize(pixelsNumber);
+            }
+        }
+    }
 
-            std::int32_t* pChannelMemory = information.m_channels[channel]->m_pBuffer;
-            std::uint32_t channelSize = loopSize;
-            std::uint8_t* pScanCopyBytes;
+    const std::uint8_t* pSegmentsData(segmentsData.data());
+    const size_t segmentsDataSize(segmentsData.size());
+    const size_t firstOffset(segmentsOffset[1]);
+    std::function<void(size_t)> decodeSegment([&](size_t decodeIndex)
+    {
+        const std::uint32_t segment(decodeSegments[decodeIndex]);
+        const size_t segmentStart(segmentsOffset[segment + 1] - firstOffset);
+        const size_t segmentEnd(segment + 1 < segmentsOffset[0] ? segmentsOffset[segment + 2] - firstOffset : segmentsDataSize);
+        decodeRLESegment(
+                    pSegmentsData + segmentStart,
+                    segmentEnd - segmentStart,
+                    bDirect ? pDestination : planes[segment].data(),
+                    pixelsNumber);
+    });
+
+    threadPool& pool(threadPool::getSharedThreadPool());
+    const bool bParallel(pixelsNumber * decodeSegments.size() >= minimumParallelRLESize);
+    if(bParallel)
+    {
+        pool.executeParallel(decodeSegments.size(), decodeSegment);
+    }
+    else
+    {
+        for(size_t decodeIndex(0); decodeIndex != decodeSegments.size(); ++decodeIndex)
+        {
+            decodeSegment(decodeIndex);
+        }
+    }
 
-            // Read the RLE segment
-            ///////////////////////////////////////////////////////////
-            pSourceStream->read(&rleByte, 1);
-            ++currentSegmentOffset;
-            while(channelSize != 0)
+    if(bDirect)
+    {
+        return;
+    }
+
+    // Copy the planes into the samples, in bands of rows.
+    //  The first segment of each channel contains the most
+    //  significant byte
+    ///////////////////////////////////////////////////////////
+    const bool bLowByteFirst(streamController::getPlatformEndian() == streamController::lowByteEndian);
+    const size_t pixelBytes((size_t)destinationSampleBytes * channelsNumber);
+    const size_t bandsNumber(bParallel ? pool.getThreadsNumber() : 1);
+    const size_t bandSize((pixelsNumber + bandsNumber - 1) / bandsNumber);
+    std::function<void(size_t)> copyBand([&](size_t band)
+    {
+        const size_t bandStart(band * bandSize);
+        const size_t bandEnd(bandStart + bandSize < pixelsNumber ? bandStart + bandSize : pixelsNumber);
+        if(bandStart >= bandEnd)
+        {
+            return;
+        }
+        for(size_t scanSegments(0); scanSegments != decodeSegments.size(); ++scanSegments)
+        {
+            const std::uint32_t segment(decodeSegments[scanSegments]);
+            const std::uint32_t significance(sampleBytes - 1 - segment % sampleBytes);
+            const size_t byteOffset((segment / sampleBytes) * destinationSampleBytes +
+                                    (bLowByteFirst ? significance : destinationSampleBytes - 1 - significance));
+            const std::uint8_t* pPlane(planes[segment].data() + bandStart);
+            std::uint8_t* pSample(pDestination + bandStart * pixelBytes + byteOffset);
+            for(size_t scanPixels(bandEnd - bandStart); scanPixels != 0; --scanPixels, pSample += pixelBytes)
             {
-                if(rleByte==0x80)
-                {
-                    pSourceStream->read(&rleByte, 1);
-                    ++currentSegmentOffset;
-                    continue;
-                }
+                *pSample = *(pPlane++);
+            }
+        }
+    });
 
-                // Copy the specified number of bytes
-                ///////////////////////////////////////////////////////////
-                if(rleByte<0x80)
-                {
-                    copyBytes = ++rleByte;
-                    if(copyBytes < channelSize)
-                    {
-                        pSourceStream->read(copyBytesBuffer, copyBytes + 1);
-                        currentSegmentOffset += copyBytes + 1;
-                        rleByte = copyBytesBuffer[copyBytes];
-                    }
-                    else
-                    {
-                        pSourceStream->read(copyBytesBuffer, copyBytes);
-                        currentSegmentOffset += copyBytes;
-                    }
-                    pScanCopyBytes = copyBytesBuffer;
-                    while(copyBytes-- && channelSize != 0)
-                    {
-                        *pChannelMemory |= ((*pScanCopyBytes++) << leftShift) & mask;
-                        ++pChannelMemory;
-                        --channelSize;
-                    }
-                    continue;
-                }
+    if(bParallel)
+    {
+        pool.executeParallel(bandsNumber, copyBand);
+    }
+    else
+    {
+        copyBand(0);
+    }
 
-                // Copy the same byte several times
-                ///////////////////////////////////////////////////////////
-                runLength = (std::uint8_t)(1-rleByte);
-                if(runLength < channelSize)
-                {
-                    pSourceStream->read(copyBytesBuffer, 2);
-                    currentSegmentOffset += 2;
-                    runByte = copyBytesBuffer[0];
-                    rleByte = copyBytesBuffer[1];
-                }
-                else
-                {
-                    pSourceStream->read(&runByte, 1);
-                    ++currentSegmentOffset;
-                }
-                while(runLength-- && channelSize != 0)
-                {
-                    *pChannelMemory |= (runByte << leftShift) & mask;
-                    ++pChannelMemory;
-                    --channelSize;
-                }
+    IMEBRA_FUNCTION_END_MODIFY(StreamEOFError, CodecCorruptedFileError);
+}
+
+
+///////////////////////////////////////////////////////////
+///////////////////////////////////////////////////////////
+//
+//
+// Decode a RLE segment
+//
+//
+///////////////////////////////////////////////////////////
+///////////////////////////////////////////////////////////
+void dicomImageCodec::decodeRLESegment(const std::uint8_t* pSource, size_t sourceSize, std::uint8_t* pDestination, size_t destinationSize)
+{
+    IMEBRA_FUNCTION_START();
 
-            } // ...End of the segment scanning loop
+    const std::uint8_t* pSourceEnd(pSource + sourceSize);
+    std::uint8_t* pDestinationEnd(pDestination + destinationSize);
 
-        } // ...End of the leftshift calculation
+    while(pDestination != pDestinationEnd)
+    {
+        if(pSource == pSourceEnd)
+        {
+            IMEBRA_THROW(CodecCorruptedFileError, "The RLE segment is too short");
+        }
 
-    } // ...Channels scanning loop
+        const std::uint8_t rleByte(*(pSource++));
+
+        // Copy the specified number of bytes
+        ///////////////////////////////////////////////////////////
+        if(rleByte < 0x80)
+        {
+            size_t copyBytes((size_t)rleByte + 1);
+            if(copyBytes > (size_t)(pDestinationEnd - pDestination))
+            {
+                copyBytes = (size_t)(pDestinationEnd - pDestination);
+            }
+            if(copyBytes > (size_t)(pSourceEnd - pSource))
+            {
+                IMEBRA_THROW(CodecCorruptedFileError, "The RLE segment is too short");
+            }
+            ::memcpy(pDestination, pSource, copyBytes);
+            pSource += copyBytes;
+            pDestination += copyBytes;
+            continue;
+        }
+
+        // Copy the same byte several times
+        ///////////////////////////////////////////////////////////
+        if(rleByte > 0x80)
+        {
+            if(pSource == pSourceEnd)
+            {
+                IMEBRA_THROW(CodecCorruptedFileError, "The RLE segment is too short");
+            }
+            size_t runLength(257 - (size_t)rleByte);
+            if(runLength > (size_t)(pDestinationEnd - pDestination))
+            {
+                runLength = (size_t)(pDestinationEnd - pDestination);
+            }
+            ::memset(pDestination, *(pSource++), runLength);
+            pDestination += runLength;
+        }
+    }
 
     IMEBRA_FUNCTION_END();
 }
@@ -960,7 +1406,7 @@ void dicomImageCodec::readPixel(
 
     if(allocatedBits == 8 || allocatedBits == 16 || allocatedBits == 32)
     {
-        pSourceStream->read(pReadBuffer, numPixels * (allocatedBits >> 3));
+        pSourceStream->read(pReadBuffer, numPixels * (allocatedBits >> 3), allocatedBits >> 3, streamController::lowByteEndian);
         if(allocatedBits == 8)
         {
             std::uint8_t* pSource(pReadBuffer);
@@ -970,7 +1416,6 @@ void dicomImageCodec::readPixel(
             }
             return;
         }
-        pSourceStream->adjustEndian(pReadBuffer, allocatedBits >> 3, streamController::lowByteEndian, numPixels);
         if(allocatedBits == 16)
         {
             std::uint16_t* pSource((std::uint16_t*)(pReadBuffer));
@@ -989,6 +1434,42 @@ void dicomImageCodec::readPixel(
 
     }
 
+    // Values packed in bytes, or in little endian words on a
+    //  little endian platform, form a little endian bit stream
+    //  that can be unpacked in bulk once the bits left in
+    //  m_ioWord have been consumed
+    ///////////////////////////////////////////////////////////
+    if(numPixels >= minimumBulkPackedPixels &&
+            (wordSizeBytes == 1 || (wordSizeBytes == 2 && streamController::getPlatformEndian() == streamController::lowByteEndian)))
+    {
+        for(; *pBitPointer != 0 && numPixels != 0; --numPixels)
+        {
+            readPixel(information, pSourceStream, pDest++, 1, pBitPointer, pReadBuffer, wordSizeBytes, allocatedBits, mask);
+        }
+
+        const size_t totalBits((size_t)numPixels * allocatedBits);
+        const size_t wordBits((size_t)wordSizeBytes * 8);
+        const size_t readBytes((totalBits + wordBits - 1) / wordBits * wordSizeBytes);
+        std::vector<std::uint8_t> packedPixels(readBytes);
+        pSourceStream->read(packedPixels.data(), readBytes);
+        unpackPixels(packedPixels.data(), pDest, numPixels, allocatedBits, mask);
+
+        // Keep the unused bits of the last word for the next call
+        ///////////////////////////////////////////////////////////
+        const size_t unusedBits(readBytes * 8 - totalBits);
+        if(unusedBits != 0)
+        {
+            std::uint32_t lastWord(packedPixels[readBytes - 1]);
+            if(wordSizeBytes == 2)
+            {
+                lastWord = (lastWord << 8) | packedPixels[readBytes - 2];
+            }
+            information.m_ioWord = (std::uint16_t)(lastWord >> (wordBits - unusedBits));
+            *pBitPointer = (std::uint8_t)unusedBits;
+        }
+        return;
+    }
+
     while(numPixels-- != 0)
     {
         *pDest = 0;
@@ -1128,6 +1609,103 @@ void dicomImageCodec::writePixel(
 }
 
 
+///////////////////////////////////////////////////////////
+///////////////////////////////////////////////////////////
+//
+//
+// Write several components into a DICOM raw image
+//
+//
+///////////////////////////////////////////////////////////
+///////////////////////////////////////////////////////////
+void dicomImageCodec::writePixels(
+        dicomInformation& information,
+        streamWriter* pDestStream,
+        const std::int32_t* pSource,
+        std::uint32_t numPixels,
+        std::uint8_t*  pBitPointer,
+        std::uint32_t wordSizeBytes,
+        std::uint8_t allocatedBits,
+        std::uint32_t mask)
+{
+    IMEBRA_FUNCTION_START();
+
+    const bool bBitStream(wordSizeBytes == 1 || (wordSizeBytes == 2 && streamController::getPlatformEndian() == streamController::lowByteEndian));
+    if(numPixels < minimumBulkPackedPixels || (!bBitStream && allocatedBits != 8 && allocatedBits != 16 && allocatedBits != 32))
+    {
+        for(; numPixels != 0; --numPixels)
+        {
+            writePixel(information, pDestStream, *(pSource++), pBitPointer, wordSizeBytes, allocatedBits, mask);
+        }
+        return;
+    }
+
+    if(allocatedBits == 8 || allocatedBits == 16 || allocatedBits == 32)
+    {
+        const size_t valueBytes(allocatedBits >> 3);
+        std::vector<std::uint8_t> values((size_t)numPixels * valueBytes);
+        if(allocatedBits == 8)
+        {
+            for(std::uint8_t* pValues(values.data()); numPixels != 0; --numPixels)
+            {
+                *(pValues++) = (std::uint8_t)((std::uint32_t)*(pSource++) & mask);
+            }
+        }
+        else if(allocatedBits == 16)
+        {
+            for(std::uint16_t* pValues((std::uint16_t*)values.data()); numPixels != 0; --numPixels)
+            {
+                *(pValues++) = (std::uint16_t)((std::uint32_t)*(pSource++) & mask);
+            }
+        }
+        else
+        {
+            for(std::uint32_t* pValues((std::uint32_t*)values.data()); numPixels != 0; --numPixels)
+            {
+                *(pValues++) = (std::uint32_t)*(pSource++) & mask;
+            }
+        }
+        if(wordSizeBytes == 1 && valueBytes != 1)
+        {
+            pDestStream->adjustEndian(values.data(), valueBytes, streamController::lowByteEndian, values.size() / valueBytes);
+        }
+        pDestStream->write(values.data(), values.size());
+        return;
+    }
+
+    // Complete the word started by the previous calls
+    ///////////////////////////////////////////////////////////
+    for(; *pBitPointer != 0 && numPixels != 0; --numPixels)
+    {
+        writePixel(information, pDestStream, *(pSource++), pBitPointer, wordSizeBytes, allocatedBits, mask);
+    }
+
+    const size_t totalBits((size_t)numPixels * allocatedBits);
+    const size_t wordBits((size_t)wordSizeBytes * 8);
+    std::vector<std::uint8_t> packedPixels((totalBits + 7) / 8);
+    packPixels(pSource, packedPixels.data(), numPixels, allocatedBits, mask);
+
+    // Write the complete words, keep the remaining bits in
+    //  m_ioWord
+    ///////////////////////////////////////////////////////////
+    const size_t writeBytes(totalBits / wordBits * wordSizeBytes);
+    pDestStream->write(packedPixels.data(), writeBytes);
+    const size_t unusedBits(totalBits - writeBytes * 8);
+    if(unusedBits != 0)
+    {
+        std::uint32_t lastWord(packedPixels[writeBytes]);
+        if(writeBytes + 1 < packedPixels.size())
+        {
+            lastWord |= (std::uint32_t)packedPixels[writeBytes + 1] << 8;
+        }
+        information.m_ioWord = (std::uint16_t)lastWord;
+        *pBitPointer = (std::uint8_t)unusedBits;
+    }
+
+    IMEBRA_FUNCTION_END();
+}
+
+
 ///////////////////////////////////////////////////////////
 ///////////////////////////////////////////////////////////
 //
@@ -1188,6 +1766,8 @@ void dicomImageCodec::setImage(
 {
     IMEBRA_FUNCTION_START();
 
+    IMEBRA_TRACE_SPAN("dicomImageCodec::setImage");
+
     // First calculate the attributes we want to use.
     // Return an exception if they are different from the
     //  old ones and bDontChangeAttributes is true
@@ -1202,6 +1782,28 @@ void dicomImageCodec::setImage(
     std::shared_ptr<handlers::readingDataHandlerNumericBase> imageHandler = pImage->getReadingDataHandler();
     std::uint32_t channelsNumber = pImage->getChannelsNumber();
 
+    std::uint32_t mask = (std::uint32_t)(((std::uint64_t)1 << (highBit + 1)) - 1);
+
+    // RLE segments are extracted directly from the image's
+    //  memory
+    ///////////////////////////////////////////////////////////
+    if(bRleCompressed)
+    {
+        if(bSubSampledX || bSubSampledY)
+        {
+            IMEBRA_THROW(CodecWrongFormatError, "Cannot write subsampled RLE images");
+        }
+        writeRLECompressed(
+                    imageHandler,
+                    imageWidth,
+                    imageHeight,
+                    channelsNumber,
+                    pDestStream.get(),
+                    (std::uint8_t)allocatedBits,
+                    mask);
+        return;
+    }
+
     // Copy the image into the dicom channels
     ///////////////////////////////////////////////////////////
     dicomInformation information;
@@ -1224,21 +1826,6 @@ void dicomImageCodec::setImage(
                     channelsNumber);
     }
 
-    std::uint32_t mask = (std::uint32_t)(((std::uint64_t)1 << (highBit + 1)) - 1);
-
-    if(bRleCompressed)
-    {
-        writeRLECompressed(
-                    information,
-                    imageWidth,
-                    imageHeight,
-                    channelsNumber,
-                    pDestStream.get(),
-                    (std::uint8_t)allocatedBits,
-                    mask);
-        return;
-    }
-
     std::uint8_t wordSizeBytes = ((dataType == tagVR_t::OW) || (dataType == tagVR_t::SS) || (dataType == tagVR_t::US)) ? 2 : 1;
 
     if(bInterleaved || channelsNumber == 1)
@@ -74,6 +74,10 @@ public:
 	///////////////////////////////////////////////////////////
     virtual std::shared_ptr<image> getImage(const dataSet& dataset, std::shared_ptr<streamReader> pSourceStream, tagVR_t dataType) const;
 
+    // Return the size of the uncompressed frames
+    ///////////////////////////////////////////////////////////
+    virtual size_t getFrameSize(const dataSet& dataset, tagVR_t dataType) const;
+
 	// Write an image into a dicom structure
 	///////////////////////////////////////////////////////////
 	virtual void setImage(
@@ -155,7 +159,7 @@ protected:
 	// Write an RLE compressed image
 	///////////////////////////////////////////////////////////
     static void writeRLECompressed(
-            dicomInformation& information,
+            std::shared_ptr<handlers::readingDataHandlerNumericBase> pImageHandler,
             std::uint32_t imageWidth,
             std::uint32_t imageHeight,
             std::uint32_t channelsNumber,
@@ -164,20 +168,35 @@ protected:
             std::uint32_t mask
             );
 
-    // Write RLE sequence of different bytes
+    // Append a RLE compressed row to a segment
+    ///////////////////////////////////////////////////////////
+    static void writeRLERow(const std::uint8_t* pRow, size_t rowLength, std::vector<std::uint8_t>* pSegment);
+
+    // Append RLE literal bytes to a segment
     ///////////////////////////////////////////////////////////
-    static size_t writeRLEDifferentBytes(std::vector<std::uint8_t>* pDifferentBytes, streamWriter* pDestStream, bool bWrite);
+    static void writeRLELiteral(const std::uint8_t* pBytes, size_t length, std::vector<std::uint8_t>* pSegment);
 
-	// Read an RLE compressed image
+    // Return the number of identical bytes at the beginning
+    //  of a buffer, up to 128
+    ///////////////////////////////////////////////////////////
+    static size_t getRLERunLength(const std::uint8_t* pBytes, size_t length);
+
+	// Read an RLE compressed image into the memory of an
+	//  image with interleaved channels. The bits outside the
+	//  stored bits are not cleared
 	///////////////////////////////////////////////////////////
     static void readRLECompressed(
-            dicomInformation& information,
+            std::uint8_t* pDestination,
+            std::uint32_t destinationSampleBytes,
             std::uint32_t imageWidth,
             std::uint32_t imageHeight,
             std::uint32_t channelsNumber,
             streamReader* pSourceStream,
-            std::uint8_t allocatedBits,
-            std::uint32_t mask);
+            std::uint8_t allocatedBits);
+
+    // Decode a RLE segment held in memory
+    ///////////////////////////////////////////////////////////
+    static void decodeRLESegment(const std::uint8_t* pSource, size_t sourceSize, std::uint8_t* pDestination, size_t destinationSize);
 
 
 	// Read a single pixel of a RAW dicom image
@@ -193,6 +212,18 @@ protected:
                     std::uint8_t allocatedBits,
                     std::uint32_t mask);
 
+    // Write several pixels of a RAW dicom image
+    ///////////////////////////////////////////////////////////
+    static void writePixels(
+                    dicomInformation& information,
+                    streamWriter* pDestStream,
+                    const std::int32_t* pSource,
+                    std::uint32_t numPixels,
+                    std::uint8_t*  pBitPointer,
+                    std::uint32_t wordSizeBytes,
+                    std::uint8_t allocatedBits,
+                    std::uint32_t mask);
+
 	// Write a single pixel of a RAW dicom image
 	///////////////////////////////////////////////////////////
     static void writePixel(
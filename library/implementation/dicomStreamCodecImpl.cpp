@@ -16,10 +16,11 @@ If you do not want to be bound by the GPL terms (such as the requirement
 
 */
 
-#include <list>
 #include <vector>
 #include <string.h>
 #include "exceptionImpl.h"
+#include "statisticsImpl.h"
+#include "tracingImpl.h"
 #include "streamReaderImpl.h"
 #include "streamWriterImpl.h"
 #include "memoryImpl.h"
@@ -108,6 +109,17 @@ void dicomStreamCodec::buildStream(std::shared_ptr<streamWriter> pStream, std::s
 {
     IMEBRA_FUNCTION_START();
 
+    lengthsCache cache;
+    buildStream(pStream, pDataSet, bExplicitDataType, endianType, streamType, cache);
+
+    IMEBRA_FUNCTION_END();
+}
+
+
+void dicomStreamCodec::buildStream(std::shared_ptr<streamWriter> pStream, std::shared_ptr<dataSet> pDataSet, bool bExplicitDataType, streamController::tByteOrdering endianType, streamType_t streamType, lengthsCache& cache)
+{
+    IMEBRA_FUNCTION_START();
+
     dataSet::tGroupsIds groups = pDataSet->getGroups();
 
     for(dataSet::tGroupsIds::const_iterator scanGroups(groups.begin()), endGroups(groups.end()); scanGroups != endGroups; ++scanGroups)
@@ -131,11 +143,11 @@ void dicomStreamCodec::buildStream(std::shared_ptr<streamWriter> pStream, std::s
                     handler->setUnsignedLong(1, 1);
                 }
                 temporaryTags[1] = metaInformationTag;
-                writeGroup(pStream, temporaryTags, *scanGroups, bExplicitDataType, endianType);
+                writeGroup(pStream, temporaryTags, *scanGroups, bExplicitDataType, endianType, cache);
                 continue;
             }
 
-            writeGroup(pStream, tags, *scanGroups, bExplicitDataType, endianType);
+            writeGroup(pStream, tags, *scanGroups, bExplicitDataType, endianType, cache);
         }
     }
 
@@ -152,7 +164,7 @@ void dicomStreamCodec::buildStream(std::shared_ptr<streamWriter> pStream, std::s
 //
 ///////////////////////////////////////////////////////////
 ///////////////////////////////////////////////////////////
-void dicomStreamCodec::writeGroup(std::shared_ptr<streamWriter> pDestStream, const dataSet::tTags& tags, std::uint16_t groupId, bool bExplicitDataType, streamController::tByteOrdering endianType)
+void dicomStreamCodec::writeGroup(std::shared_ptr<streamWriter> pDestStream, const dataSet::tTags& tags, std::uint16_t groupId, bool bExplicitDataType, streamController::tByteOrdering endianType, lengthsCache& cache)
 {
     IMEBRA_FUNCTION_START();
 
@@ -164,7 +176,7 @@ void dicomStreamCodec::writeGroup(std::shared_ptr<streamWriter> pDestStream, con
 
     // Calculate the group's length
     ///////////////////////////////////////////////////////////
-    std::uint32_t groupLength = getGroupLength(tags, bExplicitDataType);
+    std::uint32_t groupLength = getGroupLength(tags, bExplicitDataType, cache);
 
     // Write the group's length
     ///////////////////////////////////////////////////////////
@@ -201,7 +213,7 @@ void dicomStreamCodec::writeGroup(std::shared_ptr<streamWriter> pDestStream, con
             continue;
         }
         pDestStream->write((std::uint8_t*)&adjustedGroupId, 2);
-        writeTag(pDestStream, scanTags->second, tagId, bExplicitDataType, endianType);
+        writeTag(pDestStream, scanTags->second, tagId, bExplicitDataType, endianType, cache);
     }
 
     IMEBRA_FUNCTION_END();
@@ -217,7 +229,7 @@ void dicomStreamCodec::writeGroup(std::shared_ptr<streamWriter> pDestStream, con
 //
 ///////////////////////////////////////////////////////////
 ///////////////////////////////////////////////////////////
-void dicomStreamCodec::writeTag(std::shared_ptr<streamWriter> pDestStream, std::shared_ptr<data> pData, std::uint16_t tagId, bool bExplicitDataType, streamController::tByteOrdering endianType)
+void dicomStreamCodec::writeTag(std::shared_ptr<streamWriter> pDestStream, std::shared_ptr<data> pData, std::uint16_t tagId, bool bExplicitDataType, streamController::tByteOrdering endianType, lengthsCache& cache)
 {
     IMEBRA_FUNCTION_START();
 
@@ -225,7 +237,7 @@ void dicomStreamCodec::writeTag(std::shared_ptr<streamWriter> pDestStream, std::
     ///////////////////////////////////////////////////////////
     bool bSequence;
     std::uint32_t tagHeader;
-    std::uint32_t tagLength = getTagLength(pData, bExplicitDataType, &tagHeader, &bSequence);
+    std::uint32_t tagLength = getTagLength(pData, bExplicitDataType, &tagHeader, &bSequence, cache);
 
     // Prepare the identifiers for the sequence (adjust the
     //  endian)
@@ -346,13 +358,13 @@ void dicomStreamCodec::writeTag(std::shared_ptr<streamWriter> pDestStream, std::
         ///////////////////////////////////////////////////////////
         pDestStream->write((std::uint8_t*)&sequenceItemGroup, 2);
         pDestStream->write((std::uint8_t*)&sequenceItemDelimiter, 2);
-        std::uint32_t sequenceItemLength = getDataSetLength(pDataSet, bExplicitDataType);
+        std::uint32_t sequenceItemLength = getDataSetLength(pDataSet, bExplicitDataType, cache);
         pDestStream->adjustEndian((std::uint8_t*)&sequenceItemLength, 4, endianType);
         pDestStream->write((std::uint8_t*)&sequenceItemLength, 4);
 
         // write the dataset
         ///////////////////////////////////////////////////////////
-        buildStream(pDestStream, pDataSet, bExplicitDataType, endianType, streamType_t::normal);
+        buildStream(pDestStream, pDataSet, bExplicitDataType, endianType, streamType_t::normal, cache);
     }
 
     // write the sequence item end marker
@@ -378,22 +390,41 @@ void dicomStreamCodec::writeTag(std::shared_ptr<streamWriter> pDestStream, std::
 //
 ///////////////////////////////////////////////////////////
 ///////////////////////////////////////////////////////////
-std::uint32_t dicomStreamCodec::getTagLength(const std::shared_ptr<data>& pData, bool bExplicitDataType, std::uint32_t* pHeaderLength, bool *pbSequence)
+std::uint32_t dicomStreamCodec::getTagLength(const std::shared_ptr<data>& pData, bool bExplicitDataType, std::uint32_t* pHeaderLength, bool *pbSequence, lengthsCache& cache)
 {
     IMEBRA_FUNCTION_START();
 
+    // Return the cached length if the tag has already been
+    //  measured
+    ///////////////////////////////////////////////////////////
+    std::map<const data*, lengthsCache::tagLength>::const_iterator findLength(cache.m_tagsLengths.find(pData.get()));
+    if(findLength != cache.m_tagsLengths.end())
+    {
+        *pHeaderLength = findLength->second.m_headerLength;
+        *pbSequence = findLength->second.m_bSequence;
+        return findLength->second.m_length;
+    }
+
     tagVR_t dataType = pData->getDataType();
     *pbSequence = (dataType == tagVR_t::SQ);
     std::uint32_t numberOfElements = 0;
+    std::uint32_t numberOfItems = 0; // Items actually written in a sequence
     std::uint32_t totalLength = 0;
     for(std::uint32_t scanBuffers = 0; ; ++scanBuffers, ++numberOfElements)
     {
         if(pData->dataSetExists(scanBuffers))
         {
             std::shared_ptr<dataSet> pDataSet = pData->getSequenceItem(scanBuffers);
-            totalLength += getDataSetLength(pDataSet, bExplicitDataType);
-            totalLength += 8; // item tag and item length
             *pbSequence = true;
+
+            // Empty datasets are not written
+            ///////////////////////////////////////////////////////////
+            if(pDataSet->getGroups().empty())
+            {
+                continue;
+            }
+            totalLength += getDataSetLength(pDataSet, bExplicitDataType, cache);
+            ++numberOfItems;
             continue;
         }
         if(!pData->bufferExists(scanBuffers))
@@ -401,6 +432,7 @@ std::uint32_t dicomStreamCodec::getTagLength(const std::shared_ptr<data>& pData,
             break;
         }
         totalLength += (std::uint32_t)pData->getBufferSize(scanBuffers);
+        ++numberOfItems;
     }
 
     (*pbSequence) |= (numberOfElements > 1);
@@ -414,11 +446,18 @@ std::uint32_t dicomStreamCodec::getTagLength(const std::shared_ptr<data>& pData,
         (*pHeaderLength) +=4;
     }
 
+    // Add the items' headers and the sequence delimiter
+    ///////////////////////////////////////////////////////////
     if(*pbSequence)
     {
-        totalLength += (numberOfElements+1) * 8;
+        totalLength += (numberOfItems + 1) * 8;
     }
 
+    lengthsCache::tagLength& cachedLength(cache.m_tagsLengths[pData.get()]);
+    cachedLength.m_length = totalLength;
+    cachedLength.m_headerLength = *pHeaderLength;
+    cachedLength.m_bSequence = *pbSequence;
+
     return totalLength;
 
     IMEBRA_FUNCTION_END();
@@ -434,7 +473,7 @@ std::uint32_t dicomStreamCodec::getTagLength(const std::shared_ptr<data>& pData,
 //
 ///////////////////////////////////////////////////////////
 ///////////////////////////////////////////////////////////
-std::uint32_t dicomStreamCodec::getGroupLength(const dataSet::tTags tags, bool bExplicitDataType)
+std::uint32_t dicomStreamCodec::getGroupLength(const dataSet::tTags& tags, bool bExplicitDataType, lengthsCache& cache)
 {
     IMEBRA_FUNCTION_START();
 
@@ -449,7 +488,7 @@ std::uint32_t dicomStreamCodec::getGroupLength(const dataSet::tTags tags, bool b
 
         std::uint32_t tagHeaderLength;
         bool bSequence;
-        totalLength += getTagLength(scanTags->second, bExplicitDataType, &tagHeaderLength, &bSequence);
+        totalLength += getTagLength(scanTags->second, bExplicitDataType, &tagHeaderLength, &bSequence, cache);
         totalLength += tagHeaderLength;
     }
 
@@ -468,10 +507,19 @@ std::uint32_t dicomStreamCodec::getGroupLength(const dataSet::tTags tags, bool b
 //
 ///////////////////////////////////////////////////////////
 ///////////////////////////////////////////////////////////
-std::uint32_t dicomStreamCodec::getDataSetLength(std::shared_ptr<dataSet> pDataSet, bool bExplicitDataType)
+std::uint32_t dicomStreamCodec::getDataSetLength(std::shared_ptr<dataSet> pDataSet, bool bExplicitDataType, lengthsCache& cache)
 {
     IMEBRA_FUNCTION_START();
 
+    // Return the cached length if the dataset has already
+    //  been measured
+    ///////////////////////////////////////////////////////////
+    std::map<const dataSet*, std::uint32_t>::const_iterator findLength(cache.m_dataSetsLengths.find(pDataSet.get()));
+    if(findLength != cache.m_dataSetsLengths.end())
+    {
+        return findLength->second;
+    }
+
     dataSet::tGroupsIds groups(pDataSet->getGroups());
 
     std::uint32_t totalLength(0);
@@ -482,17 +530,23 @@ std::uint32_t dicomStreamCodec::getDataSetLength(std::shared_ptr<dataSet> pDataS
         for(size_t scanGroupsNumber(0); scanGroupsNumber != numGroups; ++scanGroupsNumber)
         {
             const dataSet::tTags& tags(pDataSet->getGroupTags(*scanGroups, scanGroupsNumber));
-            totalLength += getGroupLength(tags, bExplicitDataType);
+            totalLength += getGroupLength(tags, bExplicitDataType, cache);
             totalLength += 4; // Add space for the tag 0
-            if(bExplicitDataType) // Add space for the data type
+            if(bExplicitDataType)
             {
-                totalLength += 2;
+                totalLength += 2; // Add space for the data type
+                totalLength += 2; // Add space for the tag's length
+            }
+            else
+            {
+                totalLength += 4; // Add space for the tag's length
             }
-            totalLength += 2; // Add space for the tag's length
             totalLength += 4; // Add space for the group's length
         }
     }
 
+    cache.m_dataSetsLengths[pDataSet.get()] = totalLength;
+
     return totalLength;
 
     IMEBRA_FUNCTION_END();
@@ -502,78 +556,72 @@ std::uint32_t dicomStreamCodec::getDataSetLength(std::shared_ptr<dataSet> pDataS
 ///////////////////////////////////////////////////////////
 //
 //
-// Read a DICOM stream and fill the dataset with the
-//  DICOM's content
+// Probe the DICOM signature. The checks are the same
+//  performed by readStream()
 //
 //
 ///////////////////////////////////////////////////////////
 ///////////////////////////////////////////////////////////
-void dicomStreamCodec::readStream(std::shared_ptr<streamReader> pStream, std::shared_ptr<dataSet> pDataSet, std::uint32_t maxSizeBufferLoad /* = 0xffffffff */) const
+bool dicomStreamCodec::canRead(const std::uint8_t* pPrefix, size_t prefixLength) const
 {
-    IMEBRA_FUNCTION_START();
-
-    // Save the starting position
-    ///////////////////////////////////////////////////////////
-    size_t position = pStream->position();
-
-    // This flag signals a failure
+    // DICM signature after the 128 bytes preamble
     ///////////////////////////////////////////////////////////
-    bool bFailed=false;
-
-    // Read the old dicom signature (NEMA)
-    ///////////////////////////////////////////////////////////
-    std::uint8_t oldDicomSignature[8];
-
-    try
+    if(prefixLength >= 132 && ::memcmp(pPrefix + 128, "DICM", 4) == 0)
     {
-        pStream->read(oldDicomSignature, 8);
-    }
-    catch(StreamEOFError&)
-    {
-        IMEBRA_THROW(CodecWrongFormatError, "detected a wrong format");
+        return true;
     }
 
-    // Skip the first 128 bytes (8 already skipped)
+    // Old NEMA files without preamble: the first tag must
+    //  belong to the group 0x0002 or 0x0008
     ///////////////////////////////////////////////////////////
-    pStream->seekForward(120);
+    return prefixLength >= 8 &&
+            (pPrefix[0] == 0x8 || pPrefix[0] == 0x2) &&
+            pPrefix[1] == 0x0 &&
+            pPrefix[3] == 0x0;
+}
 
-    // Read the DICOM signature (DICM)
-    ///////////////////////////////////////////////////////////
-    std::uint8_t dicomSignature[4];
-    pStream->read(dicomSignature, 4);
+///////////////////////////////////////////////////////////
+///////////////////////////////////////////////////////////
+//
+//
+// Read a DICOM stream and fill the dataset with the
+//  DICOM's content
+//
+//
+///////////////////////////////////////////////////////////
+///////////////////////////////////////////////////////////
+void dicomStreamCodec::readStream(std::shared_ptr<streamReader> pStream, std::shared_ptr<dataSet> pDataSet, std::uint32_t maxSizeBufferLoad /* = 0xffffffff */) const
+{
+    IMEBRA_FUNCTION_START();
 
-    // Check the DICM signature
+    IMEBRA_STATISTICS_TIMER(parsingTimer, parsingTime);
+
+    // Peek the preamble and the DICM signature
     ///////////////////////////////////////////////////////////
-    const char* checkSignature="DICM";
-    if(::memcmp(dicomSignature, checkSignature, 4) != 0)
+    std::uint8_t prefix[IMEBRA_STREAM_PROBE_LENGTH];
+    const size_t prefixLength(pStream->peek(prefix, sizeof(prefix)));
+
+    if(!canRead(prefix, prefixLength))
     {
-        bFailed=true;
+        IMEBRA_THROW(CodecWrongFormatError, "detected a wrong format (checked DICM and old NEMA signatures)");
     }
 
     bool bExplicitDataType = true;
     streamController::tByteOrdering endianType=streamController::lowByteEndian;
-    if(bFailed)
+    if(prefixLength >= 132 && ::memcmp(prefix + 128, "DICM", 4) == 0)
     {
-        // Tags 0x8 and 0x2 are accepted in the begin of the file
+        // Skip the preamble and the signature
         ///////////////////////////////////////////////////////////
-        if(
-                (oldDicomSignature[0]!=0x8 && oldDicomSignature[0]!=0x2) ||
-                oldDicomSignature[1]!=0x0 ||
-                oldDicomSignature[3]!=0x0)
-        {
-            IMEBRA_THROW(CodecWrongFormatError, "detected a wrong format (checked old NEMA signature)");
-        }
-
-        // Go back to the beginning of the file
-        ///////////////////////////////////////////////////////////
-        pStream->seek(position);
-
-        // Set "explicit data type" to true if a valid data type
-        //  is found
+        pStream->seekForward(132);
+    }
+    else
+    {
+        // Old NEMA file: set "explicit data type" to true if a
+        //  valid data type is found
         ///////////////////////////////////////////////////////////
         std::string firstDataType;
-        firstDataType.push_back((char)(oldDicomSignature[4]));
-        firstDataType.push_back((char)(oldDicomSignature[5]));
+        firstDataType.push_back((char)(prefix[4]));
+        firstDataType.push_back((char)(prefix[5]));
         bExplicitDataType = dicomDictionary::getDicomDictionary()->isDataTypeValid(firstDataType);
     }
 
@@ -604,6 +652,8 @@ void dicomStreamCodec::parseStream(std::shared_ptr<streamReader> pStream,
 {
     IMEBRA_FUNCTION_START();
 
+    IMEBRA_TRACE_SPAN("dicomStreamCodec::parseStream");
+
     if(depth > IMEBRA_DATASET_MAX_DEPTH)
     {
         IMEBRA_THROW(DicomCodecDepthLimitReachedError, "Depth for embedded dataset reached");
@@ -697,6 +747,8 @@ void dicomStreamCodec::parseStream(std::shared_ptr<streamReader> pStream,
         ///////////////////////////////////////////////////////////
         bFirstTag = false;
 
+        IMEBRA_STATISTICS_ADD(parsedElements, 1);
+
         // Set the word's length to the default value
         ///////////////////////////////////////////////////////////
         wordSize = 1;
@@ -1007,86 +1059,35 @@ std::uint32_t dicomStreamCodec::readTag(
     }
 
     // In order to deal with damaged tags asking for an
-    //  incredible amount of memory, this function reads the
-    //  tag using a lot of small buffers (32768 bytes max)
-    //  and then the tag's buffer is rebuilt at the end of the
-    //  function.
-    // This method saves a lot of time if a huge amount of
-    //  memory is asked by a damaged tag, since only the amount
-    //  of memory actually stored in the source file is
-    //  allocated
-    ///////////////////////////////////////////////////////////
-
-    // If the buffer size is bigger than the following const
-    //  variable, then read the buffer in small chunks
+    //  incredible amount of memory, the function checks that
+    //  the last byte of the tag is actually stored in the
+    //  source stream before allocating the tag's buffer.
+    // The tag's content is then read directly into the
+    //  final buffer, without intermediate copies
     ///////////////////////////////////////////////////////////
-    const std::uint32_t smallBuffersSize(32768);
-
-    if(tagLengthDWord <= smallBuffersSize) // Read in one go
+    if(!pStream->isAvailable(tagLengthDWord))
     {
-        handler->setSize(tagLengthDWord);
-        pStream->read(handler->getMemoryBuffer(), tagLengthDWord);
+        IMEBRA_THROW(StreamEOFError, "Attempt to read past the end of the file");
     }
-    else // Read in small chunks
-    {
-        std::list<std::vector<std::uint8_t> > buffers;
-
-        // Used to keep track of the read bytes
-        ///////////////////////////////////////////////////////////
-        std::uint32_t remainingBytes(tagLengthDWord);
-
-        // Fill all the small buffers
-        ///////////////////////////////////////////////////////////
-        while(remainingBytes != 0)
-        {
-            // Calculate the small buffer's size and allocate it
-            ///////////////////////////////////////////////////////////
-            std::uint32_t thisBufferSize( (remainingBytes > smallBuffersSize) ? smallBuffersSize : remainingBytes);
-            buffers.push_back(std::vector<std::uint8_t>());
-            buffers.back().resize(thisBufferSize);
-
-            // Fill the buffer
-            ///////////////////////////////////////////////////////////
-            pStream->read(&buffers.back()[0], thisBufferSize);
 
-            // Decrease the number of the remaining bytes
-            ///////////////////////////////////////////////////////////
-            remainingBytes -= thisBufferSize;
-        }
-
-        // Copy the small buffers into the tag object
-        ///////////////////////////////////////////////////////////
-        handler->setSize(tagLengthDWord);
-        std::uint8_t* pHandlerBuffer(handler->getMemoryBuffer());
+    handler->setSize(tagLengthDWord);
+    std::uint8_t* pHandlerBuffer(handler->getMemoryBuffer());
 
-        // Scan all the small buffers and copy their content into
-        //  the final buffer
-        ///////////////////////////////////////////////////////////
-        std::list<std::vector<std::uint8_t> >::iterator smallBuffersIterator;
-        remainingBytes = tagLengthDWord;
-        for(smallBuffersIterator=buffers.begin(); smallBuffersIterator != buffers.end(); ++smallBuffersIterator)
-        {
-            std::uint32_t copySize=(remainingBytes>smallBuffersSize) ? smallBuffersSize : remainingBytes;
-            ::memcpy(pHandlerBuffer, &(*smallBuffersIterator)[0], copySize);
-            pHandlerBuffer += copySize;
-            remainingBytes -= copySize;
-        }
-    } // end of reading from stream
+    // Tags 0xfffc,0xfffc (end of the stream) don't need
+    //  the byte endian adjustment
+    ///////////////////////////////////////////////////////////
+    const bool bAdjustEndian(wordSize > 1 && !(tagId == 0xfffc && tagSubId == 0xfffc));
 
-    // All the bytes have been read, now rebuild the tag's
-    //  buffer. Don't rebuild the tag if it is 0xfffc,0xfffc
-    //  (end of the stream)
+    // The byte endian is adjusted while the data is copied
+    //  from the stream
     ///////////////////////////////////////////////////////////
-    if(tagId == 0xfffc && tagSubId == 0xfffc)
+    if(bAdjustEndian)
     {
-        return (std::uint32_t)tagLengthDWord;
+        pStream->read(pHandlerBuffer, tagLengthDWord, wordSize, endianType);
     }
-
-    // Adjust the buffer's byte endian
-    ///////////////////////////////////////////////////////////
-    if(wordSize != 0)
+    else
     {
-        pStream->adjustEndian(handler->getMemoryBuffer(), wordSize, endianType, tagLengthDWord / wordSize);
+        pStream->read(pHandlerBuffer, tagLengthDWord);
     }
 
     // Return the tag's length in bytes
@@ -23,6 +23,7 @@ If you do not want to be bound by the GPL terms (such as the requirement
 #include "dataImpl.h"
 #include "dataSetImpl.h"
 #include "streamControllerImpl.h"
+#include <map>
 
 /// \def IMEBRA_DATASET_MAX_DEPTH
 /// \brief Max number of datasets embedded into each 
@@ -116,6 +117,14 @@ public:
 		std::uint32_t* pReadSubItemLength = 0,
         std::uint32_t depth = 0);
 
+    /// \brief Returns true if the prefix contains the DICM
+    ///        signature after the 128 bytes preamble, or
+    ///        if it starts with a group 0x0002 or 0x0008 tag
+    ///        (files without preamble).
+    ///
+    ///////////////////////////////////////////////////////////
+    virtual bool canRead(const std::uint8_t* pPrefix, size_t prefixLength) const;
+
     /// \brief Indicates the type of DICOM stream to build
     ///
     ///////////////////////////////////////////////////////////
@@ -140,6 +149,32 @@ public:
 	///////////////////////////////////////////////////////////
     static void buildStream(std::shared_ptr<streamWriter> pStream, std::shared_ptr<dataSet> pDataSet, bool bExplicitDataType, streamController::tByteOrdering endianType, streamType_t streamType);
 
+protected:
+    /// \brief Stores the lengths calculated while writing
+    ///         a stream.
+    ///
+    /// The length of each tag and of each embedded dataset
+    ///  is calculated only once per written stream, even
+    ///  when the datasets are nested several levels deep.
+    ///
+    ///////////////////////////////////////////////////////////
+    struct lengthsCache
+    {
+        struct tagLength
+        {
+            std::uint32_t m_length;
+            std::uint32_t m_headerLength;
+            bool m_bSequence;
+        };
+
+        std::map<const data*, tagLength> m_tagsLengths;
+        std::map<const dataSet*, std::uint32_t> m_dataSetsLengths;
+    };
+
+    // Build a dicom stream using the specified lengths cache
+    ///////////////////////////////////////////////////////////
+    static void buildStream(std::shared_ptr<streamWriter> pStream, std::shared_ptr<dataSet> pDataSet, bool bExplicitDataType, streamController::tByteOrdering endianType, streamType_t streamType, lengthsCache& cache);
+
 protected:
 	// Write a dicom stream
 	///////////////////////////////////////////////////////////
@@ -156,23 +191,23 @@ protected:
 
 	// Calculate the tag's length
 	///////////////////////////////////////////////////////////
-    static std::uint32_t getTagLength(const std::shared_ptr<data>& pData, bool bExplicitDataType, std::uint32_t* pHeaderLength, bool *pbSequence);
+    static std::uint32_t getTagLength(const std::shared_ptr<data>& pData, bool bExplicitDataType, std::uint32_t* pHeaderLength, bool *pbSequence, lengthsCache& cache);
 
 	// Calculate the group's length
 	///////////////////////////////////////////////////////////
-    static std::uint32_t getGroupLength(const dataSet::tTags tags, bool bExplicitDataType);
+    static std::uint32_t getGroupLength(const dataSet::tTags& tags, bool bExplicitDataType, lengthsCache& cache);
 
 	// Calculate the dataset's length
 	///////////////////////////////////////////////////////////
-    static std::uint32_t getDataSetLength(std::shared_ptr<dataSet>, bool bExplicitDataType);
+    static std::uint32_t getDataSetLength(std::shared_ptr<dataSet>, bool bExplicitDataType, lengthsCache& cache);
 
 	// Write a single group
 	///////////////////////////////////////////////////////////
-    static void writeGroup(std::shared_ptr<streamWriter> pDestStream, const dataSet::tTags& tags, std::uint16_t groupId, bool bExplicitDataType, streamController::tByteOrdering endianType);
+    static void writeGroup(std::shared_ptr<streamWriter> pDestStream, const dataSet::tTags& tags, std::uint16_t groupId, bool bExplicitDataType, streamController::tByteOrdering endianType, lengthsCache& cache);
 
 	// Write a single tag
 	///////////////////////////////////////////////////////////
-    static void writeTag(std::shared_ptr<streamWriter> pDestStream, std::shared_ptr<data> pData, std::uint16_t tagId, bool bExplicitDataType, streamController::tByteOrdering endianType);
+    static void writeTag(std::shared_ptr<streamWriter> pDestStream, std::shared_ptr<data> pData, std::uint16_t tagId, bool bExplicitDataType, streamController::tByteOrdering endianType, lengthsCache& cache);
 };
 
 
@@ -21,6 +21,7 @@ If you do not want to be bound by the GPL terms (such as the requirement
 #include "colorTransformsFactoryImpl.h"
 #include "transformHighBitImpl.h"
 #include "transformsChainImpl.h"
+#include "tracingImpl.h"
 
 namespace imebra
 {
@@ -76,6 +77,8 @@ size_t drawBitmap::getBitmap(const std::shared_ptr<const image>& sourceImage, dr
         return memorySize;
     }
 
+    IMEBRA_TRACE_SPAN("drawBitmap::getBitmap");
+
     // This chain will contain all the necessary transforms, including color
     //  transforms and high bit shift
     ///////////////////////////////////////////////////////////////////////////////
@@ -17,6 +17,7 @@ If you do not want to be bound by the GPL terms (such as the requirement
 */
 
 #include "exceptionImpl.h"
+#include "statisticsImpl.h"
 #include "fileStreamImpl.h"
 #include "charsetConversionImpl.h"
 #include "../include/imebra/exceptions.h"
@@ -279,6 +280,8 @@ size_t fileStreamInput::read(size_t startPosition, std::uint8_t* pBuffer, size_t
 
     std::lock_guard<std::mutex> lock(m_mutex);
 
+    IMEBRA_STATISTICS_TIMER(readTimer, fileReadTime);
+
     ::fseek(m_openFile, (long)startPosition, SEEK_SET);
 	if(ferror(m_openFile) != 0)
 	{
@@ -290,11 +293,40 @@ size_t fileStreamInput::read(size_t startPosition, std::uint8_t* pBuffer, size_t
 	{
         IMEBRA_THROW(StreamReadError, "stream::read failure");
 	}
+    IMEBRA_STATISTICS_ADD(fileBytesRead, readBytes);
 	return readBytes;
 
 	IMEBRA_FUNCTION_END();
 }
 
+
+///////////////////////////////////////////////////////////
+///////////////////////////////////////////////////////////
+//
+//
+// Return the file's size
+//
+//
+///////////////////////////////////////////////////////////
+///////////////////////////////////////////////////////////
+size_t fileStreamInput::getSize()
+{
+    IMEBRA_FUNCTION_START();
+
+    std::lock_guard<std::mutex> lock(m_mutex);
+
+    ::fseek(m_openFile, 0, SEEK_END);
+    const long fileSize(::ftell(m_openFile));
+    if(ferror(m_openFile) != 0 || fileSize < 0)
+    {
+        IMEBRA_THROW(StreamReadError, "stream::getSize failure");
+    }
+    return (size_t)fileSize;
+
+    IMEBRA_FUNCTION_END();
+}
+
+
 } // namespace implementation
 
 } // namespace imebra
@@ -78,6 +78,11 @@ public:
 	///////////////////////////////////////////////////////////
     virtual size_t read(size_t startPosition, std::uint8_t* pBuffer, size_t bufferLength);
 
+    /// \brief Returns the file's size, in bytes.
+    ///
+    ///////////////////////////////////////////////////////////
+    size_t getSize();
+
 };
 
 class fileStreamOutput : public baseStreamOutput, public fileStream
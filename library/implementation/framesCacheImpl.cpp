@@ -0,0 +1,352 @@
+/*
+Copyright 2005 - 2017 by Paolo Brandoli/Binarno s.p.
+
+Imebra is available for free under the GNU General Public License.
+
+The full text of the license is available in the file license.rst
+ in the project root folder.
+
+If you do not want to be bound by the GPL terms (such as the requirement
+ that your application must also be GPL), you may purchase a commercial
+ license for Imebra from the Imebra’s website (http://imebra.com).
+*/
+
+/*! \file framesCacheImpl.cpp
+    \brief Implementation of the class framesCache.
+
+*/
+
+#include "framesCacheImpl.h"
+#include "exceptionImpl.h"
+#include "imageImpl.h"
+#include "threadPoolImpl.h"
+#include <chrono>
+#include <vector>
+
+namespace imebra
+{
+
+namespace implementation
+{
+
+///////////////////////////////////////////////////////////
+//
+// Return the memory used by a decoded frame
+//
+///////////////////////////////////////////////////////////
+static size_t getImageMemorySize(const image& decodedImage)
+{
+    std::uint32_t width, height;
+    decodedImage.getSize(&width, &height);
+
+    size_t bytesPerChannel(1);
+    switch(decodedImage.getDepth())
+    {
+    case bitDepth_t::depthU16:
+    case bitDepth_t::depthS16:
+        bytesPerChannel = 2;
+        break;
+    case bitDepth_t::depthU32:
+    case bitDepth_t::depthS32:
+        bytesPerChannel = 4;
+        break;
+    default:
+        break;
+    }
+
+    return (size_t)width * (size_t)height * (size_t)decodedImage.getChannelsNumber() * bytesPerChannel;
+}
+
+
+///////////////////////////////////////////////////////////
+//
+// Cached frame constructor
+//
+///////////////////////////////////////////////////////////
+framesCache::cachedFrame::cachedFrame():
+    m_bClaimed(false),
+    m_image(m_promise.get_future().share()),
+    m_size(0)
+{
+}
+
+
+///////////////////////////////////////////////////////////
+//
+// Constructor
+//
+///////////////////////////////////////////////////////////
+framesCache::framesCache(size_t memoryBudget, std::uint32_t readAheadFrames):
+    m_memoryBudget(memoryBudget),
+    m_readAheadFrames(readAheadFrames),
+    m_usedMemory(0),
+    m_lastFrame(0),
+    m_bBackward(false),
+    m_hits(0),
+    m_misses(0),
+    m_decodedFrames(0),
+    m_decodingTime(0),
+    m_maxDecodingTime(0)
+{
+}
+
+
+///////////////////////////////////////////////////////////
+//
+// Retrieve a frame
+//
+///////////////////////////////////////////////////////////
+std::shared_ptr<image> framesCache::getImage(std::uint32_t frameNumber, std::uint32_t numberOfFrames, const decoder_t& decoder)
+{
+    IMEBRA_FUNCTION_START();
+
+    std::shared_ptr<cachedFrame> pFrame;
+    std::vector<std::pair<std::uint32_t, std::shared_ptr<cachedFrame> > > readAhead;
+
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+
+        // Detect the playback direction
+        ///////////////////////////////////////////////////////////
+        if(frameNumber != m_lastFrame)
+        {
+            m_bBackward = frameNumber < m_lastFrame;
+            m_lastFrame = frameNumber;
+        }
+
+        // Schedule the decoding of the next frames before moving
+        //  the requested frame in front of the LRU list, so it
+        //  is discarded last
+        ///////////////////////////////////////////////////////////
+        for(std::uint32_t scanFrames(1); scanFrames <= m_readAheadFrames; ++scanFrames)
+        {
+            if(m_bBackward ? (scanFrames > frameNumber) : (scanFrames >= numberOfFrames - frameNumber))
+            {
+                break;
+            }
+            const std::uint32_t readAheadFrame(m_bBackward ? frameNumber - scanFrames : frameNumber + scanFrames);
+            if(m_frames.find(readAheadFrame) == m_frames.end())
+            {
+                readAhead.push_back(std::make_pair(readAheadFrame, addFrame(readAheadFrame)));
+            }
+        }
+
+        frames_t::iterator findFrame(m_frames.find(frameNumber));
+        if(findFrame == m_frames.end())
+        {
+            ++m_misses;
+            pFrame = addFrame(frameNumber);
+        }
+        else
+        {
+            ++m_hits;
+            pFrame = findFrame->second;
+            m_lru.splice(m_lru.begin(), m_lru, pFrame->m_lruPosition);
+        }
+    }
+
+    threadPool& pool(threadPool::getSharedThreadPool());
+    std::shared_ptr<framesCache> pCache(shared_from_this());
+    for(size_t scanReadAhead(0); scanReadAhead != readAhead.size(); ++scanReadAhead)
+    {
+        const std::uint32_t readAheadFrame(readAhead[scanReadAhead].first);
+        std::shared_ptr<cachedFrame> pReadAheadFrame(readAhead[scanReadAhead].second);
+        pool.execute([pCache, readAheadFrame, pReadAheadFrame, decoder](){ pCache->decodeFrame(readAheadFrame, pReadAheadFrame, decoder); });
+    }
+
+    // If nobody started decoding the frame then decode it in
+    //  this thread: waiting for a task queued in the shared
+    //  pool could deadlock when called from the pool itself
+    ///////////////////////////////////////////////////////////
+    decodeFrame(frameNumber, pFrame, decoder);
+
+    return pFrame->m_image.get();
+
+    IMEBRA_FUNCTION_END();
+}
+
+
+///////////////////////////////////////////////////////////
+//
+// Discard all the frames
+//
+///////////////////////////////////////////////////////////
+void framesCache::clear()
+{
+    IMEBRA_FUNCTION_START();
+
+    std::lock_guard<std::mutex> lock(m_mutex);
+
+    m_frames.clear();
+    m_lru.clear();
+    m_usedMemory = 0;
+
+    IMEBRA_FUNCTION_END();
+}
+
+
+///////////////////////////////////////////////////////////
+//
+// Return the statistics
+//
+///////////////////////////////////////////////////////////
+FramesCacheStatistics framesCache::getStatistics() const
+{
+    IMEBRA_FUNCTION_START();
+
+    std::lock_guard<std::mutex> lock(m_mutex);
+
+    FramesCacheStatistics statistics;
+    statistics.hits = m_hits;
+    statistics.misses = m_misses;
+    statistics.decodedFrames = m_decodedFrames;
+    statistics.decodingTime = m_decodingTime;
+    statistics.maxDecodingTime = m_maxDecodingTime;
+    statistics.cachedFrames = m_frames.size();
+    statistics.usedMemory = m_usedMemory;
+
+    return statistics;
+
+    IMEBRA_FUNCTION_END();
+}
+
+
+///////////////////////////////////////////////////////////
+//
+// Reset the statistics
+//
+///////////////////////////////////////////////////////////
+void framesCache::resetStatistics()
+{
+    IMEBRA_FUNCTION_START();
+
+    std::lock_guard<std::mutex> lock(m_mutex);
+
+    m_hits = m_misses = m_decodedFrames = m_decodingTime = m_maxDecodingTime = 0;
+
+    IMEBRA_FUNCTION_END();
+}
+
+
+///////////////////////////////////////////////////////////
+//
+// Add a frame to the cache
+//
+///////////////////////////////////////////////////////////
+std::shared_ptr<framesCache::cachedFrame> framesCache::addFrame(std::uint32_t frameNumber)
+{
+    std::shared_ptr<cachedFrame> pFrame(std::make_shared<cachedFrame>());
+    m_lru.push_front(frameNumber);
+    pFrame->m_lruPosition = m_lru.begin();
+    m_frames[frameNumber] = pFrame;
+    return pFrame;
+}
+
+
+///////////////////////////////////////////////////////////
+//
+// Decode a frame
+//
+///////////////////////////////////////////////////////////
+void framesCache::decodeFrame(std::uint32_t frameNumber, std::shared_ptr<cachedFrame> pFrame, const decoder_t& decoder)
+{
+    IMEBRA_FUNCTION_START();
+
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        if(pFrame->m_bClaimed)
+        {
+            return;
+        }
+        pFrame->m_bClaimed = true;
+    }
+
+    std::chrono::steady_clock::time_point startTime(std::chrono::steady_clock::now());
+
+    std::shared_ptr<image> pImage;
+    try
+    {
+        pImage = decoder(frameNumber);
+    }
+    catch(...)
+    {
+        pFrame->m_promise.set_exception(std::current_exception());
+
+        // Don't keep the failure: the next request will retry
+        ///////////////////////////////////////////////////////////
+        std::lock_guard<std::mutex> lock(m_mutex);
+        frames_t::iterator findFrame(m_frames.find(frameNumber));
+        if(findFrame != m_frames.end() && findFrame->second == pFrame)
+        {
+            m_lru.erase(pFrame->m_lruPosition);
+            m_frames.erase(findFrame);
+        }
+        return;
+    }
+
+    const std::uint64_t decodingTime((std::uint64_t)std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - startTime).count());
+
+    // Update the statistics before the waiting threads are
+    //  released
+    ///////////////////////////////////////////////////////////
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+
+        ++m_decodedFrames;
+        m_decodingTime += decodingTime;
+        if(decodingTime > m_maxDecodingTime)
+        {
+            m_maxDecodingTime = decodingTime;
+        }
+
+        // The frame may have been discarded by clear() while it
+        //  was being decoded
+        ///////////////////////////////////////////////////////////
+        frames_t::iterator findFrame(m_frames.find(frameNumber));
+        if(findFrame != m_frames.end() && findFrame->second == pFrame && pImage != 0)
+        {
+            pFrame->m_size = getImageMemorySize(*pImage);
+            m_usedMemory += pFrame->m_size;
+            evictFrames();
+        }
+    }
+
+    pFrame->m_promise.set_value(pImage);
+
+    IMEBRA_FUNCTION_END();
+}
+
+
+///////////////////////////////////////////////////////////
+//
+// Discard the least recently used frames
+//
+///////////////////////////////////////////////////////////
+void framesCache::evictFrames()
+{
+    // The most recently used frame is always kept, even if
+    //  it alone exceeds the budget. Frames still being
+    //  decoded don't use memory yet and are skipped
+    ///////////////////////////////////////////////////////////
+    std::list<std::uint32_t>::iterator scanLru(m_lru.end());
+    while(m_usedMemory > m_memoryBudget && scanLru != m_lru.begin())
+    {
+        --scanLru;
+        if(scanLru == m_lru.begin())
+        {
+            break;
+        }
+        frames_t::iterator findFrame(m_frames.find(*scanLru));
+        if(findFrame->second->m_size == 0)
+        {
+            continue;
+        }
+        m_usedMemory -= findFrame->second->m_size;
+        m_frames.erase(findFrame);
+        scanLru = m_lru.erase(scanLru);
+    }
+}
+
+} // namespace implementation
+
+} // namespace imebra
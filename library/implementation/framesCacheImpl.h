@@ -0,0 +1,177 @@
+/*
+Copyright 2005 - 2017 by Paolo Brandoli/Binarno s.p.
+
+Imebra is available for free under the GNU General Public License.
+
+The full text of the license is available in the file license.rst
+ in the project root folder.
+
+If you do not want to be bound by the GPL terms (such as the requirement
+ that your application must also be GPL), you may purchase a commercial
+ license for Imebra from the Imebra’s website (http://imebra.com).
+*/
+
+/*! \file framesCacheImpl.h
+    \brief Declaration of the class framesCache.
+
+*/
+
+#if !defined(imebraFramesCache_3F8B6D20_7E41_4C95_B2A7_C16E0D9F4A58__INCLUDED_)
+#define imebraFramesCache_3F8B6D20_7E41_4C95_B2A7_C16E0D9F4A58__INCLUDED_
+
+#include <memory>
+#include <map>
+#include <list>
+#include <future>
+#include <mutex>
+#include <functional>
+#include <cstdint>
+#include "../include/imebra/definitions.h"
+
+namespace imebra
+{
+
+namespace implementation
+{
+
+class image;
+
+///////////////////////////////////////////////////////////
+///////////////////////////////////////////////////////////
+/// \brief Keeps the most recently used decoded frames of
+///         a dataset in memory.
+///
+/// When a frame is requested, the following frames in the
+///  playback direction are decoded in advance by the
+///  library's shared thread pool.
+///
+/// The least recently used frames are discarded when the
+///  memory used by the decoded frames exceeds the budget.
+///
+/// The cache never calls the dataset while holding its
+///  own lock, so the dataset can call clear() while
+///  holding its lock.
+///
+///////////////////////////////////////////////////////////
+///////////////////////////////////////////////////////////
+class framesCache: public std::enable_shared_from_this<framesCache>
+{
+public:
+    /// \brief Function used to decode a frame.
+    ///
+    ///////////////////////////////////////////////////////////
+    typedef std::function<std::shared_ptr<image>(std::uint32_t)> decoder_t;
+
+    /// \brief Constructor.
+    ///
+    /// @param memoryBudget    the maximum amount of memory,
+    ///                         in bytes, used by the decoded
+    ///                         frames
+    /// @param readAheadFrames the number of frames to decode
+    ///                         in advance
+    ///
+    ///////////////////////////////////////////////////////////
+    framesCache(size_t memoryBudget, std::uint32_t readAheadFrames);
+
+    /// \brief Return a frame from the cache, decoding it if
+    ///         it is not available, and schedule the decoding
+    ///         of the next frames in the playback direction.
+    ///
+    /// If the frame is being decoded in the background then
+    ///  waits for it, or decodes it in the calling thread if
+    ///  the decoding has not started yet.
+    ///
+    /// @param frameNumber    the frame to retrieve
+    /// @param numberOfFrames the number of frames in the
+    ///                        dataset
+    /// @param decoder        the function that decodes a
+    ///                        frame
+    /// @return the decoded frame
+    ///
+    ///////////////////////////////////////////////////////////
+    std::shared_ptr<image> getImage(std::uint32_t frameNumber, std::uint32_t numberOfFrames, const decoder_t& decoder);
+
+    /// \brief Discard all the cached frames.
+    ///
+    /// Frames being decoded in the background are discarded
+    ///  when their decoding ends.
+    ///
+    ///////////////////////////////////////////////////////////
+    void clear();
+
+    /// \brief Return the cache statistics.
+    ///
+    ///////////////////////////////////////////////////////////
+    FramesCacheStatistics getStatistics() const;
+
+    /// \brief Reset the hits, misses and decoding times.
+    ///
+    ///////////////////////////////////////////////////////////
+    void resetStatistics();
+
+private:
+    /// \brief A frame stored in the cache.
+    ///
+    ///////////////////////////////////////////////////////////
+    struct cachedFrame
+    {
+        cachedFrame();
+
+        bool m_bClaimed;       ///< true when the decoding started
+        std::promise<std::shared_ptr<image> > m_promise;
+        std::shared_future<std::shared_ptr<image> > m_image;
+        size_t m_size;         ///< 0 until decoded
+        std::list<std::uint32_t>::iterator m_lruPosition;
+    };
+
+    typedef std::map<std::uint32_t, std::shared_ptr<cachedFrame> > frames_t;
+
+    /// \brief Add a frame in front of the LRU list.
+    ///
+    /// The caller must hold m_mutex.
+    ///
+    ///////////////////////////////////////////////////////////
+    std::shared_ptr<cachedFrame> addFrame(std::uint32_t frameNumber);
+
+    /// \brief Decode a frame, unless another thread already
+    ///         started decoding it.
+    ///
+    ///////////////////////////////////////////////////////////
+    void decodeFrame(std::uint32_t frameNumber, std::shared_ptr<cachedFrame> pFrame, const decoder_t& decoder);
+
+    /// \brief Discard the least recently used frames until
+    ///         the used memory fits in the budget.
+    ///
+    /// The caller must hold m_mutex.
+    ///
+    ///////////////////////////////////////////////////////////
+    void evictFrames();
+
+    const size_t m_memoryBudget;
+    const std::uint32_t m_readAheadFrames;
+
+    frames_t m_frames;
+    std::list<std::uint32_t> m_lru;
+
+    size_t m_usedMemory;
+
+    // Last requested frame, used to detect the playback
+    //  direction
+    ///////////////////////////////////////////////////////////
+    std::uint32_t m_lastFrame;
+    bool m_bBackward;
+
+    std::uint64_t m_hits;
+    std::uint64_t m_misses;
+    std::uint64_t m_decodedFrames;
+    std::uint64_t m_decodingTime;
+    std::uint64_t m_maxDecodingTime;
+
+    mutable std::mutex m_mutex;
+};
+
+} // namespace implementation
+
+} // namespace imebra
+
+#endif // !defined(imebraFramesCache_3F8B6D20_7E41_4C95_B2A7_C16E0D9F4A58__INCLUDED_)
@@ -0,0 +1,64 @@
+/*
+Copyright 2005 - 2017 by Paolo Brandoli/Binarno s.p.
+
+Imebra is available for free under the GNU General Public License.
+
+The full text of the license is available in the file license.rst
+ in the project root folder.
+
+If you do not want to be bound by the GPL terms (such as the requirement
+ that your application must also be GPL), you may purchase a commercial
+ license for Imebra from the Imebra’s website (http://imebra.com).
+*/
+
+/*! \file frozenLockImpl.h
+    \brief Declaration of the lock used by the objects that
+            can be frozen (dataSet, data, buffer).
+
+*/
+
+#if !defined(imebraFrozenLock_8D3A5E61_2C94_4F7B_A1E8_56B0C7D2F934__INCLUDED_)
+#define imebraFrozenLock_8D3A5E61_2C94_4F7B_A1E8_56B0C7D2F934__INCLUDED_
+
+#include <atomic>
+#include <mutex>
+
+namespace imebra
+{
+
+namespace implementation
+{
+
+///////////////////////////////////////////////////////////
+/// \brief Lock a mutex for a read operation, unless the
+///         object that owns the mutex has been frozen.
+///
+/// Frozen objects don't change anymore, so they can be
+///  read concurrently without locking.
+///
+/// The frozen flag is set while the mutex is locked,
+///  after the object has been prepared for the lock-free
+///  reads: a reader that sees the flag set also sees the
+///  final state of the object.
+///
+/// @param mutex   the mutex to lock
+/// @param bFrozen the object's frozen flag
+/// @return a lock that owns the mutex if the object is
+///          not frozen, or an empty lock otherwise
+///
+///////////////////////////////////////////////////////////
+template<class mutex_t>
+inline std::unique_lock<mutex_t> lockUnlessFrozen(mutex_t& mutex, const std::atomic<bool>& bFrozen)
+{
+    if(bFrozen.load(std::memory_order_acquire))
+    {
+        return std::unique_lock<mutex_t>(mutex, std::defer_lock);
+    }
+    return std::unique_lock<mutex_t>(mutex);
+}
+
+} // namespace implementation
+
+} // namespace imebra
+
+#endif // !defined(imebraFrozenLock_8D3A5E61_2C94_4F7B_A1E8_56B0C7D2F934__INCLUDED_)
@@ -119,6 +119,33 @@ void huffmanTable::incValueFreq(const std::uint32_t value)
 }
 
 
+///////////////////////////////////////////////////////////
+///////////////////////////////////////////////////////////
+//
+//
+// Add the frequencies collected by another table
+//
+//
+///////////////////////////////////////////////////////////
+///////////////////////////////////////////////////////////
+void huffmanTable::addValuesFreq(const huffmanTable& source)
+{
+    IMEBRA_FUNCTION_START();
+
+    if(source.m_numValues != m_numValues)
+    {
+        IMEBRA_THROW(std::logic_error, "The huffman tables have a different number of values");
+    }
+
+    for(std::uint32_t scanValues(0); scanValues != m_numValues; ++scanValues)
+    {
+        m_valuesFreq[scanValues].m_freq += source.m_valuesFreq[scanValues].m_freq;
+    }
+
+    IMEBRA_FUNCTION_END();
+}
+
+
 ///////////////////////////////////////////////////////////
 ///////////////////////////////////////////////////////////
 //
@@ -110,6 +110,19 @@ public:
 	///////////////////////////////////////////////////////////
 	void incValueFreq(const std::uint32_t value);
 
+	/// \brief Add the frequencies collected by another table
+	///         to the frequencies of this table.
+	///
+	/// Used to merge the frequencies collected concurrently
+	///  by several copies of the same table.
+	///
+	/// @param source  the table that collected the
+	///                 frequencies to add. It must have the
+	///                 same number of values of this table
+	///
+	///////////////////////////////////////////////////////////
+	void addValuesFreq(const huffmanTable& source);
+
 	/// \brief Calculates the length of the huffman codes.
 	///
 	/// This function must be called after incValueFreq() has
@@ -54,6 +54,21 @@ void channel::allocate(std::uint32_t width, std::uint32_t height)
     IMEBRA_FUNCTION_END();
 }
 
+
+///////////////////////////////////////////////////////////
+///////////////////////////////////////////////////////////
+//
+//
+// By default the frames don't have a fixed size
+//
+//
+///////////////////////////////////////////////////////////
+///////////////////////////////////////////////////////////
+size_t imageCodec::getFrameSize(const dataSet& /* sourceDataSet */, tagVR_t /* dataType */) const
+{
+    return 0;
+}
+
 } // namespace codecs
 
 } // namespace implementation
@@ -107,6 +107,23 @@ public:
 	///
 	///////////////////////////////////////////////////////////
     virtual std::shared_ptr<image> getImage(const dataSet& sourceDataSet, std::shared_ptr<streamReader> pSourceStream, tagVR_t dataType) const = 0;
+
+    /// \brief Return the size, in bytes, occupied by each
+    ///         frame when all the frames are stored in one
+    ///         buffer.
+    ///
+    /// dataSet::getImage() uses the returned size to seek
+    ///  directly to the requested frame instead of decoding
+    ///  all the preceding ones.
+    ///
+    /// @param sourceDataSet the dataset containing the frames
+    /// @param dataType      the data type of the buffer that
+    ///                       contains the frames
+    /// @return the size of each frame in bytes, or 0 if the
+    ///          frames don't have a fixed size
+    ///
+    ///////////////////////////////////////////////////////////
+    virtual size_t getFrameSize(const dataSet& sourceDataSet, tagVR_t dataType) const;
 	
 	/// \brief Stores an image into stream.
 	///
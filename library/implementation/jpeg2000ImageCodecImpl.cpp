@@ -19,6 +19,8 @@ If you do not want to be bound by the GPL terms (such as the requirement
 #ifdef JPEG2000
 
 #include "exceptionImpl.h"
+#include "statisticsImpl.h"
+#include "tracingImpl.h"
 #include "streamReaderImpl.h"
 #include "streamWriterImpl.h"
 #include "memoryStreamImpl.h"
@@ -273,6 +275,10 @@ std::shared_ptr<image> jpeg2000ImageCodec::getImage(const dataSet& sourceDataSet
 {
     IMEBRA_FUNCTION_START();
 
+    IMEBRA_TRACE_SPAN("jpeg2000ImageCodec::getImage");
+
+    IMEBRA_STATISTICS_TIMER(decodingTimer, jpeg2000DecodingTime);
+
 #ifdef JPEG2000_V1
     CODEC_FORMAT format = (CODEC_FORMAT)(CODEC_J2K);
 #else
@@ -373,6 +379,9 @@ std::shared_ptr<image> jpeg2000ImageCodec::getImage(const dataSet& sourceDataSet
 
     opj_image_destroy(jp2image);
 
+    IMEBRA_STATISTICS_ADD(jpeg2000DecodedFrames, 1);
+    IMEBRA_STATISTICS_ADD(jpeg2000DecodedPixels, (size_t)width * (size_t)height);
+
     return returnImage;
 
 
@@ -403,6 +412,8 @@ void jpeg2000ImageCodec::setImage(
 {
     IMEBRA_FUNCTION_START();
 
+    IMEBRA_TRACE_SPAN("jpeg2000ImageCodec::setImage");
+
     IMEBRA_THROW(DataSetUnknownTransferSyntaxError, "None of the codecs support the specified transfer syntax");
 
     IMEBRA_FUNCTION_END();
@@ -781,6 +781,7 @@ void jpegInformation::findMcuSize()
     m_mcuProcessed = 0;
     m_mcuProcessedX = 0;
     m_mcuProcessedY = 0;
+    m_mcuLastRestart = 0;
 
 
     IMEBRA_FUNCTION_END();
@@ -17,6 +17,8 @@ If you do not want to be bound by the GPL terms (such as the requirement
 */
 
 #include "exceptionImpl.h"
+#include "statisticsImpl.h"
+#include "tracingImpl.h"
 #include "streamReaderImpl.h"
 #include "streamWriterImpl.h"
 #include "huffmanTableImpl.h"
@@ -25,8 +27,13 @@ If you do not want to be bound by the GPL terms (such as the requirement
 #include "imageImpl.h"
 #include "dataHandlerNumericImpl.h"
 #include "codecFactoryImpl.h"
+#include "memoryImpl.h"
+#include "memoryStreamImpl.h"
+#include "threadPoolImpl.h"
 #include "../include/imebra/exceptions.h"
 #include <vector>
+#include <algorithm>
+#include <functional>
 #include <stdlib.h>
 #include <string.h>
 
@@ -331,6 +338,193 @@ static const std::uint32_t JpegDeZigZagOrder[]=
 
 #define JPEG_DECOMPRESSION_BITS_PRECISION 14
 
+///////////////////////////////////////////////////////////
+//
+// Read the difference between a lossless sample and its
+//  prediction
+//
+///////////////////////////////////////////////////////////
+inline static std::int32_t readLosslessDifference(streamReader* pStream, huffmanTable* pHuffmanTable)
+{
+    const std::uint32_t amplitudeLength(pHuffmanTable->readHuffmanCode(pStream));
+    if(amplitudeLength == 0)
+    {
+        return 0;
+    }
+
+    std::int32_t amplitude((std::int32_t)pStream->readBits(amplitudeLength));
+    if(amplitude < ((std::int32_t)1 << (amplitudeLength - 1)))
+    {
+        amplitude -= ((std::int32_t)1 << amplitudeLength) - 1;
+    }
+    return amplitude;
+}
+
+///////////////////////////////////////////////////////////
+//
+// Store a lossless sample: the samples are stored masked
+//  or, when bSignExtend is true, sign extended
+//
+///////////////////////////////////////////////////////////
+template<typename sample_t, bool bSignExtend>
+inline static sample_t storeLosslessSample(std::int32_t value, std::int32_t signBit)
+{
+    return bSignExtend ? (sample_t)((value ^ signBit) - signBit) : (sample_t)value;
+}
+
+///////////////////////////////////////////////////////////
+//
+// Decode a run of lossless samples in a row, applying the
+//  predictor to each difference as soon as it is read.
+// The samples of the previous row are masked again before
+//  they are used for the prediction, so they can be stored
+//  sign extended
+//
+///////////////////////////////////////////////////////////
+template<std::uint32_t predictor, typename sample_t, bool bSignExtend>
+static void decodeLosslessRun(streamReader* pStream, huffmanTable* pHuffmanTable, sample_t* pDest, std::uint32_t length, std::uint32_t rowLength, std::int32_t valuesMask, std::int32_t* pLastValue)
+{
+    const std::int32_t signBit((valuesMask >> 1) + 1);
+    const sample_t* pAbove(predictor >= 2 ? pDest - rowLength : pDest);
+
+    std::int32_t ra(*pLastValue);
+    std::int32_t rc(predictor >= 3 ? (std::int32_t)pAbove[-1] & valuesMask : 0);
+    for(; length != 0; --length)
+    {
+        const std::int32_t rb(predictor >= 2 ? (std::int32_t)*(pAbove++) & valuesMask : 0);
+
+        std::int32_t prediction;
+        switch(predictor)
+        {
+        case 0:
+            prediction = 0;
+            break;
+        case 1:
+            prediction = ra;
+            break;
+        case 2:
+            prediction = rb;
+            break;
+        case 3:
+            prediction = rc;
+            break;
+        case 4:
+            prediction = ra + rb - rc;
+            break;
+        case 5:
+            prediction = ra + ((rb - rc) >> 1);
+            break;
+        case 6:
+            prediction = rb + ((ra - rc) >> 1);
+            break;
+        default:
+            prediction = (ra + rb) >> 1;
+            break;
+        }
+
+        ra = (readLosslessDifference(pStream, pHuffmanTable) + prediction) & valuesMask;
+        *(pDest++) = storeLosslessSample<sample_t, bSignExtend>(ra, signBit);
+        rc = rb;
+    }
+    *pLastValue = ra;
+}
+
+///////////////////////////////////////////////////////////
+//
+// Decode the samples of a lossless scan that contains
+//  only one channel, until the MCU mcuStop is reached.
+//
+// Each MCU of the scan contains one sample, so the samples
+//  are decoded in runs that end with the row or with the
+//  restart interval. The first row is predicted from the
+//  left sample, the first column from the sample above it
+//  and the first sample after a restart from the default
+//  value.
+//
+///////////////////////////////////////////////////////////
+template<typename sample_t, bool bSignExtend>
+static void decodeLosslessChannel(streamReader* pStream, jpeg::jpegInformation& information, jpeg::jpegChannel* pChannel, sample_t* pSamples, std::uint32_t mcuStop)
+{
+    IMEBRA_FUNCTION_START();
+
+    const std::uint32_t predictor(information.m_spectralIndexStart);
+    if(predictor > 7)
+    {
+        IMEBRA_THROW(CodecCorruptedFileError, "Wrong predictor index in lossless jpeg stream");
+    }
+
+    const std::uint32_t width(pChannel->m_width);
+    const std::int32_t valuesMask(pChannel->m_valuesMask);
+    const std::int32_t signBit((valuesMask >> 1) + 1);
+    huffmanTable* pHuffmanTable(pChannel->m_pActiveHuffmanTableDC);
+
+    while(information.m_mcuProcessed < mcuStop && !pStream->endReached())
+    {
+        if(pChannel->m_losslessPositionY >= pChannel->m_height)
+        {
+            IMEBRA_THROW(CodecCorruptedFileError, "Excess data in the lossless jpeg stream");
+        }
+
+        const std::uint32_t positionX(pChannel->m_losslessPositionX);
+        const std::uint32_t positionY(pChannel->m_losslessPositionY);
+        const std::uint32_t runLength(std::min(width - positionX, mcuStop - information.m_mcuProcessed));
+
+        sample_t* pDest(pSamples + (size_t)positionY * width + positionX);
+        std::uint32_t length(runLength);
+
+        const bool bRestart(information.m_mcuLastRestart == information.m_mcuProcessed);
+        if(bRestart || (positionX == 0 && positionY != 0 && predictor != 0))
+        {
+            const std::int32_t prediction(bRestart ? pChannel->m_defaultDCValue : (std::int32_t)*(pDest - width) & valuesMask);
+            pChannel->m_lastDCValue = (readLosslessDifference(pStream, pHuffmanTable) + prediction) & valuesMask;
+            *(pDest++) = storeLosslessSample<sample_t, bSignExtend>(pChannel->m_lastDCValue, signBit);
+            --length;
+        }
+
+        if(length != 0)
+        {
+            switch((positionY == 0 && predictor != 0) ? 1 : predictor)
+            {
+            case 0:
+                decodeLosslessRun<0, sample_t, bSignExtend>(pStream, pHuffmanTable, pDest, length, width, valuesMask, &(pChannel->m_lastDCValue));
+                break;
+            case 1:
+                decodeLosslessRun<1, sample_t, bSignExtend>(pStream, pHuffmanTable, pDest, length, width, valuesMask, &(pChannel->m_lastDCValue));
+                break;
+            case 2:
+                decodeLosslessRun<2, sample_t, bSignExtend>(pStream, pHuffmanTable, pDest, length, width, valuesMask, &(pChannel->m_lastDCValue));
+                break;
+            case 3:
+                decodeLosslessRun<3, sample_t, bSignExtend>(pStream, pHuffmanTable, pDest, length, width, valuesMask, &(pChannel->m_lastDCValue));
+                break;
+            case 4:
+                decodeLosslessRun<4, sample_t, bSignExtend>(pStream, pHuffmanTable, pDest, length, width, valuesMask, &(pChannel->m_lastDCValue));
+                break;
+            case 5:
+                decodeLosslessRun<5, sample_t, bSignExtend>(pStream, pHuffmanTable, pDest, length, width, valuesMask, &(pChannel->m_lastDCValue));
+                break;
+            case 6:
+                decodeLosslessRun<6, sample_t, bSignExtend>(pStream, pHuffmanTable, pDest, length, width, valuesMask, &(pChannel->m_lastDCValue));
+                break;
+            default:
+                decodeLosslessRun<7, sample_t, bSignExtend>(pStream, pHuffmanTable, pDest, length, width, valuesMask, &(pChannel->m_lastDCValue));
+                break;
+            }
+        }
+
+        if((pChannel->m_losslessPositionX += runLength) == width)
+        {
+            pChannel->m_losslessPositionX = 0;
+            ++pChannel->m_losslessPositionY;
+        }
+        information.m_mcuProcessed += runLength;
+        information.m_mcuProcessedY = information.m_mcuProcessed / information.m_mcuNumberX;
+        information.m_mcuProcessedX = information.m_mcuProcessed - information.m_mcuProcessedY * information.m_mcuNumberX;
+    }
+
+    IMEBRA_FUNCTION_END();
+}
+
 ///////////////////////////////////////////////////////////
 ///////////////////////////////////////////////////////////
 ///////////////////////////////////////////////////////////
@@ -433,6 +627,10 @@ std::shared_ptr<image> jpegImageCodec::getImage(const dataSet& sourceDataSet, st
 {
     IMEBRA_FUNCTION_START();
 
+    IMEBRA_TRACE_SPAN("jpegImageCodec::getImage");
+
+    IMEBRA_STATISTICS_TIMER(decodingTimer, jpegDecodingTime);
+
     streamReader* pSourceStream = pStream.get();
 
     // Activate the tags in the stream
@@ -461,6 +659,30 @@ std::shared_ptr<image> jpegImageCodec::getImage(const dataSet& sourceDataSet, st
         IMEBRA_THROW(CodecWrongFormatError, "Jpeg signature not valid");
     }
 
+    // Check for 2's complement
+    ///////////////////////////////////////////////////////////
+    bool b2complement = sourceDataSet.getUnsignedLong(0x0028, 0, 0x0103, 0, 0, 0) != 0;
+    std::string colorSpace = sourceDataSet.getString(0x0028, 0, 0x0004, 0, 0);
+
+    // If the compression is jpeg baseline or jpeg extended
+    //  then the color space cannot be "RGB"
+    ///////////////////////////////////////////////////////////
+    if(colorSpace == "RGB")
+    {
+        std::string transferSyntax(sourceDataSet.getString(0x0002, 0, 0x0010, 0, 0));
+        if(transferSyntax == "1.2.840.10008.1.2.4.50" ||  // baseline (8 bits lossy)
+                transferSyntax == "1.2.840.10008.1.2.4.51")    // extended (12 bits lossy)
+        {
+            colorSpace = "YBR_FULL";
+        }
+    }
+
+    // Lossless images with one channel are decoded directly
+    //  into the image's memory
+    ///////////////////////////////////////////////////////////
+    std::shared_ptr<image> pLosslessImage;
+    std::shared_ptr<handlers::writingDataHandlerNumericBase> pLosslessImageHandler;
+
     // Read until the end of the image is reached
     ///////////////////////////////////////////////////////////
     jpeg::jpegInformation information;
@@ -524,6 +746,48 @@ std::shared_ptr<image> jpegImageCodec::getImage(const dataSet& sourceDataSet, st
         try
         {
             jpeg::jpegChannel* pChannel; // Used in the loops
+
+            // Lossless scans with one channel are decoded a row
+            //  at a time
+            ///////////////////////////////////////////////////////////
+            if(information.m_bLossless && information.m_channelsList[0] != 0 && information.m_channelsList[1] == 0)
+            {
+                pChannel = information.m_channelsList[0];
+
+                if(pLosslessImageHandler == 0 &&
+                        information.m_channelsMap.size() == 1 &&
+                        pChannel->m_width == information.m_imageWidth &&
+                        pChannel->m_height == information.m_imageHeight)
+                {
+                    pLosslessImage = allocateJpegImage(information, b2complement, colorSpace);
+                    pLosslessImageHandler = pLosslessImage->getWritingDataHandler();
+                    ::memset(pLosslessImageHandler->getMemoryBuffer(), 0, pLosslessImageHandler->getMemorySize());
+                }
+
+                if(pLosslessImageHandler == 0)
+                {
+                    decodeLosslessChannel<std::int32_t, false>(pSourceStream, information, pChannel, pChannel->m_pBuffer, nextMcuStop);
+                }
+                else
+                {
+                    switch(pLosslessImage->getDepth())
+                    {
+                    case bitDepth_t::depthU8:
+                        decodeLosslessChannel<std::uint8_t, false>(pSourceStream, information, pChannel, (std::uint8_t*)pLosslessImageHandler->getMemoryBuffer(), nextMcuStop);
+                        break;
+                    case bitDepth_t::depthS8:
+                        decodeLosslessChannel<std::int8_t, true>(pSourceStream, information, pChannel, (std::int8_t*)pLosslessImageHandler->getMemoryBuffer(), nextMcuStop);
+                        break;
+                    case bitDepth_t::depthU16:
+                        decodeLosslessChannel<std::uint16_t, false>(pSourceStream, information, pChannel, (std::uint16_t*)pLosslessImageHandler->getMemoryBuffer(), nextMcuStop);
+                        break;
+                    default:
+                        decodeLosslessChannel<std::int16_t, true>(pSourceStream, information, pChannel, (std::int16_t*)pLosslessImageHandler->getMemoryBuffer(), nextMcuStop);
+                        break;
+                    }
+                }
+            }
+
             while(information.m_mcuProcessed < nextMcuStop && !pSourceStream->endReached())
             {
                 // Read an MCU
@@ -544,21 +808,7 @@ std::shared_ptr<image> jpegImageCodec::getImage(const dataSet& sourceDataSet, st
                             scanBlock != pChannel->m_blockMcuXY;
                             ++scanBlock)
                         {
-                            std::uint32_t amplitudeLength = pChannel->m_pActiveHuffmanTableDC->readHuffmanCode(pSourceStream);
-                            std::int32_t amplitude;        // lossless amplitude
-                            if(amplitudeLength != 0)
-                            {
-                                amplitude = (std::int32_t)pSourceStream->readBits(amplitudeLength);
-                                if(amplitude < ((std::int32_t)1<<(amplitudeLength-1)))
-                                {
-                                    amplitude -= ((std::int32_t)1<<amplitudeLength)-1;
-                                }
-                            }
-                            else
-                            {
-                                amplitude = 0;
-                            }
-
+                            std::int32_t amplitude(readLosslessDifference(pSourceStream, pChannel->m_pActiveHuffmanTableDC));
                             pChannel->addUnprocessedAmplitude(amplitude, information.m_spectralIndexStart, information.m_mcuLastRestart == information.m_mcuProcessed && scanBlock == 0);
                         }
 
@@ -611,25 +861,21 @@ std::shared_ptr<image> jpegImageCodec::getImage(const dataSet& sourceDataSet, st
     }
 
 
-    // Check for 2's complement
-    ///////////////////////////////////////////////////////////
-    bool b2complement = sourceDataSet.getUnsignedLong(0x0028, 0, 0x0103, 0, 0, 0) != 0;
-    std::string colorSpace = sourceDataSet.getString(0x0028, 0, 0x0004, 0, 0);
-
-    // If the compression is jpeg baseline or jpeg extended
-    //  then the color space cannot be "RGB"
-    ///////////////////////////////////////////////////////////
-    if(colorSpace == "RGB")
+    std::shared_ptr<image> pImage;
+    if(pLosslessImage != 0)
     {
-        std::string transferSyntax(sourceDataSet.getString(0x0002, 0, 0x0010, 0, 0));
-        if(transferSyntax == "1.2.840.10008.1.2.4.50" ||  // baseline (8 bits lossy)
-                transferSyntax == "1.2.840.10008.1.2.4.51")    // extended (12 bits lossy)
-        {
-            colorSpace = "YBR_FULL";
-        }
+        pLosslessImageHandler.reset();
+        pImage = pLosslessImage;
+    }
+    else
+    {
+        pImage = copyJpegChannelsToImage(information, b2complement, colorSpace);
     }
 
-    return copyJpegChannelsToImage(information, b2complement, colorSpace);
+    IMEBRA_STATISTICS_ADD(jpegDecodedFrames, 1);
+    IMEBRA_STATISTICS_ADD(jpegDecodedPixels, (size_t)information.m_imageWidth * (size_t)information.m_imageHeight);
+
+    return pImage;
 
     IMEBRA_FUNCTION_END();
 }
@@ -639,15 +885,12 @@ std::shared_ptr<image> jpegImageCodec::getImage(const dataSet& sourceDataSet, st
 ///////////////////////////////////////////////////////////
 //
 //
-// Copy the loaded image into a class image
+// Allocate the image that receives the decoded jpeg
 //
 //
 ///////////////////////////////////////////////////////////
 ///////////////////////////////////////////////////////////
-std::shared_ptr<image> jpegImageCodec::copyJpegChannelsToImage(
-        jpeg::jpegInformation& information,
-        bool b2complement,
-        const std::string& colorSpace) const
+std::shared_ptr<image> jpegImageCodec::allocateJpegImage(const jpeg::jpegInformation& information, bool b2complement, const std::string& colorSpace) const
 {
     IMEBRA_FUNCTION_START();
 
@@ -657,7 +900,29 @@ std::shared_ptr<image> jpegImageCodec::copyJpegChannelsToImage(
     else
         depth = (information.m_precision==8) ? bitDepth_t::depthU8 : bitDepth_t::depthU16;
 
-    std::shared_ptr<image> destImage(std::make_shared<image>(information.m_imageWidth, information.m_imageHeight, depth, colorSpace, (std::uint8_t)(information.m_precision-1)));
+    return std::make_shared<image>(information.m_imageWidth, information.m_imageHeight, depth, colorSpace, (std::uint8_t)(information.m_precision-1));
+
+    IMEBRA_FUNCTION_END();
+}
+
+
+///////////////////////////////////////////////////////////
+///////////////////////////////////////////////////////////
+//
+//
+// Copy the loaded image into a class image
+//
+//
+///////////////////////////////////////////////////////////
+///////////////////////////////////////////////////////////
+std::shared_ptr<image> jpegImageCodec::copyJpegChannelsToImage(
+        jpeg::jpegInformation& information,
+        bool b2complement,
+        const std::string& colorSpace) const
+{
+    IMEBRA_FUNCTION_START();
+
+    std::shared_ptr<image> destImage(allocateJpegImage(information, b2complement, colorSpace));
 
     std::shared_ptr<handlers::writingDataHandlerNumericBase> handler = destImage->getWritingDataHandler();
 
@@ -996,6 +1261,8 @@ void jpegImageCodec::setImage(
 {
     IMEBRA_FUNCTION_START();
 
+    IMEBRA_TRACE_SPAN("jpegImageCodec::setImage");
+
     streamWriter* pDestinationStream = pDestStream.get();
 
     // Activate the tags in the stream
@@ -1066,6 +1333,46 @@ void jpegImageCodec::setImage(
 }
 
 
+///////////////////////////////////////////////////////////
+//
+// Return the number of MCUs in the restart intervals of
+//  the active scan, given the requested number of MCU rows
+//  per interval.
+// Returns 0 when the scan must not be split
+//
+///////////////////////////////////////////////////////////
+static std::uint16_t getRestartInterval(const jpeg::jpegInformation& information, std::uint32_t mcuRows)
+{
+    if(mcuRows == 0 || information.m_mcuNumberX > 0xffff)
+    {
+        return 0;
+    }
+
+    // The lossless restart intervals start at the beginning
+    //  of a row only when each MCU contains one sample per
+    //  channel
+    ///////////////////////////////////////////////////////////
+    if(information.m_bLossless)
+    {
+        for(jpeg::jpegChannel* const* channelsIterator = information.m_channelsList; *channelsIterator != 0; ++channelsIterator)
+        {
+            if((*channelsIterator)->m_blockMcuXY != 1)
+            {
+                return 0;
+            }
+        }
+    }
+
+    const std::uint32_t maximumRows(0xffff / information.m_mcuNumberX);
+    const std::uint32_t restartInterval((mcuRows < maximumRows ? mcuRows : maximumRows) * information.m_mcuNumberX);
+    if(restartInterval >= information.m_mcuNumberTotal)
+    {
+        return 0;
+    }
+    return (std::uint16_t)restartInterval;
+}
+
+
 ///////////////////////////////////////////////////////////
 ///////////////////////////////////////////////////////////
 //
@@ -1086,13 +1393,57 @@ void jpegImageCodec::writeScan(streamWriter* pDestinationStream, jpeg::jpegInfor
         information.m_spectralIndexStart = 1;
         information.m_spectralIndexEnd = 0;
     }
+
+    // Split the scan into restart intervals if requested.
+    // The DRI tag is written before every scan, so a scan
+    //  that is not split resets the interval set by the
+    //  previous one
+    ///////////////////////////////////////////////////////////
+    const std::uint32_t restartRows(codecFactory::getCodecFactory()->getJpegRestartInterval());
+    information.m_mcuPerRestartInterval = getRestartInterval(information, restartRows);
+
     if(!bCalcHuffman)
     {
+        if(restartRows != 0)
+        {
+            writeTag(pDestinationStream, dri, information);
+        }
         writeTag(pDestinationStream, sos, information);
     }
 
+    if(information.m_mcuPerRestartInterval == 0)
+    {
+        writeMcus(pDestinationStream, information, bCalcHuffman, information.m_mcuNumberTotal);
+    }
+    else
+    {
+        writeRestartIntervals(pDestinationStream, information, bCalcHuffman);
+    }
+
+    if(!bCalcHuffman)
+    {
+        pDestinationStream->resetOutBitsBuffer();
+    }
+
+    IMEBRA_FUNCTION_END();
+}
+
+
+///////////////////////////////////////////////////////////
+///////////////////////////////////////////////////////////
+//
+//
+// Write the MCUs of the active scan
+//
+//
+///////////////////////////////////////////////////////////
+///////////////////////////////////////////////////////////
+void jpegImageCodec::writeMcus(streamWriter* pDestinationStream, jpeg::jpegInformation& information, bool bCalcHuffman, std::uint32_t mcuStop) const
+{
+    IMEBRA_FUNCTION_START();
+
     jpeg::jpegChannel* pChannel; // Used in the loops
-    while(information.m_mcuProcessed < information.m_mcuNumberTotal)
+    while(information.m_mcuProcessed < mcuStop)
     {
         // Write an MCU
         ///////////////////////////////////////////////////////////
@@ -1113,7 +1464,11 @@ void jpegImageCodec::writeScan(streamWriter* pDestinationStream, jpeg::jpegInfor
                 for(std::uint32_t scanBlock = pChannel->m_blockMcuXY; scanBlock != 0; --scanBlock)
                 {
                     std::int32_t value(*pBuffer);
-                    if(pChannel->m_losslessPositionX == 0 && pChannel->m_losslessPositionY != 0)
+                    // The first sample of a restart interval is
+                    //  predicted from the default value
+                    ///////////////////////////////////////////////////////////
+                    if(pChannel->m_losslessPositionX == 0 && pChannel->m_losslessPositionY != 0 &&
+                            (information.m_mcuProcessed != information.m_mcuLastRestart || scanBlock != pChannel->m_blockMcuXY))
                     {
                         lastValue = *(pBuffer - pChannel->m_width);
                     }
@@ -1190,11 +1545,150 @@ void jpegImageCodec::writeScan(streamWriter* pDestinationStream, jpeg::jpegInfor
         }
     }
 
-    if(!bCalcHuffman)
+    IMEBRA_FUNCTION_END();
+}
+
+
+///////////////////////////////////////////////////////////
+///////////////////////////////////////////////////////////
+//
+//
+// Write the restart intervals of the active scan.
+// Each interval is encoded by a different task into its
+//  own buffer, then the buffers are written separated by
+//  the RST tags
+//
+//
+///////////////////////////////////////////////////////////
+///////////////////////////////////////////////////////////
+void jpegImageCodec::writeRestartIntervals(streamWriter* pDestinationStream, jpeg::jpegInformation& information, bool bCalcHuffman) const
+{
+    IMEBRA_FUNCTION_START();
+
+    const std::uint32_t restartInterval(information.m_mcuPerRestartInterval);
+    const size_t intervalsNumber((information.m_mcuNumberTotal + restartInterval - 1) / restartInterval);
+
+    // List the scan's channels and huffman tables. While the
+    //  codes frequencies are collected each interval uses its
+    //  own copy of the tables
+    ///////////////////////////////////////////////////////////
+    std::vector<jpeg::jpegChannel*> scanChannels;
+    std::vector<huffmanTable*> scanHuffmanTables;
+    for(jpeg::jpegChannel** channelsIterator = information.m_channelsList; *channelsIterator != 0; ++channelsIterator)
     {
-        pDestinationStream->resetOutBitsBuffer();
+        scanChannels.push_back(*channelsIterator);
+        huffmanTable* channelTables[] = {(*channelsIterator)->m_pActiveHuffmanTableDC, (*channelsIterator)->m_pActiveHuffmanTableAC};
+        for(size_t scanTables(0); scanTables != sizeof(channelTables) / sizeof(channelTables[0]); ++scanTables)
+        {
+            if(channelTables[scanTables] != 0 &&
+                    std::find(scanHuffmanTables.begin(), scanHuffmanTables.end(), channelTables[scanTables]) == scanHuffmanTables.end())
+            {
+                scanHuffmanTables.push_back(channelTables[scanTables]);
+            }
+        }
     }
 
+    std::vector<std::vector<huffmanTable> > intervalsHuffmanTables(intervalsNumber);
+    std::vector<std::shared_ptr<memory> > intervalsData(intervalsNumber);
+
+    std::function<void(size_t)> encodeInterval([&](size_t interval)
+    {
+        // Copy the scan's state: the DC predictions restart
+        //  from their default values
+        ///////////////////////////////////////////////////////////
+        const std::uint32_t firstMcu((std::uint32_t)interval * restartInterval);
+        const std::uint32_t lastMcu(std::min(firstMcu + restartInterval, information.m_mcuNumberTotal));
+
+        jpeg::jpegInformation intervalInformation(information);
+        intervalInformation.m_mcuProcessed = firstMcu;
+        intervalInformation.m_mcuProcessedX = 0;
+        intervalInformation.m_mcuProcessedY = firstMcu / information.m_mcuNumberX;
+        intervalInformation.m_mcuLastRestart = firstMcu;
+
+        std::vector<huffmanTable>& huffmanTables(intervalsHuffmanTables[interval]);
+        if(bCalcHuffman)
+        {
+            huffmanTables.reserve(scanHuffmanTables.size());
+            for(std::vector<huffmanTable*>::const_iterator scanTables(scanHuffmanTables.begin()), endTables(scanHuffmanTables.end()); scanTables != endTables; ++scanTables)
+            {
+                huffmanTables.push_back(**scanTables);
+                huffmanTables.back().reset();
+            }
+        }
+
+        std::vector<jpeg::jpegChannel> channels(scanChannels.size());
+        for(size_t scanChannel(0); scanChannel != scanChannels.size(); ++scanChannel)
+        {
+            jpeg::jpegChannel& channel(channels[scanChannel]);
+            channel = *(scanChannels[scanChannel]);
+            channel.m_lastDCValue = channel.m_defaultDCValue;
+            channel.m_losslessPositionX = 0;
+            channel.m_losslessPositionY = intervalInformation.m_mcuProcessedY * channel.m_blockMcuY;
+            if(bCalcHuffman)
+            {
+                if(channel.m_pActiveHuffmanTableDC != 0)
+                {
+                    channel.m_pActiveHuffmanTableDC = &(huffmanTables[std::find(scanHuffmanTables.begin(), scanHuffmanTables.end(), channel.m_pActiveHuffmanTableDC) - scanHuffmanTables.begin()]);
+                }
+                if(channel.m_pActiveHuffmanTableAC != 0)
+                {
+                    channel.m_pActiveHuffmanTableAC = &(huffmanTables[std::find(scanHuffmanTables.begin(), scanHuffmanTables.end(), channel.m_pActiveHuffmanTableAC) - scanHuffmanTables.begin()]);
+                }
+            }
+            intervalInformation.m_channelsList[scanChannel] = &channel;
+        }
+
+        // While the frequencies are collected nothing is written
+        //  and the interval's memory is discarded
+        ///////////////////////////////////////////////////////////
+        std::shared_ptr<memory> pIntervalData(std::make_shared<memory>());
+        streamWriter intervalWriter(std::make_shared<memoryStreamOutput>(pIntervalData));
+        intervalWriter.m_bJpegTags = true;
+        writeMcus(&intervalWriter, intervalInformation, bCalcHuffman, lastMcu);
+        if(bCalcHuffman)
+        {
+            return;
+        }
+        intervalWriter.resetOutBitsBuffer();
+        intervalWriter.flushDataBuffer();
+        intervalsData[interval] = pIntervalData;
+    });
+
+    threadPool::getSharedThreadPool().executeParallel(intervalsNumber, encodeInterval);
+
+    if(bCalcHuffman)
+    {
+        // Merge the frequencies collected by the intervals
+        ///////////////////////////////////////////////////////////
+        for(size_t interval(0); interval != intervalsNumber; ++interval)
+        {
+            for(size_t scanTables(0); scanTables != scanHuffmanTables.size(); ++scanTables)
+            {
+                scanHuffmanTables[scanTables]->addValuesFreq(intervalsHuffmanTables[interval][scanTables]);
+            }
+        }
+    }
+    else
+    {
+        // Write the intervals separated by the RST tags
+        ///////////////////////////////////////////////////////////
+        for(size_t interval(0); interval != intervalsNumber; ++interval)
+        {
+            if(interval != 0)
+            {
+                const std::uint8_t restartTag[2] = {(std::uint8_t)0xff, (std::uint8_t)(rst0 + ((interval - 1) & 0x7))};
+                pDestinationStream->write(restartTag, 2);
+            }
+            const std::shared_ptr<memory>& pIntervalData(intervalsData[interval]);
+            if(pIntervalData->size() != 0)
+            {
+                pDestinationStream->write(pIntervalData->data(), pIntervalData->size());
+            }
+        }
+    }
+
+    information.m_mcuProcessed = information.m_mcuNumberTotal;
+
     IMEBRA_FUNCTION_END();
 }
 
@@ -95,11 +95,22 @@ private:
 	///////////////////////////////////////////////////////////
     inline void writeBlock(streamWriter* pStream, jpeg::jpegInformation& information, std::int32_t* pBuffer, jpeg::jpegChannel* pChannel, bool bCalcHuffman) const;
 
+    std::shared_ptr<image> allocateJpegImage(const jpeg::jpegInformation& information, bool b2complement, const std::string& colorSpace) const;
     std::shared_ptr<image> copyJpegChannelsToImage(jpeg::jpegInformation& information, bool b2complement, const std::string& colorSpace) const;
     void copyImageToJpegChannels(jpeg::jpegInformation& information, std::shared_ptr<image> sourceImage, bool b2complement, std::uint32_t allocatedBits, bool bSubSampledX, bool bSubSampledY) const;
 
     void writeScan(streamWriter* pDestinationStream, jpeg::jpegInformation& information, bool bCalcHuffman) const;
 
+    // Write the MCUs of the active scan, up to the specified
+    //  one (excluded)
+    ///////////////////////////////////////////////////////////
+    void writeMcus(streamWriter* pDestinationStream, jpeg::jpegInformation& information, bool bCalcHuffman, std::uint32_t mcuStop) const;
+
+    // Write the restart intervals of the active scan,
+    //  encoding them concurrently
+    ///////////////////////////////////////////////////////////
+    void writeRestartIntervals(streamWriter* pDestinationStream, jpeg::jpegInformation& information, bool bCalcHuffman) const;
+
 };
 
 
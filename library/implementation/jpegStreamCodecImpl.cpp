@@ -411,6 +411,21 @@ void jpegStreamCodec::writeStream(std::shared_ptr<streamWriter> pStream, std::sh
 }
 
 
+///////////////////////////////////////////////////////////
+///////////////////////////////////////////////////////////
+//
+//
+// Probe the jpeg signature (SOI marker)
+//
+//
+///////////////////////////////////////////////////////////
+///////////////////////////////////////////////////////////
+bool jpegStreamCodec::canRead(const std::uint8_t* pPrefix, size_t prefixLength) const
+{
+    return prefixLength >= 2 && pPrefix[0] == 0xff && pPrefix[1] == 0xd8;
+}
+
+
 ///////////////////////////////////////////////////////////
 ///////////////////////////////////////////////////////////
 //
@@ -53,6 +53,10 @@ public:
 	///////////////////////////////////////////////////////////
     jpegStreamCodec();
 
+    // Returns true if the prefix starts with the SOI marker
+    ///////////////////////////////////////////////////////////
+    virtual bool canRead(const std::uint8_t* pPrefix, size_t prefixLength) const;
+
 protected:
 	// Read a jpeg stream and build a Dicom dataset
 	///////////////////////////////////////////////////////////
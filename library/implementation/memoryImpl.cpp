@@ -18,6 +18,7 @@ If you do not want to be bound by the GPL terms (such as the requirement
 
 #include "memoryImpl.h"
 #include "exceptionImpl.h"
+#include "statisticsImpl.h"
 #include "../include/imebra/exceptions.h"
 #include <string.h>
 
@@ -471,6 +472,7 @@ stringUint8* memoryPool::getMemory(size_t requestedSize)
 
     if(requestedSize < m_minMemoryBlockSize || requestedSize > m_maxMemoryUsageSize)
     {
+        IMEBRA_STATISTICS_ADD(memoryPoolMisses, 1);
         return new stringUint8(requestedSize, 0);
     }
 
@@ -489,6 +491,7 @@ stringUint8* memoryPool::getMemory(size_t requestedSize)
 
 		// Memory found
 		///////////////////////////////////////////////////////////
+        IMEBRA_STATISTICS_ADD(memoryPoolHits, 1);
         std::unique_ptr<stringUint8> pMemory(m_memoryPointer[findCell]);
 		m_actualSize -= m_memorySize[findCell];
 		if(findCell == m_firstUsedCell)
@@ -516,6 +519,7 @@ stringUint8* memoryPool::getMemory(size_t requestedSize)
         return pMemory.release();
 	}
 
+    IMEBRA_STATISTICS_ADD(memoryPoolMisses, 1);
     return new stringUint8(requestedSize, 0);
 
     IMEBRA_FUNCTION_END();
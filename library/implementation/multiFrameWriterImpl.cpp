@@ -0,0 +1,421 @@
+/*
+Copyright 2005 - 2017 by Paolo Brandoli/Binarno s.p.
+
+Imebra is available for free under the GNU General Public License.
+
+The full text of the license is available in the file license.rst
+ in the project root folder.
+
+If you do not want to be bound by the GPL terms (such as the requirement
+ that your application must also be GPL), you may purchase a commercial
+ license for Imebra from the Imebra’s website (http://imebra.com).
+*/
+
+/*! \file multiFrameWriterImpl.cpp
+    \brief Implementation of the class multiFrameWriter.
+
+*/
+
+#include "multiFrameWriterImpl.h"
+#include "exceptionImpl.h"
+#include "dataSetImpl.h"
+#include "dataHandlerImpl.h"
+#include "imageImpl.h"
+#include "streamWriterImpl.h"
+#include "dicomDictImpl.h"
+#include "codecFactoryImpl.h"
+#include "streamCodecImpl.h"
+#include "imageCodecImpl.h"
+#include "../include/imebra/exceptions.h"
+#include <limits>
+#include <string.h>
+
+namespace imebra
+{
+
+namespace implementation
+{
+
+///////////////////////////////////////////////////////////
+//
+// Constructor
+//
+///////////////////////////////////////////////////////////
+multiFrameWriter::multiFrameWriter(std::shared_ptr<dataSet> pHeader, std::shared_ptr<streamWriter> pWriter, std::uint32_t numberOfFrames, imageQuality_t quality, bool bExtendedOffsetTable):
+    m_pHeader(pHeader),
+    m_pWriter(pWriter),
+    m_numberOfFrames(numberOfFrames),
+    m_quality(quality),
+    m_bExtendedOffsetTable(bExtendedOffsetTable),
+    m_transferSyntax(pHeader->getString(0x0002, 0, 0x0010, 0, 0, "1.2.840.10008.1.2")),
+    m_bExplicitDataType(m_transferSyntax != "1.2.840.10008.1.2"),
+    m_endianType(m_transferSyntax == "1.2.840.10008.1.2.2" ? streamController::highByteEndian : streamController::lowByteEndian),
+    m_bEncapsulated(false),
+    m_frameLength(0),
+    m_writtenFrames(0),
+    m_bClosed(false),
+    m_groupLengthPosition(0),
+    m_offsetTablePosition(0),
+    m_lengthsTablePosition(0),
+    m_firstFragmentPosition(0)
+{
+    IMEBRA_FUNCTION_START();
+
+    if(numberOfFrames == 0)
+    {
+        IMEBRA_THROW(DataSetWrongFrameError, "The number of frames must be greater than zero");
+    }
+
+    // The writer appends the pixel data group after the
+    //  header: the header cannot contain that group or the
+    //  groups that follow it
+    ///////////////////////////////////////////////////////////
+    const dataSet::tGroupsIds groups(pHeader->getGroups());
+    if(!groups.empty() && *groups.rbegin() >= 0x7fe0)
+    {
+        IMEBRA_THROW(DataSetWrongFrameError, "The header dataset contains tags in the group " << std::hex << *groups.rbegin() << ", which must follow the pixel data");
+    }
+
+    m_framesOffsets.reserve(numberOfFrames);
+    m_framesLengths.reserve(numberOfFrames);
+
+    IMEBRA_FUNCTION_END();
+}
+
+
+///////////////////////////////////////////////////////////
+//
+// Encode and write a frame
+//
+///////////////////////////////////////////////////////////
+void multiFrameWriter::appendImage(std::shared_ptr<image> pImage)
+{
+    IMEBRA_FUNCTION_START();
+
+    if(m_bClosed || m_writtenFrames == m_numberOfFrames)
+    {
+        IMEBRA_THROW(DataSetWrongFrameError, "All the frames have already been written");
+    }
+
+    // Encode the frame in a temporary dataset, so the codecs
+    //  and the attributes validation of dataSet::setImage()
+    //  are reused
+    ///////////////////////////////////////////////////////////
+    std::shared_ptr<dataSet> pFrameDataSet(std::make_shared<dataSet>(m_transferSyntax));
+    if(m_pHeader->bufferExists(0x0028, 0, 0x0006, 0))
+    {
+        pFrameDataSet->setUnsignedLong(0x0028, 0, 0x0006, 0, m_pHeader->getUnsignedLong(0x0028, 0, 0x0006, 0, 0));
+    }
+    pFrameDataSet->setImage(0, pImage, m_quality);
+
+    std::shared_ptr<data> pPixelData(pFrameDataSet->getTag(0x7fe0, 0, 0x0010));
+    const tagVR_t dataType(pPixelData->getDataType());
+    const bool bEncapsulated(pPixelData->bufferExists(1));
+
+    // The buffer of a native frame is padded to an even
+    //  length: use the exact frame size when it is known
+    ///////////////////////////////////////////////////////////
+    size_t nativeFrameLength(0);
+    if(!bEncapsulated)
+    {
+        nativeFrameLength = codecs::codecFactory::getCodecFactory()->getImageCodec(m_transferSyntax)->getFrameSize(*pFrameDataSet, dataType);
+        if(nativeFrameLength == 0 || nativeFrameLength > pPixelData->getBufferSize(0))
+        {
+            nativeFrameLength = pPixelData->getBufferSize(0);
+        }
+    }
+
+    if(m_writtenFrames == 0)
+    {
+        // Copy the image attributes into the header
+        ///////////////////////////////////////////////////////////
+        m_pHeader->copyImageAttributes(*pFrameDataSet);
+        m_pHeader->setUnsignedLong(0x0028, 0, 0x0008, 0, m_numberOfFrames);
+
+        m_bEncapsulated = bEncapsulated;
+        m_frameLength = nativeFrameLength;
+        writeHeader(dataType, m_frameLength);
+    }
+    else
+    {
+        // All the frames must have the attributes of the first one
+        ///////////////////////////////////////////////////////////
+        if(!m_pHeader->sameImageAttributes(*pFrameDataSet) || bEncapsulated != m_bEncapsulated || nativeFrameLength != m_frameLength)
+        {
+            IMEBRA_THROW(DataSetDifferentFormatError, "The frame has different attributes than the first one");
+        }
+    }
+
+    const size_t wordSize(dicomDictionary::getDicomDictionary()->getWordSize(dataType));
+
+    // Native frames are written one after the other
+    ///////////////////////////////////////////////////////////
+    if(!m_bEncapsulated)
+    {
+        std::shared_ptr<handlers::readingDataHandlerRaw> frameHandler(pPixelData->getReadingDataHandlerRaw(0));
+        writeBuffer(frameHandler->getMemoryBuffer(), m_frameLength, wordSize);
+        ++m_writtenFrames;
+        return;
+    }
+
+    // Encapsulated frames: write the fragments and remember
+    //  the frame's offset
+    ///////////////////////////////////////////////////////////
+    const size_t buffersCount(pPixelData->getBuffersCount());
+    if(m_bExtendedOffsetTable && buffersCount != 2)
+    {
+        IMEBRA_THROW(DataSetCorruptedOffsetTableError, "The Extended Offset Table requires one fragment per frame");
+    }
+
+    const std::uint64_t frameOffset((std::uint64_t)(m_pWriter->position() - m_firstFragmentPosition));
+    if(!m_bExtendedOffsetTable && frameOffset > std::numeric_limits<std::uint32_t>::max())
+    {
+        IMEBRA_THROW(DataSetCorruptedOffsetTableError, "The frame offset doesn't fit in the Basic Offset Table");
+    }
+
+    std::uint64_t frameLength(0);
+    for(size_t scanBuffers(1); scanBuffers != buffersCount; ++scanBuffers)
+    {
+        std::shared_ptr<handlers::readingDataHandlerRaw> fragmentHandler(pPixelData->getReadingDataHandlerRaw(scanBuffers));
+        const size_t fragmentLength(fragmentHandler->getSize() + (fragmentHandler->getSize() & 1));
+        writeTagHeader(0xfffe, 0xe000, tagVR_t::UN, (std::uint32_t)fragmentLength);
+        writeBuffer(fragmentHandler->getMemoryBuffer(), fragmentHandler->getSize(), wordSize);
+        frameLength += fragmentLength;
+    }
+
+    m_framesOffsets.push_back(frameOffset);
+    m_framesLengths.push_back(frameLength);
+    ++m_writtenFrames;
+
+    IMEBRA_FUNCTION_END();
+}
+
+
+///////////////////////////////////////////////////////////
+//
+// Terminate the stream and update the reserved values
+//
+///////////////////////////////////////////////////////////
+void multiFrameWriter::close()
+{
+    IMEBRA_FUNCTION_START();
+
+    if(m_bClosed)
+    {
+        return;
+    }
+
+    if(m_writtenFrames != m_numberOfFrames)
+    {
+        IMEBRA_THROW(DataSetWrongFrameError, "Not all the frames have been written");
+    }
+
+    m_bClosed = true;
+
+    // Write the end of the pixel data
+    ///////////////////////////////////////////////////////////
+    if(m_bEncapsulated)
+    {
+        writeTagHeader(0xfffe, 0xe0dd, tagVR_t::UN, 0);
+    }
+    else if(((m_frameLength * m_numberOfFrames) & 1) != 0)
+    {
+        writeZeros(1);
+    }
+
+    // Update the group length
+    ///////////////////////////////////////////////////////////
+    if(m_groupLengthPosition != 0)
+    {
+        const size_t groupLength(m_pWriter->position() - m_groupLengthPosition - 4);
+        if(groupLength > std::numeric_limits<std::uint32_t>::max())
+        {
+            IMEBRA_THROW(StreamWriteError, "The pixel data group is too long for its group length");
+        }
+        std::uint32_t adjustedGroupLength(streamController::adjustEndian((std::uint32_t)groupLength, m_endianType));
+        m_pWriter->rewrite(m_groupLengthPosition, (std::uint8_t*)&adjustedGroupLength, 4);
+    }
+
+    // Update the offset tables
+    ///////////////////////////////////////////////////////////
+    if(m_bEncapsulated)
+    {
+        if(m_bExtendedOffsetTable)
+        {
+            std::vector<std::uint64_t> offsets(m_framesOffsets), lengths(m_framesLengths);
+            streamController::adjustEndian((std::uint8_t*)offsets.data(), 8, streamController::lowByteEndian, offsets.size());
+            streamController::adjustEndian((std::uint8_t*)lengths.data(), 8, streamController::lowByteEndian, lengths.size());
+            m_pWriter->rewrite(m_offsetTablePosition, (std::uint8_t*)offsets.data(), offsets.size() * 8);
+            m_pWriter->rewrite(m_lengthsTablePosition, (std::uint8_t*)lengths.data(), lengths.size() * 8);
+        }
+        else
+        {
+            std::vector<std::uint32_t> offsets(m_framesOffsets.size());
+            for(size_t scanOffsets(0); scanOffsets != offsets.size(); ++scanOffsets)
+            {
+                offsets[scanOffsets] = streamController::adjustEndian((std::uint32_t)m_framesOffsets[scanOffsets], m_endianType);
+            }
+            m_pWriter->rewrite(m_offsetTablePosition, (std::uint8_t*)offsets.data(), offsets.size() * 4);
+        }
+    }
+
+    m_pWriter->flushDataBuffer();
+
+    IMEBRA_FUNCTION_END();
+}
+
+
+///////////////////////////////////////////////////////////
+//
+// Write the header and the beginning of the pixel data
+//
+///////////////////////////////////////////////////////////
+void multiFrameWriter::writeHeader(tagVR_t dataType, size_t frameLength)
+{
+    IMEBRA_FUNCTION_START();
+
+    std::shared_ptr<codecs::codecFactory> factory(codecs::codecFactory::getCodecFactory());
+    factory->getStreamCodec(codecType_t::dicom)->write(m_pWriter, m_pHeader);
+
+    // Group length, updated by close(). The group length is
+    //  optional: it is omitted when the Extended Offset Table
+    //  is used, because the pixel data may exceed 4 GB
+    ///////////////////////////////////////////////////////////
+    if(!m_bEncapsulated || !m_bExtendedOffsetTable)
+    {
+        writeTagHeader(0x7fe0, 0x0000, tagVR_t::UL, 4);
+        m_groupLengthPosition = m_pWriter->position();
+        writeZeros(4);
+    }
+
+    if(!m_bEncapsulated)
+    {
+        const std::uint64_t pixelDataLength((std::uint64_t)frameLength * m_numberOfFrames);
+        if(pixelDataLength >= std::numeric_limits<std::uint32_t>::max())
+        {
+            IMEBRA_THROW(DataSetWrongFrameError, "The frames don't fit in the native pixel data");
+        }
+        writeTagHeader(0x7fe0, 0x0010, dataType, (std::uint32_t)(pixelDataLength + (pixelDataLength & 1)));
+        return;
+    }
+
+    // Reserve the Extended Offset Table, then write the
+    //  pixel data header and reserve the Basic Offset Table
+    ///////////////////////////////////////////////////////////
+    if(m_bExtendedOffsetTable)
+    {
+        writeTagHeader(0x7fe0, 0x0001, tagVR_t::OV, 8 * m_numberOfFrames);
+        m_offsetTablePosition = m_pWriter->position();
+        writeZeros(8 * (size_t)m_numberOfFrames);
+
+        writeTagHeader(0x7fe0, 0x0002, tagVR_t::OV, 8 * m_numberOfFrames);
+        m_lengthsTablePosition = m_pWriter->position();
+        writeZeros(8 * (size_t)m_numberOfFrames);
+    }
+
+    writeTagHeader(0x7fe0, 0x0010, dataType, std::numeric_limits<std::uint32_t>::max());
+
+    const std::uint32_t basicOffsetTableLength(m_bExtendedOffsetTable ? 0 : 4 * m_numberOfFrames);
+    writeTagHeader(0xfffe, 0xe000, tagVR_t::UN, basicOffsetTableLength);
+    if(!m_bExtendedOffsetTable)
+    {
+        m_offsetTablePosition = m_pWriter->position();
+        writeZeros(basicOffsetTableLength);
+    }
+
+    m_firstFragmentPosition = m_pWriter->position();
+
+    IMEBRA_FUNCTION_END();
+}
+
+
+///////////////////////////////////////////////////////////
+//
+// Write a tag or item header
+//
+///////////////////////////////////////////////////////////
+void multiFrameWriter::writeTagHeader(std::uint16_t groupId, std::uint16_t tagId, tagVR_t dataType, std::uint32_t length)
+{
+    IMEBRA_FUNCTION_START();
+
+    std::uint16_t adjustedGroupId(streamController::adjustEndian(groupId, m_endianType));
+    std::uint16_t adjustedTagId(streamController::adjustEndian(tagId, m_endianType));
+    m_pWriter->write((std::uint8_t*)&adjustedGroupId, 2);
+    m_pWriter->write((std::uint8_t*)&adjustedTagId, 2);
+
+    // The items and the delimiters never have a data type
+    ///////////////////////////////////////////////////////////
+    if(m_bExplicitDataType && groupId != 0xfffe)
+    {
+        dicomDictionary* pDictionary(dicomDictionary::getDicomDictionary());
+        std::string dataTypeString(pDictionary->enumDataTypeToString(dataType));
+        m_pWriter->write((std::uint8_t*)dataTypeString.c_str(), 2);
+        if(!pDictionary->getLongLength(dataType))
+        {
+            std::uint16_t adjustedLength(streamController::adjustEndian((std::uint16_t)length, m_endianType));
+            m_pWriter->write((std::uint8_t*)&adjustedLength, 2);
+            return;
+        }
+        writeZeros(2);
+    }
+
+    std::uint32_t adjustedLength(streamController::adjustEndian(length, m_endianType));
+    m_pWriter->write((std::uint8_t*)&adjustedLength, 4);
+
+    IMEBRA_FUNCTION_END();
+}
+
+
+///////////////////////////////////////////////////////////
+//
+// Write a buffer adjusting its endianness and padding it
+//  to an even length
+//
+///////////////////////////////////////////////////////////
+void multiFrameWriter::writeBuffer(const std::uint8_t* pBuffer, size_t bufferSize, size_t wordSize)
+{
+    IMEBRA_FUNCTION_START();
+
+    if(wordSize > 1 && streamController::getPlatformEndian() != m_endianType)
+    {
+        std::vector<std::uint8_t> tempBuffer(pBuffer, pBuffer + bufferSize);
+        streamController::adjustEndian(tempBuffer.data(), wordSize, m_endianType, bufferSize / wordSize);
+        m_pWriter->write(tempBuffer.data(), bufferSize);
+    }
+    else
+    {
+        m_pWriter->write(pBuffer, bufferSize);
+    }
+
+    if(m_bEncapsulated && (bufferSize & 1) != 0)
+    {
+        writeZeros(1);
+    }
+
+    IMEBRA_FUNCTION_END();
+}
+
+
+///////////////////////////////////////////////////////////
+//
+// Reserve space in the stream
+//
+///////////////////////////////////////////////////////////
+void multiFrameWriter::writeZeros(size_t length)
+{
+    IMEBRA_FUNCTION_START();
+
+    static const std::uint8_t zeros[1024] = {0};
+    while(length != 0)
+    {
+        const size_t writeLength(length < sizeof(zeros) ? length : sizeof(zeros));
+        m_pWriter->write(zeros, writeLength);
+        length -= writeLength;
+    }
+
+    IMEBRA_FUNCTION_END();
+}
+
+} // namespace implementation
+
+} // namespace imebra
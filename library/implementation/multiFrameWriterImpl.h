@@ -0,0 +1,149 @@
+/*
+Copyright 2005 - 2017 by Paolo Brandoli/Binarno s.p.
+
+Imebra is available for free under the GNU General Public License.
+
+The full text of the license is available in the file license.rst
+ in the project root folder.
+
+If you do not want to be bound by the GPL terms (such as the requirement
+ that your application must also be GPL), you may purchase a commercial
+ license for Imebra from the Imebra’s website (http://imebra.com).
+*/
+
+/*! \file multiFrameWriterImpl.h
+    \brief Declaration of the class multiFrameWriter.
+
+*/
+
+#if !defined(imebraMultiFrameWriter_6C2E9A47_0B3D_4F18_A6E5_83D41B7C2F90__INCLUDED_)
+#define imebraMultiFrameWriter_6C2E9A47_0B3D_4F18_A6E5_83D41B7C2F90__INCLUDED_
+
+#include <memory>
+#include <vector>
+#include <string>
+#include <cstdint>
+#include "streamControllerImpl.h"
+#include "../include/imebra/definitions.h"
+
+namespace imebra
+{
+
+namespace implementation
+{
+
+class dataSet;
+class image;
+class streamWriter;
+
+///////////////////////////////////////////////////////////
+///////////////////////////////////////////////////////////
+/// \brief Writes a multi-frame DICOM stream one frame at
+///         a time.
+///
+/// The header dataset is written when the first frame is
+///  appended; each frame is encoded and written to the
+///  stream as soon as it is appended, so only the frames
+///  offsets are kept in memory.
+///
+/// close() writes the pixel data end marker and then
+///  overwrites the offset table and the group length
+///  reserved when the header was written: the destination
+///  stream must support writing at any position.
+///
+///////////////////////////////////////////////////////////
+///////////////////////////////////////////////////////////
+class multiFrameWriter
+{
+public:
+    /// \brief Constructor.
+    ///
+    /// @param pHeader         the dataset containing the tags
+    ///                         to write before the pixel
+    ///                         data. The image attributes
+    ///                         and the number of frames are
+    ///                         set by the writer
+    /// @param pWriter         the destination stream
+    /// @param numberOfFrames  the number of frames that will
+    ///                         be appended
+    /// @param quality         the compression quality
+    /// @param bExtendedOffsetTable true to store the frames
+    ///                         offsets in the Extended Offset
+    ///                         Table instead of the Basic
+    ///                         Offset Table
+    ///
+    ///////////////////////////////////////////////////////////
+    multiFrameWriter(std::shared_ptr<dataSet> pHeader, std::shared_ptr<streamWriter> pWriter, std::uint32_t numberOfFrames, imageQuality_t quality, bool bExtendedOffsetTable);
+
+    /// \brief Encode a frame and write it into the stream.
+    ///
+    /// @param pImage the frame to write
+    ///
+    ///////////////////////////////////////////////////////////
+    void appendImage(std::shared_ptr<image> pImage);
+
+    /// \brief Terminate the pixel data and update the
+    ///         offset table and the group length.
+    ///
+    ///////////////////////////////////////////////////////////
+    void close();
+
+private:
+    /// \brief Write the header dataset and the pixel data
+    ///         element up to the first frame.
+    ///
+    /// @param dataType    the data type of the pixel data
+    /// @param frameLength the length of one native frame.
+    ///                    Ignored for encapsulated frames
+    ///
+    ///////////////////////////////////////////////////////////
+    void writeHeader(tagVR_t dataType, size_t frameLength);
+
+    /// \brief Write a tag header (id, data type and length).
+    ///
+    ///////////////////////////////////////////////////////////
+    void writeTagHeader(std::uint16_t groupId, std::uint16_t tagId, tagVR_t dataType, std::uint32_t length);
+
+    /// \brief Write a buffer, adjusting its endianness.
+    ///
+    ///////////////////////////////////////////////////////////
+    void writeBuffer(const std::uint8_t* pBuffer, size_t bufferSize, size_t wordSize);
+
+    /// \brief Write zero bytes to reserve space for the
+    ///         values set by close().
+    ///
+    ///////////////////////////////////////////////////////////
+    void writeZeros(size_t length);
+
+    std::shared_ptr<dataSet> m_pHeader;
+    std::shared_ptr<streamWriter> m_pWriter;
+
+    const std::uint32_t m_numberOfFrames;
+    const imageQuality_t m_quality;
+    const bool m_bExtendedOffsetTable;
+
+    std::string m_transferSyntax;
+    bool m_bExplicitDataType;
+    streamController::tByteOrdering m_endianType;
+
+    bool m_bEncapsulated;
+    size_t m_frameLength;
+    std::uint32_t m_writtenFrames;
+    bool m_bClosed;
+
+    // Position of the values to patch in close()
+    ///////////////////////////////////////////////////////////
+    size_t m_groupLengthPosition;
+    size_t m_offsetTablePosition;
+    size_t m_lengthsTablePosition;
+    size_t m_firstFragmentPosition;
+
+    std::vector<std::uint64_t> m_framesOffsets;
+    std::vector<std::uint64_t> m_framesLengths;
+};
+
+} // namespace implementation
+
+} // namespace imebra
+
+#endif // !defined(imebraMultiFrameWriter_6C2E9A47_0B3D_4F18_A6E5_83D41B7C2F90__INCLUDED_)
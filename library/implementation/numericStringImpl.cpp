@@ -0,0 +1,388 @@
+/*
+Copyright 2005 - 2017 by Paolo Brandoli/Binarno s.p.
+
+Imebra is available for free under the GNU General Public License.
+
+The full text of the license is available in the file license.rst
+ in the project root folder.
+
+If you do not want to be bound by the GPL terms (such as the requirement
+ that your application must also be GPL), you may purchase a commercial
+ license for Imebra from the Imebra’s website (http://imebra.com).
+*/
+
+/*! \file numericStringImpl.cpp
+    \brief Implementation of the functions that convert
+            numbers to and from strings.
+
+*/
+
+#include "numericStringImpl.h"
+#include <sstream>
+#include <locale>
+#include <clocale>
+#include <cstdio>
+
+namespace imebra
+{
+
+namespace implementation
+{
+
+///////////////////////////////////////////////////////////
+//
+// Skip the blanks, as std::istream does
+//
+///////////////////////////////////////////////////////////
+static const char* skipBlanks(const char* pChars, const char* pEndChars)
+{
+    while(pChars != pEndChars && (*pChars == ' ' || (*pChars >= '\t' && *pChars <= '\r')))
+    {
+        ++pChars;
+    }
+    return pChars;
+}
+
+
+///////////////////////////////////////////////////////////
+//
+// Return true if the char is a decimal digit
+//
+///////////////////////////////////////////////////////////
+static inline bool isDigit(const char character)
+{
+    return character >= '0' && character <= '9';
+}
+
+
+///////////////////////////////////////////////////////////
+//
+// Parse the sign and the digits of an integer.
+// Fails if the magnitude doesn't fit in 32 bits
+//
+///////////////////////////////////////////////////////////
+static bool parseInteger(const char* pChars, size_t length, bool* pbNegative, std::uint32_t* pMagnitude)
+{
+    const char* pEndChars(pChars + length);
+    pChars = skipBlanks(pChars, pEndChars);
+
+    *pbNegative = false;
+    if(pChars != pEndChars && (*pChars == '+' || *pChars == '-'))
+    {
+        *pbNegative = (*pChars == '-');
+        ++pChars;
+    }
+
+    if(pChars == pEndChars || !isDigit(*pChars))
+    {
+        return false;
+    }
+
+    std::uint64_t magnitude(0);
+    for(; pChars != pEndChars && isDigit(*pChars); ++pChars)
+    {
+        magnitude = magnitude * 10u + (std::uint64_t)(*pChars - '0');
+        if(magnitude > 0xffffffffu)
+        {
+            return false;
+        }
+    }
+
+    *pMagnitude = (std::uint32_t)magnitude;
+    return true;
+}
+
+
+///////////////////////////////////////////////////////////
+//
+// Parse a signed integer
+//
+///////////////////////////////////////////////////////////
+bool parseSignedLong(const char* pChars, size_t length, std::int32_t* pValue)
+{
+    bool bNegative;
+    std::uint32_t magnitude;
+    if(!parseInteger(pChars, length, &bNegative, &magnitude))
+    {
+        return false;
+    }
+
+    if(bNegative)
+    {
+        if(magnitude > 0x80000000u)
+        {
+            return false;
+        }
+        *pValue = (std::int32_t)(0 - (std::int64_t)magnitude);
+        return true;
+    }
+
+    if(magnitude > 0x7fffffffu)
+    {
+        return false;
+    }
+    *pValue = (std::int32_t)magnitude;
+    return true;
+}
+
+
+///////////////////////////////////////////////////////////
+//
+// Parse an unsigned integer
+//
+///////////////////////////////////////////////////////////
+bool parseUnsignedLong(const char* pChars, size_t length, std::uint32_t* pValue)
+{
+    bool bNegative;
+    std::uint32_t magnitude;
+    if(!parseInteger(pChars, length, &bNegative, &magnitude))
+    {
+        return false;
+    }
+
+    *pValue = bNegative ? (std::uint32_t)(0u - magnitude) : magnitude;
+    return true;
+}
+
+
+///////////////////////////////////////////////////////////
+//
+// Parse a decimal number
+//
+///////////////////////////////////////////////////////////
+bool parseDouble(const char* pChars, size_t length, double* pValue)
+{
+    // Powers of ten that can be represented exactly by a
+    //  double
+    ///////////////////////////////////////////////////////////
+    static const double powersOfTen[] =
+    {
+        1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10, 1e11,
+        1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22
+    };
+    static const int maxExactPower(22);
+    static const std::uint64_t maxExactMantissa((std::uint64_t)1 << 53);
+    static const int maxMantissaDigits(19);
+
+    const char* pEndChars(pChars + length);
+    const char* pNumber(skipBlanks(pChars, pEndChars));
+    const char* pScanChars(pNumber);
+
+    bool bNegative(false);
+    if(pScanChars != pEndChars && (*pScanChars == '+' || *pScanChars == '-'))
+    {
+        bNegative = (*pScanChars == '-');
+        ++pScanChars;
+    }
+
+    // Collect the significant digits in an integer mantissa
+    ///////////////////////////////////////////////////////////
+    std::uint64_t mantissa(0);
+    int mantissaDigits(0);
+    int exponent(0);
+    bool bDigits(false);
+    bool bTruncated(false);
+    for(; pScanChars != pEndChars && isDigit(*pScanChars); ++pScanChars)
+    {
+        bDigits = true;
+        if(mantissaDigits == maxMantissaDigits)
+        {
+            ++exponent;
+            bTruncated = bTruncated || *pScanChars != '0';
+            continue;
+        }
+        mantissa = mantissa * 10u + (std::uint64_t)(*pScanChars - '0');
+        if(mantissa != 0)
+        {
+            ++mantissaDigits;
+        }
+    }
+    if(pScanChars != pEndChars && *pScanChars == '.')
+    {
+        for(++pScanChars; pScanChars != pEndChars && isDigit(*pScanChars); ++pScanChars)
+        {
+            bDigits = true;
+            if(mantissaDigits == maxMantissaDigits)
+            {
+                bTruncated = bTruncated || *pScanChars != '0';
+                continue;
+            }
+            mantissa = mantissa * 10u + (std::uint64_t)(*pScanChars - '0');
+            --exponent;
+            if(mantissa != 0)
+            {
+                ++mantissaDigits;
+            }
+        }
+    }
+    if(!bDigits)
+    {
+        return false;
+    }
+
+    // Parse the exponent
+    ///////////////////////////////////////////////////////////
+    if(pScanChars != pEndChars && (*pScanChars == 'e' || *pScanChars == 'E'))
+    {
+        const char* pExponent(pScanChars + 1);
+        bool bNegativeExponent(false);
+        if(pExponent != pEndChars && (*pExponent == '+' || *pExponent == '-'))
+        {
+            bNegativeExponent = (*pExponent == '-');
+            ++pExponent;
+        }
+        int exponentValue(0);
+        for(; pExponent != pEndChars && isDigit(*pExponent); ++pExponent)
+        {
+            if(exponentValue < 100000)
+            {
+                exponentValue = exponentValue * 10 + (*pExponent - '0');
+            }
+        }
+        exponent += bNegativeExponent ? -exponentValue : exponentValue;
+    }
+
+    // When both the mantissa and the power of ten are exact
+    //  then a single multiplication or division returns the
+    //  correctly rounded value
+    ///////////////////////////////////////////////////////////
+    if(!bTruncated && (mantissa == 0 ||
+                       (mantissa <= maxExactMantissa && exponent >= -maxExactPower && exponent <= maxExactPower)))
+    {
+        double value((double)mantissa);
+        if(exponent < 0)
+        {
+            value /= powersOfTen[-exponent];
+        }
+        else if(mantissa != 0)
+        {
+            value *= powersOfTen[exponent];
+        }
+        *pValue = bNegative ? -value : value;
+        return true;
+    }
+
+    // Let the C++ library deal with the other values
+    ///////////////////////////////////////////////////////////
+    std::istringstream conversion(std::string(pNumber, pEndChars));
+    conversion.imbue(std::locale::classic());
+    double value;
+    if(!(conversion >> value))
+    {
+        return false;
+    }
+    *pValue = value;
+    return true;
+}
+
+
+///////////////////////////////////////////////////////////
+//
+// Parse a date or time field
+//
+///////////////////////////////////////////////////////////
+std::int32_t parseField(const char* pChars, size_t length)
+{
+    bool bNegative;
+    std::uint32_t magnitude;
+    if(!parseInteger(pChars, length, &bNegative, &magnitude) || magnitude > 0x7fffffffu)
+    {
+        return 0;
+    }
+    return bNegative ? -(std::int32_t)magnitude : (std::int32_t)magnitude;
+}
+
+
+///////////////////////////////////////////////////////////
+//
+// Convert a signed integer to a string
+//
+///////////////////////////////////////////////////////////
+std::string signedLongToString(std::int64_t value)
+{
+    if(value >= 0)
+    {
+        return unsignedLongToString((std::uint64_t)value);
+    }
+    std::string valueString(1, '-');
+    valueString += unsignedLongToString(0 - (std::uint64_t)value);
+    return valueString;
+}
+
+
+///////////////////////////////////////////////////////////
+//
+// Convert an unsigned integer to a string
+//
+///////////////////////////////////////////////////////////
+std::string unsignedLongToString(std::uint64_t value)
+{
+    char digits[20];
+    char* pDigits(digits + sizeof(digits));
+    do
+    {
+        *(--pDigits) = (char)('0' + value % 10u);
+        value /= 10u;
+    } while(value != 0);
+
+    return std::string(pDigits, digits + sizeof(digits));
+}
+
+
+///////////////////////////////////////////////////////////
+//
+// Convert a double to a string
+//
+///////////////////////////////////////////////////////////
+std::string doubleToString(double value)
+{
+    char buffer[32];
+    const int length(::snprintf(buffer, sizeof(buffer), "%g", value));
+    if(length <= 0)
+    {
+        return std::string();
+    }
+    std::string valueString(buffer, (size_t)length < sizeof(buffer) ? (size_t)length : sizeof(buffer) - 1);
+
+    // printf uses the decimal separator of the C locale
+    ///////////////////////////////////////////////////////////
+    const char decimalPoint(*(::localeconv()->decimal_point));
+    if(decimalPoint != '.')
+    {
+        const size_t decimalPosition(valueString.find(decimalPoint));
+        if(decimalPosition != std::string::npos)
+        {
+            valueString[decimalPosition] = '.';
+        }
+    }
+
+    return valueString;
+}
+
+
+///////////////////////////////////////////////////////////
+//
+// Append a number padded with zeros
+//
+///////////////////////////////////////////////////////////
+void appendZeroPadded(std::string* pString, std::uint32_t value, size_t width)
+{
+    char digits[10];
+    char* pDigits(digits + sizeof(digits));
+    do
+    {
+        *(--pDigits) = (char)('0' + value % 10u);
+        value /= 10u;
+    } while(value != 0);
+
+    const size_t numDigits((size_t)(digits + sizeof(digits) - pDigits));
+    if(numDigits < width)
+    {
+        pString->append(width - numDigits, '0');
+    }
+    pString->append(pDigits, numDigits);
+}
+
+} // namespace implementation
+
+} // namespace imebra
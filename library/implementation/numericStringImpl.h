@@ -0,0 +1,133 @@
+/*
+Copyright 2005 - 2017 by Paolo Brandoli/Binarno s.p.
+
+Imebra is available for free under the GNU General Public License.
+
+The full text of the license is available in the file license.rst
+ in the project root folder.
+
+If you do not want to be bound by the GPL terms (such as the requirement
+ that your application must also be GPL), you may purchase a commercial
+ license for Imebra from the Imebra’s website (http://imebra.com).
+*/
+
+/*! \file numericStringImpl.h
+    \brief Declaration of the functions that convert numbers
+            to and from strings.
+
+    The functions don't depend on the current locale and
+     don't allocate memory while parsing.
+
+*/
+
+#if !defined(imebraNumericString_8D2F4B61_3C9A_4E07_A51B_6E0C72D9F3B4__INCLUDED_)
+#define imebraNumericString_8D2F4B61_3C9A_4E07_A51B_6E0C72D9F3B4__INCLUDED_
+
+#include <cstdint>
+#include <string>
+
+namespace imebra
+{
+
+namespace implementation
+{
+
+///////////////////////////////////////////////////////////
+/// \brief Parse a signed integer.
+///
+/// Leading blanks are skipped and the parsing stops at the
+///  first char that is not a digit.
+///
+/// @param pChars  the chars to parse
+/// @param length  the number of chars to parse
+/// @param pValue  a variable that will be filled with the
+///                 parsed value
+/// @return false if the chars don't begin with a number
+///          or the number doesn't fit in 32 bits
+///
+///////////////////////////////////////////////////////////
+bool parseSignedLong(const char* pChars, size_t length, std::int32_t* pValue);
+
+///////////////////////////////////////////////////////////
+/// \brief Parse an unsigned integer.
+///
+/// As with strtoul(), a negative number is converted to
+///  unsigned.
+///
+/// @param pChars  the chars to parse
+/// @param length  the number of chars to parse
+/// @param pValue  a variable that will be filled with the
+///                 parsed value
+/// @return false if the chars don't begin with a number
+///          or the number doesn't fit in 32 bits
+///
+///////////////////////////////////////////////////////////
+bool parseUnsignedLong(const char* pChars, size_t length, std::uint32_t* pValue);
+
+///////////////////////////////////////////////////////////
+/// \brief Parse a decimal number, always using the dot as
+///         decimal separator.
+///
+/// The values whose digits fit in 53 bits and have a
+///  small exponent (the common case for the DS tags) are
+///  converted without calling the C++ library.
+///
+/// @param pChars  the chars to parse
+/// @param length  the number of chars to parse
+/// @param pValue  a variable that will be filled with the
+///                 parsed value
+/// @return false if the chars don't begin with a number
+///
+///////////////////////////////////////////////////////////
+bool parseDouble(const char* pChars, size_t length, double* pValue);
+
+///////////////////////////////////////////////////////////
+/// \brief Parse the fixed width fields of dates and
+///         times.
+///
+/// @param pChars  the chars to parse
+/// @param length  the number of chars to parse
+/// @return the parsed value, or 0 if the chars don't
+///          begin with a number
+///
+///////////////////////////////////////////////////////////
+std::int32_t parseField(const char* pChars, size_t length);
+
+///////////////////////////////////////////////////////////
+/// \brief Convert a signed integer to a string.
+///
+///////////////////////////////////////////////////////////
+std::string signedLongToString(std::int64_t value);
+
+///////////////////////////////////////////////////////////
+/// \brief Convert an unsigned integer to a string.
+///
+///////////////////////////////////////////////////////////
+std::string unsignedLongToString(std::uint64_t value);
+
+///////////////////////////////////////////////////////////
+/// \brief Convert a double to a string, with the same
+///         format used by std::ostream (6 significant
+///         digits) but always using the dot as decimal
+///         separator.
+///
+///////////////////////////////////////////////////////////
+std::string doubleToString(double value);
+
+///////////////////////////////////////////////////////////
+/// \brief Append an unsigned integer to a string, padding
+///         it with zeros on the left.
+///
+/// @param pString   the string to which the number is
+///                   appended
+/// @param value     the number to append
+/// @param width     the minimum number of digits
+///
+///////////////////////////////////////////////////////////
+void appendZeroPadded(std::string* pString, std::uint32_t value, size_t width);
+
+} // namespace implementation
+
+} // namespace imebra
+
+#endif // !defined(imebraNumericString_8D2F4B61_3C9A_4E07_A51B_6E0C72D9F3B4__INCLUDED_)
@@ -0,0 +1,228 @@
+/*
+Copyright 2005 - 2017 by Paolo Brandoli/Binarno s.p.
+
+Imebra is available for free under the GNU General Public License.
+
+The full text of the license is available in the file license.rst
+ in the project root folder.
+
+If you do not want to be bound by the GPL terms (such as the requirement
+ that your application must also be GPL), you may purchase a commercial
+ license for Imebra from the Imebra’s website (http://imebra.com).
+*/
+
+/*! \file statisticsImpl.cpp
+    \brief Implementation of the performance counters.
+
+*/
+
+#include "statisticsImpl.h"
+#include "exceptionImpl.h"
+#include "threadRegistryImpl.h"
+
+namespace imebra
+{
+
+namespace implementation
+{
+
+///////////////////////////////////////////////////////////
+//
+// Counters constructor
+//
+///////////////////////////////////////////////////////////
+statistics::countersSet::countersSet()
+{
+    for(size_t scanCounters(0); scanCounters != (size_t)statisticsCounter_t::countersNumber; ++scanCounters)
+    {
+        m_counters[scanCounters].store(0, std::memory_order_relaxed);
+    }
+}
+
+
+///////////////////////////////////////////////////////////
+//
+// Registry constructor
+//
+///////////////////////////////////////////////////////////
+statistics::registry::registry()
+{
+    for(size_t scanCounters(0); scanCounters != (size_t)statisticsCounter_t::countersNumber; ++scanCounters)
+    {
+        m_terminatedThreads[scanCounters] = 0;
+        m_resetValues[scanCounters] = 0;
+    }
+}
+
+
+///////////////////////////////////////////////////////////
+//
+// Register the counters of a thread
+//
+///////////////////////////////////////////////////////////
+void statistics::registry::addThread(countersSet* pCounters)
+{
+    IMEBRA_FUNCTION_START();
+
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_threads.push_back(pCounters);
+
+    IMEBRA_FUNCTION_END();
+}
+
+
+///////////////////////////////////////////////////////////
+//
+// Keep the counters of a terminating thread
+//
+///////////////////////////////////////////////////////////
+void statistics::registry::removeThread(countersSet* pCounters)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    for(size_t scanCounters(0); scanCounters != (size_t)statisticsCounter_t::countersNumber; ++scanCounters)
+    {
+        m_terminatedThreads[scanCounters] += pCounters->m_counters[scanCounters].load(std::memory_order_relaxed);
+    }
+    m_threads.remove(pCounters);
+}
+
+
+///////////////////////////////////////////////////////////
+//
+// Sum the counters of all the threads
+//
+///////////////////////////////////////////////////////////
+void statistics::registry::getTotals(std::uint64_t* pTotals)
+{
+    IMEBRA_FUNCTION_START();
+
+    std::lock_guard<std::mutex> lock(m_mutex);
+    for(size_t scanCounters(0); scanCounters != (size_t)statisticsCounter_t::countersNumber; ++scanCounters)
+    {
+        std::uint64_t total(m_terminatedThreads[scanCounters]);
+        for(std::list<countersSet*>::const_iterator scanThreads(m_threads.begin()), endThreads(m_threads.end()); scanThreads != endThreads; ++scanThreads)
+        {
+            total += (*scanThreads)->m_counters[scanCounters].load(std::memory_order_relaxed);
+        }
+
+        // The totals never decrease, so they are always
+        //  larger than or equal to the values at the reset
+        ///////////////////////////////////////////////////////////
+        pTotals[scanCounters] = total - m_resetValues[scanCounters];
+    }
+
+    IMEBRA_FUNCTION_END();
+}
+
+
+///////////////////////////////////////////////////////////
+//
+// Reset the counters
+//
+///////////////////////////////////////////////////////////
+void statistics::registry::reset()
+{
+    IMEBRA_FUNCTION_START();
+
+    std::uint64_t totals[(size_t)statisticsCounter_t::countersNumber];
+    getTotals(totals);
+
+    std::lock_guard<std::mutex> lock(m_mutex);
+    for(size_t scanCounters(0); scanCounters != (size_t)statisticsCounter_t::countersNumber; ++scanCounters)
+    {
+        m_resetValues[scanCounters] += totals[scanCounters];
+    }
+
+    IMEBRA_FUNCTION_END();
+}
+
+
+///////////////////////////////////////////////////////////
+//
+// Thread counters constructor
+//
+///////////////////////////////////////////////////////////
+statistics::threadCounters::threadCounters():
+    m_pRegistry(getSharedRegistry<registry>())
+{
+    m_pRegistry->addThread(this);
+}
+
+
+///////////////////////////////////////////////////////////
+//
+// Thread counters destructor
+//
+///////////////////////////////////////////////////////////
+statistics::threadCounters::~threadCounters()
+{
+    m_pRegistry->removeThread(this);
+}
+
+
+///////////////////////////////////////////////////////////
+//
+// Return the counters of the calling thread
+//
+///////////////////////////////////////////////////////////
+statistics::threadCounters& statistics::getThreadCounters()
+{
+    return getThreadObject<threadCounters>();
+}
+
+
+///////////////////////////////////////////////////////////
+//
+// Return the statistics
+//
+///////////////////////////////////////////////////////////
+LibraryStatistics statistics::getStatistics()
+{
+    IMEBRA_FUNCTION_START();
+
+    std::uint64_t totals[(size_t)statisticsCounter_t::countersNumber];
+    getSharedRegistry<registry>()->getTotals(totals);
+
+    LibraryStatistics libraryStatistics;
+    libraryStatistics.fileBytesRead = totals[(size_t)statisticsCounter_t::fileBytesRead];
+    libraryStatistics.fileReadTime = totals[(size_t)statisticsCounter_t::fileReadTime] / 1000u;
+    libraryStatistics.parsedElements = totals[(size_t)statisticsCounter_t::parsedElements];
+    libraryStatistics.parsingTime = totals[(size_t)statisticsCounter_t::parsingTime] / 1000u;
+    libraryStatistics.dicomDecodedFrames = totals[(size_t)statisticsCounter_t::dicomDecodedFrames];
+    libraryStatistics.dicomDecodedPixels = totals[(size_t)statisticsCounter_t::dicomDecodedPixels];
+    libraryStatistics.dicomDecodingTime = totals[(size_t)statisticsCounter_t::dicomDecodingTime] / 1000u;
+    libraryStatistics.jpegDecodedFrames = totals[(size_t)statisticsCounter_t::jpegDecodedFrames];
+    libraryStatistics.jpegDecodedPixels = totals[(size_t)statisticsCounter_t::jpegDecodedPixels];
+    libraryStatistics.jpegDecodingTime = totals[(size_t)statisticsCounter_t::jpegDecodingTime] / 1000u;
+    libraryStatistics.jpeg2000DecodedFrames = totals[(size_t)statisticsCounter_t::jpeg2000DecodedFrames];
+    libraryStatistics.jpeg2000DecodedPixels = totals[(size_t)statisticsCounter_t::jpeg2000DecodedPixels];
+    libraryStatistics.jpeg2000DecodingTime = totals[(size_t)statisticsCounter_t::jpeg2000DecodingTime] / 1000u;
+    libraryStatistics.transformInvocations = totals[(size_t)statisticsCounter_t::transformInvocations];
+    libraryStatistics.transformedPixels = totals[(size_t)statisticsCounter_t::transformedPixels];
+    libraryStatistics.transformTime = totals[(size_t)statisticsCounter_t::transformTime] / 1000u;
+    libraryStatistics.memoryPoolHits = totals[(size_t)statisticsCounter_t::memoryPoolHits];
+    libraryStatistics.memoryPoolMisses = totals[(size_t)statisticsCounter_t::memoryPoolMisses];
+
+    return libraryStatistics;
+
+    IMEBRA_FUNCTION_END();
+}
+
+
+///////////////////////////////////////////////////////////
+//
+// Reset the statistics
+//
+///////////////////////////////////////////////////////////
+void statistics::resetStatistics()
+{
+    IMEBRA_FUNCTION_START();
+
+    getSharedRegistry<registry>()->reset();
+
+    IMEBRA_FUNCTION_END();
+}
+
+} // namespace implementation
+
+} // namespace imebra
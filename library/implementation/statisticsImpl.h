@@ -0,0 +1,219 @@
+/*
+Copyright 2005 - 2017 by Paolo Brandoli/Binarno s.p.
+
+Imebra is available for free under the GNU General Public License.
+
+The full text of the license is available in the file license.rst
+ in the project root folder.
+
+If you do not want to be bound by the GPL terms (such as the requirement
+ that your application must also be GPL), you may purchase a commercial
+ license for Imebra from the Imebra’s website (http://imebra.com).
+*/
+
+/*! \file statisticsImpl.h
+    \brief Declaration of the performance counters.
+
+    The counters are updated through the macros
+     IMEBRA_STATISTICS_ADD and IMEBRA_STATISTICS_TIMER,
+     which compile to nothing when the library is built
+     with IMEBRA_DISABLE_STATISTICS.
+
+*/
+
+#if !defined(imebraStatistics_4E9B1C72_6A3D_4F85_B0E2_97C5D13A8F64__INCLUDED_)
+#define imebraStatistics_4E9B1C72_6A3D_4F85_B0E2_97C5D13A8F64__INCLUDED_
+
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <mutex>
+#include <list>
+#include <cstdint>
+#include "../include/imebra/definitions.h"
+
+namespace imebra
+{
+
+namespace implementation
+{
+
+///////////////////////////////////////////////////////////
+/// \brief Identifies a performance counter.
+///
+/// The timers accumulate nanoseconds.
+///
+///////////////////////////////////////////////////////////
+enum class statisticsCounter_t: std::uint32_t
+{
+    fileBytesRead,
+    fileReadTime,
+    parsedElements,
+    parsingTime,
+    dicomDecodedFrames,
+    dicomDecodedPixels,
+    dicomDecodingTime,
+    jpegDecodedFrames,
+    jpegDecodedPixels,
+    jpegDecodingTime,
+    jpeg2000DecodedFrames,
+    jpeg2000DecodedPixels,
+    jpeg2000DecodingTime,
+    transformInvocations,
+    transformedPixels,
+    transformTime,
+    memoryPoolHits,
+    memoryPoolMisses,
+
+    countersNumber
+};
+
+
+///////////////////////////////////////////////////////////
+///////////////////////////////////////////////////////////
+/// \brief Collects the performance counters of all the
+///         threads.
+///
+/// Each thread updates its own set of counters without
+///  locking; the counters of a terminated thread are
+///  added to a global set.
+///
+/// Resetting the statistics records the current values,
+///  which are then subtracted from the following
+///  snapshots: the counters of the other threads are
+///  never written.
+///
+///////////////////////////////////////////////////////////
+///////////////////////////////////////////////////////////
+class statistics
+{
+public:
+    /// \brief Add a value to a counter of the calling
+    ///         thread.
+    ///
+    /// @param counter the counter to update
+    /// @param value   the value to add
+    ///
+    ///////////////////////////////////////////////////////////
+    static void add(statisticsCounter_t counter, std::uint64_t value)
+    {
+        // Only the owner thread writes the counter: atomic
+        //  loads and stores are enough and don't lock the bus
+        ///////////////////////////////////////////////////////////
+        std::atomic<std::uint64_t>& threadCounter(getThreadCounters().m_counters[(size_t)counter]);
+        threadCounter.store(threadCounter.load(std::memory_order_relaxed) + value, std::memory_order_relaxed);
+    }
+
+    /// \brief Return the counters of all the threads,
+    ///         collected since the last reset.
+    ///
+    ///////////////////////////////////////////////////////////
+    static LibraryStatistics getStatistics();
+
+    /// \brief Reset all the counters.
+    ///
+    ///////////////////////////////////////////////////////////
+    static void resetStatistics();
+
+private:
+    struct countersSet
+    {
+        countersSet();
+
+        std::atomic<std::uint64_t> m_counters[(size_t)statisticsCounter_t::countersNumber];
+    };
+
+    /// \brief Keeps track of the counters of all the
+    ///         threads.
+    ///
+    ///////////////////////////////////////////////////////////
+    class registry
+    {
+    public:
+        registry();
+
+        void addThread(countersSet* pCounters);
+        void removeThread(countersSet* pCounters);
+
+        void getTotals(std::uint64_t* pTotals);
+
+        void reset();
+
+    private:
+        std::mutex m_mutex;
+        std::list<countersSet*> m_threads;
+
+        std::uint64_t m_terminatedThreads[(size_t)statisticsCounter_t::countersNumber];
+        std::uint64_t m_resetValues[(size_t)statisticsCounter_t::countersNumber];
+    };
+
+    /// \brief The counters of a thread, registered in the
+    ///         registry while the thread is running.
+    ///
+    ///////////////////////////////////////////////////////////
+    class threadCounters: public countersSet
+    {
+    public:
+        threadCounters();
+        ~threadCounters();
+
+    private:
+        std::shared_ptr<registry> m_pRegistry;
+    };
+
+    static threadCounters& getThreadCounters();
+};
+
+
+///////////////////////////////////////////////////////////
+///////////////////////////////////////////////////////////
+/// \brief Adds the time elapsed between its construction
+///         and its destruction to a counter.
+///
+///////////////////////////////////////////////////////////
+///////////////////////////////////////////////////////////
+class statisticsTimer
+{
+public:
+    statisticsTimer(statisticsCounter_t counter):
+        m_counter(counter), m_startTime(std::chrono::steady_clock::now())
+    {
+    }
+
+    ~statisticsTimer()
+    {
+        statistics::add(m_counter, (std::uint64_t)std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - m_startTime).count());
+    }
+
+private:
+    const statisticsCounter_t m_counter;
+    const std::chrono::steady_clock::time_point m_startTime;
+};
+
+} // namespace implementation
+
+} // namespace imebra
+
+
+#ifdef IMEBRA_DISABLE_STATISTICS
+
+#define IMEBRA_STATISTICS_ADD(counter, value)
+#define IMEBRA_STATISTICS_TIMER(timerName, counter)
+
+#else
+
+/// \brief Add a value to a counter.
+///
+///////////////////////////////////////////////////////////
+#define IMEBRA_STATISTICS_ADD(counter, value) \
+    ::imebra::implementation::statistics::add(::imebra::implementation::statisticsCounter_t::counter, (std::uint64_t)(value))
+
+/// \brief Time the rest of the enclosing scope.
+///
+///////////////////////////////////////////////////////////
+#define IMEBRA_STATISTICS_TIMER(timerName, counter) \
+    ::imebra::implementation::statisticsTimer timerName(::imebra::implementation::statisticsCounter_t::counter)
+
+#endif
+
+#endif // !defined(imebraStatistics_4E9B1C72_6A3D_4F85_B0E2_97C5D13A8F64__INCLUDED_)
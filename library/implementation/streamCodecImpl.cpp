@@ -35,6 +35,22 @@ namespace implementation
 namespace codecs
 {
 
+///////////////////////////////////////////////////////////
+///////////////////////////////////////////////////////////
+//
+//
+// Probe the stream's format. By default all the streams
+//  are accepted and the format is checked by read().
+//
+//
+///////////////////////////////////////////////////////////
+///////////////////////////////////////////////////////////
+bool streamCodec::canRead(const std::uint8_t* /* pPrefix */, size_t /* prefixLength */) const
+{
+    return true;
+}
+
+
 ///////////////////////////////////////////////////////////
 ///////////////////////////////////////////////////////////
 //
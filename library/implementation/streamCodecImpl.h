@@ -25,6 +25,13 @@ If you do not want to be bound by the GPL terms (such as the requirement
 #include "../include/imebra/definitions.h"
 
 
+/// \brief Number of bytes passed to streamCodec::canRead()
+///        when probing the format of a stream: enough to
+///        cover the DICOM preamble and the DICM signature.
+///
+///////////////////////////////////////////////////////////
+#define IMEBRA_STREAM_PROBE_LENGTH 132
+
 namespace imebra
 {
 
@@ -146,6 +153,31 @@ public:
 	///////////////////////////////////////////////////////////
     void write(std::shared_ptr<streamWriter> pDestStream, std::shared_ptr<dataSet> pSourceDataSet) const;
 
+    /// \brief Check the first bytes of a stream and return
+    ///        true if the codec may be able to parse it.
+    ///
+    /// The function doesn't throw when the format is not
+    ///  recognized: codecFactory uses it to skip the codecs
+    ///  that cannot parse the stream without paying for
+    ///  a failed read().
+    ///
+    /// A positive answer doesn't guarantee that read()
+    ///  will succeed: it just means that the stream's
+    ///  signature is compatible with the codec.
+    ///
+    /// The default implementation returns true.
+    ///
+    /// @param pPrefix      the first bytes of the stream
+    /// @param prefixLength the number of bytes in pPrefix.
+    ///                     It is smaller than
+    ///                     IMEBRA_STREAM_PROBE_LENGTH when
+    ///                     the stream is shorter
+    /// @return true if the stream may be parsed by the
+    ///          codec, false otherwise
+    ///
+    ///////////////////////////////////////////////////////////
+    virtual bool canRead(const std::uint8_t* pPrefix, size_t prefixLength) const;
+
 	//@}
 
 protected:
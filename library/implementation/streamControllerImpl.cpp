@@ -17,6 +17,11 @@ If you do not want to be bound by the GPL terms (such as the requirement
 */
 
 #include "streamControllerImpl.h"
+#include "exceptionImpl.h"
+#include <string.h>
+#if defined(_MSC_VER)
+#include <stdlib.h>
+#endif
 
 namespace imebra
 {
@@ -78,59 +83,104 @@ size_t streamController::getControlledStreamPosition()
 
 ///////////////////////////////////////////////////////////
 //
-// Adjust the byte ordering of pBuffer
+// Swap the bytes of a word. The compilers translate the
+//  builtins into a single instruction and vectorize the
+//  loops that use them
+//
+///////////////////////////////////////////////////////////
+static inline std::uint16_t swapBytes(std::uint16_t value)
+{
+#if defined(__GNUC__) || defined(__clang__)
+    return __builtin_bswap16(value);
+#elif defined(_MSC_VER)
+    return _byteswap_ushort(value);
+#else
+    return (std::uint16_t)((value >> 8) | (value << 8));
+#endif
+}
+
+static inline std::uint32_t swapBytes(std::uint32_t value)
+{
+#if defined(__GNUC__) || defined(__clang__)
+    return __builtin_bswap32(value);
+#elif defined(_MSC_VER)
+    return _byteswap_ulong(value);
+#else
+    return ((value & 0xff000000) >> 24) | ((value & 0x00ff0000) >> 8) | ((value & 0x0000ff00) << 8) | ((value & 0x000000ff) << 24);
+#endif
+}
+
+static inline std::uint64_t swapBytes(std::uint64_t value)
+{
+#if defined(__GNUC__) || defined(__clang__)
+    return __builtin_bswap64(value);
+#elif defined(_MSC_VER)
+    return _byteswap_uint64(value);
+#else
+    return ((std::uint64_t)swapBytes((std::uint32_t)value) << 32) | (std::uint64_t)swapBytes((std::uint32_t)(value >> 32));
+#endif
+}
+
+///////////////////////////////////////////////////////////
+//
+// Copy words swapping their bytes. The words are moved
+//  with memcpy so the buffers don't need to be aligned
+//
+///////////////////////////////////////////////////////////
+template<typename word_t>
+static void copySwapWords(const std::uint8_t* pSource, std::uint8_t* pDestination, size_t words)
+{
+    for(; words != 0; --words, pSource += sizeof(word_t), pDestination += sizeof(word_t))
+    {
+        word_t word;
+        ::memcpy(&word, pSource, sizeof(word_t));
+        word = swapBytes(word);
+        ::memcpy(pDestination, &word, sizeof(word_t));
+    }
+}
+
+
+///////////////////////////////////////////////////////////
+//
+// Adjust the endian of a buffer
 //
 ///////////////////////////////////////////////////////////
 void streamController::adjustEndian(std::uint8_t* pBuffer, const size_t wordLength, const tByteOrdering endianType, const size_t words /* =1 */)
 {
-    IMEBRA_FUNCTION_START();
+    adjustEndian(pBuffer, pBuffer, wordLength, endianType, words);
+}
 
-    if(endianType == m_platformByteOrder || wordLength<2L)
-	{
-		return;
-	}
 
-	switch(wordLength)
-	{
-	case 2:
-        {
-            std::uint16_t* pWord((std::uint16_t*)pBuffer);
-            for(size_t scanWords = words; scanWords != 0; --scanWords)
-            {
-                *pWord = (std::uint16_t)(((*pWord & 0x00ff) << 8) | ((*pWord & 0xff00) >> 8));
-                ++pWord;
-			}
-		}
-		return;
-	case 4:
-        {
-            std::uint32_t* pDWord((std::uint32_t*)pBuffer);
-            for(size_t scanWords = words; scanWords != 0; --scanWords)
-            {
-                *pDWord = ((*pDWord & 0xff000000) >> 24) | ((*pDWord & 0x00ff0000) >> 8) | ((*pDWord & 0x0000ff00) << 8) | ((*pDWord & 0x000000ff) << 24);
-                ++pDWord;
-			}
-		}
-		return;
-    case 8:
+///////////////////////////////////////////////////////////
+//
+// Copy a buffer adjusting its endian
+//
+///////////////////////////////////////////////////////////
+void streamController::adjustEndian(const std::uint8_t* pSource, std::uint8_t* pDestination, const size_t wordLength, const tByteOrdering endianType, const size_t words)
+{
+    IMEBRA_FUNCTION_START();
+
+    if(endianType == m_platformByteOrder || wordLength < 2)
+    {
+        if(pSource != pDestination)
         {
-            std::uint64_t* pQWord((std::uint64_t*)pBuffer);
-            for(std::uint64_t scanWords = words; scanWords != 0; --scanWords)
-            {
-                *pQWord =
-                        ((*pQWord & 0xff00000000000000) >> 56) |
-                        ((*pQWord & 0x00ff000000000000) >> 40) |
-                        ((*pQWord & 0x0000ff0000000000) >> 24) |
-                        ((*pQWord & 0x000000ff00000000) >> 8) |
-                        ((*pQWord & 0x00000000ff000000) << 8) |
-                        ((*pQWord & 0x0000000000ff0000) << 24) |
-                        ((*pQWord & 0x000000000000ff00) << 40) |
-                        ((*pQWord & 0x00000000000000ff) << 56);
-                ++pQWord;
-            }
+            ::memmove(pDestination, pSource, wordLength * words);
         }
         return;
-	}
+    }
+
+    switch(wordLength)
+    {
+    case 2:
+        copySwapWords<std::uint16_t>(pSource, pDestination, words);
+        return;
+    case 4:
+        copySwapWords<std::uint32_t>(pSource, pDestination, words);
+        return;
+    case 8:
+        copySwapWords<std::uint64_t>(pSource, pDestination, words);
+        return;
+    }
 
     IMEBRA_FUNCTION_END();
 }
@@ -141,7 +191,7 @@ std::uint16_t streamController::adjustEndian(std::uint16_t buffer, const tByteOr
     {
         return buffer;
     }
-    return (std::uint16_t)(((buffer & 0xff00) >> 8) | ((buffer & 0xff) << 8));
+    return swapBytes(buffer);
 }
 
 std::uint32_t streamController::adjustEndian(std::uint32_t buffer, const tByteOrdering endianType)
@@ -150,11 +200,7 @@ std::uint32_t streamController::adjustEndian(std::uint32_t buffer, const tByteOr
     {
         return buffer;
     }
-    return (std::uint32_t)(
-            ((buffer & 0xff000000) >> 24) |
-            ((buffer & 0x00ff0000) >> 8) |
-            ((buffer & 0x0000ff00) << 8) |
-            ((buffer & 0x000000ff) << 24) );
+    return swapBytes(buffer);
 }
 
 std::uint64_t streamController::adjustEndian(std::uint64_t buffer, const tByteOrdering endianType)
@@ -163,15 +209,7 @@ std::uint64_t streamController::adjustEndian(std::uint64_t buffer, const tByteOr
     {
         return buffer;
     }
-    return (std::uint64_t)(
-            ((buffer & 0xff00000000000000) >> 56) |
-            ((buffer & 0x00ff000000000000) >> 40) |
-            ((buffer & 0x0000ff0000000000) >> 24) |
-            ((buffer & 0x000000ff00000000) >> 8) |
-            ((buffer & 0x00000000ff000000) << 8) |
-            ((buffer & 0x0000000000ff0000) << 24) |
-            ((buffer & 0x000000000000ff00) << 40) |
-            ((buffer & 0x00000000000000ff) << 56));
+    return swapBytes(buffer);
 }
 
 streamController::tByteOrdering streamController::getPlatformEndian()
@@ -156,6 +156,25 @@ public:
 	///////////////////////////////////////////////////////////
     static void adjustEndian(std::uint8_t* pBuffer, const size_t wordLength, const tByteOrdering endianType, const size_t words = 1);
 
+    /// \brief Copy a buffer adjusting the byte endian of
+    ///         its elements.
+    ///
+    /// Does the same as adjustEndian(std::uint8_t*, const size_t, const tByteOrdering, const size_t)
+    ///  but writes the result into pDestination, so the
+    ///  data is read and written only once.
+    /// pSource and pDestination may point to the same
+    ///  buffer.
+    ///
+    /// @param pSource      the buffer to copy
+    /// @param pDestination the destination buffer
+    /// @param wordLength   the size, in bytes, of the
+    ///                      elements
+    /// @param endianType   the desidered byte ordering
+    /// @param words        the number of elements to copy
+    ///
+    ///////////////////////////////////////////////////////////
+    static void adjustEndian(const std::uint8_t* pSource, std::uint8_t* pDestination, const size_t wordLength, const tByteOrdering endianType, const size_t words);
+
     static std::uint16_t adjustEndian(std::uint16_t buffer, const tByteOrdering endianType);
 
     static std::uint32_t adjustEndian(std::uint32_t buffer, const tByteOrdering endianType);
@@ -79,21 +79,6 @@ std::shared_ptr<streamReader> streamReader::getReader(size_t virtualLength)
     IMEBRA_FUNCTION_END();
 }
 
-///////////////////////////////////////////////////////////
-//
-// Returns true if the last byte has been read
-//
-///////////////////////////////////////////////////////////
-bool streamReader::endReached()
-{
-    IMEBRA_FUNCTION_START();
-
-    return (m_dataBufferCurrent == m_dataBufferEnd && fillDataBuffer() == 0);
-
-    IMEBRA_FUNCTION_END();
-}
-
-
 ///////////////////////////////////////////////////////////
 //
 // Refill the data buffer
@@ -167,6 +152,83 @@ void streamReader::read(std::uint8_t* pBuffer, size_t bufferLength)
 }
 
 
+///////////////////////////////////////////////////////////
+//
+// Read data and adjust its byte endian
+//
+///////////////////////////////////////////////////////////
+void streamReader::read(std::uint8_t* pBuffer, size_t bufferLength, size_t wordLength, tByteOrdering endianType)
+{
+    IMEBRA_FUNCTION_START();
+
+    if(wordLength < 2 || endianType == getPlatformEndian())
+    {
+        read(pBuffer, bufferLength);
+        return;
+    }
+
+    // The bytes after the last complete word are not swapped
+    ///////////////////////////////////////////////////////////
+    const size_t tailLength(bufferLength % wordLength);
+    bufferLength -= tailLength;
+
+    while(bufferLength != 0)
+    {
+        if(m_dataBufferCurrent == m_dataBufferEnd)
+        {
+            // Large blocks are read directly into the destination
+            //  buffer and swapped while they are still in the cache
+            ///////////////////////////////////////////////////////////
+            if(bufferLength >= m_dataBuffer.size())
+            {
+                size_t sliceLength(bufferLength > 262144 ? 262144 : bufferLength);
+                sliceLength -= sliceLength % wordLength;
+                read(pBuffer, sliceLength);
+                adjustEndian(pBuffer, wordLength, endianType, sliceLength / wordLength);
+                pBuffer += sliceLength;
+                bufferLength -= sliceLength;
+                continue;
+            }
+
+            if(fillDataBuffer() == 0)
+            {
+                IMEBRA_THROW(StreamEOFError, "Attempt to read past the end of the file");
+            }
+        }
+
+        size_t copySize((size_t)(m_dataBufferEnd - m_dataBufferCurrent));
+        if(copySize > bufferLength)
+        {
+            copySize = bufferLength;
+        }
+        copySize -= copySize % wordLength;
+
+        // A word split between two refills of the data buffer
+        ///////////////////////////////////////////////////////////
+        if(copySize == 0)
+        {
+            read(pBuffer, wordLength);
+            adjustEndian(pBuffer, wordLength, endianType, 1);
+            pBuffer += wordLength;
+            bufferLength -= wordLength;
+            continue;
+        }
+
+        adjustEndian(&(m_dataBuffer[m_dataBufferCurrent]), pBuffer, wordLength, endianType, copySize / wordLength);
+        pBuffer += copySize;
+        bufferLength -= copySize;
+        m_dataBufferCurrent += copySize;
+    }
+
+    if(tailLength != 0)
+    {
+        read(pBuffer, tailLength);
+    }
+
+    IMEBRA_FUNCTION_END();
+}
+
+
 ///////////////////////////////////////////////////////////
 //
 // Return the specified number of bytes from the stream
@@ -269,6 +331,92 @@ void streamReader::seekForward(std::uint32_t newPosition)
     IMEBRA_FUNCTION_END();
 }
 
+///////////////////////////////////////////////////////////
+//
+// Check if the specified amount of bytes is available
+//
+///////////////////////////////////////////////////////////
+bool streamReader::isAvailable(size_t length)
+{
+    IMEBRA_FUNCTION_START();
+
+    if(length == 0)
+    {
+        return true;
+    }
+
+    size_t lastBytePosition(position() + length - 1);
+
+    if(lastBytePosition < m_dataBufferStreamPosition + m_dataBufferEnd)
+    {
+        return true;
+    }
+
+    if(m_virtualLength != 0 && lastBytePosition >= m_virtualLength)
+    {
+        return false;
+    }
+
+    std::uint8_t lastByte;
+    return m_pControlledStream->read(lastBytePosition + m_virtualStart, &lastByte, 1) == 1;
+
+    IMEBRA_FUNCTION_END();
+}
+
+
+///////////////////////////////////////////////////////////
+//
+// Copy the next bytes without moving the read position
+//
+///////////////////////////////////////////////////////////
+size_t streamReader::peek(std::uint8_t* pBuffer, size_t bufferLength)
+{
+    IMEBRA_FUNCTION_START();
+
+    const size_t peekPosition(position());
+    if(m_virtualLength != 0)
+    {
+        if(peekPosition >= m_virtualLength)
+        {
+            return 0;
+        }
+        if(peekPosition + bufferLength > m_virtualLength)
+        {
+            bufferLength = m_virtualLength - peekPosition;
+        }
+    }
+
+    // Copy the bytes already in the data buffer
+    ///////////////////////////////////////////////////////////
+    size_t peekedBytes((size_t)(m_dataBufferEnd - m_dataBufferCurrent));
+    if(peekedBytes > bufferLength)
+    {
+        peekedBytes = bufferLength;
+    }
+    if(peekedBytes != 0)
+    {
+        ::memcpy(pBuffer, &(m_dataBuffer[m_dataBufferCurrent]), peekedBytes);
+    }
+
+    // Read the remaining bytes directly from the controlled
+    //  stream, leaving the data buffer untouched
+    ///////////////////////////////////////////////////////////
+    while(peekedBytes != bufferLength)
+    {
+        const size_t readBytes(m_pControlledStream->read(peekPosition + peekedBytes + m_virtualStart, pBuffer + peekedBytes, bufferLength - peekedBytes));
+        if(readBytes == 0)
+        {
+            break;
+        }
+        peekedBytes += readBytes;
+    }
+
+    return peekedBytes;
+
+    IMEBRA_FUNCTION_END();
+}
+
+
 } // namespace implementation
 
 } // namespace imebra
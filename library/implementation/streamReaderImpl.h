@@ -119,6 +119,24 @@ public:
 	///////////////////////////////////////////////////////////
     void read(std::uint8_t* pBuffer, size_t bufferLength);
 
+    /// \brief Read raw data from the stream and adjust its
+    ///         byte endian.
+    ///
+    /// The bytes are swapped while they are copied from the
+    ///  stream's internal buffer. Large blocks that bypass
+    ///  the internal buffer are swapped in slices right after
+    ///  reading them.
+    ///
+    /// @param pBuffer      the destination buffer
+    /// @param bufferLength the number of bytes to read
+    /// @param wordLength   the size, in bytes, of the
+    ///                      elements stored in the stream
+    /// @param endianType   the byte ordering of the elements
+    ///                      in the stream
+    ///
+    ///////////////////////////////////////////////////////////
+    void read(std::uint8_t* pBuffer, size_t bufferLength, size_t wordLength, tByteOrdering endianType);
+
     size_t readSome(std::uint8_t* pBuffer, size_t bufferLength);
 
 	/// \brief Returns true if the last byte in the stream
@@ -128,7 +146,14 @@ public:
 	///          been read
 	///
 	///////////////////////////////////////////////////////////
-	bool endReached();
+    inline bool endReached()
+    {
+        IMEBRA_FUNCTION_START();
+
+        return (m_dataBufferCurrent == m_dataBufferEnd && fillDataBuffer() == 0);
+
+        IMEBRA_FUNCTION_END();
+    }
 
 	/// \brief Seek the stream's read position.
 	///
@@ -147,6 +172,38 @@ public:
 
     void seekForward(std::uint32_t newPosition);
 
+    /// \brief Returns true if the specified amount of bytes
+    ///         can be read from the current read position.
+    ///
+    /// The function probes the last byte of the requested
+    ///  range directly in the controlled stream: the read
+    ///  position and the internal buffer are not modified.
+    ///
+    /// @param length the number of bytes that should be
+    ///               available from the current position
+    /// @return true if at least length bytes are available
+    ///
+    ///////////////////////////////////////////////////////////
+    bool isAvailable(size_t length);
+
+    /// \brief Copy the bytes at the current read position
+    ///         into a buffer without consuming them.
+    ///
+    /// The read position is not modified and no exception
+    ///  is thrown when the end of the stream is reached:
+    ///  the function is used to probe the stream's format
+    ///  before parsing it.
+    ///
+    /// @param pBuffer      the buffer where the bytes are
+    ///                     copied
+    /// @param bufferLength the number of bytes to copy
+    /// @return the number of bytes copied into the buffer:
+    ///          less than bufferLength when the stream
+    ///          ends before
+    ///
+    ///////////////////////////////////////////////////////////
+    size_t peek(std::uint8_t* pBuffer, size_t bufferLength);
+
 	/// \brief Read the specified amount of bits from the
 	///         stream.
 	///
@@ -121,6 +121,22 @@ void streamWriter::write(const std::uint8_t* pBuffer, size_t bufferLength)
     IMEBRA_FUNCTION_END();
 }
 
+
+///////////////////////////////////////////////////////////
+//
+// Overwrite data already written
+//
+///////////////////////////////////////////////////////////
+void streamWriter::rewrite(size_t position, const std::uint8_t* pBuffer, size_t bufferLength)
+{
+    IMEBRA_FUNCTION_START();
+
+    flushDataBuffer();
+    m_pControlledStream->write(position + m_virtualStart, pBuffer, bufferLength);
+
+    IMEBRA_FUNCTION_END();
+}
+
 } // namespace implementation
 
 } // namespace imebra
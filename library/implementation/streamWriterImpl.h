@@ -95,6 +95,21 @@ public:
 	///////////////////////////////////////////////////////////
     void write(const std::uint8_t* pBuffer, size_t bufferLength);
 
+    /// \brief Overwrite data already written into the
+    ///         stream.
+    ///
+    /// The internal buffer is flushed before the data is
+    ///  overwritten. The current writing position is not
+    ///  changed.
+    ///
+    /// @param position  the position of the first byte to
+    ///                   overwrite
+    /// @param pBuffer   a pointer to the new data
+    /// @param bufferLength the number of bytes to overwrite
+    ///
+    ///////////////////////////////////////////////////////////
+    void rewrite(size_t position, const std::uint8_t* pBuffer, size_t bufferLength);
+
 	/// \brief Write the specified amount of bits to the
 	///         stream.
 	///
@@ -3648,6 +3648,8 @@ static const tagDescription_t m_tagsDescription[] =
         { 0x60001303, L"ROI Standard Deviation", "ROIStandardDeviation", tagVR_t::DS},
         { 0x60001500, L"Overlay Label", "OverlayLabel", tagVR_t::LO},
         { 0x60003000, L"Overlay Data", "OverlayData", tagVR_t::OB},
+        { 0x7FE00001, L"Extended Offset Table", "ExtendedOffsetTable", tagVR_t::OV},
+        { 0x7FE00002, L"Extended Offset Table Lengths", "ExtendedOffsetTableLengths", tagVR_t::OV},
         { 0x7FE00008, L"Float Pixel Data", "FloatPixelData", tagVR_t::OF},
         { 0x7FE00009, L"Double Float Pixel Data", "DoubleFloatPixelData", tagVR_t::OD},
         { 0x7FE00010, L"Pixel Data", "PixelData", tagVR_t::OB},
@@ -0,0 +1,224 @@
+/*
+Copyright 2005 - 2017 by Paolo Brandoli/Binarno s.p.
+
+Imebra is available for free under the GNU General Public License.
+
+The full text of the license is available in the file license.rst
+ in the project root folder.
+
+If you do not want to be bound by the GPL terms (such as the requirement
+ that your application must also be GPL), you may purchase a commercial
+ license for Imebra from the Imebra’s website (http://imebra.com).
+*/
+
+/*! \file threadPoolImpl.cpp
+    \brief Implementation of the class threadPool.
+
+*/
+
+#include "threadPoolImpl.h"
+#include "exceptionImpl.h"
+
+namespace imebra
+{
+
+namespace implementation
+{
+
+///////////////////////////////////////////////////////////
+//
+// Constructor
+//
+///////////////////////////////////////////////////////////
+threadPool::threadPool(size_t threadsNumber): m_bTerminate(false)
+{
+    IMEBRA_FUNCTION_START();
+
+    if(threadsNumber == 0)
+    {
+        threadsNumber = (size_t)std::thread::hardware_concurrency();
+        if(threadsNumber == 0)
+        {
+            threadsNumber = 1;
+        }
+    }
+
+    for(size_t createThreads(0); createThreads != threadsNumber; ++createThreads)
+    {
+        m_threads.push_back(std::thread(&threadPool::workerThread, this));
+    }
+
+    IMEBRA_FUNCTION_END();
+}
+
+
+///////////////////////////////////////////////////////////
+//
+// Destructor. Executes the pending tasks and joins the
+//  threads
+//
+///////////////////////////////////////////////////////////
+threadPool::~threadPool()
+{
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_bTerminate = true;
+    }
+    m_taskAvailable.notify_all();
+
+    for(std::vector<std::thread>::iterator scanThreads(m_threads.begin()), endThreads(m_threads.end()); scanThreads != endThreads; ++scanThreads)
+    {
+        scanThreads->join();
+    }
+}
+
+
+///////////////////////////////////////////////////////////
+//
+// Return the pool shared by the library
+//
+///////////////////////////////////////////////////////////
+threadPool& threadPool::getSharedThreadPool()
+{
+    static threadPool sharedThreadPool(0);
+    return sharedThreadPool;
+}
+
+
+///////////////////////////////////////////////////////////
+//
+// Return the number of threads
+//
+///////////////////////////////////////////////////////////
+size_t threadPool::getThreadsNumber() const
+{
+    return m_threads.size();
+}
+
+
+///////////////////////////////////////////////////////////
+//
+// Execute a task several times in parallel
+//
+///////////////////////////////////////////////////////////
+void threadPool::executeParallel(size_t count, const std::function<void(size_t)>& task)
+{
+    IMEBRA_FUNCTION_START();
+
+    if(count < 2 || m_threads.size() < 2)
+    {
+        for(size_t index(0); index != count; ++index)
+        {
+            task(index);
+        }
+        return;
+    }
+
+    // The state is shared with the helper tasks, which may
+    //  start after this function returned
+    ///////////////////////////////////////////////////////////
+    struct parallelState
+    {
+        std::mutex m_mutex;
+        std::condition_variable m_completedCondition;
+        size_t m_nextIndex;
+        size_t m_completed;
+        std::exception_ptr m_exception;
+    };
+    std::shared_ptr<parallelState> pState(std::make_shared<parallelState>());
+    pState->m_nextIndex = 0;
+    pState->m_completed = 0;
+
+    // Helper tasks don't call the function once all the
+    //  indexes have been claimed, so they can keep a
+    //  reference to it
+    ///////////////////////////////////////////////////////////
+    const std::function<void(size_t)>* pTask(&task);
+    std::function<void()> runTasks([pState, pTask, count]()
+    {
+        for(;;)
+        {
+            size_t index;
+            {
+                std::lock_guard<std::mutex> lock(pState->m_mutex);
+                if(pState->m_nextIndex == count)
+                {
+                    return;
+                }
+                index = pState->m_nextIndex++;
+            }
+
+            std::exception_ptr exception;
+            try
+            {
+                (*pTask)(index);
+            }
+            catch(...)
+            {
+                exception = std::current_exception();
+            }
+
+            std::lock_guard<std::mutex> lock(pState->m_mutex);
+            if(exception != 0 && pState->m_exception == 0)
+            {
+                pState->m_exception = exception;
+            }
+            if(++(pState->m_completed) == count)
+            {
+                pState->m_completedCondition.notify_all();
+            }
+        }
+    });
+
+    const size_t helpersNumber(count - 1 < m_threads.size() ? count - 1 : m_threads.size());
+    for(size_t scanHelpers(0); scanHelpers != helpersNumber; ++scanHelpers)
+    {
+        execute(runTasks);
+    }
+
+    runTasks();
+
+    std::unique_lock<std::mutex> lock(pState->m_mutex);
+    pState->m_completedCondition.wait(lock, [pState, count](){ return pState->m_completed == count; });
+    if(pState->m_exception != 0)
+    {
+        std::rethrow_exception(pState->m_exception);
+    }
+
+    IMEBRA_FUNCTION_END();
+}
+
+
+///////////////////////////////////////////////////////////
+//
+// Execute the queued tasks
+//
+///////////////////////////////////////////////////////////
+void threadPool::workerThread()
+{
+    for(;;)
+    {
+        std::function<void()> task;
+
+        {
+            std::unique_lock<std::mutex> lock(m_mutex);
+            m_taskAvailable.wait(lock, [this](){ return m_bTerminate || !m_tasks.empty(); });
+
+            if(m_tasks.empty())
+            {
+                return;
+            }
+
+            task = m_tasks.front();
+            m_tasks.pop_front();
+        }
+
+        // The exceptions are stored in the task's future
+        ///////////////////////////////////////////////////////////
+        task();
+    }
+}
+
+} // namespace implementation
+
+} // namespace imebra
@@ -0,0 +1,137 @@
+/*
+Copyright 2005 - 2017 by Paolo Brandoli/Binarno s.p.
+
+Imebra is available for free under the GNU General Public License.
+
+The full text of the license is available in the file license.rst
+ in the project root folder.
+
+If you do not want to be bound by the GPL terms (such as the requirement
+ that your application must also be GPL), you may purchase a commercial
+ license for Imebra from the Imebra’s website (http://imebra.com).
+*/
+
+/*! \file threadPoolImpl.h
+    \brief Declaration of the class threadPool.
+
+*/
+
+#if !defined(imebraThreadPool_5A1C7E34_8B2D_4F6A_9C0E_2D7B91F3A6C4__INCLUDED_)
+#define imebraThreadPool_5A1C7E34_8B2D_4F6A_9C0E_2D7B91F3A6C4__INCLUDED_
+
+#include <memory>
+#include <functional>
+#include <future>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <list>
+#include <vector>
+#include <type_traits>
+
+namespace imebra
+{
+
+namespace implementation
+{
+
+///////////////////////////////////////////////////////////
+///////////////////////////////////////////////////////////
+/// \brief A fixed set of worker threads that execute the
+///         tasks submitted by execute() in FIFO order.
+///
+/// The destructor executes all the pending tasks before
+///  joining the worker threads.
+///
+/// Exceptions thrown by a task are stored into the
+///  std::future returned by execute() and rethrown by
+///  std::future::get().
+///
+///////////////////////////////////////////////////////////
+///////////////////////////////////////////////////////////
+class threadPool
+{
+public:
+    /// \brief Constructor.
+    ///
+    /// @param threadsNumber the number of worker threads.
+    ///                      If zero then the number of
+    ///                      hardware threads is used
+    ///
+    ///////////////////////////////////////////////////////////
+    threadPool(size_t threadsNumber);
+
+    ~threadPool();
+
+    /// \brief Returns a pool shared by the library, with one
+    ///         thread per hardware thread.
+    ///
+    /// The tasks executed by the shared pool must not wait
+    ///  for other tasks queued in the same pool.
+    ///
+    ///////////////////////////////////////////////////////////
+    static threadPool& getSharedThreadPool();
+
+    /// \brief Returns the number of worker threads.
+    ///
+    ///////////////////////////////////////////////////////////
+    size_t getThreadsNumber() const;
+
+    /// \brief Queue a task for execution.
+    ///
+    /// @param task the function to execute
+    /// @return a future that will receive the value returned
+    ///         by the task or the exception thrown by it
+    ///
+    ///////////////////////////////////////////////////////////
+    template<typename task_t>
+    std::future<typename std::result_of<task_t()>::type> execute(task_t task)
+    {
+        typedef typename std::result_of<task_t()>::type result_t;
+
+        std::shared_ptr<std::packaged_task<result_t()> > pTask(std::make_shared<std::packaged_task<result_t()> >(task));
+        std::future<result_t> result(pTask->get_future());
+
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_tasks.push_back([pTask](){ (*pTask)(); });
+        }
+        m_taskAvailable.notify_one();
+
+        return result;
+    }
+
+    /// \brief Call task(0) ... task(count - 1) using the
+    ///         pool's threads and the calling thread, and
+    ///         return when all the calls have returned.
+    ///
+    /// The calling thread executes the calls not yet started
+    ///  by the pool's threads and then waits only for the
+    ///  calls already running, so executeParallel() can be
+    ///  used also by tasks executed by the pool.
+    ///
+    /// The first exception thrown by a call is rethrown
+    ///  after all the calls have returned.
+    ///
+    /// @param count the number of calls
+    /// @param task  the function to call
+    ///
+    ///////////////////////////////////////////////////////////
+    void executeParallel(size_t count, const std::function<void(size_t)>& task);
+
+private:
+    void workerThread();
+
+    std::mutex m_mutex;
+    std::condition_variable m_taskAvailable;
+    std::list<std::function<void()> > m_tasks;
+    bool m_bTerminate;
+
+    std::vector<std::thread> m_threads;
+};
+
+} // namespace implementation
+
+} // namespace imebra
+
+#endif // !defined(imebraThreadPool_5A1C7E34_8B2D_4F6A_9C0E_2D7B91F3A6C4__INCLUDED_)
@@ -0,0 +1,112 @@
+/*
+Copyright 2005 - 2017 by Paolo Brandoli/Binarno s.p.
+
+Imebra is available for free under the GNU General Public License.
+
+The full text of the license is available in the file license.rst
+ in the project root folder.
+
+If you do not want to be bound by the GPL terms (such as the requirement
+ that your application must also be GPL), you may purchase a commercial
+ license for Imebra from the Imebra’s website (http://imebra.com).
+*/
+
+/*! \file threadRegistryImpl.h
+    \brief Declaration of the helpers that keep a process wide
+            registry and one object per thread registered in it.
+
+    Used by the statistics, the tracing and the charset
+     conversion code.
+
+*/
+
+#if !defined(imebraThreadRegistry_8C2E5A17_3F4B_4D9E_A6C1_5B7D02E9F3A4__INCLUDED_)
+#define imebraThreadRegistry_8C2E5A17_3F4B_4D9E_A6C1_5B7D02E9F3A4__INCLUDED_
+
+#include <memory>
+
+#ifdef __APPLE__
+#include <pthread.h>
+#endif
+
+namespace imebra
+{
+
+namespace implementation
+{
+
+///////////////////////////////////////////////////////////
+/// \brief Return the process wide instance of a registry.
+///
+/// The per-thread objects returned by getThreadObject()
+///  should keep the shared pointer returned by this
+///  function: the threads may terminate after the static
+///  objects have been destroyed, and the reference keeps
+///  the registry alive until the last thread object has
+///  unregistered itself.
+///
+/// \tparam registry_t the registry type. Must be default
+///                    constructible
+/// \return the process wide registry
+///
+///////////////////////////////////////////////////////////
+template <class registry_t>
+std::shared_ptr<registry_t> getSharedRegistry()
+{
+    static std::shared_ptr<registry_t> pRegistry(std::make_shared<registry_t>());
+    return pRegistry;
+}
+
+
+///////////////////////////////////////////////////////////
+/// \brief Return the instance of threadObject_t owned
+///         by the calling thread, allocating it on the
+///         first call.
+///
+/// The object is deleted when the thread terminates.
+///
+/// \tparam threadObject_t the object type. Must be
+///                        default constructible
+/// \return the object owned by the calling thread
+///
+///////////////////////////////////////////////////////////
+template <class threadObject_t>
+threadObject_t& getThreadObject()
+{
+#ifdef __APPLE__
+    // thread_local is not available: use the pthread keys
+    ///////////////////////////////////////////////////////////
+    struct deleter
+    {
+        static void deleteObject(void* pObject)
+        {
+            delete (threadObject_t*)pObject;
+        }
+    };
+
+    static pthread_key_t key;
+    static const int keyCreated(::pthread_key_create(&key, &deleter::deleteObject));
+    (void)keyCreated;
+
+    threadObject_t* pObject = (threadObject_t*)pthread_getspecific(key);
+    if(pObject == 0)
+    {
+        pObject = new threadObject_t;
+        pthread_setspecific(key, pObject);
+    }
+    return *pObject;
+#else
+    thread_local std::unique_ptr<threadObject_t> pObject;
+    if(pObject.get() == 0)
+    {
+        pObject.reset(new threadObject_t);
+    }
+    return *(pObject.get());
+#endif
+}
+
+} // namespace implementation
+
+} // namespace imebra
+
+#endif // !defined(imebraThreadRegistry_8C2E5A17_3F4B_4D9E_A6C1_5B7D02E9F3A4__INCLUDED_)
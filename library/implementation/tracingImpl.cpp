@@ -0,0 +1,362 @@
+/*
+Copyright 2005 - 2017 by Paolo Brandoli/Binarno s.p.
+
+Imebra is available for free under the GNU General Public License.
+
+The full text of the license is available in the file license.rst
+ in the project root folder.
+
+If you do not want to be bound by the GPL terms (such as the requirement
+ that your application must also be GPL), you may purchase a commercial
+ license for Imebra from the Imebra’s website (http://imebra.com).
+*/
+
+/*! \file tracingImpl.cpp
+    \brief Implementation of the trace spans.
+
+*/
+
+#include "tracingImpl.h"
+#include "numericStringImpl.h"
+#include "exceptionImpl.h"
+#include "threadRegistryImpl.h"
+#include <vector>
+#include <algorithm>
+
+namespace imebra
+{
+
+namespace implementation
+{
+
+std::atomic<bool> tracing::m_bEnabled(false);
+
+
+///////////////////////////////////////////////////////////
+//
+// Enable or disable the tracing
+//
+///////////////////////////////////////////////////////////
+void tracing::setEnabled(bool bEnabled)
+{
+    m_bEnabled.store(bEnabled, std::memory_order_relaxed);
+}
+
+
+///////////////////////////////////////////////////////////
+//
+// Record a span
+//
+///////////////////////////////////////////////////////////
+void tracing::addSpan(const char* name, std::uint64_t startTime, std::uint64_t endTime)
+{
+    traceBuffer& buffer(getThreadBuffer());
+
+    // Only this thread writes in the buffer
+    ///////////////////////////////////////////////////////////
+    const std::uint64_t writeIndex(buffer.m_writeIndex.load(std::memory_order_relaxed));
+    buffer.m_writingIndex.store(writeIndex + 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+
+    traceEvent& event(buffer.m_events[writeIndex % IMEBRA_TRACE_BUFFER_EVENTS]);
+    event.m_name.store(name, std::memory_order_relaxed);
+    event.m_startTime.store(startTime, std::memory_order_relaxed);
+    event.m_endTime.store(endTime, std::memory_order_relaxed);
+
+    buffer.m_writeIndex.store(writeIndex + 1, std::memory_order_release);
+}
+
+
+///////////////////////////////////////////////////////////
+//
+// Discard the recorded spans
+//
+///////////////////////////////////////////////////////////
+void tracing::clear()
+{
+    IMEBRA_FUNCTION_START();
+
+    getSharedRegistry<registry>()->clear();
+
+    IMEBRA_FUNCTION_END();
+}
+
+
+///////////////////////////////////////////////////////////
+//
+// Export the recorded spans
+//
+///////////////////////////////////////////////////////////
+std::string tracing::getChromeTrace()
+{
+    IMEBRA_FUNCTION_START();
+
+    return getSharedRegistry<registry>()->getChromeTrace();
+
+    IMEBRA_FUNCTION_END();
+}
+
+
+///////////////////////////////////////////////////////////
+//
+// Buffer constructor
+//
+///////////////////////////////////////////////////////////
+tracing::traceBuffer::traceBuffer(std::uint32_t threadId):
+    m_threadId(threadId), m_writingIndex(0), m_writeIndex(0), m_clearIndex(0)
+{
+}
+
+
+///////////////////////////////////////////////////////////
+//
+// Registry constructor
+//
+///////////////////////////////////////////////////////////
+tracing::registry::registry(): m_nextThreadId(1), m_originTime(tracing::now())
+{
+}
+
+
+///////////////////////////////////////////////////////////
+//
+// Allocate the buffer for a thread
+//
+///////////////////////////////////////////////////////////
+std::shared_ptr<tracing::traceBuffer> tracing::registry::addThread()
+{
+    IMEBRA_FUNCTION_START();
+
+    std::lock_guard<std::mutex> lock(m_mutex);
+
+    std::shared_ptr<traceBuffer> pBuffer(std::make_shared<traceBuffer>(m_nextThreadId++));
+    m_buffers.push_back(pBuffer);
+    return pBuffer;
+
+    IMEBRA_FUNCTION_END();
+}
+
+
+///////////////////////////////////////////////////////////
+//
+// Copy the spans of a terminated thread, then release its
+//  buffer
+//
+///////////////////////////////////////////////////////////
+void tracing::registry::removeThread(const std::shared_ptr<traceBuffer>& pBuffer)
+{
+    IMEBRA_FUNCTION_START();
+
+    std::lock_guard<std::mutex> lock(m_mutex);
+
+    m_buffers.remove(pBuffer);
+
+    if(pBuffer->m_writeIndex.load(std::memory_order_acquire) != pBuffer->m_clearIndex.load(std::memory_order_relaxed))
+    {
+        m_terminatedThreads.push_back(terminatedThread());
+        m_terminatedThreads.back().m_threadId = pBuffer->m_threadId;
+        copyEvents(*pBuffer, &(m_terminatedThreads.back().m_events));
+    }
+
+    IMEBRA_FUNCTION_END();
+}
+
+
+///////////////////////////////////////////////////////////
+//
+// Discard the recorded spans and the spans of the
+//  terminated threads
+//
+///////////////////////////////////////////////////////////
+void tracing::registry::clear()
+{
+    IMEBRA_FUNCTION_START();
+
+    std::lock_guard<std::mutex> lock(m_mutex);
+
+    m_terminatedThreads.clear();
+
+    // The owner threads may still be writing: the spans
+    //  before the current write position will be ignored
+    ///////////////////////////////////////////////////////////
+    for(std::list<std::shared_ptr<traceBuffer> >::iterator scanBuffers(m_buffers.begin()), endBuffers(m_buffers.end()); scanBuffers != endBuffers; ++scanBuffers)
+    {
+        (*scanBuffers)->m_clearIndex.store((*scanBuffers)->m_writeIndex.load(std::memory_order_acquire), std::memory_order_relaxed);
+    }
+
+    IMEBRA_FUNCTION_END();
+}
+
+
+///////////////////////////////////////////////////////////
+//
+// Copy the spans published in a buffer
+//
+///////////////////////////////////////////////////////////
+void tracing::registry::copyEvents(const traceBuffer& buffer, std::vector<copiedEvent>* pEvents) const
+{
+    IMEBRA_FUNCTION_START();
+
+    // Copy the events published by the owner thread
+    ///////////////////////////////////////////////////////////
+    const std::uint64_t endIndex(buffer.m_writeIndex.load(std::memory_order_acquire));
+    std::uint64_t beginIndex(buffer.m_clearIndex.load(std::memory_order_relaxed));
+    if(endIndex - beginIndex > IMEBRA_TRACE_BUFFER_EVENTS)
+    {
+        beginIndex = endIndex - IMEBRA_TRACE_BUFFER_EVENTS;
+    }
+
+    pEvents->clear();
+    pEvents->reserve((size_t)(endIndex - beginIndex));
+    for(std::uint64_t scanEvents(beginIndex); scanEvents != endIndex; ++scanEvents)
+    {
+        const traceEvent& event(buffer.m_events[scanEvents % IMEBRA_TRACE_BUFFER_EVENTS]);
+        copiedEvent copy;
+        copy.m_name = event.m_name.load(std::memory_order_relaxed);
+        copy.m_startTime = event.m_startTime.load(std::memory_order_relaxed);
+        copy.m_endTime = event.m_endTime.load(std::memory_order_relaxed);
+        pEvents->push_back(copy);
+    }
+
+    // Discard the events that the owner thread overwrote
+    //  while they were being copied
+    ///////////////////////////////////////////////////////////
+    std::atomic_thread_fence(std::memory_order_acquire);
+    const std::uint64_t overwrittenIndex(buffer.m_writingIndex.load(std::memory_order_relaxed));
+    if(overwrittenIndex - beginIndex > IMEBRA_TRACE_BUFFER_EVENTS)
+    {
+        const size_t overwrittenEvents((size_t)(overwrittenIndex - beginIndex - IMEBRA_TRACE_BUFFER_EVENTS));
+        pEvents->erase(pEvents->begin(), pEvents->begin() + (std::ptrdiff_t)std::min(overwrittenEvents, pEvents->size()));
+    }
+
+    IMEBRA_FUNCTION_END();
+}
+
+
+///////////////////////////////////////////////////////////
+//
+// Append the spans of a thread in the trace-event format
+//
+///////////////////////////////////////////////////////////
+void tracing::registry::appendEvents(std::string* pTrace, bool* pbFirstEvent, std::uint32_t threadId, const std::vector<copiedEvent>& events) const
+{
+    IMEBRA_FUNCTION_START();
+
+    for(std::vector<copiedEvent>::const_iterator scanEvents(events.begin()), endEvents(events.end()); scanEvents != endEvents; ++scanEvents)
+    {
+        const copiedEvent& event(*scanEvents);
+        const std::uint64_t startTime(event.m_startTime > m_originTime ? event.m_startTime - m_originTime : 0);
+        const std::uint64_t duration(event.m_endTime > event.m_startTime ? event.m_endTime - event.m_startTime : 0);
+
+        if(!*pbFirstEvent)
+        {
+            *pTrace += ",";
+        }
+        *pbFirstEvent = false;
+
+        // The names are literals defined by Imebra and don't
+        //  contain chars that must be escaped
+        ///////////////////////////////////////////////////////////
+        *pTrace += "\n{\"name\":\"";
+        *pTrace += event.m_name;
+        *pTrace += "\",\"cat\":\"imebra\",\"ph\":\"X\",\"pid\":1,\"tid\":";
+        *pTrace += unsignedLongToString(threadId);
+
+        // Timestamps are in microseconds
+        ///////////////////////////////////////////////////////////
+        *pTrace += ",\"ts\":";
+        *pTrace += unsignedLongToString(startTime / 1000u);
+        *pTrace += ".";
+        appendZeroPadded(pTrace, (std::uint32_t)(startTime % 1000u), 3);
+        *pTrace += ",\"dur\":";
+        *pTrace += unsignedLongToString(duration / 1000u);
+        *pTrace += ".";
+        appendZeroPadded(pTrace, (std::uint32_t)(duration % 1000u), 3);
+        *pTrace += "}";
+    }
+
+    IMEBRA_FUNCTION_END();
+}
+
+
+///////////////////////////////////////////////////////////
+//
+// Write the spans of all the threads in the trace-event
+//  format
+//
+///////////////////////////////////////////////////////////
+std::string tracing::registry::getChromeTrace()
+{
+    IMEBRA_FUNCTION_START();
+
+    std::string trace("{\"traceEvents\":[");
+    bool bFirstEvent(true);
+
+    std::vector<copiedEvent> events;
+
+    std::lock_guard<std::mutex> lock(m_mutex);
+
+    for(std::list<terminatedThread>::const_iterator scanThreads(m_terminatedThreads.begin()), endThreads(m_terminatedThreads.end()); scanThreads != endThreads; ++scanThreads)
+    {
+        appendEvents(&trace, &bFirstEvent, scanThreads->m_threadId, scanThreads->m_events);
+    }
+
+    for(std::list<std::shared_ptr<traceBuffer> >::const_iterator scanBuffers(m_buffers.begin()), endBuffers(m_buffers.end()); scanBuffers != endBuffers; ++scanBuffers)
+    {
+        copyEvents(**scanBuffers, &events);
+        appendEvents(&trace, &bFirstEvent, (*scanBuffers)->m_threadId, events);
+    }
+
+    trace += "\n],\"displayTimeUnit\":\"ms\"}\n";
+
+    return trace;
+
+    IMEBRA_FUNCTION_END();
+}
+
+
+///////////////////////////////////////////////////////////
+//
+// Thread buffer constructor
+//
+///////////////////////////////////////////////////////////
+tracing::threadBuffer::threadBuffer():
+    m_pRegistry(getSharedRegistry<registry>()),
+    m_pBuffer(m_pRegistry->addThread())
+{
+}
+
+
+///////////////////////////////////////////////////////////
+//
+// Thread buffer destructor
+//
+///////////////////////////////////////////////////////////
+tracing::threadBuffer::~threadBuffer()
+{
+    // The registry keeps the spans until the next clear().
+    // The spans are lost if they cannot be copied
+    ///////////////////////////////////////////////////////////
+    try
+    {
+        m_pRegistry->removeThread(m_pBuffer);
+    }
+    catch(...)
+    {
+    }
+}
+
+
+///////////////////////////////////////////////////////////
+//
+// Return the buffer of the calling thread
+//
+///////////////////////////////////////////////////////////
+tracing::traceBuffer& tracing::getThreadBuffer()
+{
+    return *(getThreadObject<threadBuffer>().m_pBuffer);
+}
+
+} // namespace implementation
+
+} // namespace imebra
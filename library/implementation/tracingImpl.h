@@ -0,0 +1,257 @@
+/*
+Copyright 2005 - 2017 by Paolo Brandoli/Binarno s.p.
+
+Imebra is available for free under the GNU General Public License.
+
+The full text of the license is available in the file license.rst
+ in the project root folder.
+
+If you do not want to be bound by the GPL terms (such as the requirement
+ that your application must also be GPL), you may purchase a commercial
+ license for Imebra from the Imebra’s website (http://imebra.com).
+*/
+
+/*! \file tracingImpl.h
+    \brief Declaration of the trace spans.
+
+    The spans are declared with the macro IMEBRA_TRACE_SPAN
+     and are recorded only while the tracing is enabled.
+
+*/
+
+#if !defined(imebraTracing_B1D63F0A_27C4_4E9D_8A15_C3E0F47D92B6__INCLUDED_)
+#define imebraTracing_B1D63F0A_27C4_4E9D_8A15_C3E0F47D92B6__INCLUDED_
+
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <mutex>
+#include <list>
+#include <string>
+#include <vector>
+#include <cstdint>
+
+#if(!defined IMEBRA_TRACE_BUFFER_EVENTS)
+    #define IMEBRA_TRACE_BUFFER_EVENTS 16384
+#endif
+
+namespace imebra
+{
+
+namespace implementation
+{
+
+///////////////////////////////////////////////////////////
+///////////////////////////////////////////////////////////
+/// \brief Collects the trace spans of all the threads.
+///
+/// Each thread records its spans in its own ring buffer,
+///  without locking: when the buffer is full the oldest
+///  spans are overwritten.
+///
+/// The buffers are allocated when a thread records its
+///  first span and released when the thread terminates:
+///  the spans of the terminated threads are kept until
+///  clear() is called.
+///
+///////////////////////////////////////////////////////////
+///////////////////////////////////////////////////////////
+class tracing
+{
+public:
+    /// \brief Returns true if the spans are being recorded.
+    ///
+    ///////////////////////////////////////////////////////////
+    static bool isEnabled()
+    {
+        return m_bEnabled.load(std::memory_order_relaxed);
+    }
+
+    /// \brief Enable or disable the recording of the spans.
+    ///
+    ///////////////////////////////////////////////////////////
+    static void setEnabled(bool bEnabled);
+
+    /// \brief Returns the current time, in nanoseconds.
+    ///
+    ///////////////////////////////////////////////////////////
+    static std::uint64_t now()
+    {
+        return (std::uint64_t)std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+    }
+
+    /// \brief Record a span in the calling thread's buffer.
+    ///
+    /// @param name      the span's name. Must be a string
+    ///                   literal
+    /// @param startTime the time when the span started, in
+    ///                   nanoseconds
+    /// @param endTime   the time when the span ended, in
+    ///                   nanoseconds
+    ///
+    ///////////////////////////////////////////////////////////
+    static void addSpan(const char* name, std::uint64_t startTime, std::uint64_t endTime);
+
+    /// \brief Discard all the recorded spans.
+    ///
+    ///////////////////////////////////////////////////////////
+    static void clear();
+
+    /// \brief Return the recorded spans in the Chrome
+    ///         trace-event JSON format.
+    ///
+    ///////////////////////////////////////////////////////////
+    static std::string getChromeTrace();
+
+private:
+    struct traceEvent
+    {
+        std::atomic<const char*> m_name;
+        std::atomic<std::uint64_t> m_startTime;
+        std::atomic<std::uint64_t> m_endTime;
+    };
+
+    struct copiedEvent
+    {
+        const char* m_name;
+        std::uint64_t m_startTime;
+        std::uint64_t m_endTime;
+    };
+
+    /// \brief Ring buffer written by a single thread.
+    ///
+    /// The owner thread announces each event by incrementing
+    ///  m_writingIndex and publishes it by incrementing
+    ///  m_writeIndex; the readers discard the events that
+    ///  are overwritten while being copied.
+    ///
+    ///////////////////////////////////////////////////////////
+    struct traceBuffer
+    {
+        traceBuffer(std::uint32_t threadId);
+
+        const std::uint32_t m_threadId;
+        std::atomic<std::uint64_t> m_writingIndex;
+        std::atomic<std::uint64_t> m_writeIndex;
+        std::atomic<std::uint64_t> m_clearIndex;
+        traceEvent m_events[IMEBRA_TRACE_BUFFER_EVENTS];
+    };
+
+    /// \brief Spans copied from the buffer of a terminated
+    ///         thread.
+    ///
+    ///////////////////////////////////////////////////////////
+    struct terminatedThread
+    {
+        std::uint32_t m_threadId;
+        std::vector<copiedEvent> m_events;
+    };
+
+    /// \brief Keeps track of the buffers of all the
+    ///         threads.
+    ///
+    ///////////////////////////////////////////////////////////
+    class registry
+    {
+    public:
+        registry();
+
+        std::shared_ptr<traceBuffer> addThread();
+
+        /// \brief Copy the spans of a terminated thread and
+        ///         release its buffer.
+        ///
+        ///////////////////////////////////////////////////////////
+        void removeThread(const std::shared_ptr<traceBuffer>& pBuffer);
+
+        void clear();
+
+        std::string getChromeTrace();
+
+    private:
+        void copyEvents(const traceBuffer& buffer, std::vector<copiedEvent>* pEvents) const;
+
+        void appendEvents(std::string* pTrace, bool* pbFirstEvent, std::uint32_t threadId, const std::vector<copiedEvent>& events) const;
+
+        std::mutex m_mutex;
+        std::list<std::shared_ptr<traceBuffer> > m_buffers;
+        std::list<terminatedThread> m_terminatedThreads;
+        std::uint32_t m_nextThreadId;
+        const std::uint64_t m_originTime;
+    };
+
+    /// \brief Owns a thread's reference to its buffer and
+    ///         removes the buffer from the registry when the
+    ///         thread ends.
+    ///
+    ///////////////////////////////////////////////////////////
+    class threadBuffer
+    {
+    public:
+        threadBuffer();
+        ~threadBuffer();
+
+        const std::shared_ptr<registry> m_pRegistry;
+        const std::shared_ptr<traceBuffer> m_pBuffer;
+    };
+
+    static traceBuffer& getThreadBuffer();
+
+    static std::atomic<bool> m_bEnabled;
+};
+
+
+///////////////////////////////////////////////////////////
+///////////////////////////////////////////////////////////
+/// \brief Records a span that lasts from its construction
+///         to its destruction.
+///
+/// When the tracing is disabled the span costs a single
+///  test.
+///
+///////////////////////////////////////////////////////////
+///////////////////////////////////////////////////////////
+class traceSpan
+{
+public:
+    traceSpan(const char* name):
+        m_name(tracing::isEnabled() ? name : 0), m_startTime(m_name == 0 ? 0 : tracing::now())
+    {
+    }
+
+    ~traceSpan()
+    {
+        if(m_name != 0)
+        {
+            // Losing a span is better than terminating the
+            //  application when the buffer cannot be allocated
+            ///////////////////////////////////////////////////////////
+            try
+            {
+                tracing::addSpan(m_name, m_startTime, tracing::now());
+            }
+            catch(...)
+            {
+            }
+        }
+    }
+
+private:
+    const char* const m_name;
+    const std::uint64_t m_startTime;
+};
+
+} // namespace implementation
+
+} // namespace imebra
+
+
+/// \brief Trace the rest of the enclosing scope.
+///
+/// @param name the span's name. Must be a string literal
+///
+///////////////////////////////////////////////////////////
+#define IMEBRA_TRACE_SPAN(name) \
+    ::imebra::implementation::traceSpan imebraTraceSpan(name)
+
+#endif // !defined(imebraTracing_B1D63F0A_27C4_4E9D_8A15_C3E0F47D92B6__INCLUDED_)
@@ -17,6 +17,7 @@ If you do not want to be bound by the GPL terms (such as the requirement
 */
 
 #include "exceptionImpl.h"
+#include "statisticsImpl.h"
 #include "transformImpl.h"
 #include "imageImpl.h"
 #include "transformHighBitImpl.h"
@@ -80,6 +81,10 @@ void transform::runTransform(
         IMEBRA_THROW(TransformInvalidAreaError, "The input and/or output areas are invalid");
     }
 
+    IMEBRA_STATISTICS_TIMER(transformTimer, transformTime);
+    IMEBRA_STATISTICS_ADD(transformInvocations, 1);
+    IMEBRA_STATISTICS_ADD(transformedPixels, (size_t)inputWidth * (size_t)inputHeight);
+
     std::shared_ptr<handlers::readingDataHandlerNumericBase> inputHandler(inputImage->getReadingDataHandler());
 	std::shared_ptr<palette> inputPalette(inputImage->getPalette());
     std::string inputColorSpace(inputImage->getColorSpace());
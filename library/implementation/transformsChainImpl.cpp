@@ -17,6 +17,7 @@ If you do not want to be bound by the GPL terms (such as the requirement
 */
 
 #include "exceptionImpl.h"
+#include "tracingImpl.h"
 #include "transformsChainImpl.h"
 #include "imageImpl.h"
 #include "dataSetImpl.h"
@@ -77,6 +78,8 @@ void transformsChain::runTransformHandlers(
 {
     IMEBRA_FUNCTION_START();
 
+    IMEBRA_TRACE_SPAN("transformsChain::runTransformHandlers");
+
     if(isEmpty())
     {
         std::shared_ptr<transformHighBit> highBit(std::make_shared<transformHighBit>());
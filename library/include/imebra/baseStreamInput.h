@@ -60,6 +60,7 @@ class IMEBRA_API BaseStreamInput
 	friend class StreamReader;
     friend class FileStreamInput;
     friend class MemoryStreamInput;
+    friend class BatchLoader;
 
 private:
     /// \brief Construct a BaseStreamInput object from an implementation object.
@@ -0,0 +1,170 @@
+/*
+Copyright 2005 - 2017 by Paolo Brandoli/Binarno s.p.
+
+Imebra is available for free under the GNU General Public License.
+
+The full text of the license is available in the file license.rst
+ in the project root folder.
+
+If you do not want to be bound by the GPL terms (such as the requirement
+ that your application must also be GPL), you may purchase a commercial
+ license for Imebra from the Imebra’s website (http://imebra.com).
+*/
+
+/*! \file batchLoader.h
+    \brief Declaration of the class BatchLoader.
+
+*/
+
+#if !defined(imebraBatchLoader__INCLUDED_)
+#define imebraBatchLoader__INCLUDED_
+
+#include <string>
+#include <memory>
+#include <limits>
+#include <cstdint>
+#include "definitions.h"
+
+#ifndef SWIG
+
+namespace imebra
+{
+namespace implementation
+{
+class batchLoader;
+}
+}
+
+#endif
+
+namespace imebra
+{
+
+class BaseStreamInput;
+class DataSet;
+
+///
+/// \brief Loads several DICOM files or streams concurrently.
+///
+/// Each call to load() queues a job and returns immediately with the job's
+/// id. A dedicated I/O thread reads the files into memory ahead of the
+/// parsing threads (at most prefetchFiles files are kept in memory waiting
+/// to be parsed), while a pool of threads parses them.
+///
+/// The loaded DataSet is retrieved with getDataSet(), which waits for the
+/// job's completion and rethrows the exception that caused the job to fail,
+/// if any.
+///
+/// The destructor waits for the completion of all the pending jobs.
+///
+///////////////////////////////////////////////////////////////////////////////
+class IMEBRA_API BatchLoader
+{
+    BatchLoader(const BatchLoader&) = delete;
+    BatchLoader& operator=(const BatchLoader&) = delete;
+
+public:
+    /// \brief Constructor.
+    ///
+    /// \param threadsNumber     the number of parsing threads. 0 means one
+    ///                          thread per hardware thread
+    /// \param prefetchFiles     the maximum number of files read in memory
+    ///                          and waiting to be parsed. 0 means twice the
+    ///                          number of parsing threads
+    /// \param maxSizeBufferLoad the maximum size of the tags that are loaded
+    ///                          immediately. Tags larger than
+    ///                          maxSizeBufferLoad are left on the input
+    ///                          stream and loaded only when a
+    ///                          ReadingDataHandler or a WritingDataHandler
+    ///                          reference them
+    ///
+    ///////////////////////////////////////////////////////////////////////////////
+    BatchLoader(std::uint32_t threadsNumber, std::uint32_t prefetchFiles, size_t maxSizeBufferLoad = std::numeric_limits<size_t>::max());
+
+    /// \brief Destructor. Waits for the completion of all the pending jobs.
+    ///
+    ///////////////////////////////////////////////////////////////////////////////
+    virtual ~BatchLoader();
+
+    /// \brief Queue the loading of a file.
+    ///
+    /// \param fileName the Unicode name of the file to load
+    /// \return the job's id
+    ///
+    ///////////////////////////////////////////////////////////////////////////////
+#ifndef SWIG // Use UTF8 strings only with SWIG
+    size_t load(const std::wstring& fileName);
+#endif
+
+    /// \brief Queue the loading of a file.
+    ///
+    /// \param fileName the Utf8 name of the file to load
+    /// \return the job's id
+    ///
+    ///////////////////////////////////////////////////////////////////////////////
+    size_t load(const std::string& fileName);
+
+    /// \brief Queue the loading of a stream.
+    ///
+    /// The stream is parsed directly by one of the parsing threads, without
+    /// prefetching.
+    ///
+    /// \param stream the stream to load
+    /// \return the job's id
+    ///
+    ///////////////////////////////////////////////////////////////////////////////
+    size_t load(const BaseStreamInput& stream);
+
+    /// \brief Returns true if the job has been completed (successfully or
+    ///        not).
+    ///
+    /// \param jobId the id returned by load()
+    /// \return true if the job has been completed
+    ///
+    ///////////////////////////////////////////////////////////////////////////////
+    bool isReady(size_t jobId);
+
+    /// \brief Waits for the job completion and returns the loaded DataSet.
+    ///
+    /// If the job failed then the exception that caused the failure is
+    /// rethrown.
+    ///
+    /// The job is then removed from the loader: the DataSet of each job can
+    /// be retrieved only once, and isReady(), getReadTime() and
+    /// getParseTime() throw BatchLoaderUnknownJobError for the job.
+    ///
+    /// \param jobId the id returned by load()
+    /// \return the loaded DataSet
+    ///
+    ///////////////////////////////////////////////////////////////////////////////
+    DataSet* getDataSet(size_t jobId);
+
+    /// \brief Waits for the job completion and returns the time spent reading
+    ///        the file into memory, in microseconds.
+    ///
+    /// Returns 0 for the jobs that load a BaseStreamInput.
+    ///
+    /// \param jobId the id returned by load()
+    /// \return the reading time in microseconds
+    ///
+    ///////////////////////////////////////////////////////////////////////////////
+    std::uint64_t getReadTime(size_t jobId);
+
+    /// \brief Waits for the job completion and returns the time spent parsing
+    ///        the file or stream, in microseconds.
+    ///
+    /// \param jobId the id returned by load()
+    /// \return the parsing time in microseconds
+    ///
+    ///////////////////////////////////////////////////////////////////////////////
+    std::uint64_t getParseTime(size_t jobId);
+
+#ifndef SWIG
+protected:
+    std::shared_ptr<implementation::batchLoader> m_pBatchLoader;
+#endif
+};
+
+}
+
+#endif // !defined(imebraBatchLoader__INCLUDED_)
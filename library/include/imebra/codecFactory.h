@@ -146,6 +146,26 @@ public:
     ///////////////////////////////////////////////////////////////////////////////
     static void setMaximumImageSize(const std::uint32_t maximumWidth, const std::uint32_t maximumHeight);
 
+    /// \brief Set the restart interval used by the jpeg encoder.
+    ///
+    /// When the restart interval is not zero then the jpeg encoder splits
+    ///  each scan into restart intervals made of the specified number of MCU
+    ///  rows, encodes the intervals concurrently and separates them with
+    ///  RST markers.
+    ///
+    /// The number of rows is reduced when an interval would contain more
+    ///  than 65535 MCUs. Lossless scans with subsampled channels are never
+    ///  split.
+    ///
+    /// By default the restart interval is 0 (no restart intervals).
+    ///
+    /// \param mcuRows           the number of MCU rows in each restart
+    ///                          interval, or 0 to disable the restart
+    ///                          intervals
+    ///
+    ///////////////////////////////////////////////////////////////////////////////
+    static void setJpegRestartInterval(const std::uint32_t mcuRows);
+
 };
 
 }
@@ -119,6 +119,8 @@ class IMEBRA_API DataSet
     friend class VOILUT;
     friend class CodecFactory;
     friend class Tag;
+    friend class BatchLoader;
+    friend class MultiFrameWriter;
 
 private:
     DataSet(std::shared_ptr<imebra::implementation::dataSet> pDataSet);
@@ -237,6 +239,23 @@ public:
     ///////////////////////////////////////////////////////////////////////////////
     Image* getImage(size_t frameNumber);
 
+#ifndef SWIG
+    /// \brief Retrieve several consecutive images from the dataset.
+    ///
+    /// The images are decoded concurrently by a pool of threads shared by the
+    /// library and are returned in order.
+    ///
+    /// Throws DataSetImageDoesntExistError if one of the requested frames does
+    /// not exist.
+    ///
+    /// \param firstFrame  the first frame to retrieve (the first frame is 0)
+    /// \param framesCount the number of frames to retrieve
+    /// \return the decompressed images, in frame order
+    ///
+    ///////////////////////////////////////////////////////////////////////////////
+    std::vector<std::unique_ptr<Image> > getImages(size_t firstFrame, size_t framesCount);
+#endif
+
     /// \brief Retrieve an image from the dataset and if necessary process it with
     ///        ModalityVOILUT before returning it.
     ///
@@ -254,6 +273,74 @@ public:
     ///////////////////////////////////////////////////////////////////////////////
     Image* getImageApplyModalityTransform(size_t frameNumber);
 
+    /// \brief Enable the decoded frames cache.
+    ///
+    /// Once the cache is enabled, getImage() keeps the decoded frames in memory
+    ///  and returns them when they are requested again; the frames that follow
+    ///  the requested one in the playback direction are decoded in advance by
+    ///  a pool of threads shared by the library.
+    ///
+    /// The least recently used frames are discarded when the memory used by
+    ///  the cache exceeds memoryBudget.
+    ///
+    /// The images returned while the cache is enabled are shared with the cache
+    ///  and must not be modified.
+    ///
+    /// The cache is emptied when the pixel data or the tags in the group 0x0028
+    ///  are modified.
+    ///
+    /// \param memoryBudget    the maximum memory, in bytes, used by the decoded
+    ///                         frames
+    /// \param readAheadFrames the number of frames to decode in advance
+    ///
+    ///////////////////////////////////////////////////////////////////////////////
+    void enableFramesCache(size_t memoryBudget, size_t readAheadFrames);
+
+    /// \brief Disable the decoded frames cache and release the cached frames.
+    ///
+    ///////////////////////////////////////////////////////////////////////////////
+    void disableFramesCache();
+
+    /// \brief Return the hits, misses and decoding times collected by the
+    ///        decoded frames cache.
+    ///
+    /// All the values are zero if the cache is not enabled.
+    ///
+    /// \return the decoded frames cache statistics
+    ///
+    ///////////////////////////////////////////////////////////////////////////////
+    FramesCacheStatistics getFramesCacheStatistics() const;
+
+    /// \brief Reset the hits, misses and decoding times collected by the decoded
+    ///        frames cache.
+    ///
+    ///////////////////////////////////////////////////////////////////////////////
+    void resetFramesCacheStatistics();
+
+    /// \brief Make the dataset read-only.
+    ///
+    /// After the dataset has been frozen it can be read concurrently by
+    ///  several threads without locking: the functions that read the tags,
+    ///  return the data handlers or decode the images don't acquire any lock.
+    ///
+    /// The functions that modify the dataset, its tags or its sequence items
+    ///  throw DataSetFrozenError. The changes made through writing handlers
+    ///  obtained before the dataset was frozen are discarded.
+    ///
+    /// The decoded frames cache must be enabled before freezing the dataset.
+    ///
+    /// A frozen dataset can still be saved, but cannot be unfrozen.
+    ///
+    ///////////////////////////////////////////////////////////////////////////////
+    void freeze();
+
+    /// \brief Returns true if the dataset has been frozen with freeze().
+    ///
+    /// \return true if the dataset is read-only
+    ///
+    ///////////////////////////////////////////////////////////////////////////////
+    bool isFrozen() const;
+
     /// \brief Insert an image into the dataset.
     ///
     /// In multi-frame datasets the images must be inserted in order: first, insert
@@ -269,6 +356,11 @@ public:
     ///  images already in the dataset then the exception
     ///  DataSetDifferentFormatError is thrown.
     ///
+    /// The RLE transfer syntax (1.2.840.10008.1.2.5) cannot store subsampled
+    ///  images: CodecWrongFormatError is thrown when the quality would
+    ///  subsample the chroma channels (quality lower than high with a color
+    ///  space that can be subsampled, like YBR_FULL).
+    ///
     /// \param frameNumber    the frame number (the first frame is 0)
     /// \param image          the image
     /// \param quality        the quality to use for lossy compression. Ignored
@@ -277,6 +369,42 @@ public:
     ///////////////////////////////////////////////////////////////////////////////
     void setImage(size_t frameNumber, const Image& image, imageQuality_t quality);
 
+#ifndef SWIG
+    /// \brief Insert several images into the dataset, encoding them
+    ///        concurrently.
+    ///
+    /// The images are encoded by a pool of threads shared by the library and
+    /// are inserted in order, as if setImage() was called for each of them.
+    ///
+    /// Throws DataSetWrongFrameError if firstFrame is not equal to the number
+    /// of frames already in the dataset and DataSetDifferentFormatError if
+    /// the images have different attributes than the frames already in the
+    /// dataset.
+    ///
+    /// \param firstFrame the frame number of the first image
+    /// \param images     the images to insert
+    /// \param quality    the quality to use for lossy compression. Ignored
+    ///                   if lossless compression is used
+    ///
+    ///////////////////////////////////////////////////////////////////////////////
+    void setImages(size_t firstFrame, const std::vector<const Image*>& images, imageQuality_t quality);
+#endif
+
+    /// \brief Decode all the images of another dataset and insert them after
+    ///        the images already in this dataset, encoded with this dataset's
+    ///        transfer syntax.
+    ///
+    /// The frames are transcoded in small batches by a pool of threads shared
+    /// by the library and by the calling thread, so only a few frames are
+    /// kept in memory at any time.
+    ///
+    /// \param source  the dataset containing the images to transcode
+    /// \param quality the quality to use for lossy compression. Ignored if
+    ///                lossless compression is used
+    ///
+    ///////////////////////////////////////////////////////////////////////////////
+    void transcodeImages(const DataSet& source, imageQuality_t quality);
+
     /// \brief Return the list of VOI settings stored in the DataSet.
     ///
     /// Each VOI setting includes the center & width values that can be used with
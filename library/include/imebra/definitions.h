@@ -179,6 +179,7 @@ enum class tagVR_t: std::uint32_t
     OD = 0x4f44, ///< Other Double String
     OF = 0x4f46, ///< Other Float String
     OL = 0x4f4c, ///< Other Long String
+    OV = 0x4f56, ///< Other Very Long String
     OW = 0x4f57, ///< Other Word String
     PN = 0x504e, ///< Person Name
     SH = 0x5348, ///< Short String
@@ -214,6 +215,7 @@ static_assert((std::uint16_t)tagVR_t::SB == MAKE_VR_ENUM("SB"), "Wrong VR enumer
 static_assert((std::uint16_t)tagVR_t::OD == MAKE_VR_ENUM("OD"), "Wrong VR enumeration value");
 static_assert((std::uint16_t)tagVR_t::OF == MAKE_VR_ENUM("OF"), "Wrong VR enumeration value");
 static_assert((std::uint16_t)tagVR_t::OL == MAKE_VR_ENUM("OL"), "Wrong VR enumeration value");
+static_assert((std::uint16_t)tagVR_t::OV == MAKE_VR_ENUM("OV"), "Wrong VR enumeration value");
 static_assert((std::uint16_t)tagVR_t::OW == MAKE_VR_ENUM("OW"), "Wrong VR enumeration value");
 static_assert((std::uint16_t)tagVR_t::PN == MAKE_VR_ENUM("PN"), "Wrong VR enumeration value");
 static_assert((std::uint16_t)tagVR_t::SH == MAKE_VR_ENUM("SH"), "Wrong VR enumeration value");
@@ -345,6 +347,56 @@ struct IMEBRA_API VOIDescription
 ///////////////////////////////////////////////////////////////////////////////
 typedef std::vector<VOIDescription> vois_t;
 
+///
+/// \brief Statistics collected by the decoded frames cache of a DataSet.
+///
+/// The statistics can be retrieved with DataSet::getFramesCacheStatistics()
+/// after the cache has been enabled with DataSet::enableFramesCache().
+///
+///////////////////////////////////////////////////////////////////////////////
+struct IMEBRA_API FramesCacheStatistics
+{
+    std::uint64_t hits;            ///< Requested frames found in the cache
+    std::uint64_t misses;          ///< Requested frames not found in the cache
+    std::uint64_t decodedFrames;   ///< Frames decoded, including the read-ahead ones
+    std::uint64_t decodingTime;    ///< Total decoding time, in microseconds
+    std::uint64_t maxDecodingTime; ///< Longest decoding time, in microseconds
+    size_t cachedFrames;           ///< Frames currently in the cache
+    size_t usedMemory;             ///< Memory used by the cached frames, in bytes
+};
+
+///
+/// \brief Counters collected by the library's subsystems, summed across all
+///        the threads.
+///
+/// The counters can be retrieved with Statistics::getStatistics() and reset
+/// with Statistics::resetStatistics().
+///
+/// All the times are in microseconds.
+///
+///////////////////////////////////////////////////////////////////////////////
+struct IMEBRA_API LibraryStatistics
+{
+    std::uint64_t fileBytesRead;           ///< Bytes read from files
+    std::uint64_t fileReadTime;            ///< Time spent reading files
+    std::uint64_t parsedElements;          ///< DICOM elements parsed
+    std::uint64_t parsingTime;             ///< Time spent parsing DICOM streams
+    std::uint64_t dicomDecodedFrames;      ///< Native and RLE frames decoded
+    std::uint64_t dicomDecodedPixels;      ///< Native and RLE pixels decoded
+    std::uint64_t dicomDecodingTime;       ///< Time spent decoding native and RLE frames
+    std::uint64_t jpegDecodedFrames;       ///< Jpeg frames decoded
+    std::uint64_t jpegDecodedPixels;       ///< Jpeg pixels decoded
+    std::uint64_t jpegDecodingTime;        ///< Time spent decoding Jpeg frames
+    std::uint64_t jpeg2000DecodedFrames;   ///< Jpeg2000 frames decoded
+    std::uint64_t jpeg2000DecodedPixels;   ///< Jpeg2000 pixels decoded
+    std::uint64_t jpeg2000DecodingTime;    ///< Time spent decoding Jpeg2000 frames
+    std::uint64_t transformInvocations;    ///< Transforms executed
+    std::uint64_t transformedPixels;       ///< Pixels processed by the transforms
+    std::uint64_t transformTime;           ///< Time spent in the transforms
+    std::uint64_t memoryPoolHits;          ///< Memory allocations served by the memory pool
+    std::uint64_t memoryPoolMisses;        ///< Memory allocations not served by the memory pool
+};
+
 } // namespace imebra
 
 #endif // imebraDefinitions__INCLUDED_
@@ -636,6 +636,21 @@ public:
     DataSetCorruptedOffsetTableError(const std::string& message);
 };
 
+/// \brief This exception is thrown when the client tries to modify a
+///        dataset that has been frozen with DataSet::freeze().
+///
+///////////////////////////////////////////////////////////////////////////////
+class IMEBRA_API DataSetFrozenError: public DataSetError
+{
+public:
+    /// \brief Constructor.
+    ///
+    /// \param message the message to store into the exception
+    ///
+    ///////////////////////////////////////////////////////////////////////////////
+    DataSetFrozenError(const std::string& message);
+};
+
 
 /// \brief Base class from which the exceptions thrown by DicomDirEntry and
 ///        DicomDir classes.
@@ -1095,6 +1110,38 @@ public:
 
 
 
+/// \brief Base exception for the errors reported by BatchLoader.
+///
+///////////////////////////////////////////////////////////////////////////////
+class IMEBRA_API BatchLoaderError: public std::runtime_error
+{
+public:
+    /// \brief Constructor.
+    ///
+    /// \param message the message to store into the exception
+    ///
+    ///////////////////////////////////////////////////////////////////////////////
+    BatchLoaderError(const std::string& message);
+};
+
+
+/// \brief Exception thrown when the job id passed to BatchLoader does not
+///        exist or when its DataSet has already been retrieved.
+///
+///////////////////////////////////////////////////////////////////////////////
+class IMEBRA_API BatchLoaderUnknownJobError: public BatchLoaderError
+{
+public:
+    /// \brief Constructor.
+    ///
+    /// \param message the message to store into the exception
+    ///
+    ///////////////////////////////////////////////////////////////////////////////
+    BatchLoaderUnknownJobError(const std::string& message);
+};
+
+
+
 }
 
 #endif // !defined(imebraExceptions__INCLUDED_)
@@ -71,6 +71,7 @@ class IMEBRA_API Image
     friend class VOILUT;
     friend class DataSet;
     friend class DrawBitmap;
+    friend class MultiFrameWriter;
 
 private:
     Image(std::shared_ptr<imebra::implementation::image> pImage);
@@ -22,6 +22,8 @@ If you do not want to be bound by the GPL terms (such as the requirement
 #include "readingDataHandlerNumeric.h"
 #include "writingDataHandler.h"
 #include "writingDataHandlerNumeric.h"
+#include "readingNumericView.h"
+#include "writingNumericView.h"
 #include "dataSet.h"
 #include "definitions.h"
 #include "dicomDir.h"
@@ -36,6 +38,8 @@ If you do not want to be bound by the GPL terms (such as the requirement
 #include "readMemory.h"
 #include "readWriteMemory.h"
 #include "memoryPool.h"
+#include "statistics.h"
+#include "tracing.h"
 #include "memoryStreamInput.h"
 #include "memoryStreamOutput.h"
 #include "modalityVOILUT.h"
@@ -47,6 +51,8 @@ If you do not want to be bound by the GPL terms (such as the requirement
 #include "transformHighBit.h"
 #include "transformsChain.h"
 #include "VOILUT.h"
+#include "batchLoader.h"
+#include "multiFrameWriter.h"
 #include "tagId.h"
 
 #endif // IMEBRA_INCLUDED
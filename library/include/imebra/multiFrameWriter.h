@@ -0,0 +1,127 @@
+/*
+Copyright 2005 - 2017 by Paolo Brandoli/Binarno s.p.
+
+Imebra is available for free under the GNU General Public License.
+
+The full text of the license is available in the file license.rst
+ in the project root folder.
+
+If you do not want to be bound by the GPL terms (such as the requirement
+ that your application must also be GPL), you may purchase a commercial
+ license for Imebra from the Imebra’s website (http://imebra.com).
+*/
+
+/*! \file multiFrameWriter.h
+    \brief Declaration of the class MultiFrameWriter.
+
+*/
+
+#if !defined(imebraMultiFrameWriter__INCLUDED_)
+#define imebraMultiFrameWriter__INCLUDED_
+
+#include <memory>
+#include <cstdint>
+#include "definitions.h"
+
+#ifndef SWIG
+
+namespace imebra
+{
+namespace implementation
+{
+class multiFrameWriter;
+}
+}
+
+#endif
+
+namespace imebra
+{
+
+class DataSet;
+class StreamWriter;
+class Image;
+
+///
+/// \brief Writes a multi-frame DICOM stream one frame at a time, without
+///        keeping the encoded frames in memory.
+///
+/// The header DataSet (patient, study, series tags, transfer syntax) is
+/// written when the first frame is appended; the writer sets the image
+/// attributes and the number of frames in the header before writing it.
+/// The header is modified in place: after the first frame has been
+/// appended it contains the image attributes and the number of frames.
+/// Each frame appended with appendImage() is encoded and written immediately
+/// to the StreamWriter.
+///
+/// close() terminates the pixel data and then overwrites the Basic Offset
+/// Table (or the Extended Offset Table) and the group length reserved when
+/// the header was written: the destination stream must allow writing at any
+/// position (memory and file streams do).
+///
+/// All the frames must have the same size, color space and bit depth.
+///
+///////////////////////////////////////////////////////////////////////////////
+class IMEBRA_API MultiFrameWriter
+{
+    MultiFrameWriter(const MultiFrameWriter&) = delete;
+    MultiFrameWriter& operator=(const MultiFrameWriter&) = delete;
+
+public:
+    /// \brief Constructor.
+    ///
+    /// \param header              the tags to write before the pixel data.
+    ///                            The DataSet must not contain images or
+    ///                            any tag in the group 0x7fe0 or in the
+    ///                            following groups, otherwise
+    ///                            DataSetWrongFrameError is thrown.
+    ///                            The writer keeps a reference to the
+    ///                            DataSet and adds the image attributes
+    ///                            and the number of frames to it
+    /// \param writer              the destination stream
+    /// \param numberOfFrames      the number of frames that will be appended
+    /// \param quality             the quality to use for lossy compression.
+    ///                            Ignored if lossless compression is used
+    /// \param bExtendedOffsetTable true to store the frames offsets in the
+    ///                            Extended Offset Table (needed when the
+    ///                            frames exceed 4 GB), false to store them in
+    ///                            the Basic Offset Table. The Extended Offset
+    ///                            Table requires one fragment per frame
+    ///
+    ///////////////////////////////////////////////////////////////////////////////
+    MultiFrameWriter(DataSet& header, StreamWriter& writer, size_t numberOfFrames, imageQuality_t quality, bool bExtendedOffsetTable);
+
+    virtual ~MultiFrameWriter();
+
+    /// \brief Encode a frame and write it into the stream.
+    ///
+    /// Throws DataSetWrongFrameError if all the frames have already been
+    /// written and DataSetDifferentFormatError if the image has different
+    /// attributes than the first frame.
+    ///
+    /// \param image the frame to write
+    ///
+    ///////////////////////////////////////////////////////////////////////////////
+    void appendImage(const Image& image);
+
+    /// \brief Terminate the pixel data and update the offset table and the
+    ///        group length.
+    ///
+    /// Throws DataSetWrongFrameError if less frames than the number specified
+    /// in the constructor have been appended and StreamWriteError if the
+    /// pixel data group exceeds the 4 GB allowed by its group length.
+    /// The group length is not written when the Extended Offset Table is
+    /// used.
+    ///
+    ///////////////////////////////////////////////////////////////////////////////
+    void close();
+
+#ifndef SWIG
+protected:
+    std::shared_ptr<implementation::multiFrameWriter> m_pWriter;
+#endif
+};
+
+}
+
+#endif // !defined(imebraMultiFrameWriter__INCLUDED_)
@@ -157,6 +157,44 @@ public:
     ///
     ///////////////////////////////////////////////////////////////////////////////
     std::wstring getUnicodeString(size_t index) const;
+
+    /// \brief Returns a pointer to the characters of a buffer's value, without
+    ///        copying them.
+    ///
+    /// Available only for the tags that store ASCII strings (AE, AS, CS, DA,
+    /// DS, DT, IS, TM, UI, UR): for the other data types throws
+    /// DataHandlerConversionError.
+    ///
+    /// Multi-valued tags (e.g. lists of UIDs or of decimal strings) can be
+    /// scanned with getSize() and getStringView() without allocating memory.
+    ///
+    /// \param index   the element number within the buffer. Must be smaller
+    ///                than getSize()
+    /// \param pLength a variable that will contain the number of characters in
+    ///                the value
+    /// \return a pointer to the value's first character. The characters are
+    ///         not terminated by a zero and are owned by the
+    ///         ReadingDataHandler object
+    ///
+    ///////////////////////////////////////////////////////////////////////////////
+    const char* getStringView(size_t index, size_t* pLength) const;
+
+    /// \brief Copies all the buffer's values into an array of doubles.
+    ///
+    /// The whole buffer is converted in one pass: for the DS and IS tags
+    /// (e.g. contour data) this is much faster than calling getDouble() for
+    /// each value.
+    ///
+    /// If the array is not large enough then the method doesn't copy any
+    /// data and just returns the required array's size.
+    ///
+    /// \param destination     a pointer to the allocated array
+    /// \param destinationSize the number of doubles that the array can
+    ///                        contain
+    /// \return the number of values stored in the buffer
+    ///
+    ///////////////////////////////////////////////////////////////////////////////
+    size_t getDoubles(double* destination, size_t destinationSize) const;
 #endif
 
     /// \brief Retrieve a buffer's value a date or time.
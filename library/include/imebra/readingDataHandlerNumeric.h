@@ -66,6 +66,7 @@ public:
     friend class Tag;
     friend class LUT;
     friend class WritingDataHandlerNumeric;
+    friend class ReadingNumericView;
 
 private:
     ReadingDataHandlerNumeric(std::shared_ptr<imebra::implementation::handlers::readingDataHandlerNumericBase> pDataHandler);
@@ -0,0 +1,180 @@
+/*
+Copyright 2005 - 2017 by Paolo Brandoli/Binarno s.p.
+
+Imebra is available for free under the GNU General Public License.
+
+The full text of the license is available in the file license.rst
+ in the project root folder.
+
+If you do not want to be bound by the GPL terms (such as the requirement
+ that your application must also be GPL), you may purchase a commercial
+ license for Imebra from the Imebra’s website (http://imebra.com).
+*/
+
+/*! \file readingNumericView.h
+    \brief Declaration of the class ReadingNumericView.
+
+*/
+
+#if !defined(imebraReadingNumericView__INCLUDED_)
+#define imebraReadingNumericView__INCLUDED_
+
+#include <memory>
+#include <limits>
+#include <cstdint>
+#include "definitions.h"
+
+#ifndef SWIG
+
+namespace imebra
+{
+namespace implementation
+{
+namespace handlers
+{
+class readingDataHandlerNumericBase;
+}
+}
+}
+
+#endif
+
+namespace imebra
+{
+
+class ReadingDataHandlerNumeric;
+
+///
+/// \brief A read-only view on the numbers managed by a
+///        ReadingDataHandlerNumeric, without copying them.
+///
+/// The view covers all the handler's elements, or every stride-th element
+/// starting from a specific one (e.g. one channel of an interleaved image).
+///
+/// In C++ data() returns a typed pointer to the first element, that can be
+/// passed directly to the application's own processing routines: the
+/// element type must match the type of the handler's data.
+///
+/// The element accessors check the index and convert the value.
+///
+/// The view keeps a reference to the handler's memory, so it can outlive the
+/// ReadingDataHandlerNumeric object that created it.
+///
+///////////////////////////////////////////////////////////////////////////////
+class IMEBRA_API ReadingNumericView
+{
+    ReadingNumericView(const ReadingNumericView&) = delete;
+    ReadingNumericView& operator=(const ReadingNumericView&) = delete;
+
+public:
+    /// \brief Construct a view on all the handler's elements.
+    ///
+    /// \param dataHandler the data handler that manages the numbers
+    ///
+    ///////////////////////////////////////////////////////////////////////////////
+    explicit ReadingNumericView(const ReadingDataHandlerNumeric& dataHandler);
+
+    /// \brief Construct a view on every stride-th element of a data handler.
+    ///
+    /// If firstElement is bigger than the handler's size or stride is 0 then
+    /// throws MissingItemError.
+    ///
+    /// \param dataHandler  the data handler that manages the numbers
+    /// \param firstElement the first element in the view
+    /// \param stride       the distance between the elements in the view,
+    ///                     in elements
+    ///
+    ///////////////////////////////////////////////////////////////////////////////
+    ReadingNumericView(const ReadingDataHandlerNumeric& dataHandler, size_t firstElement, size_t stride);
+
+    virtual ~ReadingNumericView();
+
+    /// \brief Returns the number of elements in the view.
+    ///
+    ///////////////////////////////////////////////////////////////////////////////
+    size_t getSize() const;
+
+    /// \brief Returns the distance between the elements in the view, in
+    ///        elements.
+    ///
+    ///////////////////////////////////////////////////////////////////////////////
+    size_t getStride() const;
+
+    /// \brief Returns the size of each element, in bytes.
+    ///
+    ///////////////////////////////////////////////////////////////////////////////
+    size_t getUnitSize() const;
+
+    /// \brief Returns true if the elements are signed numbers.
+    ///
+    ///////////////////////////////////////////////////////////////////////////////
+    bool isSigned() const;
+
+    /// \brief Returns true if the elements are floating point numbers.
+    ///
+    ///////////////////////////////////////////////////////////////////////////////
+    bool isFloat() const;
+
+    /// \brief Retrieve an element as a signed long integer (32 bit).
+    ///
+    /// If the index is out of range then throws MissingItemError.
+    ///
+    /// \param index the element's index within the view
+    /// \return the element's value
+    ///
+    ///////////////////////////////////////////////////////////////////////////////
+    std::int32_t getSignedLong(size_t index) const;
+
+    /// \brief Retrieve an element as an unsigned long integer (32 bit).
+    ///
+    /// If the index is out of range then throws MissingItemError.
+    ///
+    /// \param index the element's index within the view
+    /// \return the element's value
+    ///
+    ///////////////////////////////////////////////////////////////////////////////
+    std::uint32_t getUnsignedLong(size_t index) const;
+
+    /// \brief Retrieve an element as a double floating point value.
+    ///
+    /// If the index is out of range then throws MissingItemError.
+    ///
+    /// \param index the element's index within the view
+    /// \return the element's value
+    ///
+    ///////////////////////////////////////////////////////////////////////////////
+    double getDouble(size_t index) const;
+
+#ifndef SWIG
+    /// \brief Returns a pointer to the view's first element.
+    ///
+    /// The element i of the view is at position i * getStride().
+    ///
+    /// If the template type doesn't match the type of the elements then throws
+    /// DataHandlerConversionError.
+    ///
+    /// \return a pointer to the first element, or 0 if the view is empty.
+    ///         The memory is owned by the view
+    ///
+    ///////////////////////////////////////////////////////////////////////////////
+    template<typename dataType_t>
+    const dataType_t* data() const
+    {
+        return (const dataType_t*)getData(sizeof(dataType_t), std::numeric_limits<dataType_t>::is_signed, !std::numeric_limits<dataType_t>::is_integer);
+    }
+
+private:
+    const void* getData(size_t unitSize, bool bSigned, bool bFloat) const;
+
+    size_t getHandlerIndex(size_t index) const;
+
+    std::shared_ptr<implementation::handlers::readingDataHandlerNumericBase> m_pDataHandler;
+    size_t m_firstElement;
+    size_t m_size;
+    size_t m_stride;
+#endif
+};
+
+}
+
+#endif // !defined(imebraReadingNumericView__INCLUDED_)
@@ -0,0 +1,66 @@
+/*
+Copyright 2005 - 2017 by Paolo Brandoli/Binarno s.p.
+
+Imebra is available for free under the GNU General Public License.
+
+The full text of the license is available in the file license.rst
+ in the project root folder.
+
+If you do not want to be bound by the GPL terms (such as the requirement
+ that your application must also be GPL), you may purchase a commercial
+ license for Imebra from the Imebra’s website (http://imebra.com).
+*/
+
+/*! \file statistics.h
+    \brief Declaration of the class Statistics.
+
+*/
+
+#if !defined(imebraStatistics__INCLUDED_)
+#define imebraStatistics__INCLUDED_
+
+#include "definitions.h"
+
+namespace imebra
+{
+
+///
+/// \brief Retrieves the performance counters collected by Imebra.
+///
+/// Each thread updates its own counters; the snapshot returned by
+/// getStatistics() sums the counters of all the threads, including the
+/// terminated ones.
+///
+/// The counters are not collected when Imebra is compiled with
+/// IMEBRA_STATISTICS=0: in this case isEnabled() returns false and all the
+/// counters are zero.
+///
+///////////////////////////////////////////////////////////////////////////////
+class IMEBRA_API Statistics
+{
+public:
+    /// \brief Returns the counters collected since the last call to
+    ///        resetStatistics().
+    ///
+    /// \return the counters collected by all the threads
+    ///
+    ///////////////////////////////////////////////////////////////////////////////
+    static LibraryStatistics getStatistics();
+
+    /// \brief Resets all the counters to zero.
+    ///
+    ///////////////////////////////////////////////////////////////////////////////
+    static void resetStatistics();
+
+    /// \brief Returns true if the library has been compiled with the counters
+    ///        enabled.
+    ///
+    /// \return true if the counters are collected, false otherwise
+    ///
+    ///////////////////////////////////////////////////////////////////////////////
+    static bool isEnabled();
+};
+
+}
+
+#endif // !defined(imebraStatistics__INCLUDED_)
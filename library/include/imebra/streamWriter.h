@@ -60,6 +60,7 @@ class IMEBRA_API StreamWriter
 #ifndef SWIG
     friend class CodecFactory;
     friend class Tag;
+    friend class MultiFrameWriter;
 
 private:
     StreamWriter(std::shared_ptr<implementation::streamWriter> pWriter);
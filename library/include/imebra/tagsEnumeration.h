@@ -3645,6 +3645,8 @@ enum class tagId_t: std::uint32_t
     ROIStandardDeviation_6000_1303 = 0x60001303, ///< ROI Standard Deviation (60xx,1303)
     OverlayLabel_6000_1500 = 0x60001500, ///< Overlay Label (60xx,1500)
     OverlayData_6000_3000 = 0x60003000, ///< Overlay Data (60xx,3000)
+    ExtendedOffsetTable_7FE0_0001 = 0x7FE00001, ///< Extended Offset Table (7FE0,0001)
+    ExtendedOffsetTableLengths_7FE0_0002 = 0x7FE00002, ///< Extended Offset Table Lengths (7FE0,0002)
     FloatPixelData_7FE0_0008 = 0x7FE00008, ///< Float Pixel Data (7FE0,0008)
     DoubleFloatPixelData_7FE0_0009 = 0x7FE00009, ///< Double Float Pixel Data (7FE0,0009)
     PixelData_7FE0_0010 = 0x7FE00010, ///< Pixel Data (7FE0,0010)
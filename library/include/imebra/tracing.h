@@ -0,0 +1,92 @@
+/*
+Copyright 2005 - 2017 by Paolo Brandoli/Binarno s.p.
+
+Imebra is available for free under the GNU General Public License.
+
+The full text of the license is available in the file license.rst
+ in the project root folder.
+
+If you do not want to be bound by the GPL terms (such as the requirement
+ that your application must also be GPL), you may purchase a commercial
+ license for Imebra from the Imebra’s website (http://imebra.com).
+*/
+
+/*! \file tracing.h
+    \brief Declaration of the class Tracing.
+
+*/
+
+#if !defined(imebraTracing__INCLUDED_)
+#define imebraTracing__INCLUDED_
+
+#include <string>
+#include "definitions.h"
+
+namespace imebra
+{
+
+///
+/// \brief Records the timeline of the operations executed by Imebra.
+///
+/// While the tracing is enabled Imebra records a span for each dataset
+/// load, DICOM stream parsing, image decoding and encoding, transforms
+/// chain execution and bitmap rendering.
+///
+/// Each thread records the spans in its own ring buffer without locking;
+/// when a buffer is full the oldest spans are overwritten.
+///
+/// The spans can be exported in the Chrome trace-event format, that can be
+/// loaded by chrome://tracing or by Perfetto.
+///
+/// When the tracing is disabled (the default) each span costs a single test.
+///
+///////////////////////////////////////////////////////////////////////////////
+class IMEBRA_API Tracing
+{
+public:
+    /// \brief Enables or disables the recording of the spans.
+    ///
+    /// \param bEnabled true to start recording the spans, false to stop
+    ///
+    ///////////////////////////////////////////////////////////////////////////////
+    static void setEnabled(bool bEnabled);
+
+    /// \brief Returns true if the spans are being recorded.
+    ///
+    ///////////////////////////////////////////////////////////////////////////////
+    static bool isEnabled();
+
+    /// \brief Discards all the recorded spans.
+    ///
+    ///////////////////////////////////////////////////////////////////////////////
+    static void clear();
+
+    /// \brief Returns the recorded spans in the Chrome trace-event JSON format.
+    ///
+    /// \return a JSON document containing the recorded spans
+    ///
+    ///////////////////////////////////////////////////////////////////////////////
+    static std::string getChromeTrace();
+
+    /// \brief Writes the recorded spans to a file, in the Chrome trace-event
+    ///        JSON format.
+    ///
+    /// \param fileName the Unicode name of the file to write
+    ///
+    ///////////////////////////////////////////////////////////////////////////////
+#ifndef SWIG // Use UTF8 strings only with SWIG
+    static void saveChromeTrace(const std::wstring& fileName);
+#endif
+
+    /// \brief Writes the recorded spans to a file, in the Chrome trace-event
+    ///        JSON format.
+    ///
+    /// \param fileName the UTF8 name of the file to write
+    ///
+    ///////////////////////////////////////////////////////////////////////////////
+    static void saveChromeTrace(const std::string& fileName);
+};
+
+}
+
+#endif // !defined(imebraTracing__INCLUDED_)
@@ -63,6 +63,7 @@ class IMEBRA_API WritingDataHandlerNumeric: public WritingDataHandler
     friend class DataSet;
     friend class Tag;
     friend class ReadingDataHandlerNumeric;
+    friend class WritingNumericView;
 private:
     WritingDataHandlerNumeric(std::shared_ptr<imebra::implementation::handlers::writingDataHandlerNumericBase> pDataHandler);
 #endif
@@ -0,0 +1,182 @@
+/*
+Copyright 2005 - 2017 by Paolo Brandoli/Binarno s.p.
+
+Imebra is available for free under the GNU General Public License.
+
+The full text of the license is available in the file license.rst
+ in the project root folder.
+
+If you do not want to be bound by the GPL terms (such as the requirement
+ that your application must also be GPL), you may purchase a commercial
+ license for Imebra from the Imebra’s website (http://imebra.com).
+*/
+
+/*! \file writingNumericView.h
+    \brief Declaration of the class WritingNumericView.
+
+*/
+
+#if !defined(imebraWritingNumericView__INCLUDED_)
+#define imebraWritingNumericView__INCLUDED_
+
+#include <memory>
+#include <limits>
+#include <cstdint>
+#include "definitions.h"
+
+#ifndef SWIG
+
+namespace imebra
+{
+namespace implementation
+{
+namespace handlers
+{
+class writingDataHandlerNumericBase;
+}
+}
+}
+
+#endif
+
+namespace imebra
+{
+
+class WritingDataHandlerNumeric;
+
+///
+/// \brief A writable view on the numbers managed by a
+///        WritingDataHandlerNumeric, without copying them.
+///
+/// The view covers all the handler's elements, or every stride-th element
+/// starting from a specific one (e.g. one channel of an interleaved image).
+///
+/// In C++ data() returns a typed pointer to the first element, so the
+/// application's own processing routines can write the elements in place:
+/// the element type must match the type of the handler's data.
+///
+/// The element setters check the index and convert the value. Unlike the
+/// WritingDataHandlerNumeric setters they don't resize the handler.
+///
+/// The view keeps a reference to the handler: the data is committed to the
+/// buffer when both the WritingDataHandlerNumeric and all its views have been
+/// destroyed.
+///
+///////////////////////////////////////////////////////////////////////////////
+class IMEBRA_API WritingNumericView
+{
+    WritingNumericView(const WritingNumericView&) = delete;
+    WritingNumericView& operator=(const WritingNumericView&) = delete;
+
+public:
+    /// \brief Construct a view on all the handler's elements.
+    ///
+    /// \param dataHandler the data handler that manages the numbers
+    ///
+    ///////////////////////////////////////////////////////////////////////////////
+    explicit WritingNumericView(const WritingDataHandlerNumeric& dataHandler);
+
+    /// \brief Construct a view on every stride-th element of a data handler.
+    ///
+    /// If firstElement is bigger than the handler's size or stride is 0 then
+    /// throws MissingItemError.
+    ///
+    /// \param dataHandler  the data handler that manages the numbers
+    /// \param firstElement the first element in the view
+    /// \param stride       the distance between the elements in the view,
+    ///                     in elements
+    ///
+    ///////////////////////////////////////////////////////////////////////////////
+    WritingNumericView(const WritingDataHandlerNumeric& dataHandler, size_t firstElement, size_t stride);
+
+    virtual ~WritingNumericView();
+
+    /// \brief Returns the number of elements in the view.
+    ///
+    ///////////////////////////////////////////////////////////////////////////////
+    size_t getSize() const;
+
+    /// \brief Returns the distance between the elements in the view, in
+    ///        elements.
+    ///
+    ///////////////////////////////////////////////////////////////////////////////
+    size_t getStride() const;
+
+    /// \brief Returns the size of each element, in bytes.
+    ///
+    ///////////////////////////////////////////////////////////////////////////////
+    size_t getUnitSize() const;
+
+    /// \brief Returns true if the elements are signed numbers.
+    ///
+    ///////////////////////////////////////////////////////////////////////////////
+    bool isSigned() const;
+
+    /// \brief Returns true if the elements are floating point numbers.
+    ///
+    ///////////////////////////////////////////////////////////////////////////////
+    bool isFloat() const;
+
+    /// \brief Set an element to a signed long integer (32 bit).
+    ///
+    /// If the index is out of range then throws MissingItemError.
+    ///
+    /// \param index the element's index within the view
+    /// \param value the value to write
+    ///
+    ///////////////////////////////////////////////////////////////////////////////
+    void setSignedLong(size_t index, std::int32_t value);
+
+    /// \brief Set an element to an unsigned long integer (32 bit).
+    ///
+    /// If the index is out of range then throws MissingItemError.
+    ///
+    /// \param index the element's index within the view
+    /// \param value the value to write
+    ///
+    ///////////////////////////////////////////////////////////////////////////////
+    void setUnsignedLong(size_t index, std::uint32_t value);
+
+    /// \brief Set an element to a double floating point value.
+    ///
+    /// If the index is out of range then throws MissingItemError.
+    ///
+    /// \param index the element's index within the view
+    /// \param value the value to write
+    ///
+    ///////////////////////////////////////////////////////////////////////////////
+    void setDouble(size_t index, double value);
+
+#ifndef SWIG
+    /// \brief Returns a pointer to the view's first element.
+    ///
+    /// The element i of the view is at position i * getStride().
+    ///
+    /// If the template type doesn't match the type of the elements then throws
+    /// DataHandlerConversionError.
+    ///
+    /// \return a pointer to the first element, or 0 if the view is empty.
+    ///         The memory is owned by the view
+    ///
+    ///////////////////////////////////////////////////////////////////////////////
+    template<typename dataType_t>
+    dataType_t* data() const
+    {
+        return (dataType_t*)getData(sizeof(dataType_t), std::numeric_limits<dataType_t>::is_signed, !std::numeric_limits<dataType_t>::is_integer);
+    }
+
+private:
+    void* getData(size_t unitSize, bool bSigned, bool bFloat) const;
+
+    size_t getHandlerIndex(size_t index) const;
+
+    std::shared_ptr<implementation::handlers::writingDataHandlerNumericBase> m_pDataHandler;
+    size_t m_firstElement;
+    size_t m_size;
+    size_t m_stride;
+#endif
+};
+
+}
+
+#endif // !defined(imebraWritingNumericView__INCLUDED_)
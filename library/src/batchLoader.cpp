@@ -0,0 +1,100 @@
+/*
+Copyright 2005 - 2017 by Paolo Brandoli/Binarno s.p.
+
+Imebra is available for free under the GNU General Public License.
+
+The full text of the license is available in the file license.rst
+ in the project root folder.
+
+If you do not want to be bound by the GPL terms (such as the requirement
+ that your application must also be GPL), you may purchase a commercial
+ license for Imebra from the Imebra’s website (http://imebra.com).
+*/
+
+/*! \file batchLoader.cpp
+    \brief Implementation of the class BatchLoader.
+
+*/
+
+#include "../include/imebra/batchLoader.h"
+#include "../include/imebra/baseStreamInput.h"
+#include "../include/imebra/dataSet.h"
+#include "../implementation/batchLoaderImpl.h"
+#include "../implementation/exceptionImpl.h"
+
+namespace imebra
+{
+
+BatchLoader::BatchLoader(std::uint32_t threadsNumber, std::uint32_t prefetchFiles, size_t maxSizeBufferLoad):
+    m_pBatchLoader(std::make_shared<implementation::batchLoader>(threadsNumber, prefetchFiles, maxSizeBufferLoad))
+{
+}
+
+BatchLoader::~BatchLoader()
+{
+}
+
+size_t BatchLoader::load(const std::wstring& fileName)
+{
+    IMEBRA_FUNCTION_START();
+
+    return m_pBatchLoader->load(fileName);
+
+    IMEBRA_FUNCTION_END();
+}
+
+size_t BatchLoader::load(const std::string& fileName)
+{
+    IMEBRA_FUNCTION_START();
+
+    return m_pBatchLoader->load(fileName);
+
+    IMEBRA_FUNCTION_END();
+}
+
+size_t BatchLoader::load(const BaseStreamInput& stream)
+{
+    IMEBRA_FUNCTION_START();
+
+    return m_pBatchLoader->load(stream.m_pStream);
+
+    IMEBRA_FUNCTION_END();
+}
+
+bool BatchLoader::isReady(size_t jobId)
+{
+    IMEBRA_FUNCTION_START();
+
+    return m_pBatchLoader->isReady(jobId);
+
+    IMEBRA_FUNCTION_END();
+}
+
+DataSet* BatchLoader::getDataSet(size_t jobId)
+{
+    IMEBRA_FUNCTION_START();
+
+    return new DataSet(m_pBatchLoader->getDataSet(jobId));
+
+    IMEBRA_FUNCTION_END();
+}
+
+std::uint64_t BatchLoader::getReadTime(size_t jobId)
+{
+    IMEBRA_FUNCTION_START();
+
+    return m_pBatchLoader->getReadTime(jobId);
+
+    IMEBRA_FUNCTION_END();
+}
+
+std::uint64_t BatchLoader::getParseTime(size_t jobId)
+{
+    IMEBRA_FUNCTION_START();
+
+    return m_pBatchLoader->getParseTime(jobId);
+
+    IMEBRA_FUNCTION_END();
+}
+
+}
@@ -95,6 +95,16 @@ void CodecFactory::setMaximumImageSize(const std::uint32_t maximumWidth, const s
 
 }
 
+void CodecFactory::setJpegRestartInterval(const std::uint32_t mcuRows)
+{
+    IMEBRA_FUNCTION_START();
+
+    std::shared_ptr<imebra::implementation::codecs::codecFactory> factory(imebra::implementation::codecs::codecFactory::getCodecFactory());
+    factory->setJpegRestartInterval(mcuRows);
+
+    IMEBRA_FUNCTION_END();
+}
+
 
 void CodecFactory::save(const DataSet& dataSet, StreamWriter& writer, codecType_t codecType)
 {
@@ -105,16 +105,75 @@ Image* DataSet::getImage(size_t frameNumber)
     return new Image(m_pDataSet->getImage((std::uint32_t)frameNumber));
 }
 
+std::vector<std::unique_ptr<Image> > DataSet::getImages(size_t firstFrame, size_t framesCount)
+{
+    std::vector<std::shared_ptr<implementation::image> > images(m_pDataSet->getImages((std::uint32_t)firstFrame, (std::uint32_t)framesCount));
+
+    std::vector<std::unique_ptr<Image> > returnImages;
+    returnImages.reserve(images.size());
+    for(std::vector<std::shared_ptr<implementation::image> >::const_iterator scanImages(images.begin()), endImages(images.end()); scanImages != endImages; ++scanImages)
+    {
+        returnImages.push_back(std::unique_ptr<Image>(new Image(*scanImages)));
+    }
+    return returnImages;
+}
+
 Image* DataSet::getImageApplyModalityTransform(size_t frameNumber)
 {
     return new Image(m_pDataSet->getModalityImage((std::uint32_t)frameNumber));
 }
 
+void DataSet::enableFramesCache(size_t memoryBudget, size_t readAheadFrames)
+{
+    m_pDataSet->enableFramesCache(memoryBudget, (std::uint32_t)readAheadFrames);
+}
+
+void DataSet::disableFramesCache()
+{
+    m_pDataSet->disableFramesCache();
+}
+
+FramesCacheStatistics DataSet::getFramesCacheStatistics() const
+{
+    return m_pDataSet->getFramesCacheStatistics();
+}
+
+void DataSet::resetFramesCacheStatistics()
+{
+    m_pDataSet->resetFramesCacheStatistics();
+}
+
+void DataSet::freeze()
+{
+    m_pDataSet->freeze();
+}
+
+bool DataSet::isFrozen() const
+{
+    return m_pDataSet->isFrozen();
+}
+
 void DataSet::setImage(size_t frameNumber, const Image& image, imageQuality_t quality)
 {
     m_pDataSet->setImage((std::uint32_t)frameNumber, image.m_pImage, quality);
 }
 
+void DataSet::setImages(size_t firstFrame, const std::vector<const Image*>& images, imageQuality_t quality)
+{
+    std::vector<std::shared_ptr<implementation::image> > setImages;
+    setImages.reserve(images.size());
+    for(std::vector<const Image*>::const_iterator scanImages(images.begin()), endImages(images.end()); scanImages != endImages; ++scanImages)
+    {
+        setImages.push_back((*scanImages)->m_pImage);
+    }
+    m_pDataSet->setImages((std::uint32_t)firstFrame, setImages, quality);
+}
+
+void DataSet::transcodeImages(const DataSet& source, imageQuality_t quality)
+{
+    m_pDataSet->transcodeImages(source.m_pDataSet, quality);
+}
+
 DataSet* DataSet::getSequenceItem(const TagId& tagId, size_t itemId)
 {
     return new DataSet(m_pDataSet->getSequenceItem(tagId.getGroupId(), tagId.getGroupOrder(), tagId.getTagId(), itemId));
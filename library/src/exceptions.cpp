@@ -135,6 +135,9 @@ DataSetImagePaletteColorIsReadOnly::DataSetImagePaletteColorIsReadOnly(const std
 DataSetCorruptedOffsetTableError::DataSetCorruptedOffsetTableError(const std::string& message): DataSetError(message)
 {}
 
+DataSetFrozenError::DataSetFrozenError(const std::string& message): DataSetError(message)
+{}
+
 DicomDirError::DicomDirError(const std::string& message): std::runtime_error(message)
 {}
 
@@ -222,5 +225,11 @@ MemoryError::MemoryError(const std::string& message): std::runtime_error(message
 MemorySizeError::MemorySizeError(const std::string& message): MemoryError(message)
 {}
 
+BatchLoaderError::BatchLoaderError(const std::string& message): std::runtime_error(message)
+{}
+
+BatchLoaderUnknownJobError::BatchLoaderUnknownJobError(const std::string& message): BatchLoaderError(message)
+{}
+
 
 }
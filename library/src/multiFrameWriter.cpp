@@ -0,0 +1,67 @@
+/*
+Copyright 2005 - 2017 by Paolo Brandoli/Binarno s.p.
+
+Imebra is available for free under the GNU General Public License.
+
+The full text of the license is available in the file license.rst
+ in the project root folder.
+
+If you do not want to be bound by the GPL terms (such as the requirement
+ that your application must also be GPL), you may purchase a commercial
+ license for Imebra from the Imebra’s website (http://imebra.com).
+*/
+
+/*! \file multiFrameWriter.cpp
+    \brief Implementation of the class MultiFrameWriter.
+
+*/
+
+#include "../include/imebra/multiFrameWriter.h"
+#include "../include/imebra/dataSet.h"
+#include "../include/imebra/streamWriter.h"
+#include "../include/imebra/image.h"
+#include "../implementation/multiFrameWriterImpl.h"
+#include "../implementation/exceptionImpl.h"
+#include "../include/imebra/exceptions.h"
+#include <limits>
+
+namespace imebra
+{
+
+MultiFrameWriter::MultiFrameWriter(DataSet& header, StreamWriter& writer, size_t numberOfFrames, imageQuality_t quality, bool bExtendedOffsetTable)
+{
+    IMEBRA_FUNCTION_START();
+
+    if(numberOfFrames > std::numeric_limits<std::uint32_t>::max())
+    {
+        IMEBRA_THROW(DataSetWrongFrameError, "Too many frames");
+    }
+
+    m_pWriter = std::make_shared<implementation::multiFrameWriter>(header.m_pDataSet, writer.m_pWriter, (std::uint32_t)numberOfFrames, quality, bExtendedOffsetTable);
+
+    IMEBRA_FUNCTION_END();
+}
+
+MultiFrameWriter::~MultiFrameWriter()
+{
+}
+
+void MultiFrameWriter::appendImage(const Image& image)
+{
+    IMEBRA_FUNCTION_START();
+
+    m_pWriter->appendImage(image.m_pImage);
+
+    IMEBRA_FUNCTION_END();
+}
+
+void MultiFrameWriter::close()
+{
+    IMEBRA_FUNCTION_START();
+
+    m_pWriter->close();
+
+    IMEBRA_FUNCTION_END();
+}
+
+}
@@ -65,6 +65,21 @@ std::wstring ReadingDataHandler::getUnicodeString(size_t index) const
     return m_pDataHandler->getUnicodeString(index);
 }
 
+const char* ReadingDataHandler::getStringView(size_t index, size_t* pLength) const
+{
+    return m_pDataHandler->getStringView(index, pLength);
+}
+
+size_t ReadingDataHandler::getDoubles(double* destination, size_t destinationSize) const
+{
+    const size_t size(m_pDataHandler->getSize());
+    if(destination != 0 && destinationSize >= size)
+    {
+        m_pDataHandler->getDoubles(0, destination, size);
+    }
+    return size;
+}
+
 Date ReadingDataHandler::getDate(size_t index) const
 {
     std::uint32_t year, month, day, hour, minutes, seconds, nanoseconds;
@@ -0,0 +1,140 @@
+/*
+Copyright 2005 - 2017 by Paolo Brandoli/Binarno s.p.
+
+Imebra is available for free under the GNU General Public License.
+
+The full text of the license is available in the file license.rst
+ in the project root folder.
+
+If you do not want to be bound by the GPL terms (such as the requirement
+ that your application must also be GPL), you may purchase a commercial
+ license for Imebra from the Imebra’s website (http://imebra.com).
+*/
+
+/*! \file readingNumericView.cpp
+    \brief Implementation of the class ReadingNumericView.
+
+*/
+
+#include "../include/imebra/readingNumericView.h"
+#include "../include/imebra/readingDataHandlerNumeric.h"
+#include "../implementation/dataHandlerNumericImpl.h"
+#include "../implementation/exceptionImpl.h"
+
+namespace imebra
+{
+
+ReadingNumericView::ReadingNumericView(const ReadingDataHandlerNumeric& dataHandler):
+    m_pDataHandler(std::dynamic_pointer_cast<implementation::handlers::readingDataHandlerNumericBase>(dataHandler.m_pDataHandler)),
+    m_firstElement(0),
+    m_size(m_pDataHandler->getSize()),
+    m_stride(1)
+{
+}
+
+ReadingNumericView::ReadingNumericView(const ReadingDataHandlerNumeric& dataHandler, size_t firstElement, size_t stride):
+    m_pDataHandler(std::dynamic_pointer_cast<implementation::handlers::readingDataHandlerNumericBase>(dataHandler.m_pDataHandler)),
+    m_firstElement(firstElement),
+    m_size(0),
+    m_stride(stride)
+{
+    IMEBRA_FUNCTION_START();
+
+    const size_t handlerSize(m_pDataHandler->getSize());
+    if(stride == 0 || firstElement > handlerSize)
+    {
+        IMEBRA_THROW(MissingItemError, "The view's first element " << firstElement << " or stride " << stride << " are not valid for a handler with " << handlerSize << " elements");
+    }
+    m_size = (handlerSize - firstElement + stride - 1) / stride;
+
+    IMEBRA_FUNCTION_END();
+}
+
+ReadingNumericView::~ReadingNumericView()
+{
+}
+
+size_t ReadingNumericView::getSize() const
+{
+    return m_size;
+}
+
+size_t ReadingNumericView::getStride() const
+{
+    return m_stride;
+}
+
+size_t ReadingNumericView::getUnitSize() const
+{
+    return m_pDataHandler->getUnitSize();
+}
+
+bool ReadingNumericView::isSigned() const
+{
+    return m_pDataHandler->isSigned();
+}
+
+bool ReadingNumericView::isFloat() const
+{
+    return m_pDataHandler->isFloat();
+}
+
+std::int32_t ReadingNumericView::getSignedLong(size_t index) const
+{
+    IMEBRA_FUNCTION_START();
+
+    return m_pDataHandler->getSignedLong(getHandlerIndex(index));
+
+    IMEBRA_FUNCTION_END();
+}
+
+std::uint32_t ReadingNumericView::getUnsignedLong(size_t index) const
+{
+    IMEBRA_FUNCTION_START();
+
+    return m_pDataHandler->getUnsignedLong(getHandlerIndex(index));
+
+    IMEBRA_FUNCTION_END();
+}
+
+double ReadingNumericView::getDouble(size_t index) const
+{
+    IMEBRA_FUNCTION_START();
+
+    return m_pDataHandler->getDouble(getHandlerIndex(index));
+
+    IMEBRA_FUNCTION_END();
+}
+
+const void* ReadingNumericView::getData(size_t unitSize, bool bSigned, bool bFloat) const
+{
+    IMEBRA_FUNCTION_START();
+
+    if(unitSize != m_pDataHandler->getUnitSize() || bSigned != m_pDataHandler->isSigned() || bFloat != m_pDataHandler->isFloat())
+    {
+        IMEBRA_THROW(DataHandlerConversionError, "The requested type doesn't match the type of the elements");
+    }
+
+    if(m_size == 0)
+    {
+        return 0;
+    }
+    return m_pDataHandler->getMemoryBuffer() + m_firstElement * unitSize;
+
+    IMEBRA_FUNCTION_END();
+}
+
+size_t ReadingNumericView::getHandlerIndex(size_t index) const
+{
+    IMEBRA_FUNCTION_START();
+
+    if(index >= m_size)
+    {
+        IMEBRA_THROW(MissingItemError, "Missing item " << index);
+    }
+    return m_firstElement + index * m_stride;
+
+    IMEBRA_FUNCTION_END();
+}
+
+}
@@ -0,0 +1,56 @@
+/*
+Copyright 2005 - 2017 by Paolo Brandoli/Binarno s.p.
+
+Imebra is available for free under the GNU General Public License.
+
+The full text of the license is available in the file license.rst
+ in the project root folder.
+
+If you do not want to be bound by the GPL terms (such as the requirement
+ that your application must also be GPL), you may purchase a commercial
+ license for Imebra from the Imebra’s website (http://imebra.com).
+*/
+
+#include "../include/imebra/statistics.h"
+
+#include "../implementation/statisticsImpl.h"
+#include "../implementation/exceptionImpl.h"
+
+namespace imebra
+{
+
+LibraryStatistics Statistics::getStatistics()
+{
+    IMEBRA_FUNCTION_START();
+
+#ifdef IMEBRA_DISABLE_STATISTICS
+    LibraryStatistics libraryStatistics = LibraryStatistics();
+    return libraryStatistics;
+#else
+    return implementation::statistics::getStatistics();
+#endif
+
+    IMEBRA_FUNCTION_END();
+}
+
+void Statistics::resetStatistics()
+{
+    IMEBRA_FUNCTION_START();
+
+#ifndef IMEBRA_DISABLE_STATISTICS
+    implementation::statistics::resetStatistics();
+#endif
+
+    IMEBRA_FUNCTION_END();
+}
+
+bool Statistics::isEnabled()
+{
+#ifdef IMEBRA_DISABLE_STATISTICS
+    return false;
+#else
+    return true;
+#endif
+}
+
+}
@@ -0,0 +1,75 @@
+/*
+Copyright 2005 - 2017 by Paolo Brandoli/Binarno s.p.
+
+Imebra is available for free under the GNU General Public License.
+
+The full text of the license is available in the file license.rst
+ in the project root folder.
+
+If you do not want to be bound by the GPL terms (such as the requirement
+ that your application must also be GPL), you may purchase a commercial
+ license for Imebra from the Imebra’s website (http://imebra.com).
+*/
+
+#include "../include/imebra/tracing.h"
+
+#include "../implementation/tracingImpl.h"
+#include "../implementation/fileStreamImpl.h"
+#include "../implementation/exceptionImpl.h"
+
+namespace imebra
+{
+
+void Tracing::setEnabled(bool bEnabled)
+{
+    implementation::tracing::setEnabled(bEnabled);
+}
+
+bool Tracing::isEnabled()
+{
+    return implementation::tracing::isEnabled();
+}
+
+void Tracing::clear()
+{
+    IMEBRA_FUNCTION_START();
+
+    implementation::tracing::clear();
+
+    IMEBRA_FUNCTION_END();
+}
+
+std::string Tracing::getChromeTrace()
+{
+    IMEBRA_FUNCTION_START();
+
+    return implementation::tracing::getChromeTrace();
+
+    IMEBRA_FUNCTION_END();
+}
+
+void Tracing::saveChromeTrace(const std::wstring& fileName)
+{
+    IMEBRA_FUNCTION_START();
+
+    const std::string trace(implementation::tracing::getChromeTrace());
+
+    implementation::fileStreamOutput file(fileName);
+    file.write(0, (const std::uint8_t*)trace.data(), trace.size());
+
+    IMEBRA_FUNCTION_END();
+}
+
+void Tracing::saveChromeTrace(const std::string& fileName)
+{
+    IMEBRA_FUNCTION_START();
+
+    const std::string trace(implementation::tracing::getChromeTrace());
+
+    implementation::fileStreamOutput file(fileName);
+    file.write(0, (const std::uint8_t*)trace.data(), trace.size());
+
+    IMEBRA_FUNCTION_END();
+}
+
+}
@@ -0,0 +1,106 @@
+#include <imebra/imebra.h>
+#include <gtest/gtest.h>
+#include <sstream>
+#include <cstdio>
+
+namespace imebra
+{
+
+namespace tests
+{
+
+TEST(batchLoaderTest, loadFilesAndStreams)
+{
+    const size_t filesNumber(8);
+
+    std::vector<std::string> fileNames;
+    std::vector<std::unique_ptr<ReadWriteMemory> > memories;
+    for(size_t createFiles(0); createFiles != filesNumber; ++createFiles)
+    {
+        DataSet testDataSet("1.2.840.10008.1.2.1");
+        std::ostringstream patientName;
+        patientName << "Patient " << createFiles;
+        testDataSet.setString(TagId(tagId_t::PatientName_0010_0010), patientName.str());
+        testDataSet.setUnsignedLong(TagId(tagId_t::Rows_0028_0010), (std::uint32_t)createFiles);
+
+        std::ostringstream fileName;
+        fileName << "testBatchLoader" << createFiles << ".dcm";
+        fileNames.push_back(fileName.str());
+        CodecFactory::save(testDataSet, fileName.str(), codecType_t::dicom);
+
+        memories.push_back(std::unique_ptr<ReadWriteMemory>(new ReadWriteMemory()));
+        MemoryStreamOutput memoryStream(*memories.back());
+        StreamWriter writer(memoryStream);
+        CodecFactory::save(testDataSet, writer, codecType_t::dicom);
+    }
+
+    for(std::uint32_t prefetchFiles(0); prefetchFiles != 3; ++prefetchFiles)
+    {
+        BatchLoader loader(3, prefetchFiles);
+
+        std::vector<size_t> fileJobs;
+        std::vector<size_t> streamJobs;
+        for(size_t loadFiles(0); loadFiles != filesNumber; ++loadFiles)
+        {
+            fileJobs.push_back(loader.load(fileNames[loadFiles]));
+            MemoryStreamInput memoryStream(*memories[loadFiles]);
+            streamJobs.push_back(loader.load(memoryStream));
+        }
+
+        for(size_t checkFiles(0); checkFiles != filesNumber; ++checkFiles)
+        {
+            std::ostringstream patientName;
+            patientName << "Patient " << checkFiles;
+
+            loader.getParseTime(fileJobs[checkFiles]);
+            EXPECT_TRUE(loader.isReady(fileJobs[checkFiles]));
+            std::unique_ptr<DataSet> pFileDataSet(loader.getDataSet(fileJobs[checkFiles]));
+            EXPECT_EQ(patientName.str(), pFileDataSet->getString(TagId(tagId_t::PatientName_0010_0010), 0));
+            EXPECT_EQ(checkFiles, pFileDataSet->getUnsignedLong(TagId(tagId_t::Rows_0028_0010), 0));
+
+            EXPECT_EQ(0u, loader.getReadTime(streamJobs[checkFiles]));
+            loader.getParseTime(streamJobs[checkFiles]);
+            std::unique_ptr<DataSet> pStreamDataSet(loader.getDataSet(streamJobs[checkFiles]));
+            EXPECT_EQ(patientName.str(), pStreamDataSet->getString(TagId(tagId_t::PatientName_0010_0010), 0));
+
+            // The dataset can be retrieved only once, then the job
+            //  is removed from the loader
+            EXPECT_THROW(loader.getDataSet(fileJobs[checkFiles]), BatchLoaderUnknownJobError);
+            EXPECT_THROW(loader.isReady(fileJobs[checkFiles]), BatchLoaderUnknownJobError);
+            EXPECT_THROW(loader.getParseTime(streamJobs[checkFiles]), BatchLoaderUnknownJobError);
+        }
+    }
+
+    for(size_t removeFiles(0); removeFiles != filesNumber; ++removeFiles)
+    {
+        EXPECT_EQ(0, std::remove(fileNames[removeFiles].c_str()));
+    }
+}
+
+
+TEST(batchLoaderTest, errors)
+{
+    BatchLoader loader(2, 1);
+
+    size_t missingFileJob(loader.load("thisFileDoesNotExist.dcm"));
+    loader.getReadTime(missingFileJob);
+    EXPECT_TRUE(loader.isReady(missingFileJob));
+    EXPECT_THROW(loader.getDataSet(missingFileJob), StreamOpenError);
+
+    // Failed jobs are removed too, once their exception has
+    //  been rethrown
+    EXPECT_THROW(loader.getDataSet(missingFileJob), BatchLoaderUnknownJobError);
+
+    ReadWriteMemory notDicom;
+    notDicom.assign("notADicomStream", 15);
+    MemoryStreamInput notDicomStream(notDicom);
+    size_t wrongFormatJob(loader.load(notDicomStream));
+    EXPECT_THROW(loader.getDataSet(wrongFormatJob), std::runtime_error);
+
+    EXPECT_THROW(loader.isReady(wrongFormatJob + 1), BatchLoaderUnknownJobError);
+    EXPECT_THROW(loader.getDataSet(wrongFormatJob + 1), BatchLoaderUnknownJobError);
+}
+
+} // namespace tests
+
+} // namespace imebra
@@ -4,6 +4,8 @@
 #include <list>
 #include <string.h>
 #include <memory>
+#include <thread>
+#include <atomic>
 #include <gtest/gtest.h>
 
 namespace imebra
@@ -96,6 +98,170 @@ TEST(dataSetTest, testFragmentation)
 }
 
 
+TEST(dataSetTest, testOffsetTables)
+{
+    // Store three images, then split each frame in two
+    //  fragments and locate the frames through the extended
+    //  offset table or with an empty basic offset table
+    const std::uint32_t numberOfFrames(3);
+
+    ReadWriteMemory originalStream;
+    std::vector<std::shared_ptr<Image> > originalImages;
+    {
+        DataSet originalDataSet("1.2.840.10008.1.2.4.70");
+        for(std::uint32_t frame(0); frame != numberOfFrames; ++frame)
+        {
+            std::unique_ptr<Image> testImage(buildImageForTest(64, 48, imebra::bitDepth_t::depthU8, 7, 64, 48, "MONOCHROME2", 10 + frame * 20));
+            originalDataSet.setImage(frame, *testImage, imageQuality_t::high);
+            originalImages.push_back(std::shared_ptr<Image>(testImage.release()));
+        }
+
+        MemoryStreamOutput outputStream(originalStream);
+        StreamWriter outputWriter(outputStream);
+        CodecFactory::save(originalDataSet, outputWriter, codecType_t::dicom);
+    }
+
+    for(int offsetTableType(0); offsetTableType != 3; ++offsetTableType)
+    {
+        MemoryStreamInput originalInput(originalStream);
+        StreamReader originalReader(originalInput);
+        std::unique_ptr<DataSet> testDataSet(CodecFactory::load(originalReader));
+
+        std::vector<std::string> frames;
+        for(std::uint32_t frame(0); frame != numberOfFrames; ++frame)
+        {
+            std::unique_ptr<ReadingDataHandlerNumeric> frameHandler(testDataSet->getReadingDataHandlerNumeric(TagId(tagId_t::PixelData_7FE0_0010), frame + 1));
+            size_t frameSize;
+            const char* pFrame(frameHandler->data(&frameSize));
+            frames.push_back(std::string(pFrame, frameSize));
+        }
+
+        {
+            std::unique_ptr<WritingDataHandlerNumeric> offsetsHandler(testDataSet->getWritingDataHandlerNumeric(TagId(tagId_t::ExtendedOffsetTable_7FE0_0001), 0, tagVR_t::OV));
+            offsetsHandler->setSize(numberOfFrames);
+
+            std::uint32_t fragmentId(1);
+            std::uint32_t offset(0);
+            for(std::uint32_t frame(0); frame != numberOfFrames; ++frame)
+            {
+                // The type 2 offsets don't point to a fragment
+                offsetsHandler->setUnsignedLong(frame, offsetTableType == 2 ? offset + 2 : offset);
+
+                const size_t firstFragmentSize((frames[frame].size() / 2) & ~(size_t)1);
+                std::unique_ptr<WritingDataHandlerNumeric> fragment0(testDataSet->getWritingDataHandlerNumeric(TagId(tagId_t::PixelData_7FE0_0010), fragmentId++, tagVR_t::OB));
+                fragment0->assign(frames[frame].data(), firstFragmentSize);
+                std::unique_ptr<WritingDataHandlerNumeric> fragment1(testDataSet->getWritingDataHandlerNumeric(TagId(tagId_t::PixelData_7FE0_0010), fragmentId++, tagVR_t::OB));
+                fragment1->assign(frames[frame].data() + firstFragmentSize, frames[frame].size() - firstFragmentSize);
+
+                offset += (std::uint32_t)frames[frame].size() + 16;
+            }
+
+            std::unique_ptr<WritingDataHandlerNumeric> basicOffsetTable(testDataSet->getWritingDataHandlerNumeric(TagId(tagId_t::PixelData_7FE0_0010), 0, tagVR_t::OB));
+            basicOffsetTable->setSize(0);
+        }
+        if(offsetTableType == 1)
+        {
+            testDataSet->getWritingDataHandlerNumeric(TagId(tagId_t::ExtendedOffsetTable_7FE0_0001), 0, tagVR_t::OV)->setSize(0);
+        }
+
+        // Save and reload the dataset
+        ReadWriteMemory encodedDataSet;
+        {
+            MemoryStreamOutput outputStream(encodedDataSet);
+            StreamWriter outputWriter(outputStream);
+            CodecFactory::save(*testDataSet, outputWriter, codecType_t::dicom);
+        }
+        MemoryStreamInput inputStream(encodedDataSet);
+        StreamReader inputReader(inputStream);
+        std::unique_ptr<DataSet> readDataSet(CodecFactory::load(inputReader));
+
+        for(std::uint32_t frame(numberOfFrames); frame != 0; --frame)
+        {
+            if(offsetTableType == 2)
+            {
+                ASSERT_THROW(readDataSet->getImage(frame - 1), DataSetCorruptedOffsetTableError);
+                continue;
+            }
+            std::unique_ptr<Image> checkImage(readDataSet->getImage(frame - 1));
+            ASSERT_TRUE(compareImages(*originalImages[frame - 1], *checkImage) < 0.000001);
+        }
+    }
+}
+
+TEST(dataSetTest, testFramesIndexUpdate)
+{
+    // Locate the frames, then move the frames' boundaries
+    //  through a Tag obtained before the change: the frames
+    //  must be located again
+    ReadWriteMemory originalStream;
+    std::vector<std::shared_ptr<Image> > originalImages;
+    std::vector<std::string> frames;
+    DataSet testDataSet("1.2.840.10008.1.2.4.70");
+    for(std::uint32_t frame(0); frame != 2; ++frame)
+    {
+        std::unique_ptr<Image> testImage(buildImageForTest(64, 48, imebra::bitDepth_t::depthU8, 7, 64, 48, "MONOCHROME2", 10 + frame * 20));
+        testDataSet.setImage(frame, *testImage, imageQuality_t::high);
+        originalImages.push_back(std::shared_ptr<Image>(testImage.release()));
+
+        std::unique_ptr<ReadingDataHandlerNumeric> frameHandler(testDataSet.getReadingDataHandlerNumeric(TagId(tagId_t::PixelData_7FE0_0010), frame + 1));
+        size_t frameSize;
+        const char* pFrame(frameHandler->data(&frameSize));
+        frames.push_back(std::string(pFrame, frameSize));
+    }
+
+    std::unique_ptr<Tag> pixelTag(testDataSet.getTag(TagId(tagId_t::PixelData_7FE0_0010)));
+
+    // Store the fragments of both frames, splitting one of them
+    //  in two fragments
+    auto storeFrames = [&](std::uint32_t splitFrame)
+    {
+        std::vector<std::string> fragments;
+        std::uint32_t offsets[2];
+        std::uint32_t offset(0);
+        for(std::uint32_t frame(0); frame != 2; ++frame)
+        {
+            offsets[frame] = offset;
+            const size_t firstFragmentSize(frame == splitFrame ? (frames[frame].size() / 2) & ~(size_t)1 : frames[frame].size());
+            fragments.push_back(frames[frame].substr(0, firstFragmentSize));
+            if(firstFragmentSize != frames[frame].size())
+            {
+                fragments.push_back(frames[frame].substr(firstFragmentSize));
+            }
+            offset += (std::uint32_t)((frames[frame].size() + 1) & ~(size_t)1) + 8 * (frame == splitFrame ? 2 : 1);
+        }
+
+        std::uint8_t basicOffsetTable[8];
+        for(size_t scanBytes(0); scanBytes != 8; ++scanBytes)
+        {
+            basicOffsetTable[scanBytes] = (std::uint8_t)(offsets[scanBytes / 4] >> (8 * (scanBytes % 4)));
+        }
+        std::unique_ptr<WritingDataHandlerNumeric> offsetsHandler(pixelTag->getWritingDataHandlerRaw(0));
+        offsetsHandler->assign((const char*)basicOffsetTable, 8);
+
+        for(size_t fragment(0); fragment != fragments.size(); ++fragment)
+        {
+            std::unique_ptr<WritingDataHandlerNumeric> fragmentHandler(pixelTag->getWritingDataHandlerRaw(fragment + 1));
+            fragmentHandler->assign(fragments[fragment].data(), fragments[fragment].size());
+        }
+    };
+
+    storeFrames(0);
+    for(std::uint32_t frame(0); frame != 2; ++frame)
+    {
+        std::unique_ptr<Image> checkImage(testDataSet.getImage(frame));
+        ASSERT_TRUE(compareImages(*originalImages[frame], *checkImage) < 0.000001);
+    }
+
+    // Same number of fragments, different frames boundaries
+    storeFrames(1);
+    for(std::uint32_t frame(0); frame != 2; ++frame)
+    {
+        std::unique_ptr<Image> checkImage(testDataSet.getImage(frame));
+        ASSERT_TRUE(compareImages(*originalImages[frame], *checkImage) < 0.000001);
+    }
+}
+
+
 TEST(dataSetTest, testVOIs)
 {
     DataSet testDataSet;
@@ -302,6 +468,73 @@ TEST(dataSetTest, testSequence)
     }
 }
 
+TEST(dataSetTest, testNestedSequences)
+{
+    const size_t depth(10);
+
+    for(int transferSyntaxId(0); transferSyntaxId != 3; ++transferSyntaxId)
+    {
+        std::string transferSyntax;
+        switch(transferSyntaxId)
+        {
+        case 0:
+            transferSyntax = "1.2.840.10008.1.2";
+            break;
+        case 1:
+            transferSyntax = "1.2.840.10008.1.2.1";
+            break;
+        case 2:
+            transferSyntax = "1.2.840.10008.1.2.2";
+            break;
+        }
+
+        DataSet testDataSet(transferSyntax);
+
+        {
+            std::unique_ptr<DataSet> innerItem(new DataSet());
+            innerItem->setString(TagId(0x10, 0x10), "Level0");
+
+            for(size_t level(1); level != depth; ++level)
+            {
+                std::ostringstream levelName;
+                levelName << "Level" << level;
+
+                std::unique_ptr<DataSet> outerItem(new DataSet());
+                outerItem->setString(TagId(0x10, 0x10), levelName.str());
+                outerItem->setSequenceItem(TagId(tagId_t::ReferencedPerformedProcedureStepSequence_0008_1111), 0, *innerItem);
+                outerItem->setSequenceItem(TagId(tagId_t::ReferencedPerformedProcedureStepSequence_0008_1111), 1, *innerItem);
+                innerItem.reset(outerItem.release());
+            }
+            testDataSet.setSequenceItem(TagId(tagId_t::ReferencedPerformedProcedureStepSequence_0008_1111), 0, *innerItem);
+        }
+
+        ReadWriteMemory encodedDataSet;
+        MemoryStreamOutput outputStream(encodedDataSet);
+        StreamWriter outputWriter(outputStream);
+        CodecFactory::save(testDataSet, outputWriter, codecType_t::dicom);
+
+        MemoryStreamInput inputStream(encodedDataSet);
+        StreamReader inputReader(inputStream);
+        std::unique_ptr<DataSet> readDataSet(CodecFactory::load(inputReader));
+
+        std::unique_ptr<DataSet> item(readDataSet->getSequenceItem(TagId(tagId_t::ReferencedPerformedProcedureStepSequence_0008_1111), 0));
+        for(size_t level(depth - 1); ; --level)
+        {
+            std::ostringstream levelName;
+            levelName << "Level" << level;
+            ASSERT_EQ(levelName.str(), item->getString(TagId(0x10, 0x10), 0));
+            if(level == 0)
+            {
+                break;
+            }
+            std::unique_ptr<DataSet> secondItem(item->getSequenceItem(TagId(tagId_t::ReferencedPerformedProcedureStepSequence_0008_1111), 1));
+            std::unique_ptr<DataSet> firstItem(item->getSequenceItem(TagId(tagId_t::ReferencedPerformedProcedureStepSequence_0008_1111), 0));
+            ASSERT_EQ(firstItem->getString(TagId(0x10, 0x10), 0), secondItem->getString(TagId(0x10, 0x10), 0));
+            item.reset(firstItem.release());
+        }
+    }
+}
+
 TEST(dataSetTest, dataHandler)
 {
     {
@@ -437,6 +670,204 @@ TEST(dataSetTest, testEmptySequence)
 }
 
 
+TEST(dataSetTest, testFreeze)
+{
+    const std::uint32_t numberOfFrames(3);
+
+    ReadWriteMemory encodedDataSet;
+    std::vector<std::shared_ptr<Image> > originalImages;
+    {
+        DataSet originalDataSet("1.2.840.10008.1.2.4.70");
+        originalDataSet.setString(TagId(tagId_t::PatientName_0010_0010), "Test^Patient");
+        DataSet item;
+        item.setString(TagId(tagId_t::CodeValue_0008_0100), "CODE");
+        originalDataSet.setSequenceItem(TagId(tagId_t::ReferencedPerformedProcedureStepSequence_0008_1111), 0, item);
+        for(std::uint32_t frame(0); frame != numberOfFrames; ++frame)
+        {
+            std::unique_ptr<Image> testImage(buildImageForTest(64, 48, imebra::bitDepth_t::depthU8, 7, 64, 48, "MONOCHROME2", 10 + frame * 20));
+            originalDataSet.setImage(frame, *testImage, imageQuality_t::high);
+            originalImages.push_back(std::shared_ptr<Image>(testImage.release()));
+        }
+
+        MemoryStreamOutput outputStream(encodedDataSet);
+        StreamWriter outputWriter(outputStream);
+        CodecFactory::save(originalDataSet, outputWriter, codecType_t::dicom);
+    }
+
+    MemoryStreamInput inputStream(encodedDataSet);
+    StreamReader inputReader(inputStream);
+    std::unique_ptr<DataSet> testDataSet(CodecFactory::load(inputReader));
+
+    // Writing handlers obtained before freezing don't modify
+    //  the frozen dataset
+    ///////////////////////////////////////////////////////////
+    std::unique_ptr<WritingDataHandler> lateHandler(testDataSet->getWritingDataHandler(TagId(tagId_t::PatientID_0010_0020), 0));
+    lateHandler->setString(0, "Late");
+
+    EXPECT_FALSE(testDataSet->isFrozen());
+    testDataSet->freeze();
+    EXPECT_TRUE(testDataSet->isFrozen());
+
+    lateHandler.reset();
+    EXPECT_EQ("", testDataSet->getString(TagId(tagId_t::PatientID_0010_0020), 0, ""));
+
+    // Writes are rejected
+    ///////////////////////////////////////////////////////////
+    EXPECT_THROW(testDataSet->setString(TagId(tagId_t::PatientName_0010_0010), "Other"), DataSetFrozenError);
+    EXPECT_THROW(testDataSet->setUnsignedLong(TagId(tagId_t::Rows_0028_0010), 10), DataSetFrozenError);
+    EXPECT_THROW(testDataSet->getWritingDataHandler(TagId(tagId_t::PatientName_0010_0010), 0), DataSetFrozenError);
+    EXPECT_THROW(testDataSet->getWritingDataHandler(TagId(tagId_t::StudyID_0020_0010), 0), DataSetFrozenError);
+    {
+        std::unique_ptr<Tag> patientTag(testDataSet->getTag(TagId(tagId_t::PatientName_0010_0010)));
+        EXPECT_THROW(patientTag->getWritingDataHandler(0), DataSetFrozenError);
+    }
+    {
+        std::unique_ptr<DataSet> sequenceItem(testDataSet->getSequenceItem(TagId(tagId_t::ReferencedPerformedProcedureStepSequence_0008_1111), 0));
+        EXPECT_TRUE(sequenceItem->isFrozen());
+        EXPECT_EQ("CODE", sequenceItem->getString(TagId(tagId_t::CodeValue_0008_0100), 0));
+        EXPECT_THROW(sequenceItem->setString(TagId(tagId_t::CodeValue_0008_0100), "OTHER"), DataSetFrozenError);
+    }
+    {
+        std::unique_ptr<Image> image(buildImageForTest(64, 48, imebra::bitDepth_t::depthU8, 7, 64, 48, "MONOCHROME2", 1));
+        EXPECT_THROW(testDataSet->setImage(numberOfFrames, *image, imageQuality_t::high), DataSetFrozenError);
+    }
+
+    // Concurrent reads
+    ///////////////////////////////////////////////////////////
+    std::atomic<int> errors(0);
+    std::vector<std::thread> threads;
+    for(int thread(0); thread != 4; ++thread)
+    {
+        threads.push_back(std::thread([&]()
+        {
+            for(int repeat(0); repeat != 20; ++repeat)
+            {
+                if(testDataSet->getString(TagId(tagId_t::PatientName_0010_0010), 0) != "Test^Patient")
+                {
+                    ++errors;
+                }
+                for(std::uint32_t frame(0); frame != numberOfFrames; ++frame)
+                {
+                    std::unique_ptr<Image> image(testDataSet->getImage(frame));
+                    if(!identicalImages(*image, *(originalImages[frame])))
+                    {
+                        ++errors;
+                    }
+                }
+            }
+        }));
+    }
+    for(size_t thread(0); thread != threads.size(); ++thread)
+    {
+        threads[thread].join();
+    }
+    EXPECT_EQ(0, errors);
+
+    // A frozen dataset can be saved
+    ///////////////////////////////////////////////////////////
+    ReadWriteMemory savedDataSet;
+    {
+        MemoryStreamOutput outputStream(savedDataSet);
+        StreamWriter outputWriter(outputStream);
+        CodecFactory::save(*testDataSet, outputWriter, codecType_t::dicom);
+    }
+    MemoryStreamInput savedStream(savedDataSet);
+    StreamReader savedReader(savedStream);
+    std::unique_ptr<DataSet> savedDataSetRead(CodecFactory::load(savedReader));
+    EXPECT_FALSE(savedDataSetRead->isFrozen());
+    EXPECT_EQ("Test^Patient", savedDataSetRead->getString(TagId(tagId_t::PatientName_0010_0010), 0));
+    std::unique_ptr<Image> lastImage(savedDataSetRead->getImage(numberOfFrames - 1));
+    EXPECT_TRUE(identicalImages(*lastImage, *(originalImages[numberOfFrames - 1])));
+}
+
+
+TEST(dataSetTest, testCachedValues)
+{
+    DataSet testDataSet("1.2.840.10008.1.2.1");
+
+    testDataSet.setString(TagId(tagId_t::PatientName_0010_0010), "Test^Patient");
+    testDataSet.setString(TagId(tagId_t::SliceThickness_0018_0050), "2.5", tagVR_t::DS);
+    testDataSet.setUnsignedLong(TagId(tagId_t::Rows_0028_0010), 512);
+
+    for(int repeat(0); repeat != 3; ++repeat)
+    {
+        EXPECT_EQ("Test^Patient", testDataSet.getString(TagId(tagId_t::PatientName_0010_0010), 0));
+        EXPECT_DOUBLE_EQ(2.5, testDataSet.getDouble(TagId(tagId_t::SliceThickness_0018_0050), 0));
+        EXPECT_EQ(2, testDataSet.getSignedLong(TagId(tagId_t::SliceThickness_0018_0050), 0));
+        EXPECT_EQ(512u, testDataSet.getUnsignedLong(TagId(tagId_t::Rows_0028_0010), 0));
+        EXPECT_EQ("512", testDataSet.getString(TagId(tagId_t::Rows_0028_0010), 0));
+    }
+
+    // Changes made through the dataset
+    ///////////////////////////////////////////////////////////
+    testDataSet.setString(TagId(tagId_t::PatientName_0010_0010), "Other^Patient");
+    testDataSet.setUnsignedLong(TagId(tagId_t::Rows_0028_0010), 256);
+    EXPECT_EQ("Other^Patient", testDataSet.getString(TagId(tagId_t::PatientName_0010_0010), 0));
+    EXPECT_EQ(256u, testDataSet.getUnsignedLong(TagId(tagId_t::Rows_0028_0010), 0));
+    EXPECT_EQ("256", testDataSet.getString(TagId(tagId_t::Rows_0028_0010), 0));
+
+    // Changes made through a tag's writing handler
+    ///////////////////////////////////////////////////////////
+    {
+        std::unique_ptr<Tag> thicknessTag(testDataSet.getTag(TagId(tagId_t::SliceThickness_0018_0050)));
+        std::unique_ptr<WritingDataHandler> handler(thicknessTag->getWritingDataHandler(0));
+        handler->setSize(2);
+        handler->setDouble(0, 7.5);
+        handler->setDouble(1, 3);
+    }
+    EXPECT_DOUBLE_EQ(7.5, testDataSet.getDouble(TagId(tagId_t::SliceThickness_0018_0050), 0));
+    EXPECT_DOUBLE_EQ(3, testDataSet.getDouble(TagId(tagId_t::SliceThickness_0018_0050), 1));
+    EXPECT_EQ(7, testDataSet.getSignedLong(TagId(tagId_t::SliceThickness_0018_0050), 0));
+
+    // Missing elements are not cached
+    ///////////////////////////////////////////////////////////
+    EXPECT_EQ(0u, testDataSet.getUnsignedLong(TagId(tagId_t::Columns_0028_0011), 0, 0));
+    testDataSet.setUnsignedLong(TagId(tagId_t::Columns_0028_0011), 128);
+    EXPECT_EQ(128u, testDataSet.getUnsignedLong(TagId(tagId_t::Columns_0028_0011), 0, 0));
+    EXPECT_THROW(testDataSet.getUnsignedLong(TagId(tagId_t::Columns_0028_0011), 1), MissingItemError);
+
+    // More elements than the cache's entries
+    ///////////////////////////////////////////////////////////
+    for(std::uint16_t tag(0x10); tag != 0x50; ++tag)
+    {
+        testDataSet.setUnsignedLong(TagId(0x0011, tag), tag, tagVR_t::UL);
+    }
+    for(int repeat(0); repeat != 2; ++repeat)
+    {
+        for(std::uint16_t tag(0x10); tag != 0x50; ++tag)
+        {
+            EXPECT_EQ(tag, testDataSet.getUnsignedLong(TagId(0x0011, tag), 0));
+        }
+    }
+
+    // Concurrent readers share the cache
+    ///////////////////////////////////////////////////////////
+    std::vector<std::thread> readers;
+    std::atomic<size_t> wrongValues(0);
+    for(size_t thread(0); thread != 4; ++thread)
+    {
+        readers.push_back(std::thread([&testDataSet, &wrongValues]()
+        {
+            for(int repeat(0); repeat != 100; ++repeat)
+            {
+                for(std::uint16_t tag(0x10); tag != 0x50; ++tag)
+                {
+                    if(testDataSet.getUnsignedLong(TagId(0x0011, tag), 0) != tag ||
+                            testDataSet.getString(TagId(tagId_t::PatientName_0010_0010), 0) != "Other^Patient")
+                    {
+                        ++wrongValues;
+                    }
+                }
+            }
+        }));
+    }
+    for(std::thread& reader: readers)
+    {
+        reader.join();
+    }
+    EXPECT_EQ(0u, wrongValues.load());
+}
+
 } // namespace tests
 
 } // namespace imebra
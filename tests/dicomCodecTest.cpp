@@ -3,6 +3,8 @@
 #include "testsSettings.h"
 #include <gtest/gtest.h>
 #include <limits>
+#include <functional>
+#include <algorithm>
 
 namespace imebra
 {
@@ -285,6 +287,232 @@ TEST(dicomCodecTest, testDicom32bit)
 }
 
 
+///////////////////////////////////////////////////////////
+//
+// Fill a byte plane with literals and runs of the lengths
+//  at the limits of the RLE encoder
+//
+///////////////////////////////////////////////////////////
+static std::vector<std::uint8_t> buildRLEPlane(size_t planeSize, size_t seed)
+{
+    const size_t lengths[] = {1, 2, 3, 4, 127, 128, 129, 130, 255, 256, 257};
+    const size_t lengthsCount(sizeof(lengths) / sizeof(lengths[0]));
+
+    std::vector<std::uint8_t> plane;
+    plane.reserve(planeSize + 2 * 257);
+    std::uint8_t literalValue((std::uint8_t)seed);
+    for(size_t block(seed); plane.size() < planeSize; ++block)
+    {
+        // Literal bytes: consecutive bytes are always different
+        for(size_t literal(lengths[block % lengthsCount]); literal != 0; --literal)
+        {
+            plane.push_back(literalValue);
+            literalValue = (std::uint8_t)(literalValue + 7);
+        }
+
+        // Run of identical bytes, different from the last
+        //  literal byte
+        plane.insert(plane.end(), lengths[(block * 5 + 3) % lengthsCount], (std::uint8_t)(literalValue + 3));
+    }
+    plane.resize(planeSize);
+    return plane;
+}
+
+
+TEST(dicomCodecTest, testRLEEdgeCases)
+{
+    struct rleFormat
+    {
+        bitDepth_t m_depth;
+        std::uint32_t m_sampleBytes;
+        const char* m_colorSpace;
+        std::uint32_t m_channels;
+    };
+
+    // 1, 2 and 4 byte planes per channel
+    const rleFormat formats[] =
+    {
+        {bitDepth_t::depthU8, 1, "MONOCHROME2", 1},
+        {bitDepth_t::depthU16, 2, "MONOCHROME2", 1},
+        {bitDepth_t::depthU32, 4, "MONOCHROME2", 1},
+        {bitDepth_t::depthU8, 1, "RGB", 3},
+        {bitDepth_t::depthU16, 2, "RGB", 3}
+    };
+
+    // Odd widths and rows longer than the literal and run
+    //  limits
+    const std::uint32_t widths[] = {1, 2, 131, 300};
+
+    for(const rleFormat& format: formats)
+    {
+        for(std::uint32_t width: widths)
+        {
+            const std::uint32_t height(5);
+            const size_t pixelsNumber((size_t)width * height);
+
+            std::unique_ptr<Image> image(new Image(width, height, format.m_depth, format.m_colorSpace, format.m_sampleBytes * 8 - 1));
+            {
+                std::unique_ptr<WritingDataHandlerNumeric> write(image->getWritingDataHandler());
+                for(std::uint32_t channel(0); channel != format.m_channels; ++channel)
+                {
+                    std::vector<std::uint32_t> values(pixelsNumber, 0);
+                    for(std::uint32_t planeByte(0); planeByte != format.m_sampleBytes; ++planeByte)
+                    {
+                        const std::vector<std::uint8_t> plane(buildRLEPlane(pixelsNumber, channel * 4 + planeByte));
+                        for(size_t pixel(0); pixel != pixelsNumber; ++pixel)
+                        {
+                            values[pixel] |= (std::uint32_t)plane[pixel] << (planeByte * 8);
+                        }
+                    }
+                    for(size_t pixel(0); pixel != pixelsNumber; ++pixel)
+                    {
+                        write->setUnsignedLong(pixel * format.m_channels + channel, values[pixel]);
+                    }
+                }
+            }
+
+            ReadWriteMemory streamMemory;
+            {
+                DataSet testDataSet("1.2.840.10008.1.2.5");
+                testDataSet.setImage(0, *image, imageQuality_t::veryHigh);
+
+                MemoryStreamOutput writeStream(streamMemory);
+                StreamWriter writer(writeStream);
+                CodecFactory::save(testDataSet, writer, codecType_t::dicom);
+            }
+
+            MemoryStreamInput readStream(streamMemory);
+            StreamReader reader(readStream);
+            std::unique_ptr<DataSet> testDataSet(CodecFactory::load(reader, std::numeric_limits<size_t>::max()));
+            std::unique_ptr<Image> checkImage(testDataSet->getImage(0));
+
+            ASSERT_TRUE(identicalImages(*checkImage, *image)) << format.m_colorSpace << " " << format.m_sampleBytes << " bytes, width " << width;
+        }
+    }
+}
+
+
+TEST(dicomCodecTest, testRLESubsampled)
+{
+    // The RLE codec doesn't store subsampled channels
+    std::unique_ptr<Image> image(buildImageForTest(32, 16, bitDepth_t::depthU8, 7, 32, 16, "YBR_FULL", 1));
+
+    DataSet testDataSet("1.2.840.10008.1.2.5");
+    EXPECT_THROW(testDataSet.setImage(0, *image, imageQuality_t::medium), CodecWrongFormatError);
+    EXPECT_THROW(testDataSet.setImage(0, *image, imageQuality_t::belowMedium), CodecWrongFormatError);
+
+    // Without subsampling the image is accepted
+    testDataSet.setImage(0, *image, imageQuality_t::veryHigh);
+    std::unique_ptr<Image> checkImage(testDataSet.getImage(0));
+    EXPECT_TRUE(identicalImages(*checkImage, *image));
+}
+
+
+///////////////////////////////////////////////////////////
+//
+// Pack the pixels one after the other, starting from the
+//  least significant bit of each byte
+//
+///////////////////////////////////////////////////////////
+static std::vector<std::uint8_t> packPixelsForTest(const std::vector<std::uint32_t>& values, std::uint32_t allocatedBits)
+{
+    std::vector<std::uint8_t> packedBytes((values.size() * allocatedBits + 7) / 8, 0);
+    for(size_t pixel(0); pixel != values.size(); ++pixel)
+    {
+        for(std::uint32_t bit(0); bit != allocatedBits; ++bit)
+        {
+            if(((values[pixel] >> bit) & 1) != 0)
+            {
+                const size_t position(pixel * allocatedBits + bit);
+                packedBytes[position / 8] |= (std::uint8_t)(1 << (position % 8));
+            }
+        }
+    }
+    return packedBytes;
+}
+
+
+TEST(dicomCodecTest, testPackedPixels)
+{
+    // Rows that don't end on a byte boundary
+    const std::uint32_t widths[] = {1, 3, 7, 9, 13, 17};
+    const std::uint32_t height(3);
+
+    for(std::uint32_t width: widths)
+    {
+        const size_t pixelsNumber((size_t)width * height);
+
+        // 1 bit pixels can't be written by setImage(): decode
+        //  a dataset built by hand
+        {
+            std::vector<std::uint32_t> values(pixelsNumber);
+            for(size_t pixel(0); pixel != pixelsNumber; ++pixel)
+            {
+                values[pixel] = (std::uint32_t)((pixel * 7 + pixel / 3) & 1);
+            }
+            const std::vector<std::uint8_t> packedBytes(packPixelsForTest(values, 1));
+
+            DataSet testDataSet("1.2.840.10008.1.2.1");
+            testDataSet.setString(TagId(tagId_t::PhotometricInterpretation_0028_0004), "MONOCHROME2");
+            testDataSet.setUnsignedLong(TagId(tagId_t::SamplesPerPixel_0028_0002), 1);
+            testDataSet.setUnsignedLong(TagId(tagId_t::Rows_0028_0010), height);
+            testDataSet.setUnsignedLong(TagId(tagId_t::Columns_0028_0011), width);
+            testDataSet.setUnsignedLong(TagId(tagId_t::BitsAllocated_0028_0100), 1);
+            testDataSet.setUnsignedLong(TagId(tagId_t::BitsStored_0028_0101), 1);
+            testDataSet.setUnsignedLong(TagId(tagId_t::HighBit_0028_0102), 0);
+            testDataSet.setUnsignedLong(TagId(tagId_t::PixelRepresentation_0028_0103), 0);
+            {
+                std::unique_ptr<WritingDataHandlerNumeric> pixelsHandler(testDataSet.getWritingDataHandlerRaw(TagId(tagId_t::PixelData_7FE0_0010), 0, tagVR_t::OB));
+                pixelsHandler->assign((const char*)packedBytes.data(), packedBytes.size());
+            }
+
+            std::unique_ptr<Image> checkImage(testDataSet.getImage(0));
+            std::unique_ptr<ReadingDataHandlerNumeric> read(checkImage->getReadingDataHandler());
+            for(size_t pixel(0); pixel != pixelsNumber; ++pixel)
+            {
+                ASSERT_EQ(values[pixel], read->getUnsignedLong(pixel)) << "1 bit, width " << width << ", pixel " << pixel;
+            }
+        }
+
+        // 12 bits packed and 32 bits pixels are packed by
+        //  setImage() and unpacked by getImage()
+        const std::uint32_t highBits[] = {11, 31};
+        for(std::uint32_t highBit: highBits)
+        {
+            const std::uint32_t allocatedBits(highBit + 1);
+            const std::uint64_t valuesNumber((std::uint64_t)1 << allocatedBits);
+
+            std::unique_ptr<Image> image(new Image(width, height, highBit > 15 ? bitDepth_t::depthU32 : bitDepth_t::depthU16, "MONOCHROME2", highBit));
+            std::vector<std::uint32_t> values(pixelsNumber);
+            {
+                std::unique_ptr<WritingDataHandlerNumeric> write(image->getWritingDataHandler());
+                for(size_t pixel(0); pixel != pixelsNumber; ++pixel)
+                {
+                    values[pixel] = (std::uint32_t)(((std::uint64_t)pixel * 2654435761u + 12345u) % valuesNumber);
+                    write->setUnsignedLong(pixel, values[pixel]);
+                }
+            }
+
+            DataSet testDataSet("1.2.840.10008.1.2.1");
+            testDataSet.setImage(0, *image, imageQuality_t::veryHigh);
+            ASSERT_EQ(allocatedBits, testDataSet.getUnsignedLong(TagId(tagId_t::BitsAllocated_0028_0100), 0));
+
+            const std::vector<std::uint8_t> expectedBytes(packPixelsForTest(values, allocatedBits));
+            {
+                std::unique_ptr<ReadingDataHandlerNumeric> pixelsHandler(testDataSet.getReadingDataHandlerRaw(TagId(tagId_t::PixelData_7FE0_0010), 0));
+                size_t pixelsSize(0);
+                const std::uint8_t* pPixels((const std::uint8_t*)pixelsHandler->data(&pixelsSize));
+                ASSERT_LE(expectedBytes.size(), pixelsSize);
+                EXPECT_TRUE(std::equal(expectedBytes.begin(), expectedBytes.end(), pPixels)) << "high bit " << highBit << ", width " << width;
+            }
+
+            std::unique_ptr<Image> checkImage(testDataSet.getImage(0));
+            EXPECT_TRUE(identicalImages(*checkImage, *image)) << "high bit " << highBit << ", width " << width;
+        }
+    }
+}
+
+
 TEST(dicomCodecTest, testImplicitPrivateTags)
 {
     ReadWriteMemory streamMemory;
@@ -314,6 +542,206 @@ TEST(dicomCodecTest, testImplicitPrivateTags)
 
 }
 
+
+TEST(dicomCodecTest, testLargeTags)
+{
+    const size_t valuesNumber(200000);
+
+    for(int transferSyntaxId(0); transferSyntaxId != 2; ++transferSyntaxId)
+    {
+        std::string transferSyntax(transferSyntaxId == 0 ? "1.2.840.10008.1.2.1" : "1.2.840.10008.1.2.2");
+
+        ReadWriteMemory streamMemory;
+        {
+            DataSet testDataSet(transferSyntax);
+            {
+                std::unique_ptr<WritingDataHandler> writeHandler(testDataSet.getWritingDataHandler(TagId(std::uint16_t(11), std::uint16_t(2)), 0, tagVR_t::OW));
+                writeHandler->setSize(valuesNumber);
+                for(size_t writeValue(0); writeValue != valuesNumber; ++writeValue)
+                {
+                    writeHandler->setUnsignedLong(writeValue, (std::uint32_t)(writeValue & 0xffff));
+                }
+            }
+            testDataSet.setString(TagId(tagId_t::PatientName_0010_0010), "Patient name");
+
+            MemoryStreamOutput writeStream(streamMemory);
+            StreamWriter writer(writeStream);
+            CodecFactory::save(testDataSet, writer, codecType_t::dicom);
+        }
+
+        {
+            MemoryStreamInput readStream(streamMemory);
+            StreamReader reader(readStream);
+            std::unique_ptr<DataSet> testDataSet(CodecFactory::load(reader, std::numeric_limits<size_t>::max()));
+
+            std::unique_ptr<ReadingDataHandler> readHandler(testDataSet->getReadingDataHandler(TagId(std::uint16_t(11), std::uint16_t(2)), 0));
+            ASSERT_EQ(valuesNumber, readHandler->getSize());
+            for(size_t readValue(0); readValue != valuesNumber; ++readValue)
+            {
+                ASSERT_EQ((std::uint32_t)(readValue & 0xffff), readHandler->getUnsignedLong(readValue));
+            }
+            EXPECT_EQ("Patient name", testDataSet->getString(TagId(tagId_t::PatientName_0010_0010), 0));
+        }
+
+        // Truncate the stream: the large tag cannot be loaded
+        ///////////////////////////////////////////////////////////
+        size_t streamSize(0);
+        streamMemory.data(&streamSize);
+        streamMemory.resize(streamSize - 1000);
+        {
+            MemoryStreamInput readStream(streamMemory);
+            StreamReader reader(readStream);
+            EXPECT_THROW(CodecFactory::load(reader, std::numeric_limits<size_t>::max()), StreamEOFError);
+        }
+    }
+}
+
+
+TEST(dicomCodecTest, testFormatDetection)
+{
+    ReadWriteMemory streamMemory;
+    {
+        DataSet testDataSet("1.2.840.10008.1.2.1");
+        testDataSet.setString(TagId(tagId_t::PatientName_0010_0010), "Patient name");
+
+        MemoryStreamOutput writeStream(streamMemory);
+        StreamWriter writer(writeStream);
+        CodecFactory::save(testDataSet, writer, codecType_t::dicom);
+    }
+
+    // Stream without the preamble and the DICM signature
+    ///////////////////////////////////////////////////////////
+    {
+        size_t streamSize(0);
+        const char* pStreamData(streamMemory.data(&streamSize));
+        ReadWriteMemory noPreambleMemory(pStreamData + 132, streamSize - 132);
+
+        MemoryStreamInput readStream(noPreambleMemory);
+        StreamReader reader(readStream);
+        std::unique_ptr<DataSet> testDataSet(CodecFactory::load(reader, std::numeric_limits<size_t>::max()));
+        EXPECT_EQ("Patient name", testDataSet->getString(TagId(tagId_t::PatientName_0010_0010), 0));
+    }
+
+    // Data that is neither DICOM nor jpeg, long and shorter
+    //  than the DICOM preamble
+    ///////////////////////////////////////////////////////////
+    for(size_t junkSize(1000); junkSize != 0; junkSize /= 10)
+    {
+        ReadWriteMemory junkMemory(std::string(junkSize, 'x').c_str(), junkSize);
+        MemoryStreamInput readStream(junkMemory);
+        StreamReader reader(readStream);
+        EXPECT_THROW(CodecFactory::load(reader, std::numeric_limits<size_t>::max()), CodecWrongFormatError);
+    }
+
+    // Empty stream
+    ///////////////////////////////////////////////////////////
+    {
+        ReadWriteMemory emptyMemory;
+        MemoryStreamInput readStream(emptyMemory);
+        StreamReader reader(readStream);
+        EXPECT_THROW(CodecFactory::load(reader, std::numeric_limits<size_t>::max()), CodecWrongFormatError);
+    }
+}
+
+///////////////////////////////////////////////////////////
+//
+// Decode a RLE image after corrupting its fragment
+//
+///////////////////////////////////////////////////////////
+static void decodeCorruptedRLE(const Image& image, const std::function<void(std::vector<std::uint32_t>& header, std::string& fragment)>& corrupt)
+{
+    DataSet testDataSet("1.2.840.10008.1.2.5");
+    testDataSet.setImage(0, image, imageQuality_t::veryHigh);
+
+    // The fragment starts with the RLE header: the number of
+    //  segments followed by 15 offsets
+    ///////////////////////////////////////////////////////////
+    std::string fragment;
+    {
+        std::unique_ptr<ReadingDataHandlerNumeric> fragmentHandler(testDataSet.getReadingDataHandlerRaw(TagId(tagId_t::PixelData_7FE0_0010), 1));
+        size_t fragmentSize(0);
+        const char* pFragment(fragmentHandler->data(&fragmentSize));
+        fragment.assign(pFragment, fragmentSize);
+    }
+    std::vector<std::uint32_t> header(16);
+    for(size_t scanHeader(0); scanHeader != header.size(); ++scanHeader)
+    {
+        for(size_t scanBytes(0); scanBytes != 4; ++scanBytes)
+        {
+            header[scanHeader] |= (std::uint32_t)(std::uint8_t)fragment[scanHeader * 4 + scanBytes] << (scanBytes * 8);
+        }
+    }
+
+    corrupt(header, fragment);
+
+    for(size_t scanHeader(0); scanHeader != header.size(); ++scanHeader)
+    {
+        for(size_t scanBytes(0); scanBytes != 4 && scanHeader * 4 + scanBytes < fragment.size(); ++scanBytes)
+        {
+            fragment[scanHeader * 4 + scanBytes] = (char)(std::uint8_t)(header[scanHeader] >> (scanBytes * 8));
+        }
+    }
+    if((fragment.size() & 1) != 0)
+    {
+        fragment.push_back(0);
+    }
+    {
+        std::unique_ptr<WritingDataHandlerNumeric> fragmentHandler(testDataSet.getWritingDataHandlerRaw(TagId(tagId_t::PixelData_7FE0_0010), 1));
+        fragmentHandler->assign(fragment.data(), fragment.size());
+    }
+
+    std::unique_ptr<Image> decodedImage(testDataSet.getImage(0));
+}
+
+
+TEST(dicomCodecTest, testCorruptedRLE)
+{
+    // 16 bits monochrome: two segments
+    std::unique_ptr<Image> image(buildImageForTest(31, 17, bitDepth_t::depthU16, 15, 31, 17, "MONOCHROME2", 1));
+
+    // The uncorrupted fragment is decoded
+    EXPECT_NO_THROW(decodeCorruptedRLE(*image, [](std::vector<std::uint32_t>&, std::string&){}));
+
+    // Wrong number of segments
+    EXPECT_THROW(decodeCorruptedRLE(*image, [](std::vector<std::uint32_t>& header, std::string&){ header[0] = 0; }), CodecCorruptedFileError);
+    EXPECT_THROW(decodeCorruptedRLE(*image, [](std::vector<std::uint32_t>& header, std::string&){ header[0] = 1; }), CodecCorruptedFileError);
+    EXPECT_THROW(decodeCorruptedRLE(*image, [](std::vector<std::uint32_t>& header, std::string&){ header[0] = 16; }), CodecCorruptedFileError);
+
+    // Segment offsets inside the header or decreasing
+    EXPECT_THROW(decodeCorruptedRLE(*image, [](std::vector<std::uint32_t>& header, std::string&){ header[1] = 32; }), CodecCorruptedFileError);
+    EXPECT_THROW(decodeCorruptedRLE(*image, [](std::vector<std::uint32_t>& header, std::string&){ header[2] = header[1] - 1; }), CodecCorruptedFileError);
+
+    // Segment offset after the end of the fragment
+    EXPECT_THROW(decodeCorruptedRLE(*image, [](std::vector<std::uint32_t>& header, std::string& fragment){ header[2] = (std::uint32_t)fragment.size() + 1000; }), CodecCorruptedFileError);
+
+    // Truncated first segment
+    EXPECT_THROW(decodeCorruptedRLE(*image, [](std::vector<std::uint32_t>& header, std::string&){ header[2] = header[1] + 2; }), CodecCorruptedFileError);
+
+    // Truncated last segment
+    EXPECT_THROW(decodeCorruptedRLE(*image, [](std::vector<std::uint32_t>& header, std::string& fragment){ fragment.resize(header[2] + 2); }), CodecCorruptedFileError);
+
+    // Literal run longer than the segment
+    EXPECT_THROW(decodeCorruptedRLE(*image, [](std::vector<std::uint32_t>& header, std::string& fragment){ fragment.resize(header[2] + 2); fragment[header[2]] = 0x7f; }), CodecCorruptedFileError);
+
+    // Literal run longer than the image, truncated at the end
+    //  of the image
+    EXPECT_NO_THROW(decodeCorruptedRLE(*image, [](std::vector<std::uint32_t>& header, std::string& fragment)
+    {
+        fragment.resize(header[2]);
+        for(size_t remainingBytes(31 * 17); remainingBytes != 0; )
+        {
+            const size_t copyBytes(std::min(remainingBytes, (size_t)128));
+            fragment.push_back((char)0x7f);
+            fragment.append(copyBytes, (char)0x55);
+            remainingBytes -= copyBytes;
+        }
+    }));
+
+    // Repeat run without the repeated byte
+    EXPECT_THROW(decodeCorruptedRLE(*image, [](std::vector<std::uint32_t>& header, std::string& fragment){ fragment.resize(header[2] + 1); fragment[header[2]] = (char)0x81; }), CodecCorruptedFileError);
+}
+
+
 } // namespace tests
 
 } // namespace imebra
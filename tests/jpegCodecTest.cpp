@@ -183,6 +183,305 @@ TEST(jpegCodecTest, testLossless)
     }
 }
 
+
+///////////////////////////////////////////////////////////
+//
+// Decode a lossless stream with all the predictors.
+// The encoder uses only the first predictor, so the
+//  stream's predictor is patched: the expected image is
+//  calculated from the differences stored in the stream
+//
+///////////////////////////////////////////////////////////
+TEST(jpegCodecTest, testLosslessPredictors)
+{
+    const std::uint32_t width(67);
+    const std::uint32_t height(41);
+
+    const bitDepth_t depths[] = {bitDepth_t::depthU8, bitDepth_t::depthS8, bitDepth_t::depthU16, bitDepth_t::depthU16, bitDepth_t::depthS16};
+    const std::uint32_t highBits[] = {7, 7, 11, 15, 15};
+
+    for(size_t scanDepths(0); scanDepths != sizeof(depths) / sizeof(depths[0]); ++scanDepths)
+    {
+        const bitDepth_t depth(depths[scanDepths]);
+        const std::uint32_t highBit(highBits[scanDepths]);
+        const bool bSigned(depth == bitDepth_t::depthS8 || depth == bitDepth_t::depthS16);
+
+        std::unique_ptr<Image> image(buildImageForTest(width, height, depth, highBit, 30, 20, "MONOCHROME2", 50));
+
+        ReadWriteMemory savedJpeg;
+        {
+            DataSet dataSet("1.2.840.10008.1.2.4.70");
+            dataSet.setImage(0, *image, imageQuality_t::veryHigh);
+
+            MemoryStreamOutput saveStream(savedJpeg);
+            StreamWriter writer(saveStream);
+            CodecFactory::save(dataSet, writer, codecType_t::dicom);
+        }
+
+        // The jpeg precision can be higher than the image's one
+        ///////////////////////////////////////////////////////////
+        std::uint32_t precisionHighBit;
+        {
+            MemoryStreamInput loadStream(savedJpeg);
+            StreamReader reader(loadStream);
+            std::unique_ptr<DataSet> readDataSet(CodecFactory::load(reader, 0xffff));
+            std::unique_ptr<Image> checkImage(readDataSet->getImage(0));
+            precisionHighBit = checkImage->getHighBit();
+        }
+        const std::int32_t mask(((std::int32_t)1 << (precisionHighBit + 1)) - 1);
+        const std::int32_t signBit((std::int32_t)1 << precisionHighBit);
+
+        // Samples masked to the precision, and the differences
+        //  calculated by the encoder with the first predictor
+        ///////////////////////////////////////////////////////////
+        std::vector<std::int32_t> samples(width * height);
+        {
+            std::unique_ptr<ReadingDataHandlerNumeric> imageHandler(image->getReadingDataHandler());
+            for(size_t scanSamples(0); scanSamples != samples.size(); ++scanSamples)
+            {
+                samples[scanSamples] = imageHandler->getSignedLong(scanSamples) & mask;
+            }
+        }
+        std::vector<std::int32_t> differences(width * height);
+        for(std::uint32_t y(0); y != height; ++y)
+        {
+            for(std::uint32_t x(0); x != width; ++x)
+            {
+                const size_t index(y * width + x);
+                std::int32_t prediction;
+                if(index == 0)
+                {
+                    prediction = signBit;
+                }
+                else if(x == 0)
+                {
+                    prediction = samples[index - width];
+                }
+                else
+                {
+                    prediction = samples[index - 1];
+                }
+                differences[index] = samples[index] - prediction;
+            }
+        }
+
+        // Find the predictor in the SOS tag
+        ///////////////////////////////////////////////////////////
+        size_t jpegSize(0);
+        char* pJpeg(savedJpeg.data(&jpegSize));
+        size_t predictorPosition(0);
+        for(size_t scanJpeg(0); scanJpeg + 8 < jpegSize; ++scanJpeg)
+        {
+            if((std::uint8_t)pJpeg[scanJpeg] == 0xff && (std::uint8_t)pJpeg[scanJpeg + 1] == 0xda)
+            {
+                predictorPosition = scanJpeg + 7;
+                break;
+            }
+        }
+        ASSERT_NE(0u, predictorPosition);
+        ASSERT_EQ(1, pJpeg[predictorPosition]);
+
+        for(std::int32_t predictor(1); predictor != 8; ++predictor)
+        {
+            pJpeg[predictorPosition] = (char)predictor;
+
+            std::vector<std::int32_t> expected(width * height);
+            for(std::uint32_t y(0); y != height; ++y)
+            {
+                for(std::uint32_t x(0); x != width; ++x)
+                {
+                    const size_t index(y * width + x);
+                    std::int32_t prediction;
+                    if(index == 0)
+                    {
+                        prediction = signBit;
+                    }
+                    else if(y == 0)
+                    {
+                        prediction = expected[index - 1];
+                    }
+                    else if(x == 0)
+                    {
+                        prediction = expected[index - width];
+                    }
+                    else
+                    {
+                        const std::int32_t ra(expected[index - 1]);
+                        const std::int32_t rb(expected[index - width]);
+                        const std::int32_t rc(expected[index - width - 1]);
+                        switch(predictor)
+                        {
+                        case 1: prediction = ra; break;
+                        case 2: prediction = rb; break;
+                        case 3: prediction = rc; break;
+                        case 4: prediction = ra + rb - rc; break;
+                        case 5: prediction = ra + ((rb - rc) >> 1); break;
+                        case 6: prediction = rb + ((ra - rc) >> 1); break;
+                        default: prediction = (ra + rb) >> 1; break;
+                        }
+                    }
+                    expected[index] = (differences[index] + prediction) & mask;
+                }
+            }
+
+            MemoryStreamInput loadStream(savedJpeg);
+            StreamReader reader(loadStream);
+            std::unique_ptr<DataSet> readDataSet(CodecFactory::load(reader, 0xffff));
+            std::unique_ptr<Image> checkImage(readDataSet->getImage(0));
+            std::unique_ptr<ReadingDataHandlerNumeric> checkHandler(checkImage->getReadingDataHandler());
+
+            size_t errors(0);
+            for(size_t scanSamples(0); scanSamples != expected.size(); ++scanSamples)
+            {
+                std::int32_t expectedValue(expected[scanSamples]);
+                if(bSigned && (expectedValue & signBit) != 0)
+                {
+                    expectedValue -= signBit << 1;
+                }
+                if(checkHandler->getSignedLong(scanSamples) != expectedValue)
+                {
+                    ++errors;
+                }
+            }
+            EXPECT_EQ(0u, errors) << "highBit=" << precisionHighBit << " signed=" << bSigned << " predictor=" << predictor;
+        }
+    }
+}
+
+
+TEST(jpegCodecTest, testLosslessColor)
+{
+    for(std::uint32_t planarConfiguration(0); planarConfiguration != 2; ++planarConfiguration)
+    {
+        for(std::uint32_t highBit(7); highBit <= 15; highBit += 8)
+        {
+            std::unique_ptr<Image> image(buildImageForTest(93, 57, highBit == 7 ? bitDepth_t::depthU8 : bitDepth_t::depthU16, highBit, 30, 20, "RGB", 50));
+
+            ReadWriteMemory savedJpeg;
+            {
+                DataSet dataSet("1.2.840.10008.1.2.4.70");
+                dataSet.setUnsignedLong(TagId(tagId_t::PlanarConfiguration_0028_0006), planarConfiguration);
+                dataSet.setImage(0, *image, imageQuality_t::veryHigh);
+
+                MemoryStreamOutput saveStream(savedJpeg);
+                StreamWriter writer(saveStream);
+                CodecFactory::save(dataSet, writer, codecType_t::dicom);
+            }
+
+            MemoryStreamInput loadStream(savedJpeg);
+            StreamReader reader(loadStream);
+            std::unique_ptr<DataSet> readDataSet(CodecFactory::load(reader, 0xffff));
+            std::unique_ptr<Image> checkImage(readDataSet->getImage(0));
+
+            EXPECT_TRUE(identicalImages(*image, *checkImage)) << "planarConfiguration=" << planarConfiguration << " highBit=" << highBit;
+        }
+    }
+}
+
+
+///////////////////////////////////////////////////////////
+//
+// Save a jpeg stream and return its content
+//
+///////////////////////////////////////////////////////////
+static std::string saveJpeg(const Image& image, const std::string& transferSyntax, std::uint32_t allocatedBits, bool bSubsampled, bool bInterleaved)
+{
+    ReadWriteMemory savedJpeg;
+    {
+        MemoryStreamOutput saveStream(savedJpeg);
+        StreamWriter writer(saveStream);
+        CodecFactory::saveImage(writer, image, transferSyntax, imageQuality_t::veryHigh, tagVR_t::OB, allocatedBits, bSubsampled, bSubsampled, bInterleaved, false);
+    }
+    size_t dataSize;
+    const char* pData = savedJpeg.data(&dataSize);
+    return std::string(pData, dataSize);
+}
+
+
+///////////////////////////////////////////////////////////
+//
+// Decode a jpeg stream
+//
+///////////////////////////////////////////////////////////
+static Image* loadJpeg(const std::string& jpeg)
+{
+    ReadMemory savedJpeg(jpeg.data(), jpeg.size());
+    MemoryStreamInput loadStream(savedJpeg);
+    StreamReader reader(loadStream);
+    std::unique_ptr<DataSet> readDataSet(CodecFactory::load(reader, 0xffff));
+    return readDataSet->getImage(0);
+}
+
+
+///////////////////////////////////////////////////////////
+//
+// The images encoded with restart intervals must decode
+//  to the same images encoded without them
+//
+///////////////////////////////////////////////////////////
+TEST(jpegCodecTest, testRestartIntervals)
+{
+    const std::uint32_t width(93);
+    const std::uint32_t height(203);
+
+    const char* transferSyntaxes[] = {"1.2.840.10008.1.2.4.50", "1.2.840.10008.1.2.4.51", "1.2.840.10008.1.2.4.70"};
+    const char* colorSpaces[] = {"MONOCHROME2", "YBR_FULL"};
+
+    for(size_t scanTransferSyntaxes(0); scanTransferSyntaxes != sizeof(transferSyntaxes) / sizeof(transferSyntaxes[0]); ++scanTransferSyntaxes)
+    {
+        const std::string transferSyntax(transferSyntaxes[scanTransferSyntaxes]);
+        const bool bLossless(scanTransferSyntaxes == 2);
+        const std::uint32_t highBit(scanTransferSyntaxes == 0 ? 7 : 11);
+
+        for(size_t scanColorSpaces(0); scanColorSpaces != sizeof(colorSpaces) / sizeof(colorSpaces[0]); ++scanColorSpaces)
+        {
+            std::unique_ptr<Image> image(buildImageForTest(width, height, highBit == 7 ? bitDepth_t::depthU8 : bitDepth_t::depthU16, highBit, 30, 20, colorSpaces[scanColorSpaces], 50));
+
+            for(int subsampled(0); subsampled != (bLossless || scanColorSpaces == 0 ? 1 : 2); ++subsampled)
+            {
+                for(int interleaved(0); interleaved != 2; ++interleaved)
+                {
+                    const std::string referenceJpeg(saveJpeg(*image, transferSyntax, highBit + 1, subsampled != 0, interleaved != 0));
+                    std::unique_ptr<Image> referenceImage(loadJpeg(referenceJpeg));
+
+                    for(std::uint32_t restartRows(1); restartRows <= 3; restartRows += 2)
+                    {
+                        CodecFactory::setJpegRestartInterval(restartRows);
+                        std::string restartJpeg;
+                        try
+                        {
+                            restartJpeg = saveJpeg(*image, transferSyntax, highBit + 1, subsampled != 0, interleaved != 0);
+                        }
+                        catch(...)
+                        {
+                            CodecFactory::setJpegRestartInterval(0);
+                            throw;
+                        }
+                        CodecFactory::setJpegRestartInterval(0);
+
+                        EXPECT_NE(std::string::npos, restartJpeg.find("\xff\xdd")) << "missing DRI tag";
+                        EXPECT_NE(std::string::npos, restartJpeg.find("\xff\xd0")) << "missing RST0 tag";
+                        if(restartRows == 1)
+                        {
+                            EXPECT_NE(std::string::npos, restartJpeg.find("\xff\xd7")) << "missing RST7 tag";
+                        }
+
+                        std::unique_ptr<Image> checkImage(loadJpeg(restartJpeg));
+                        EXPECT_TRUE(identicalImages(*referenceImage, *checkImage)) <<
+                            "transferSyntax=" << transferSyntax << " colorSpace=" << colorSpaces[scanColorSpaces] <<
+                            " subsampled=" << subsampled << " interleaved=" << interleaved << " restartRows=" << restartRows;
+                        if(bLossless)
+                        {
+                            EXPECT_TRUE(identicalImages(*image, *checkImage));
+                        }
+                    }
+                }
+            }
+        }
+    }
+}
+
+
 } // namespace tests
 
 } // namespace imebra
@@ -0,0 +1,159 @@
+#include <imebra/imebra.h>
+#include <gtest/gtest.h>
+#include "buildImageForTest.h"
+
+namespace imebra
+{
+
+namespace tests
+{
+
+TEST(multiFrameWriterTest, writeFrames)
+{
+    const size_t numberOfFrames(6);
+
+    const char* const transferSyntaxes[] =
+    {
+        "1.2.840.10008.1.2.4.70",
+        "1.2.840.10008.1.2.5",
+        "1.2.840.10008.1.2.1",
+        "1.2.840.10008.1.2",
+        "1.2.840.10008.1.2.2"
+    };
+
+    for(size_t transferSyntaxId(0); transferSyntaxId != sizeof(transferSyntaxes) / sizeof(transferSyntaxes[0]); ++transferSyntaxId)
+    {
+        const std::string transferSyntax(transferSyntaxes[transferSyntaxId]);
+        const bool bEncapsulated(transferSyntaxId < 2);
+
+        for(int depthId(0); depthId != 2; ++depthId)
+        {
+            if(depthId == 1 && transferSyntaxId == 0)
+            {
+                continue;
+            }
+            const bitDepth_t depth(depthId == 0 ? bitDepth_t::depthU8 : bitDepth_t::depthU16);
+            const std::uint32_t highBit(depthId == 0 ? 7 : 15);
+
+            for(int extendedOffsetTable(0); extendedOffsetTable != (bEncapsulated ? 2 : 1); ++extendedOffsetTable)
+            {
+                SCOPED_TRACE(transferSyntax);
+                SCOPED_TRACE(depthId);
+                SCOPED_TRACE(extendedOffsetTable);
+
+                std::vector<std::shared_ptr<Image> > images;
+
+                ReadWriteMemory streamMemory;
+                {
+                    DataSet header(transferSyntax);
+                    header.setString(TagId(tagId_t::PatientName_0010_0010), "Test^Patient");
+
+                    MemoryStreamOutput writeStream(streamMemory);
+                    StreamWriter writer(writeStream);
+                    MultiFrameWriter framesWriter(header, writer, numberOfFrames, imageQuality_t::veryHigh, extendedOffsetTable != 0);
+
+                    for(size_t frame(0); frame != numberOfFrames; ++frame)
+                    {
+                        images.push_back(std::shared_ptr<Image>(buildImageForTest(101, 77, depth, highBit, 101, 77, "MONOCHROME2", (std::uint32_t)(5 + frame))));
+                        framesWriter.appendImage(*images.back());
+                    }
+                    ASSERT_THROW(framesWriter.appendImage(*images.back()), DataSetWrongFrameError);
+
+                    framesWriter.close();
+
+                    // The writer stores the image attributes in the header
+                    ASSERT_EQ(numberOfFrames, header.getUnsignedLong(TagId(tagId_t::NumberOfFrames_0028_0008), 0));
+                }
+
+                MemoryStreamInput readStream(streamMemory);
+                StreamReader reader(readStream);
+                std::unique_ptr<DataSet> testDataSet(CodecFactory::load(reader, 1));
+
+                ASSERT_EQ("Test^Patient", testDataSet->getString(TagId(tagId_t::PatientName_0010_0010), 0));
+                ASSERT_EQ(numberOfFrames, testDataSet->getUnsignedLong(TagId(tagId_t::NumberOfFrames_0028_0008), 0));
+                ASSERT_EQ(transferSyntax, testDataSet->getString(TagId(tagId_t::TransferSyntaxUID_0002_0010), 0));
+
+                if(bEncapsulated)
+                {
+                    std::unique_ptr<ReadingDataHandlerNumeric> offsetTable(testDataSet->getReadingDataHandlerRaw(TagId(tagId_t::PixelData_7FE0_0010), 0));
+                    ASSERT_EQ(extendedOffsetTable != 0 ? 0 : numberOfFrames * 4, offsetTable->getSize());
+                    if(extendedOffsetTable != 0)
+                    {
+                        std::unique_ptr<ReadingDataHandlerNumeric> extendedOffsets(testDataSet->getReadingDataHandlerRaw(TagId(tagId_t::ExtendedOffsetTable_7FE0_0001), 0));
+                        std::unique_ptr<ReadingDataHandlerNumeric> extendedLengths(testDataSet->getReadingDataHandlerRaw(TagId(tagId_t::ExtendedOffsetTableLengths_7FE0_0002), 0));
+                        ASSERT_EQ(numberOfFrames * 8, extendedOffsets->getSize());
+                        ASSERT_EQ(numberOfFrames * 8, extendedLengths->getSize());
+                    }
+                }
+
+                // Read the frames in reverse order to use the offset tables
+                for(size_t frame(numberOfFrames); frame != 0; --frame)
+                {
+                    std::unique_ptr<Image> image(testDataSet->getImage(frame - 1));
+                    ASSERT_TRUE(identicalImages(*image, *images[frame - 1]));
+                }
+            }
+        }
+    }
+}
+
+
+TEST(multiFrameWriterTest, errors)
+{
+    ReadWriteMemory streamMemory;
+    MemoryStreamOutput writeStream(streamMemory);
+    StreamWriter writer(writeStream);
+
+    {
+        DataSet header("1.2.840.10008.1.2.1");
+        MultiFrameWriter framesWriter(header, writer, 3, imageQuality_t::veryHigh, false);
+
+        std::unique_ptr<Image> image(buildImageForTest(20, 10, bitDepth_t::depthU8, 7, 20, 10, "MONOCHROME2", 5));
+        framesWriter.appendImage(*image);
+
+        std::unique_ptr<Image> differentImage(buildImageForTest(21, 10, bitDepth_t::depthU8, 7, 21, 10, "MONOCHROME2", 5));
+        ASSERT_THROW(framesWriter.appendImage(*differentImage), DataSetDifferentFormatError);
+
+        framesWriter.appendImage(*image);
+        ASSERT_THROW(framesWriter.close(), DataSetWrongFrameError);
+    }
+
+    {
+        DataSet header("1.2.840.10008.1.2.1");
+        std::unique_ptr<Image> image(buildImageForTest(20, 10, bitDepth_t::depthU8, 7, 20, 10, "MONOCHROME2", 5));
+        header.setImage(0, *image, imageQuality_t::veryHigh);
+        ASSERT_THROW(MultiFrameWriter(header, writer, 3, imageQuality_t::veryHigh, false), DataSetWrongFrameError);
+    }
+
+    // Other tags in the pixel data group would be written twice
+    {
+        DataSet header("1.2.840.10008.1.2.1");
+        header.setUnsignedLong(TagId(0x7fe0, 0x0003), 1, tagVR_t::UL);
+        ASSERT_THROW(MultiFrameWriter(header, writer, 3, imageQuality_t::veryHigh, false), DataSetWrongFrameError);
+    }
+
+    // Tags in the groups that follow the pixel data would be
+    //  written before it
+    {
+        DataSet header("1.2.840.10008.1.2.1");
+        header.setString(TagId(0x7fe1, 0x0010), "PRIVATE CREATOR", tagVR_t::LO);
+        ASSERT_THROW(MultiFrameWriter(header, writer, 3, imageQuality_t::veryHigh, false), DataSetWrongFrameError);
+    }
+
+    {
+        DataSet header("1.2.840.10008.1.2.1");
+        header.setString(TagId(0xfffa, 0xfffa), "X", tagVR_t::LO);
+        ASSERT_THROW(MultiFrameWriter(header, writer, 3, imageQuality_t::veryHigh, false), DataSetWrongFrameError);
+    }
+
+    // Tags that precede the pixel data group are accepted
+    {
+        DataSet header("1.2.840.10008.1.2.1");
+        header.setString(TagId(0x7fdf, 0x0010), "PRIVATE CREATOR", tagVR_t::LO);
+        MultiFrameWriter framesWriter(header, writer, 1, imageQuality_t::veryHigh, false);
+    }
+}
+
+}
+
+}
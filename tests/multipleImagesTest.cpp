@@ -14,6 +14,7 @@ If you do not want to be bound by the GPL terms (such as the requirement
 #include <imebra/imebra.h>
 #include "buildImageForTest.h"
 #include <gtest/gtest.h>
+#include <string.h>
 
 namespace imebra
 {
@@ -107,6 +108,304 @@ TEST(multipleImagesTest, testLosslessImages)
     } // transferSyntaxId
 }
 
+
+TEST(multipleImagesTest, testRandomAccess)
+{
+    // Frames stored in one buffer, retrieved in reverse order.
+    // Odd sizes and packed bit depths produce frames that don't
+    //  end on a word boundary
+    const std::uint32_t numImages(7);
+
+    for(int transferSyntaxId(0); transferSyntaxId != 3; ++transferSyntaxId)
+    {
+        std::string transferSyntax;
+        switch(transferSyntaxId)
+        {
+        case 0:
+            transferSyntax = "1.2.840.10008.1.2";
+            break;
+        case 1:
+            transferSyntax = "1.2.840.10008.1.2.1";
+            break;
+        case 2:
+            transferSyntax = "1.2.840.10008.1.2.2";
+            break;
+        }
+
+        const std::uint32_t highBits[] = {2, 7, 11, 15};
+        for(std::uint32_t highBit: highBits)
+        {
+            for(int colorSpaceId(0); colorSpaceId != 2; ++colorSpaceId)
+            {
+                const std::string colorSpace(colorSpaceId == 0 ? "MONOCHROME2" : "YBR_FULL_422");
+                const bitDepth_t depth(highBit > 7 ? bitDepth_t::depthU16 : bitDepth_t::depthU8);
+
+                std::vector<std::shared_ptr<Image> > images;
+
+                ReadWriteMemory streamMemory;
+                {
+                    DataSet testDataSet(transferSyntax);
+
+                    for(std::uint32_t imageNumber(0); imageNumber != numImages; ++imageNumber)
+                    {
+                        std::shared_ptr<Image> dicomImage(buildImageForTest(33, 17, depth, highBit, 33, 17, colorSpace, 3 + imageNumber));
+                        testDataSet.setImage(imageNumber, *dicomImage, imageQuality_t::veryHigh);
+                        images.push_back(dicomImage);
+                    }
+
+                    MemoryStreamOutput writeStream(streamMemory);
+                    StreamWriter writer(writeStream);
+                    CodecFactory::save(testDataSet, writer, codecType_t::dicom);
+                }
+
+                MemoryStreamInput readStream(streamMemory);
+                StreamReader reader(readStream);
+                std::unique_ptr<DataSet> testDataSet(CodecFactory::load(reader));
+
+                for(std::uint32_t imageNumber(numImages); imageNumber != 0; --imageNumber)
+                {
+                    std::unique_ptr<Image> checkImage(testDataSet->getImage(imageNumber - 1));
+                    ASSERT_TRUE(identicalImages(*checkImage, *images[imageNumber - 1]));
+                }
+            }
+        }
+    }
+}
+
+
+TEST(multipleImagesTest, testParallelDecoding)
+{
+    const std::uint32_t numImages(12);
+
+    for(int transferSyntaxId(0); transferSyntaxId != 3; ++transferSyntaxId)
+    {
+        std::string transferSyntax;
+        switch(transferSyntaxId)
+        {
+        case 0:
+            transferSyntax = "1.2.840.10008.1.2.4.70";
+            break;
+        case 1:
+            transferSyntax = "1.2.840.10008.1.2.5";
+            break;
+        case 2:
+            transferSyntax = "1.2.840.10008.1.2.1";
+            break;
+        }
+
+        std::vector<std::shared_ptr<Image> > images;
+
+        ReadWriteMemory streamMemory;
+        {
+            DataSet testDataSet(transferSyntax);
+
+            for(std::uint32_t imageNumber(0); imageNumber != numImages; ++imageNumber)
+            {
+                std::shared_ptr<Image> dicomImage(buildImageForTest(101, 77, bitDepth_t::depthU8, 7, 101, 77, "MONOCHROME2", 5 + imageNumber));
+                testDataSet.setImage(imageNumber, *dicomImage, imageQuality_t::veryHigh);
+                images.push_back(dicomImage);
+            }
+
+            MemoryStreamOutput writeStream(streamMemory);
+            StreamWriter writer(writeStream);
+            CodecFactory::save(testDataSet, writer, codecType_t::dicom);
+        }
+
+        MemoryStreamInput readStream(streamMemory);
+        StreamReader reader(readStream);
+        std::unique_ptr<DataSet> testDataSet(CodecFactory::load(reader, 1));
+
+        std::vector<std::unique_ptr<Image> > allImages(testDataSet->getImages(0, numImages));
+        ASSERT_EQ(numImages, allImages.size());
+        for(std::uint32_t imageNumber(0); imageNumber != numImages; ++imageNumber)
+        {
+            ASSERT_TRUE(identicalImages(*allImages[imageNumber], *images[imageNumber]));
+        }
+
+        std::vector<std::unique_ptr<Image> > someImages(testDataSet->getImages(3, 4));
+        ASSERT_EQ(4u, someImages.size());
+        for(std::uint32_t imageNumber(0); imageNumber != 4; ++imageNumber)
+        {
+            ASSERT_TRUE(identicalImages(*someImages[imageNumber], *images[imageNumber + 3]));
+        }
+
+        ASSERT_THROW(testDataSet->getImages(numImages - 2, 3), DataSetImageDoesntExistError);
+    }
+}
+
+
+TEST(multipleImagesTest, testFramesCache)
+{
+    const std::uint32_t numImages(12);
+    const size_t frameSize(101 * 77);
+
+    std::vector<std::shared_ptr<Image> > images;
+
+    ReadWriteMemory streamMemory;
+    {
+        DataSet testDataSet("1.2.840.10008.1.2.4.70");
+
+        for(std::uint32_t imageNumber(0); imageNumber != numImages; ++imageNumber)
+        {
+            std::shared_ptr<Image> dicomImage(buildImageForTest(101, 77, bitDepth_t::depthU8, 7, 101, 77, "MONOCHROME2", 5 + imageNumber));
+            testDataSet.setImage(imageNumber, *dicomImage, imageQuality_t::veryHigh);
+            images.push_back(dicomImage);
+        }
+
+        MemoryStreamOutput writeStream(streamMemory);
+        StreamWriter writer(writeStream);
+        CodecFactory::save(testDataSet, writer, codecType_t::dicom);
+    }
+
+    MemoryStreamInput readStream(streamMemory);
+    StreamReader reader(readStream);
+    std::unique_ptr<DataSet> testDataSet(CodecFactory::load(reader, 1));
+
+    ASSERT_EQ(0u, testDataSet->getFramesCacheStatistics().cachedFrames);
+
+    // Play forward and backward with read-ahead: only the
+    //  first frame is a miss
+    testDataSet->enableFramesCache(numImages * frameSize, 3);
+    for(std::uint32_t imageNumber(0); imageNumber != numImages; ++imageNumber)
+    {
+        std::unique_ptr<Image> image(testDataSet->getImage(imageNumber));
+        ASSERT_TRUE(identicalImages(*image, *images[imageNumber]));
+    }
+    for(std::uint32_t imageNumber(numImages); imageNumber != 0; --imageNumber)
+    {
+        std::unique_ptr<Image> image(testDataSet->getImage(imageNumber - 1));
+        ASSERT_TRUE(identicalImages(*image, *images[imageNumber - 1]));
+    }
+
+    FramesCacheStatistics statistics(testDataSet->getFramesCacheStatistics());
+    ASSERT_EQ(1u, statistics.misses);
+    ASSERT_EQ(2 * numImages - 1, statistics.hits);
+    ASSERT_EQ(numImages, statistics.decodedFrames);
+    ASSERT_EQ(numImages, statistics.cachedFrames);
+    ASSERT_EQ(numImages * frameSize, statistics.usedMemory);
+    ASSERT_LE(statistics.maxDecodingTime, statistics.decodingTime);
+
+    testDataSet->resetFramesCacheStatistics();
+    statistics = testDataSet->getFramesCacheStatistics();
+    ASSERT_EQ(0u, statistics.hits);
+    ASSERT_EQ(0u, statistics.misses);
+    ASSERT_EQ(numImages, statistics.cachedFrames);
+
+    // Modifying the image attributes empties the cache
+    testDataSet->setString(TagId(tagId_t::PixelSpacing_0028_0030), "1");
+    ASSERT_EQ(0u, testDataSet->getFramesCacheStatistics().cachedFrames);
+
+    // The least recently used frames are discarded when the
+    //  budget is exceeded
+    testDataSet->enableFramesCache(3 * frameSize, 0);
+    for(std::uint32_t imageNumber(0); imageNumber != numImages; ++imageNumber)
+    {
+        std::unique_ptr<Image> image(testDataSet->getImage(imageNumber));
+        ASSERT_TRUE(identicalImages(*image, *images[imageNumber]));
+        statistics = testDataSet->getFramesCacheStatistics();
+        ASSERT_LE(statistics.usedMemory, 3 * frameSize);
+    }
+    ASSERT_EQ(numImages, testDataSet->getFramesCacheStatistics().misses);
+    std::unique_ptr<Image> lastImage(testDataSet->getImage(numImages - 1));
+    std::unique_ptr<Image> firstImage(testDataSet->getImage(0));
+    statistics = testDataSet->getFramesCacheStatistics();
+    ASSERT_EQ(1u, statistics.hits);
+    ASSERT_EQ(numImages + 1, statistics.misses);
+
+    ASSERT_THROW(testDataSet->getImage(numImages), DataSetImageDoesntExistError);
+
+    testDataSet->disableFramesCache();
+    ASSERT_EQ(0u, testDataSet->getFramesCacheStatistics().decodedFrames);
+    std::unique_ptr<Image> uncachedImage(testDataSet->getImage(5));
+    ASSERT_TRUE(identicalImages(*uncachedImage, *images[5]));
+}
+
+
+TEST(multipleImagesTest, testParallelEncoding)
+{
+    const std::uint32_t numImages(12);
+
+    const char* const transferSyntaxes[] =
+    {
+        "1.2.840.10008.1.2.4.70",
+        "1.2.840.10008.1.2.5",
+        "1.2.840.10008.1.2.1"
+    };
+    const size_t transferSyntaxesCount(sizeof(transferSyntaxes) / sizeof(transferSyntaxes[0]));
+
+    // The 8 bits frames have an odd length
+    const bitDepth_t depths[] = {bitDepth_t::depthU8, bitDepth_t::depthU16};
+    const std::uint32_t highBits[] = {7, 15};
+
+    for(size_t depthId(0); depthId != sizeof(depths) / sizeof(depths[0]); ++depthId)
+    {
+        std::vector<std::shared_ptr<Image> > images;
+        std::vector<const Image*> imagesPointers;
+        for(std::uint32_t imageNumber(0); imageNumber != numImages; ++imageNumber)
+        {
+            images.push_back(std::shared_ptr<Image>(buildImageForTest(101, 77, depths[depthId], highBits[depthId], 101, 77, "MONOCHROME2", 5 + imageNumber)));
+            imagesPointers.push_back(images.back().get());
+        }
+
+        for(size_t transferSyntaxId(0); transferSyntaxId != transferSyntaxesCount; ++transferSyntaxId)
+        {
+            const std::string transferSyntax(transferSyntaxes[transferSyntaxId]);
+
+            DataSet sequentialDataSet(transferSyntax);
+            for(std::uint32_t imageNumber(0); imageNumber != numImages; ++imageNumber)
+            {
+                sequentialDataSet.setImage(imageNumber, *images[imageNumber], imageQuality_t::veryHigh);
+            }
+
+            // Insert the first frames one by one, then the others
+            //  in one call
+            DataSet parallelDataSet(transferSyntax);
+            ASSERT_THROW(parallelDataSet.setImages(1, imagesPointers, imageQuality_t::veryHigh), DataSetWrongFrameError);
+            parallelDataSet.setImage(0, *images[0], imageQuality_t::veryHigh);
+            parallelDataSet.setImages(1, std::vector<const Image*>(imagesPointers.begin() + 1, imagesPointers.end()), imageQuality_t::veryHigh);
+
+            DataSet parallelDataSet1(transferSyntax);
+            parallelDataSet1.setImages(0, imagesPointers, imageQuality_t::veryHigh);
+
+            ReadWriteMemory sequentialMemory, parallelMemory, parallelMemory1;
+            {
+                MemoryStreamOutput sequentialStream(sequentialMemory);
+                StreamWriter sequentialWriter(sequentialStream);
+                CodecFactory::save(sequentialDataSet, sequentialWriter, codecType_t::dicom);
+
+                MemoryStreamOutput parallelStream(parallelMemory);
+                StreamWriter parallelWriter(parallelStream);
+                CodecFactory::save(parallelDataSet, parallelWriter, codecType_t::dicom);
+
+                MemoryStreamOutput parallelStream1(parallelMemory1);
+                StreamWriter parallelWriter1(parallelStream1);
+                CodecFactory::save(parallelDataSet1, parallelWriter1, codecType_t::dicom);
+            }
+            size_t sequentialSize, parallelSize, parallelSize1;
+            const char* pSequential(sequentialMemory.data(&sequentialSize));
+            const char* pParallel(parallelMemory.data(&parallelSize));
+            const char* pParallel1(parallelMemory1.data(&parallelSize1));
+            ASSERT_EQ(sequentialSize, parallelSize);
+            ASSERT_EQ(sequentialSize, parallelSize1);
+            ASSERT_EQ(0, ::memcmp(pSequential, pParallel, sequentialSize));
+            ASSERT_EQ(0, ::memcmp(pSequential, pParallel1, sequentialSize));
+
+            // Transcode to all the transfer syntaxes
+            for(size_t destinationId(0); destinationId != transferSyntaxesCount; ++destinationId)
+            {
+                DataSet transcodedDataSet(transferSyntaxes[destinationId]);
+                transcodedDataSet.transcodeImages(parallelDataSet, imageQuality_t::veryHigh);
+                ASSERT_EQ(numImages, transcodedDataSet.getUnsignedLong(TagId(tagId_t::NumberOfFrames_0028_0008), 0));
+                for(std::uint32_t imageNumber(0); imageNumber != numImages; ++imageNumber)
+                {
+                    std::unique_ptr<Image> image(transcodedDataSet.getImage(imageNumber));
+                    ASSERT_TRUE(identicalImages(*image, *images[imageNumber]));
+                }
+            }
+        }
+    }
+}
+
 }
 
 }
@@ -276,6 +276,53 @@ TEST(numericHandlerTest, testCopyTo)
 }
 
 
+TEST(numericHandlerTest, testViews)
+{
+    Image image(4, 3, bitDepth_t::depthU16, "RGB", 15);
+
+    {
+        std::unique_ptr<WritingDataHandlerNumeric> writingHandler(image.getWritingDataHandler());
+        WritingNumericView greenView(*writingHandler, 1, 3);
+        ASSERT_EQ(12u, greenView.getSize());
+        ASSERT_EQ(3u, greenView.getStride());
+        ASSERT_EQ(2u, greenView.getUnitSize());
+        ASSERT_FALSE(greenView.isSigned());
+        ASSERT_FALSE(greenView.isFloat());
+
+        ASSERT_THROW(greenView.data<std::int16_t>(), DataHandlerConversionError);
+        ASSERT_THROW(greenView.data<std::uint8_t>(), DataHandlerConversionError);
+
+        std::uint16_t* pGreen(greenView.data<std::uint16_t>());
+        for(size_t scanPixels(0); scanPixels != greenView.getSize(); ++scanPixels)
+        {
+            pGreen[scanPixels * greenView.getStride()] = (std::uint16_t)(scanPixels * 100u);
+        }
+        greenView.setUnsignedLong(11, 4000);
+        ASSERT_THROW(greenView.setUnsignedLong(12, 0), MissingItemError);
+    }
+
+    std::unique_ptr<ReadingDataHandlerNumeric> readingHandler(image.getReadingDataHandler());
+    std::unique_ptr<ReadingNumericView> view(new ReadingNumericView(*readingHandler));
+    readingHandler.reset();
+
+    ASSERT_EQ(36u, view->getSize());
+    ASSERT_EQ(1u, view->getStride());
+    const std::uint16_t* pValues(view->data<std::uint16_t>());
+    for(size_t scanPixels(0); scanPixels != 11; ++scanPixels)
+    {
+        ASSERT_EQ(scanPixels * 100u, pValues[scanPixels * 3 + 1]);
+        ASSERT_EQ(scanPixels * 100u, view->getUnsignedLong(scanPixels * 3 + 1));
+    }
+    ASSERT_EQ(4000.0, view->getDouble(34));
+    ASSERT_THROW(view->getDouble(36), MissingItemError);
+
+    readingHandler.reset(image.getReadingDataHandler());
+    ReadingNumericView emptyView(*readingHandler, 36, 1);
+    ASSERT_EQ(0u, emptyView.getSize());
+    ASSERT_EQ(0, emptyView.data<std::uint16_t>());
+    ASSERT_THROW(ReadingNumericView(*readingHandler, 37, 1), MissingItemError);
+    ASSERT_THROW(ReadingNumericView(*readingHandler, 0, 0), MissingItemError);
+}
 
 
 } // namespace tests
@@ -0,0 +1,75 @@
+#include <imebra/imebra.h>
+#include <gtest/gtest.h>
+#include <thread>
+#include <cstdio>
+#include "buildImageForTest.h"
+
+namespace imebra
+{
+
+namespace tests
+{
+
+TEST(statisticsTest, testCounters)
+{
+    const std::uint32_t width(60);
+    const std::uint32_t height(40);
+
+    std::unique_ptr<Image> rgbImage(buildImageForTest(width, height, bitDepth_t::depthU8, 7, 30, 20, "RGB", 50));
+
+    std::unique_ptr<Transform> colorTransform(ColorTransformsFactory::getTransform("RGB", "YBR_FULL"));
+    std::unique_ptr<Image> ybrImage(colorTransform->allocateOutputImage(*rgbImage, width, height));
+
+    {
+        DataSet dataSet("1.2.840.10008.1.2.1");
+        dataSet.setImage(0, *rgbImage, imageQuality_t::veryHigh);
+        CodecFactory::save(dataSet, "testStatistics.dcm", codecType_t::dicom);
+    }
+
+    Statistics::resetStatistics();
+
+    // Transforms executed in another thread are counted too
+    ///////////////////////////////////////////////////////////
+    std::thread transformThread([&]()
+    {
+        colorTransform->runTransform(*rgbImage, 0, 0, width, height, *ybrImage, 0, 0);
+    });
+    transformThread.join();
+
+    std::unique_ptr<DataSet> loadedDataSet(CodecFactory::load("testStatistics.dcm"));
+    std::unique_ptr<Image> loadedImage(loadedDataSet->getImage(0));
+
+    LibraryStatistics statistics(Statistics::getStatistics());
+
+    loadedImage.reset();
+    loadedDataSet.reset();
+    EXPECT_EQ(0, std::remove("testStatistics.dcm"));
+
+    if(!Statistics::isEnabled())
+    {
+        EXPECT_EQ(0u, statistics.fileBytesRead);
+        EXPECT_EQ(0u, statistics.parsedElements);
+        EXPECT_EQ(0u, statistics.transformInvocations);
+        return;
+    }
+
+    EXPECT_GT(statistics.fileBytesRead, (std::uint64_t)width * height * 3u);
+    EXPECT_GT(statistics.parsedElements, 0u);
+    EXPECT_EQ(1u, statistics.dicomDecodedFrames);
+    EXPECT_EQ((std::uint64_t)width * height, statistics.dicomDecodedPixels);
+    EXPECT_EQ(0u, statistics.jpegDecodedFrames);
+    EXPECT_EQ(1u, statistics.transformInvocations);
+    EXPECT_EQ((std::uint64_t)width * height, statistics.transformedPixels);
+
+    Statistics::resetStatistics();
+    statistics = Statistics::getStatistics();
+    EXPECT_EQ(0u, statistics.fileBytesRead);
+    EXPECT_EQ(0u, statistics.parsedElements);
+    EXPECT_EQ(0u, statistics.dicomDecodedFrames);
+    EXPECT_EQ(0u, statistics.transformInvocations);
+    EXPECT_EQ(0u, statistics.transformedPixels);
+}
+
+} // namespace tests
+
+} // namespace imebra
@@ -413,6 +413,93 @@ TEST(stringHandlerTest, CSTest)
 }
 
 
+TEST(stringHandlerTest, stringView)
+{
+    DataSet testDataSet;
+
+    {
+        std::unique_ptr<WritingDataHandler> writingHandler(testDataSet.getWritingDataHandler(TagId(0x0008, 0x1150), 0, tagVR_t::UI));
+        writingHandler->setString(0, "1.2.840.10008.5.1.4.1.1.2");
+    }
+    {
+        std::unique_ptr<WritingDataHandler> writingHandler(testDataSet.getWritingDataHandler(TagId(0x0028, 0x1051), 0, tagVR_t::DS));
+        writingHandler->setString(0, "10.5");
+        writingHandler->setString(1, "");
+        writingHandler->setString(2, "-3");
+    }
+    testDataSet.setString(TagId(0x0010, 0x0010), "PATIENT", tagVR_t::PN);
+
+    size_t length(0);
+
+    std::unique_ptr<ReadingDataHandler> uidHandler(testDataSet.getReadingDataHandler(TagId(0x0008, 0x1150), 0));
+    ASSERT_EQ(1u, uidHandler->getSize());
+    const char* pUid(uidHandler->getStringView(0, &length));
+    ASSERT_EQ("1.2.840.10008.5.1.4.1.1.2", std::string(pUid, length));
+    ASSERT_THROW(uidHandler->getStringView(1, &length), MissingItemError);
+
+    std::unique_ptr<ReadingDataHandler> dsHandler(testDataSet.getReadingDataHandler(TagId(0x0028, 0x1051), 0));
+    ASSERT_EQ(3u, dsHandler->getSize());
+    const char* pValue(dsHandler->getStringView(0, &length));
+    ASSERT_EQ("10.5", std::string(pValue, length));
+    dsHandler->getStringView(1, &length);
+    ASSERT_EQ(0u, length);
+    pValue = dsHandler->getStringView(2, &length);
+    ASSERT_EQ("-3", std::string(pValue, length));
+    ASSERT_EQ("-3", dsHandler->getString(2));
+    ASSERT_THROW(dsHandler->getStringView(3, &length), MissingItemError);
+
+    std::unique_ptr<ReadingDataHandler> pnHandler(testDataSet.getReadingDataHandler(TagId(0x0010, 0x0010), 0));
+    ASSERT_THROW(pnHandler->getStringView(0, &length), DataHandlerConversionError);
+}
+
+
+TEST(stringHandlerTest, getDoubles)
+{
+    DataSet testDataSet;
+
+    {
+        std::unique_ptr<WritingDataHandler> writingHandler(testDataSet.getWritingDataHandler(TagId(0x3006, 0x0050), 0, tagVR_t::DS));
+        writingHandler->setString(0, "1.5");
+        writingHandler->setString(1, "-2e3");
+        writingHandler->setString(2, " 0.1");
+        writingHandler->setString(3, "123456.7890123");
+        writingHandler->setDouble(4, 0.25);
+    }
+    {
+        std::unique_ptr<WritingDataHandler> writingHandler(testDataSet.getWritingDataHandler(TagId(0x0020, 0x0013), 0, tagVR_t::IS));
+        writingHandler->setSignedLong(0, -12);
+        writingHandler->setString(1, "+7");
+    }
+
+    ASSERT_EQ("0.25", testDataSet.getString(TagId(0x3006, 0x0050), 4));
+    ASSERT_EQ("-12", testDataSet.getString(TagId(0x0020, 0x0013), 0));
+
+    std::unique_ptr<ReadingDataHandler> dsHandler(testDataSet.getReadingDataHandler(TagId(0x3006, 0x0050), 0));
+    ASSERT_EQ(5u, dsHandler->getDoubles(0, 0));
+    double values[5] = {0, 0, 0, 0, 0};
+    ASSERT_EQ(5u, dsHandler->getDoubles(values, 4));
+    ASSERT_EQ(0.0, values[0]);
+    ASSERT_EQ(5u, dsHandler->getDoubles(values, 5));
+    ASSERT_EQ(1.5, values[0]);
+    ASSERT_EQ(-2000.0, values[1]);
+    ASSERT_EQ(0.1, values[2]);
+    ASSERT_EQ(123456.7890123, values[3]);
+    ASSERT_EQ(0.25, values[4]);
+    ASSERT_EQ(-2000, dsHandler->getSignedLong(1));
+
+    std::unique_ptr<ReadingDataHandler> isHandler(testDataSet.getReadingDataHandler(TagId(0x0020, 0x0013), 0));
+    ASSERT_EQ(2u, isHandler->getDoubles(values, 5));
+    ASSERT_EQ(-12.0, values[0]);
+    ASSERT_EQ(7.0, values[1]);
+    ASSERT_EQ(4294967284u, isHandler->getUnsignedLong(0));
+
+    testDataSet.setString(TagId(0x0020, 0x0013), "abc", tagVR_t::IS);
+    ASSERT_THROW(testDataSet.getSignedLong(TagId(0x0020, 0x0013), 0), DataHandlerConversionError);
+    testDataSet.setString(TagId(0x0020, 0x0013), "4294967296", tagVR_t::IS);
+    ASSERT_THROW(testDataSet.getSignedLong(TagId(0x0020, 0x0013), 0), DataHandlerConversionError);
+}
+
+
 TEST(stringHandlerTest, ASTest)
 {
     imebra::DataSet dataSet;
@@ -0,0 +1,83 @@
+#include <imebra/imebra.h>
+#include <gtest/gtest.h>
+#include <thread>
+#include <fstream>
+#include <iterator>
+#include <cstdio>
+#include "buildImageForTest.h"
+
+namespace imebra
+{
+
+namespace tests
+{
+
+TEST(tracingTest, testSpans)
+{
+    const std::uint32_t width(60);
+    const std::uint32_t height(40);
+
+    std::unique_ptr<Image> rgbImage(buildImageForTest(width, height, bitDepth_t::depthU8, 7, 30, 20, "RGB", 50));
+
+    {
+        DataSet dataSet("1.2.840.10008.1.2.1");
+        dataSet.setImage(0, *rgbImage, imageQuality_t::veryHigh);
+        CodecFactory::save(dataSet, "testTracing.dcm", codecType_t::dicom);
+    }
+
+    Tracing::clear();
+
+    // Nothing is recorded while the tracing is disabled
+    ///////////////////////////////////////////////////////////
+    ASSERT_FALSE(Tracing::isEnabled());
+    {
+        std::unique_ptr<DataSet> loadedDataSet(CodecFactory::load("testTracing.dcm"));
+        std::unique_ptr<Image> loadedImage(loadedDataSet->getImage(0));
+    }
+    EXPECT_EQ(std::string::npos, Tracing::getChromeTrace().find("\"name\""));
+
+    Tracing::setEnabled(true);
+    ASSERT_TRUE(Tracing::isEnabled());
+
+    std::unique_ptr<DataSet> loadedDataSet(CodecFactory::load("testTracing.dcm"));
+    std::unique_ptr<Image> loadedImage(loadedDataSet->getImage(0));
+
+    // Spans recorded by other threads are exported too, also
+    //  after the threads terminate
+    ///////////////////////////////////////////////////////////
+    std::thread drawThread([&]()
+    {
+        DrawBitmap drawBitmap;
+        std::unique_ptr<ReadWriteMemory> bitmap(drawBitmap.getBitmap(*loadedImage, drawBitmapType_t::drawBitmapRGB, 4));
+    });
+    drawThread.join();
+
+    Tracing::setEnabled(false);
+
+    std::string trace(Tracing::getChromeTrace());
+    EXPECT_EQ(0u, trace.find("{\"traceEvents\":["));
+    EXPECT_NE(std::string::npos, trace.find("\"name\":\"codecFactory::load\""));
+    EXPECT_NE(std::string::npos, trace.find("\"name\":\"dicomStreamCodec::parseStream\""));
+    EXPECT_NE(std::string::npos, trace.find("\"name\":\"dicomImageCodec::getImage\""));
+    EXPECT_NE(std::string::npos, trace.find("\"name\":\"drawBitmap::getBitmap\""));
+    EXPECT_NE(std::string::npos, trace.find("\"ph\":\"X\""));
+
+    Tracing::saveChromeTrace("testTracing.json");
+    {
+        std::ifstream traceFile("testTracing.json", std::ios::binary);
+        std::string savedTrace((std::istreambuf_iterator<char>(traceFile)), std::istreambuf_iterator<char>());
+        EXPECT_EQ(trace, savedTrace);
+    }
+
+    Tracing::clear();
+    EXPECT_EQ(std::string::npos, Tracing::getChromeTrace().find("\"name\""));
+
+    loadedImage.reset();
+    loadedDataSet.reset();
+    EXPECT_EQ(0, std::remove("testTracing.dcm"));
+    EXPECT_EQ(0, std::remove("testTracing.json"));
+}
+
+} // namespace tests
+
+} // namespace imebra
@@ -1,5 +1,6 @@
 #include <imebra/imebra.h>
 #include <gtest/gtest.h>
+#include <cstring>
 
 namespace imebra
 {
@@ -160,6 +161,219 @@ TEST(unicodeStringHandlerTest, unicodeNumericConversion)
 }
 
 
+// Return the wide representation of a code point (a surrogate pair when
+//  wchar_t has 16 bits)
+///////////////////////////////////////////////////////////
+static std::wstring codePointToWide(std::uint32_t codePoint)
+{
+    std::wstring wide;
+    if(sizeof(wchar_t) == 2 && codePoint >= 0x10000)
+    {
+        codePoint -= 0x10000;
+        wide.push_back((wchar_t)(0xd800 + (codePoint >> 10)));
+        wide.push_back((wchar_t)(0xdc00 + (codePoint & 0x3ff)));
+    }
+    else
+    {
+        wide.push_back((wchar_t)codePoint);
+    }
+    return wide;
+}
+
+
+// Save a dataset containing the patient name, replace the bytes
+//  placeholder with replacement in the stream (same size) and load it
+//  again
+///////////////////////////////////////////////////////////
+static DataSet* loadPatchedDataSet(const charsetsList_t& charsets, const std::wstring& patientName, const std::string& placeholder, const std::string& replacement)
+{
+    ReadWriteMemory streamMemory;
+    {
+        DataSet testDataSet("1.2.840.10008.1.2.1", charsets);
+        testDataSet.setUnicodeString(TagId(0x10, 0x10), patientName);
+
+        MemoryStreamOutput writeStream(streamMemory);
+        StreamWriter writer(writeStream);
+        CodecFactory::save(testDataSet, writer, codecType_t::dicom);
+    }
+
+    size_t dataSize(0);
+    char* pData(streamMemory.data(&dataSize));
+    const std::string::size_type position(std::string(pData, dataSize).find(placeholder));
+    EXPECT_NE(std::string::npos, position);
+    if(position != std::string::npos)
+    {
+        ::memcpy(pData + position, replacement.data(), replacement.size());
+    }
+
+    MemoryStreamInput readStream(streamMemory);
+    StreamReader reader(readStream);
+    return CodecFactory::load(reader);
+}
+
+
+TEST(unicodeStringHandlerTest, utf8RoundTrip)
+{
+    struct utf8Sequence
+    {
+        std::uint32_t m_codePoint;
+        const char* m_utf8;
+    };
+
+    // 2, 3 and 4 bytes sequences, including the boundaries of each length
+    const utf8Sequence sequences[] = {
+        {0x80, "\xc2\x80"},
+        {0xe9, "\xc3\xa9"},
+        {0x7ff, "\xdf\xbf"},
+        {0x800, "\xe0\xa0\x80"},
+        {0x20ac, "\xe2\x82\xac"},
+        {0x4e2d, "\xe4\xb8\xad"},
+        {0xffff, "\xef\xbf\xbf"},
+        {0x10000, "\xf0\x90\x80\x80"},
+        {0x1f600, "\xf0\x9f\x98\x80"},
+        {0x10ffff, "\xf4\x8f\xbf\xbf"}
+    };
+
+    charsetsList_t charsets;
+    charsets.push_back("ISO_IR 192");
+
+    std::wstring allWide;
+    std::string allUtf8;
+    for(const utf8Sequence& sequence: sequences)
+    {
+        const std::wstring wide(L"a" + codePointToWide(sequence.m_codePoint) + L"b");
+        const std::string utf8(std::string("a") + sequence.m_utf8 + "b");
+        allWide += wide;
+        allUtf8 += utf8;
+
+        DataSet testDataSet("1.2.840.10008.1.2.1", charsets);
+
+        testDataSet.setUnicodeString(TagId(0x10, 0x10), wide);
+        EXPECT_EQ(utf8, testDataSet.getString(TagId(0x10, 0x10), 0));
+        EXPECT_EQ(wide, testDataSet.getUnicodeString(TagId(0x10, 0x10), 0));
+
+        testDataSet.setString(TagId(0x10, 0x10), utf8);
+        EXPECT_EQ(wide, testDataSet.getUnicodeString(TagId(0x10, 0x10), 0));
+    }
+
+    std::unique_ptr<DataSet> testDataSet(loadPatchedDataSet(charsets, allWide, "ISO_IR 192", "ISO_IR 192"));
+    EXPECT_EQ(allWide, testDataSet->getUnicodeString(TagId(0x10, 0x10), 0));
+}
+
+
+TEST(unicodeStringHandlerTest, invalidUtf8)
+{
+    charsetsList_t charsets;
+    charsets.push_back("ISO_IR 192");
+
+    // Overlong, surrogate, truncated, unexpected continuation and
+    //  out of range sequences are rejected by the UTF-8 decoder and
+    //  handed to the charset converter
+    const char* invalidSequences[] = {
+        "a\xc0\xaf" "b",
+        "a\xed\xa0\x80" "b",
+        "a\xe2\x82",
+        "a\x80" "b",
+        "a\xf4\x90\x80\x80" "b"
+    };
+
+    for(const char* invalidSequence: invalidSequences)
+    {
+        const std::string invalid(invalidSequence);
+        const std::string placeholder(invalid.size(), '#');
+        std::unique_ptr<DataSet> testDataSet(loadPatchedDataSet(charsets, std::wstring(placeholder.begin(), placeholder.end()), placeholder, invalid));
+
+        std::wstring patientName;
+        EXPECT_NO_THROW(patientName = testDataSet->getUnicodeString(TagId(0x10, 0x10), 0));
+
+        // The overlong "/" must not be decoded, neither the encoded
+        //  surrogate
+        EXPECT_EQ(std::wstring::npos, patientName.find(L'/'));
+        for(wchar_t character: patientName)
+        {
+            EXPECT_TRUE(sizeof(wchar_t) == 2 || (std::uint32_t)character < 0xd800 || (std::uint32_t)character > 0xdfff);
+        }
+    }
+}
+
+
+TEST(unicodeStringHandlerTest, asciiFastPath)
+{
+    const std::wstring asciiName(L"Smith^John^Q");
+    const std::wstring latinName(L"M\x00fcller^Jos\x00e9");
+
+    {
+        charsetsList_t charsets;
+        charsets.push_back("ISO_IR 100");
+        DataSet testDataSet("1.2.840.10008.1.2.1", charsets);
+
+        testDataSet.setUnicodeString(TagId(0x10, 0x10), asciiName);
+        EXPECT_EQ("Smith^John^Q", testDataSet.getString(TagId(0x10, 0x10), 0));
+        EXPECT_EQ(asciiName, testDataSet.getUnicodeString(TagId(0x10, 0x10), 0));
+
+        testDataSet.setUnicodeString(TagId(0x10, 0x10), latinName);
+        EXPECT_EQ(latinName, testDataSet.getUnicodeString(TagId(0x10, 0x10), 0));
+
+        std::unique_ptr<DataSet> loadedDataSet(loadPatchedDataSet(charsets, latinName, "ISO_IR 100", "ISO_IR 100"));
+        EXPECT_EQ(latinName, loadedDataSet->getUnicodeString(TagId(0x10, 0x10), 0));
+    }
+
+    {
+        // Multiple charsets: the ASCII strings take the fast path, the
+        //  other ones need the escape sequences
+        charsetsList_t charsets;
+        charsets.push_back("ISO 2022 IR 6");
+        charsets.push_back("ISO 2022 IR 100");
+
+        std::unique_ptr<DataSet> asciiDataSet(loadPatchedDataSet(charsets, asciiName, "Smith", "Smith"));
+        EXPECT_EQ(asciiName, asciiDataSet->getUnicodeString(TagId(0x10, 0x10), 0));
+
+        std::unique_ptr<DataSet> latinDataSet(loadPatchedDataSet(charsets, asciiName, "Smith^John^Q", "\x1b\x2d\x41" "M\xfcller^Jo"));
+        EXPECT_EQ(L"M\x00fcller^Jo", latinDataSet->getUnicodeString(TagId(0x10, 0x10), 0));
+    }
+}
+
+
+TEST(unicodeStringHandlerTest, unsupportedCharsetIsNotCached)
+{
+    // Unsupported tables must throw on each conversion: the failed
+    //  converter is never stored in the cache
+    const char* unsupportedCharsets[] = {"ISO_IR 159", "ISO_IR 13 ", "ISO_IR 87 "};
+
+    charsetsList_t charsets;
+    charsets.push_back("ISO_IR 100");
+
+    for(const char* unsupportedCharset: unsupportedCharsets)
+    {
+        bool bFirstThrew(false);
+        for(size_t attempt(0); attempt != 3; ++attempt)
+        {
+            std::unique_ptr<DataSet> testDataSet(loadPatchedDataSet(charsets, L"a\x00e9" L"b", "ISO_IR 100", unsupportedCharset));
+            bool bThrew(false);
+            try
+            {
+                testDataSet->getUnicodeString(TagId(0x10, 0x10), 0);
+            }
+            catch(const CharsetConversionNoSupportedTableError&)
+            {
+                bThrew = true;
+            }
+            if(attempt == 0)
+            {
+                bFirstThrew = bThrew;
+            }
+            EXPECT_EQ(bFirstThrew, bThrew);
+        }
+    }
+
+    for(size_t attempt(0); attempt != 3; ++attempt)
+    {
+        std::unique_ptr<DataSet> testDataSet(loadPatchedDataSet(charsets, L"a\x00e9" L"b", "ISO_IR 100", "ISO_IR 999"));
+        EXPECT_THROW(testDataSet->getUnicodeString(TagId(0x10, 0x10), 0), CharsetConversionNoTableError);
+    }
+}
+
+
 
 } // namespace tests
 
@@ -42,6 +42,8 @@
 ////////////////////////////////////////////////////////
 %newobject imebra::CodecFactory::load;
 
+%newobject imebra::BatchLoader::getDataSet;
+
 %newobject imebra::ColorTransformsFactory::getTransform;
 
 %newobject imebra::DataSet::getTag;
@@ -152,6 +154,8 @@
 %include "../library/include/imebra/readMemory.h"
 %include "../library/include/imebra/readWriteMemory.h"
 %include "../library/include/imebra/memoryPool.h"
+%include "../library/include/imebra/statistics.h"
+%include "../library/include/imebra/tracing.h"
 %include "../library/include/imebra/baseStreamInput.h"
 %include "../library/include/imebra/baseStreamOutput.h"
 %include "../library/include/imebra/streamReader.h"
@@ -160,6 +164,8 @@
 %include "../library/include/imebra/readingDataHandlerNumeric.h"
 %include "../library/include/imebra/writingDataHandler.h"
 %include "../library/include/imebra/writingDataHandlerNumeric.h"
+%include "../library/include/imebra/readingNumericView.h"
+%include "../library/include/imebra/writingNumericView.h"
 %include "../library/include/imebra/lut.h"
 %include "../library/include/imebra/image.h"
 %include "../library/include/imebra/tag.h"
@@ -179,6 +185,8 @@
 %include "../library/include/imebra/fileStreamOutput.h"
 %include "../library/include/imebra/memoryStreamInput.h"
 %include "../library/include/imebra/memoryStreamOutput.h"
+%include "../library/include/imebra/batchLoader.h"
+%include "../library/include/imebra/multiFrameWriter.h"
 
 
 